@@ -0,0 +1,215 @@
+/**
+ * @file Benchmark.ino
+ * @brief Timing of the library hot paths on the target
+ *
+ * Measures the time per call of the LoRaWAN crypto, the region channel
+ * selection, the time on air calculation and the SPI access of the IRQ
+ * handling. Each result is printed as one JSON object per line, see README.md
+ * how to compare two runs.
+ */
+#include <Arduino.h>
+
+#include <LoRaWan-Arduino.h>
+#include <mac/LoRaMacCrypto.h>
+#include <SPI.h>
+
+#if !defined(RAK4630) && !defined(ARDUINO_ARCH_RP2040)
+hw_config hwConfig;
+
+#ifdef ESP32
+// ESP32 - SX126x pin configuration
+int PIN_LORA_RESET = 4;	 // LORA RESET
+int PIN_LORA_DIO_1 = 21; // LORA DIO_1
+int PIN_LORA_BUSY = 22;	 // LORA SPI BUSY
+int PIN_LORA_NSS = 5;	 // LORA SPI CS
+int PIN_LORA_SCLK = 18;	 // LORA SPI CLK
+int PIN_LORA_MISO = 19;	 // LORA SPI MISO
+int PIN_LORA_MOSI = 23;	 // LORA SPI MOSI
+int RADIO_TXEN = -1;	 // LORA ANTENNA TX ENABLE
+int RADIO_RXEN = -1;	 // LORA ANTENNA RX ENABLE
+#endif
+#ifdef NRF52_SERIES
+// nRF52832 - SX126x pin configuration
+int PIN_LORA_RESET = 4;	 // LORA RESET
+int PIN_LORA_DIO_1 = 11; // LORA DIO_1
+int PIN_LORA_BUSY = 29;	 // LORA SPI BUSY
+int PIN_LORA_NSS = 28;	 // LORA SPI CS
+int PIN_LORA_SCLK = 12;	 // LORA SPI CLK
+int PIN_LORA_MISO = 14;	 // LORA SPI MISO
+int PIN_LORA_MOSI = 13;	 // LORA SPI MOSI
+int RADIO_TXEN = -1;	 // LORA ANTENNA TX ENABLE
+int RADIO_RXEN = -1;	 // LORA ANTENNA RX ENABLE
+#endif
+#endif
+
+// Define LoRa parameters
+#define RF_FREQUENCY 868000000 // Hz
+#define TX_OUTPUT_POWER 22	   // dBm
+#define LORA_BANDWIDTH 0	   // [0: 125 kHz, 1: 250 kHz, 2: 500 kHz, 3: Reserved]
+#define LORA_CODINGRATE 1	   // [1: 4/5, 2: 4/6,  3: 4/7,  4: 4/8]
+#define LORA_PREAMBLE_LENGTH 8 // Same for Tx and Rx
+#define TX_TIMEOUT_VALUE 3000
+
+#define BENCH_MIN_TIME 200000 // Min measuring time per benchmark in us
+
+static RadioEvents_t RadioEvents;
+
+static uint8_t benchBuffer[256];
+static uint8_t benchEncrypted[256];
+static const uint8_t benchKey[16] = {0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+
+/** Payload sizes of the crypto benchmarks, from a small sensor frame to the max LoRaWAN payload */
+static const uint8_t payloadSizes[] = {16, 51, 115, 222};
+
+/**
+ * @brief Run a function until BENCH_MIN_TIME is reached and print the result
+ *
+ * @param name name of the benchmark
+ * @param param parameter of the benchmark, e.g. the payload size
+ * @param function function to measure
+ * @param arg argument for the function
+ */
+static void runBenchmark(const char *name, uint32_t param, void (*function)(uint32_t), uint32_t arg)
+{
+	uint32_t ops = 0;
+	uint32_t batch = 1;
+	uint32_t start = micros();
+	uint32_t elapsed = 0;
+
+	// Grow the batches so the loop overhead of micros() stays small
+	while (elapsed < BENCH_MIN_TIME)
+	{
+		for (uint32_t idx = 0; idx < batch; idx++)
+		{
+			function(arg);
+		}
+		ops += batch;
+		batch *= 2;
+		elapsed = micros() - start;
+	}
+
+	Serial.printf("{\"bench\":\"%s\",\"param\":%lu,\"ops\":%lu,\"ns_op\":%lu}\n",
+				  name, (unsigned long)param, (unsigned long)ops,
+				  (unsigned long)(((uint64_t)elapsed * 1000) / ops));
+}
+
+static void benchMic(uint32_t size)
+{
+	uint32_t mic;
+	LoRaMacComputeMic(benchBuffer, size, benchKey, 0x260116F8, UP_LINK, 1, &mic);
+}
+
+static void benchEncrypt(uint32_t size)
+{
+	LoRaMacPayloadEncrypt(benchBuffer, size, benchKey, 0x260116F8, UP_LINK, 1, benchEncrypted);
+}
+
+static void benchTimeOnAir(uint32_t size)
+{
+	Radio.TimeOnAir(MODEM_LORA, size);
+}
+
+static void benchIrqStatus(uint32_t)
+{
+	// SPI traffic of the IRQ handling, read and clear the IRQ flags
+	uint16_t irqRegs = SX126xGetIrqStatus();
+	SX126xClearIrqStatus(irqRegs);
+}
+
+static void benchNextChannel(uint32_t region)
+{
+	NextChanParams_t nextChan;
+	uint8_t channel;
+	TimerTime_t dutyCycleTimeOff;
+	TimerTime_t aggregatedTimeOff = 0;
+
+	nextChan.AggrTimeOff = 0;
+	nextChan.LastAggrTx = 0;
+	nextChan.Datarate = DR_0;
+	nextChan.Joined = true;
+	nextChan.DutyCycleEnabled = false;
+	RegionNextChannel((LoRaMacRegion_t)region, &nextChan, &channel, &dutyCycleTimeOff, &aggregatedTimeOff);
+}
+
+void setup()
+{
+	// Initialize Serial for the results
+	Serial.begin(115200);
+	time_t serial_timeout = millis();
+	while (!Serial && ((millis() - serial_timeout) < 5000))
+	{
+		delay(100);
+	}
+
+	Serial.println("=====================================");
+	Serial.println("SX126x benchmark");
+	Serial.println("=====================================");
+
+	// Initialize the LoRa chip
+#if defined(RAK4630)
+	uint32_t err_code = lora_rak4630_init();
+#elif defined(ARDUINO_ARCH_RP2040)
+	uint32_t err_code = lora_rak11300_init();
+#else
+	// Define the HW configuration between MCU and SX126x
+	hwConfig.CHIP_TYPE = SX1262_CHIP;		  // Example uses an eByte E22 module with an SX1262
+	hwConfig.PIN_LORA_RESET = PIN_LORA_RESET; // LORA RESET
+	hwConfig.PIN_LORA_NSS = PIN_LORA_NSS;	  // LORA SPI CS
+	hwConfig.PIN_LORA_SCLK = PIN_LORA_SCLK;	  // LORA SPI CLK
+	hwConfig.PIN_LORA_MISO = PIN_LORA_MISO;	  // LORA SPI MISO
+	hwConfig.PIN_LORA_DIO_1 = PIN_LORA_DIO_1; // LORA DIO_1
+	hwConfig.PIN_LORA_BUSY = PIN_LORA_BUSY;	  // LORA SPI BUSY
+	hwConfig.PIN_LORA_MOSI = PIN_LORA_MOSI;	  // LORA SPI MOSI
+	hwConfig.RADIO_TXEN = RADIO_TXEN;		  // LORA ANTENNA TX ENABLE
+	hwConfig.RADIO_RXEN = RADIO_RXEN;		  // LORA ANTENNA RX ENABLE
+	hwConfig.USE_DIO2_ANT_SWITCH = true;	  // Example uses an CircuitRocks Alora RFM1262 which uses DIO2 pins as antenna control
+	hwConfig.USE_DIO3_TCXO = true;			  // Example uses an CircuitRocks Alora RFM1262 which uses DIO3 to control oscillator voltage
+	hwConfig.USE_DIO3_ANT_SWITCH = false;	  // Only Insight ISP4520 module uses DIO3 as antenna control
+	uint32_t err_code = lora_hardware_init(hwConfig);
+#endif
+	if (err_code != 0)
+	{
+		Serial.printf("LoRa chip initialization failed - %d\n", err_code);
+	}
+
+	// Initialize the Radio without callbacks, nothing is sent or received
+	Radio.Init(&RadioEvents);
+	Radio.SetChannel(RF_FREQUENCY);
+	Radio.Standby();
+
+	for (uint16_t idx = 0; idx < sizeof(benchBuffer); idx++)
+	{
+		benchBuffer[idx] = (uint8_t)idx;
+	}
+}
+
+void loop()
+{
+	for (uint8_t idx = 0; idx < sizeof(payloadSizes); idx++)
+	{
+		runBenchmark("mic", payloadSizes[idx], benchMic, payloadSizes[idx]);
+		runBenchmark("encrypt", payloadSizes[idx], benchEncrypt, payloadSizes[idx]);
+	}
+
+	for (uint8_t sf = 7; sf <= 12; sf++)
+	{
+		Radio.SetTxConfig(MODEM_LORA, TX_OUTPUT_POWER, 0, LORA_BANDWIDTH,
+						  sf, LORA_CODINGRATE, LORA_PREAMBLE_LENGTH, false,
+						  true, 0, 0, false, TX_TIMEOUT_VALUE);
+		runBenchmark("time_on_air", sf, benchTimeOnAir, 51);
+	}
+
+	runBenchmark("irq_status", 0, benchIrqStatus, 0);
+
+	for (uint8_t region = LORAMAC_REGION_AS923; region <= LORAMAC_REGION_RU864; region++)
+	{
+		if (RegionIsActive((LoRaMacRegion_t)region))
+		{
+			RegionInitDefaults((LoRaMacRegion_t)region, INIT_TYPE_INIT);
+			runBenchmark("next_channel", region, benchNextChannel, region);
+		}
+	}
+
+	Serial.println("{\"bench\":\"done\"}");
+	delay(60000);
+}
@@ -0,0 +1,257 @@
+/**
+ * @file Profile.ino
+ * @brief Profile report of the library on the target
+ *
+ * Runs either a LoRaWAN node (join, uplinks and downlinks) or a P2P ping loop
+ * and prints the profile zones of the library every minute. The library must
+ * be compiled with LIB_PROFILE=1, see README.md.
+ */
+#include <Arduino.h>
+
+#include <LoRaWan-Arduino.h>
+#include <SPI.h>
+
+// Set to 1 for the LoRaWAN node, 0 for the P2P ping loop
+#define PROFILE_LORAWAN 1
+
+#if !defined(RAK4630) && !defined(ARDUINO_ARCH_RP2040)
+hw_config hwConfig;
+
+#ifdef ESP32
+// ESP32 - SX126x pin configuration
+int PIN_LORA_RESET = 4;	 // LORA RESET
+int PIN_LORA_DIO_1 = 21; // LORA DIO_1
+int PIN_LORA_BUSY = 22;	 // LORA SPI BUSY
+int PIN_LORA_NSS = 5;	 // LORA SPI CS
+int PIN_LORA_SCLK = 18;	 // LORA SPI CLK
+int PIN_LORA_MISO = 19;	 // LORA SPI MISO
+int PIN_LORA_MOSI = 23;	 // LORA SPI MOSI
+int RADIO_TXEN = -1;	 // LORA ANTENNA TX ENABLE
+int RADIO_RXEN = -1;	 // LORA ANTENNA RX ENABLE
+#endif
+#ifdef NRF52_SERIES
+// nRF52832 - SX126x pin configuration
+int PIN_LORA_RESET = 4;	 // LORA RESET
+int PIN_LORA_DIO_1 = 11; // LORA DIO_1
+int PIN_LORA_BUSY = 29;	 // LORA SPI BUSY
+int PIN_LORA_NSS = 28;	 // LORA SPI CS
+int PIN_LORA_SCLK = 12;	 // LORA SPI CLK
+int PIN_LORA_MISO = 14;	 // LORA SPI MISO
+int PIN_LORA_MOSI = 13;	 // LORA SPI MOSI
+int RADIO_TXEN = -1;	 // LORA ANTENNA TX ENABLE
+int RADIO_RXEN = -1;	 // LORA ANTENNA RX ENABLE
+#endif
+#endif
+
+#define PROFILE_REPORT_INTERVAL 60000 // Profile report interval in ms
+#define APP_TX_INTERVAL 30000		  // Uplink or ping interval in ms
+
+#if PROFILE_LORAWAN > 0
+uint8_t nodeDeviceEUI[8] = {0x00, 0x95, 0x64, 0x1F, 0xDA, 0x91, 0x19, 0x0B};
+uint8_t nodeAppEUI[8] = {0x70, 0xB3, 0xD5, 0x7E, 0xD0, 0x02, 0x01, 0xE1};
+uint8_t nodeAppKey[16] = {0x07, 0xC0, 0x82, 0x0C, 0x30, 0xB9, 0x08, 0x70, 0x0C, 0x0F, 0x70, 0x06, 0x00, 0xB0, 0xBE, 0x09};
+
+static void lorawan_has_joined_handler(void);
+static void lorawan_rx_handler(lmh_app_data_t *app_data);
+static void lorawan_confirm_class_handler(DeviceClass_t Class);
+static void lorawan_join_failed_handler(void);
+
+static uint8_t m_lora_app_data_buffer[64];
+static lmh_app_data_t m_lora_app_data = {m_lora_app_data_buffer, 0, 0, 0, 0};
+
+static lmh_param_t lora_param_init = {LORAWAN_ADR_ON, LORAWAN_DEFAULT_DATARATE, LORAWAN_PUBLIC_NETWORK, 3, LORAWAN_DEFAULT_TX_POWER, LORAWAN_DUTYCYCLE_OFF};
+
+static lmh_callback_t lora_callbacks = {BoardGetBatteryLevel, BoardGetUniqueId, BoardGetRandomSeed,
+										lorawan_rx_handler, lorawan_has_joined_handler, lorawan_confirm_class_handler, lorawan_join_failed_handler};
+#else
+// Define LoRa parameters
+#define RF_FREQUENCY 868000000 // Hz
+#define TX_OUTPUT_POWER 22	   // dBm
+#define LORA_BANDWIDTH 0	   // [0: 125 kHz, 1: 250 kHz, 2: 500 kHz, 3: Reserved]
+#define LORA_SPREADING_FACTOR 7 // [SF7..SF12]
+#define LORA_CODINGRATE 1	   // [1: 4/5, 2: 4/6,  3: 4/7,  4: 4/8]
+#define LORA_PREAMBLE_LENGTH 8 // Same for Tx and Rx
+#define TX_TIMEOUT_VALUE 3000
+
+static RadioEvents_t RadioEvents;
+static uint8_t pingMsg[] = "PING";
+
+void OnTxDone(void);
+void OnRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr);
+void OnTxTimeout(void);
+void OnRxTimeout(void);
+void OnRxError(void);
+#endif
+
+static TimerEvent_t appTimer;
+static volatile bool sendNow = false;
+static time_t lastReport = 0;
+
+/**@brief Trigger the next uplink or ping from the loop
+ */
+static void app_timer_handler(void)
+{
+	sendNow = true;
+	TimerSetValue(&appTimer, APP_TX_INTERVAL);
+	TimerStart(&appTimer);
+}
+
+void setup()
+{
+	Serial.begin(115200);
+	time_t serial_timeout = millis();
+	while (!Serial && ((millis() - serial_timeout) < 5000))
+	{
+		delay(100);
+	}
+
+	Serial.println("=====================================");
+	Serial.println("SX126x profile");
+	Serial.println("=====================================");
+	if (profile_frequency() == 0)
+	{
+		Serial.println("Profiler disabled, compile the library with LIB_PROFILE=1");
+	}
+
+	// Initialize the LoRa chip
+#if defined(RAK4630)
+	uint32_t err_code = lora_rak4630_init();
+#elif defined(ARDUINO_ARCH_RP2040)
+	uint32_t err_code = lora_rak11300_init();
+#else
+	// Define the HW configuration between MCU and SX126x
+	hwConfig.CHIP_TYPE = SX1262_CHIP;		  // Example uses an eByte E22 module with an SX1262
+	hwConfig.PIN_LORA_RESET = PIN_LORA_RESET; // LORA RESET
+	hwConfig.PIN_LORA_NSS = PIN_LORA_NSS;	  // LORA SPI CS
+	hwConfig.PIN_LORA_SCLK = PIN_LORA_SCLK;	  // LORA SPI CLK
+	hwConfig.PIN_LORA_MISO = PIN_LORA_MISO;	  // LORA SPI MISO
+	hwConfig.PIN_LORA_DIO_1 = PIN_LORA_DIO_1; // LORA DIO_1
+	hwConfig.PIN_LORA_BUSY = PIN_LORA_BUSY;	  // LORA SPI BUSY
+	hwConfig.PIN_LORA_MOSI = PIN_LORA_MOSI;	  // LORA SPI MOSI
+	hwConfig.RADIO_TXEN = RADIO_TXEN;		  // LORA ANTENNA TX ENABLE
+	hwConfig.RADIO_RXEN = RADIO_RXEN;		  // LORA ANTENNA RX ENABLE
+	hwConfig.USE_DIO2_ANT_SWITCH = true;	  // Example uses an CircuitRocks Alora RFM1262 which uses DIO2 pins as antenna control
+	hwConfig.USE_DIO3_TCXO = true;			  // Example uses an CircuitRocks Alora RFM1262 which uses DIO3 to control oscillator voltage
+	hwConfig.USE_DIO3_ANT_SWITCH = false;	  // Only Insight ISP4520 module uses DIO3 as antenna control
+	uint32_t err_code = lora_hardware_init(hwConfig);
+#endif
+	if (err_code != 0)
+	{
+		Serial.printf("LoRa chip initialization failed - %d\n", err_code);
+	}
+
+	TimerInit(&appTimer, app_timer_handler);
+
+#if PROFILE_LORAWAN > 0
+	lmh_setDevEui(nodeDeviceEUI);
+	lmh_setAppEui(nodeAppEUI);
+	lmh_setAppKey(nodeAppKey);
+
+	err_code = lmh_init(&lora_callbacks, lora_param_init, true, CLASS_A, LORAMAC_REGION_EU868);
+	if (err_code != 0)
+	{
+		Serial.printf("lmh_init failed - %d\n", err_code);
+	}
+	lmh_join();
+#else
+	RadioEvents.TxDone = OnTxDone;
+	RadioEvents.RxDone = OnRxDone;
+	RadioEvents.TxTimeout = OnTxTimeout;
+	RadioEvents.RxTimeout = OnRxTimeout;
+	RadioEvents.RxError = OnRxError;
+	Radio.Init(&RadioEvents);
+	Radio.SetChannel(RF_FREQUENCY);
+	Radio.SetTxConfig(MODEM_LORA, TX_OUTPUT_POWER, 0, LORA_BANDWIDTH,
+					  LORA_SPREADING_FACTOR, LORA_CODINGRATE,
+					  LORA_PREAMBLE_LENGTH, false, true, 0, 0, false, TX_TIMEOUT_VALUE);
+	Radio.SetRxConfig(MODEM_LORA, LORA_BANDWIDTH, LORA_SPREADING_FACTOR,
+					  LORA_CODINGRATE, 0, LORA_PREAMBLE_LENGTH,
+					  0, false, 0, true, 0, 0, false, true);
+	Radio.Rx(0);
+	app_timer_handler();
+#endif
+
+	lastReport = millis();
+}
+
+void loop()
+{
+#ifdef ESP8266
+	// Handle Radio events
+	Radio.IrqProcess();
+#endif
+
+	if (sendNow)
+	{
+		sendNow = false;
+		PROFILE_ZONE("app_send");
+#if PROFILE_LORAWAN > 0
+		if (lmh_join_status_get() == LMH_SET)
+		{
+			m_lora_app_data.port = LORAWAN_APP_PORT;
+			m_lora_app_data.buffsize = 12;
+			memcpy(m_lora_app_data.buffer, "Hello world!", 12);
+			lmh_send(&m_lora_app_data, LMH_UNCONFIRMED_MSG);
+		}
+#else
+		Radio.Send(pingMsg, sizeof(pingMsg));
+#endif
+	}
+
+	if ((millis() - lastReport) >= PROFILE_REPORT_INTERVAL)
+	{
+		lastReport = millis();
+		Serial.println("-------------------------------------");
+		profile_report();
+	}
+	delay(10);
+}
+
+#if PROFILE_LORAWAN > 0
+static void lorawan_join_failed_handler(void)
+{
+	Serial.println("Join failed");
+}
+
+static void lorawan_has_joined_handler(void)
+{
+	Serial.println("Network joined");
+	app_timer_handler();
+}
+
+static void lorawan_rx_handler(lmh_app_data_t *app_data)
+{
+	Serial.printf("Downlink on port %d, size:%d, rssi:%d, snr:%d\n",
+				  app_data->port, app_data->buffsize, app_data->rssi, app_data->snr);
+}
+
+static void lorawan_confirm_class_handler(DeviceClass_t Class)
+{
+	Serial.printf("switch to class %c done\n", "ABC"[Class]);
+}
+#else
+void OnTxDone(void)
+{
+	Radio.Rx(0);
+}
+
+void OnRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+{
+	Serial.printf("Received %d bytes, rssi:%d, snr:%d\n", size, rssi, snr);
+}
+
+void OnTxTimeout(void)
+{
+	Radio.Rx(0);
+}
+
+void OnRxTimeout(void)
+{
+	Radio.Rx(0);
+}
+
+void OnRxError(void)
+{
+	Radio.Rx(0);
+}
+#endif
@@ -0,0 +1,209 @@
+/**
+ * @file TimerBench.ino
+ * @brief Latency and CPU load of the timer backend on the target
+ *
+ * Measures how late the timer callbacks run and how much CPU time a recurring
+ * timer takes from the application. Each result is printed as one JSON object
+ * per line in the format of the Benchmark example, see README.md.
+ */
+#include <Arduino.h>
+
+#include <LoRaWan-Arduino.h>
+#include <SPI.h>
+
+#if !defined(RAK4630) && !defined(ARDUINO_ARCH_RP2040)
+hw_config hwConfig;
+
+#ifdef ESP32
+// ESP32 - SX126x pin configuration
+int PIN_LORA_RESET = 4;	 // LORA RESET
+int PIN_LORA_DIO_1 = 21; // LORA DIO_1
+int PIN_LORA_BUSY = 22;	 // LORA SPI BUSY
+int PIN_LORA_NSS = 5;	 // LORA SPI CS
+int PIN_LORA_SCLK = 18;	 // LORA SPI CLK
+int PIN_LORA_MISO = 19;	 // LORA SPI MISO
+int PIN_LORA_MOSI = 23;	 // LORA SPI MOSI
+int RADIO_TXEN = -1;	 // LORA ANTENNA TX ENABLE
+int RADIO_RXEN = -1;	 // LORA ANTENNA RX ENABLE
+#endif
+#ifdef NRF52_SERIES
+// nRF52832 - SX126x pin configuration
+int PIN_LORA_RESET = 4;	 // LORA RESET
+int PIN_LORA_DIO_1 = 11; // LORA DIO_1
+int PIN_LORA_BUSY = 29;	 // LORA SPI BUSY
+int PIN_LORA_NSS = 28;	 // LORA SPI CS
+int PIN_LORA_SCLK = 12;	 // LORA SPI CLK
+int PIN_LORA_MISO = 14;	 // LORA SPI MISO
+int PIN_LORA_MOSI = 13;	 // LORA SPI MOSI
+int RADIO_TXEN = -1;	 // LORA ANTENNA TX ENABLE
+int RADIO_RXEN = -1;	 // LORA ANTENNA RX ENABLE
+#endif
+#endif
+
+#define TIMER_SAMPLES 100	 // Expiries measured by the timer latency benchmark
+#define TIMER_LOAD_TIME 1000000 // Measuring time of the timer load benchmark in us
+
+static TimerEvent_t benchTimer;
+static volatile uint32_t timerStart = 0;
+static volatile uint32_t timerCount = 0;
+static volatile uint32_t timerLateMin = 0;
+static volatile uint32_t timerLateMax = 0;
+static volatile uint32_t timerLateSum = 0;
+
+/**
+ * @brief Timer callback of the latency benchmark, restarts the timer until TIMER_SAMPLES are taken
+ */
+static void onLatencyTimer(void)
+{
+	uint32_t late = micros() - timerStart - benchTimer.ReloadValue * 1000;
+
+	if ((timerCount == 0) || (late < timerLateMin))
+	{
+		timerLateMin = late;
+	}
+	if (late > timerLateMax)
+	{
+		timerLateMax = late;
+	}
+	timerLateSum += late;
+	timerCount++;
+
+	if (timerCount < TIMER_SAMPLES)
+	{
+		timerStart = micros();
+		TimerStart(&benchTimer);
+	}
+}
+
+/**
+ * @brief Timer callback of the load benchmark
+ */
+static void onLoadTimer(void)
+{
+	timerCount++;
+}
+
+/**
+ * @brief Measure how late a timer callback runs, from the expiry to the callback
+ * On boards that run the callbacks in the LoRa task this includes the wake-up of the task.
+ *
+ * @param period timer period in ms
+ */
+static void runTimerLatency(uint32_t period)
+{
+	timerCount = 0;
+	timerLateMin = 0;
+	timerLateMax = 0;
+	timerLateSum = 0;
+
+	benchTimer.oneShot = true;
+	TimerInit(&benchTimer, onLatencyTimer);
+	TimerSetValue(&benchTimer, period);
+	timerStart = micros();
+	TimerStart(&benchTimer);
+
+	uint32_t timeout = millis() + period * TIMER_SAMPLES * 2 + 1000;
+	while ((timerCount < TIMER_SAMPLES) && ((int32_t)(millis() - timeout) < 0))
+	{
+		delay(1);
+	}
+	TimerStop(&benchTimer);
+
+	uint32_t samples = timerCount;
+	Serial.printf("{\"bench\":\"timer_late\",\"param\":%lu,\"ops\":%lu,\"ns_op\":%lu,\"min_ns\":%lu,\"max_ns\":%lu}\n",
+				  (unsigned long)period, (unsigned long)samples,
+				  (unsigned long)(samples != 0 ? ((uint64_t)timerLateSum * 1000) / samples : 0),
+				  (unsigned long)timerLateMin * 1000, (unsigned long)timerLateMax * 1000);
+}
+
+/**
+ * @brief Measure the CPU time left to the application while a recurring timer runs
+ * Counts the iterations of a busy loop. The timer ISR and the timer handling of the
+ * LoRa task take their time from this loop, a slower iteration is a higher load.
+ *
+ * @param period timer period in ms, 0 to measure without a running timer
+ */
+static void runTimerLoad(uint32_t period)
+{
+	timerCount = 0;
+	if (period != 0)
+	{
+		benchTimer.oneShot = false;
+		TimerInit(&benchTimer, onLoadTimer);
+		TimerSetValue(&benchTimer, period);
+		TimerStart(&benchTimer);
+	}
+
+	uint32_t ops = 0;
+	uint32_t start = micros();
+	uint32_t elapsed = 0;
+	while (elapsed < TIMER_LOAD_TIME)
+	{
+		ops++;
+		elapsed = micros() - start;
+	}
+
+	if (period != 0)
+	{
+		TimerStop(&benchTimer);
+		benchTimer.oneShot = true;
+	}
+
+	Serial.printf("{\"bench\":\"timer_load\",\"param\":%lu,\"ops\":%lu,\"ns_op\":%lu,\"expiries\":%lu}\n",
+				  (unsigned long)period, (unsigned long)ops,
+				  (unsigned long)(((uint64_t)elapsed * 1000) / ops), (unsigned long)timerCount);
+}
+
+void setup()
+{
+	// Initialize Serial for the results
+	Serial.begin(115200);
+	time_t serial_timeout = millis();
+	while (!Serial && ((millis() - serial_timeout) < 5000))
+	{
+		delay(100);
+	}
+
+	Serial.println("=====================================");
+	Serial.println("SX126x timer benchmark");
+	Serial.println("=====================================");
+
+	// Initialize the LoRa chip
+#if defined(RAK4630)
+	uint32_t err_code = lora_rak4630_init();
+#elif defined(ARDUINO_ARCH_RP2040)
+	uint32_t err_code = lora_rak11300_init();
+#else
+	// Define the HW configuration between MCU and SX126x
+	hwConfig.CHIP_TYPE = SX1262_CHIP;		  // Example uses an eByte E22 module with an SX1262
+	hwConfig.PIN_LORA_RESET = PIN_LORA_RESET; // LORA RESET
+	hwConfig.PIN_LORA_NSS = PIN_LORA_NSS;	  // LORA SPI CS
+	hwConfig.PIN_LORA_SCLK = PIN_LORA_SCLK;	  // LORA SPI CLK
+	hwConfig.PIN_LORA_MISO = PIN_LORA_MISO;	  // LORA SPI MISO
+	hwConfig.PIN_LORA_DIO_1 = PIN_LORA_DIO_1; // LORA DIO_1
+	hwConfig.PIN_LORA_BUSY = PIN_LORA_BUSY;	  // LORA SPI BUSY
+	hwConfig.PIN_LORA_MOSI = PIN_LORA_MOSI;	  // LORA SPI MOSI
+	hwConfig.RADIO_TXEN = RADIO_TXEN;		  // LORA ANTENNA TX ENABLE
+	hwConfig.RADIO_RXEN = RADIO_RXEN;		  // LORA ANTENNA RX ENABLE
+	hwConfig.USE_DIO2_ANT_SWITCH = true;	  // Example uses an CircuitRocks Alora RFM1262 which uses DIO2 pins as antenna control
+	hwConfig.USE_DIO3_TCXO = true;			  // Example uses an CircuitRocks Alora RFM1262 which uses DIO3 to control oscillator voltage
+	hwConfig.USE_DIO3_ANT_SWITCH = false;	  // Only Insight ISP4520 module uses DIO3 as antenna control
+	uint32_t err_code = lora_hardware_init(hwConfig);
+#endif
+	if (err_code != 0)
+	{
+		Serial.printf("LoRa chip initialization failed - %d\n", err_code);
+	}
+}
+
+void loop()
+{
+	runTimerLatency(10);
+	runTimerLatency(100);
+	runTimerLoad(0);
+	runTimerLoad(1);
+	runTimerLoad(10);
+
+	Serial.println("{\"bench\":\"done\"}");
+	delay(60000);
+}
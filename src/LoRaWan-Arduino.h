@@ -15,6 +15,7 @@
 #include "boards/mcu/board.h"
 #include "radio/radio.h"
 #include "mac/LoRaMacHelper.h"
+#include "mac/LoRaMacPlanner.h"
 
 #ifdef NRF52_SERIES
 #include <SPI.h>
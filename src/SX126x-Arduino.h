@@ -19,6 +19,14 @@
 
 #include "boards/mcu/board.h"
 #include "radio/radio.h"
+#include "p2p/P2PAdapt.h"
+#include "p2p/P2PArq.h"
+#include "p2p/P2PBulk.h"
+#include "p2p/P2PMesh.h"
+#include "p2p/P2PPower.h"
+#include "p2p/P2PScan.h"
+#include "p2p/P2PSurvey.h"
+#include "p2p/P2PTdma.h"
 
 #ifdef NRF52_SERIES
 #include <SPI.h>
@@ -82,6 +82,7 @@ uint32_t lora_hardware_init(hw_config hwConfig)
 	_hwConfig.TCXO_CTRL_VOLTAGE = hwConfig.TCXO_CTRL_VOLTAGE;
 
 	TimerConfig();
+	profile_init();
 
 	SX126xIoInit();
 
@@ -128,6 +129,7 @@ uint32_t lora_hardware_re_init(hw_config hwConfig)
 	_hwConfig.USE_RXEN_ANT_PWR = hwConfig.USE_RXEN_ANT_PWR;		  // RXEN used as power for antenna switch
 
 	TimerConfig();
+	profile_init();
 
 	SX126xIoReInit();
 
@@ -173,6 +175,7 @@ uint32_t lora_isp4520_init(int chipType)
 	_hwConfig.USE_DIO3_ANT_SWITCH = true; // LORA DIO3 controls antenna (e.g. Insight SIP ISP4520 module)
 	_hwConfig.USE_RXEN_ANT_PWR = false;	  // RXEN is not used as power for antenna switch
 	TimerConfig();
+	profile_init();
 
 	SX126xIoInit();
 
@@ -220,6 +223,7 @@ uint32_t lora_rak4630_init(void)
 	_hwConfig.USE_LDO = false;			   // LORA usage of LDO or DCDC power regulator (defaults to DCDC)
 
 	TimerConfig();
+	profile_init();
 
 	SX126xIoInit();
 
@@ -271,6 +275,7 @@ uint32_t lora_rak11300_init(void)
 #endif
 	LOG_LIB("BRD", "TimerConfig()");
 	TimerConfig();
+	profile_init();
 
 	LOG_LIB("BRD", "SX126xIoInit()");
 	SX126xIoInit();
@@ -334,6 +339,7 @@ uint32_t lora_rak13300_init(void)
 	_hwConfig.USE_RXEN_ANT_PWR = true;	   // RXEN is used as power for antenna switch
 
 	TimerConfig();
+	profile_init();
 
 	SX126xIoInit();
 
@@ -374,6 +380,10 @@ void _lora_task(void *pvParameters)
 			LOG_LIB("BRD", "LoRa task wakeup");
 			// Handle Radio events
 			Radio.BgIrqProcess();
+#if defined ARDUINO_RAKWIRELESS_RAK11300
+			// Handle expired timers
+			TimerHandleEvents();
+#endif
 		}
 	}
 }
@@ -407,7 +417,7 @@ Thread _thread_handle_lora(osPriorityAboveNormal, 4096);
 /** Thread id for lora event thread */
 osThreadId _lora_task_thread = NULL;
 
-// Task to handle timer events
+// Task to handle radio and timer events
 void _lora_task()
 {
 	_lora_task_thread = osThreadGetId();
@@ -419,6 +429,8 @@ void _lora_task()
 		// LOG_LIB("TIM", "LoRa IRQ");
 		// Handle Radio events
 		Radio.BgIrqProcess();
+		// Handle expired timers
+		TimerHandleEvents();
 
 		yield();
 	}
@@ -50,6 +50,8 @@ Maintainer: Miguel Luis and Gregory Cristian
 #include "boards/sx126x/sx126x-board.h"
 #include "timer.h"
 #include "sx126x-debug.h"
+#include "sx126x-profile.h"
+#include "sx126x-trace.h"
 
 // SX126x chip type
 #define SX1261_CHIP 1
@@ -67,19 +67,31 @@ void TimerInit(TimerEvent_t *obj, void (*callback)(void))
 
 void timerCallback(TimerEvent_t *obj)
 {
-	// Nothing to do here for the ESP32
+	TimerDispatch(obj);
 }
 
-void TimerStart(TimerEvent_t *obj)
+void TimerArm(TimerEvent_t *obj, uint32_t value)
 {
 	int idx = obj->timerNum;
 	if (obj->oneShot)
 	{
-		timerTickers[idx].once_ms(timerTimes[idx], obj->Callback);
+		timerTickers[idx].once_ms(value, timerCallback, obj);
 	}
 	else
 	{
-		timerTickers[idx].attach_ms(timerTimes[idx], obj->Callback);
+		timerTickers[idx].attach_ms(value, timerCallback, obj);
+	}
+}
+
+void TimerStart(TimerEvent_t *obj)
+{
+	int idx = obj->timerNum;
+	uint32_t value = timerTimes[idx];
+
+	timerTickers[idx].detach();
+	if (TimerCoalesce(obj, &value))
+	{
+		TimerArm(obj, value);
 	}
 }
 
@@ -87,26 +99,22 @@ void TimerStop(TimerEvent_t *obj)
 {
 	int idx = obj->timerNum;
 	timerTickers[idx].detach();
+	TimerRemove(obj);
 }
 
 void TimerReset(TimerEvent_t *obj)
 {
 	int idx = obj->timerNum;
 	timerTickers[idx].detach();
-	if (obj->oneShot)
-	{
-		timerTickers[idx].once_ms(timerTimes[idx], obj->Callback);
-	}
-	else
-	{
-		timerTickers[idx].attach_ms(timerTimes[idx], obj->Callback);
-	}
+	TimerStart(obj);
 }
 
 void TimerSetValue(TimerEvent_t *obj, uint32_t value)
 {
 	int idx = obj->timerNum;
 	timerTimes[idx] = value;
+	// Period of a recurring timer, TimerDispatch stamps its next expiry with it
+	obj->ReloadValue = value;
 }
 
 TimerTime_t TimerGetCurrentTime(void)
@@ -40,6 +40,9 @@ Maintainer: Miguel Luis, Gregory Cristian and Wael Guibene
 
 SoftwareTimer timerTickers[10];
 uint32_t timerTimes[10];
+uint32_t timerPeriods[10];
+
+void timerCallback(TimerHandle_t xTimer);
 bool timerInUse[10] = {false, false, false, false, false, false, false, false, false, false};
 
 // External functions
@@ -59,13 +62,14 @@ void TimerInit(TimerEvent_t *obj, void (*callback)(void))
 			timerInUse[idx] = true;
 			obj->timerNum = idx;
 			obj->Callback = callback;
+			timerPeriods[idx] = 10000;
 			if (obj->oneShot)
 			{
-				timerTickers[idx].begin(10000, (TimerCallbackFunction_t)obj->Callback, NULL, false);
+				timerTickers[idx].begin(10000, timerCallback, obj, false);
 			}
 			else
 			{
-				timerTickers[idx].begin(10000, (TimerCallbackFunction_t)obj->Callback, NULL, true);
+				timerTickers[idx].begin(10000, timerCallback, obj, true);
 			}
 			return;
 		}
@@ -74,23 +78,47 @@ void TimerInit(TimerEvent_t *obj, void (*callback)(void))
 	/// \todo We run out of tickers, what do we do now???
 }
 
-void timerCallback(TimerEvent_t *obj)
+void timerCallback(TimerHandle_t xTimer)
 {
-	// Nothing to do here for the nRF52
+	TimerEvent_t *obj = (TimerEvent_t *)pvTimerGetTimerID(xTimer);
+	TimerDispatch(obj);
 }
 
-void TimerStart(TimerEvent_t *obj)
+void TimerArm(TimerEvent_t *obj, uint32_t value)
 {
 	int idx = obj->timerNum;
 
+	// A FreeRTOS timer needs a period of at least 1 tick
+	if (value == 0)
+	{
+		value = 1;
+	}
 	timerTickers[idx].stop();
+	if (value != timerPeriods[idx])
+	{
+		timerPeriods[idx] = value;
+		timerTickers[idx].setPeriod(value);
+	}
 	timerTickers[idx].start();
 }
 
+void TimerStart(TimerEvent_t *obj)
+{
+	int idx = obj->timerNum;
+	uint32_t value = timerTimes[idx];
+
+	timerTickers[idx].stop();
+	if (TimerCoalesce(obj, &value))
+	{
+		TimerArm(obj, value);
+	}
+}
+
 void TimerStop(TimerEvent_t *obj)
 {
 	int idx = obj->timerNum;
 	timerTickers[idx].stop();
+	TimerRemove(obj);
 }
 
 void TimerReset(TimerEvent_t *obj)
@@ -98,14 +126,17 @@ void TimerReset(TimerEvent_t *obj)
 	int idx = obj->timerNum;
 
 	timerTickers[idx].stop();
-	timerTickers[idx].reset();
+	TimerStart(obj);
 }
 
 void TimerSetValue(TimerEvent_t *obj, uint32_t value)
 {
 	int idx = obj->timerNum;
 	timerTimes[idx] = value;
+	timerPeriods[idx] = value;
 	timerTickers[idx].setPeriod(value);
+	// Period of a recurring timer, TimerDispatch stamps its next expiry with it
+	obj->ReloadValue = value;
 }
 
 TimerTime_t TimerGetCurrentTime(void)
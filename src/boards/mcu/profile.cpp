@@ -0,0 +1,102 @@
+/**
+ * @file profile.cpp
+ * @brief Cycle counting profiler with scoped zones, see sx126x-profile.h
+ */
+#include "boards/mcu/board.h"
+
+#if LIB_PROFILE > 0
+
+/** First zone of the report list */
+static profile_zone_t *profileZones = NULL;
+
+void profile_init(void)
+{
+#if defined NRF52_SERIES
+	// The cycle counter of the DWT needs the trace unit
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+uint32_t profile_frequency(void)
+{
+#if defined NRF52_SERIES
+	return SystemCoreClock;
+#elif defined ESP32 || defined ESP8266
+	return ESP.getCpuFreqMHz() * 1000000;
+#else
+	// RP2040 system timer and micros()
+	return 1000000;
+#endif
+}
+
+void profile_add(profile_zone_t *zone, uint32_t ticks)
+{
+	if (!zone->registered)
+	{
+		BoardDisableIrq();
+		if (!zone->registered)
+		{
+			zone->next = profileZones;
+			profileZones = zone;
+			zone->registered = true;
+		}
+		BoardEnableIrq();
+	}
+
+	zone->count++;
+	zone->total += ticks;
+	if (ticks < zone->min)
+	{
+		zone->min = ticks;
+	}
+	if (ticks > zone->max)
+	{
+		zone->max = ticks;
+	}
+}
+
+/**
+ * @brief Convert counter ticks into ns
+ *
+ * @param ticks counter ticks
+ * @return uint32_t time in ns
+ */
+static uint32_t ticksToNs(uint64_t ticks)
+{
+	return (uint32_t)((ticks * 1000000000) / profile_frequency());
+}
+
+void profile_report(void)
+{
+	Serial.printf("%-24s %10s %10s %10s %10s\n", "zone", "count", "min ns", "avg ns", "max ns");
+	for (profile_zone_t *zone = profileZones; zone != NULL; zone = zone->next)
+	{
+		if (zone->count == 0)
+		{
+			Serial.printf("%-24s %10d\n", zone->name, 0);
+			continue;
+		}
+		Serial.printf("%-24s %10lu %10lu %10lu %10lu\n", zone->name,
+					  (unsigned long)zone->count,
+					  (unsigned long)ticksToNs(zone->min),
+					  (unsigned long)ticksToNs(zone->total / zone->count),
+					  (unsigned long)ticksToNs(zone->max));
+	}
+}
+
+void profile_reset(void)
+{
+	for (profile_zone_t *zone = profileZones; zone != NULL; zone = zone->next)
+	{
+		BoardDisableIrq();
+		zone->count = 0;
+		zone->min = UINT32_MAX;
+		zone->max = 0;
+		zone->total = 0;
+		BoardEnableIrq();
+	}
+}
+
+#endif
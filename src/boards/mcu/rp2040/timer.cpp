@@ -34,205 +34,210 @@ Maintainer: Miguel Luis, Gregory Cristian and Wael Guibene
  *
  *****************************************************************************/
 // #define ARDUINO_ARCH_RP2040
-#if defined ARDUINO_ARCH_RP2040 && not defined ARDUINO_RAKWIRELESS_RAK11300
+#if defined ARDUINO_ARCH_RP2040 || defined ARDUINO_RAKWIRELESS_RAK11300
 
 #include "boards/mcu/timer.h"
 #include "boards/mcu/board.h"
 
-#include <mbed.h>
-#include <rtos.h>
-#include <cmsis_os.h>
 #include <pico/time.h>
+#include <hardware/timer.h>
+#include <hardware/sync.h>
 
-using namespace std::chrono_literals;
-using namespace std::chrono;
-using namespace rtos;
-using namespace mbed;
+#if defined ARDUINO_RAKWIRELESS_RAK11300
+/** Semaphore used to wake up the LoRa task */
+extern SemaphoreHandle_t _lora_sem;
+#endif
 
-/** The event handler thread */
-Thread thread_handle_timers(osPriorityAboveNormal, 4096);
+/** Maximum number of timers, limited by the pending bit mask */
+#define RP2040_MAX_TIMERS 16
 
 /** Timer structure */
 struct s_timer
 {
-	int32_t signal = 0;
 	bool in_use = false;
-	bool active = false;
-	time_t duration;
-	time_t start_time;
-	void (*callback)();
+	alarm_id_t alarm = 0;
+	TimerEvent_t *obj = NULL;
 };
 
 /** Array to hold the timers */
-s_timer timer[10];
-mbed::Ticker timerTickers[10];
-
-// Timer callbacks
-void cb_timer_1(void);
-void cb_timer_2(void);
-void cb_timer_3(void);
-void cb_timer_4(void);
-void cb_timer_5(void);
-void cb_timer_6(void);
-void cb_timer_7(void);
-void cb_timer_8(void);
-void cb_timer_9(void);
-void cb_timer_10(void);
-
-void (*cb_callback[])() = {cb_timer_1, cb_timer_2, cb_timer_3, cb_timer_4, cb_timer_5, cb_timer_6, cb_timer_7, cb_timer_8, cb_timer_9, cb_timer_10};
-
-/** Thread id for timer thread */
-osThreadId timer_event_thread = NULL;
+static s_timer timer[RP2040_MAX_TIMERS];
 
-/**
- * @brief Thread to handle timer events
- * Called every 500 us to check if any timer
- * has to be handled
- *
- */
-void handle_timer_events(void)
-{
-	timer_event_thread = osThreadGetId();
-	while (true)
-	{
-		// Wait for event
-		osEvent event = osSignalWait(0, osWaitForever);
+/** Alarm pool on a hardware alarm of its own */
+static alarm_pool_t *timerPool = NULL;
 
-		if (event.status == osEventSignal)
-		{
-			// Serial.printf("Signal %02X\n", event.value.signals);
-			uint16_t mask = 0x01;
-			for (int idx = 0; idx < 10; idx++)
-			{
-				if ((event.value.signals & (mask << idx)) == (mask << idx))
-				{
-					// Serial.printf("Callback %d", idx);
-					timer[idx].callback();
-				}
-			}
-		}
-		yield();
-	}
-}
+/** Expired timers waiting to be handled by the LoRa task, one bit per timer */
+static volatile uint32_t timerPending = 0;
 
 /**
- * @brief Hardware timer callbacks
+ * @brief Wake up the LoRa task from the alarm ISR
+ *
  */
-void cb_timer_1(void)
+static void wakeLoRaTask(void)
 {
-	if (timer_event_thread != NULL)
+#if defined ARDUINO_RAKWIRELESS_RAK11300
+	if (_lora_sem != NULL)
 	{
-		osSignalSet(timer_event_thread, 0x01);
+		BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+		xSemaphoreGiveFromISR(_lora_sem, &xHigherPriorityTaskWoken);
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 	}
-}
-void cb_timer_2(void)
-{
-	if (timer_event_thread != NULL)
+#else
+	if (_lora_task_thread != NULL)
 	{
-		osSignalSet(timer_event_thread, 0x02);
+		osSignalSet(_lora_task_thread, 0x1);
 	}
+#endif
 }
-void cb_timer_3(void)
-{
-	if (timer_event_thread != NULL)
-	{
-		osSignalSet(timer_event_thread, 0x04);
-	}
-}
-void cb_timer_4(void)
-{
-	if (timer_event_thread != NULL)
-	{
-		osSignalSet(timer_event_thread, 0x08);
-	}
-}
-void cb_timer_5(void)
+
+/**
+ * @brief Alarm ISR, flags the timer and wakes up the LoRa task
+ *
+ * @param id alarm id
+ * @param user_data timer index
+ * @return int64_t 0 to stop a one shot timer,
+ * 		reload time in us to restart a recurring timer relative to its last expiry
+ */
+static int64_t alarmCallback(alarm_id_t id, void *user_data)
 {
-	if (timer_event_thread != NULL)
+	(void)id;
+	int idx = (int)(intptr_t)user_data;
+	TimerEvent_t *obj = timer[idx].obj;
+
+	timerPending |= (1UL << idx);
+	wakeLoRaTask();
+
+	if (obj->oneShot)
 	{
-		osSignalSet(timer_event_thread, 0x10);
+		timer[idx].alarm = 0;
+		return 0;
 	}
+	return (int64_t)obj->ReloadValue * 1000;
 }
-void cb_timer_6(void)
+
+/**
+ * @brief Cancel the alarm of a timer and drop an expiry not yet handled
+ *
+ * @param idx timer index
+ */
+static void cancelAlarm(int idx)
 {
-	if (timer_event_thread != NULL)
+	uint32_t irqState = save_and_disable_interrupts();
+	if (timer[idx].alarm > 0)
 	{
-		osSignalSet(timer_event_thread, 0x20);
+		alarm_pool_cancel_alarm(timerPool, timer[idx].alarm);
+		timer[idx].alarm = 0;
 	}
+	timerPending &= ~(1UL << idx);
+	restore_interrupts(irqState);
 }
-void cb_timer_7(void)
+
+/**
+ * @brief Arm the alarm of a timer
+ * The alarm is added and its id stored with the interrupts disabled. Otherwise a short alarm
+ * can expire before the id is stored, and the id of the expired alarm would be kept.
+ * The alarm pool interrupt is on the core that called TimerConfig, the LoRa task runs there too.
+ *
+ * @param idx timer index
+ * @param value duration time in milliseconds
+ */
+static void armAlarm(int idx, uint32_t value)
 {
-	if (timer_event_thread != NULL)
+	TimerEvent_t *obj = timer[idx].obj;
+	bool expired = false;
+
+	uint32_t irqState = save_and_disable_interrupts();
+	// Not fired by the pool if already past, the callback would run with the interrupts disabled
+	alarm_id_t alarm = alarm_pool_add_alarm_in_us(timerPool, (uint64_t)value * 1000, alarmCallback, (void *)(intptr_t)idx, false);
+	if (alarm == 0)
 	{
-		osSignalSet(timer_event_thread, 0x40);
+		// Expired already, flag it as the alarm ISR does and arm the next period of a recurring timer
+		expired = true;
+		timerPending |= (1UL << idx);
+		if (!obj->oneShot && (obj->ReloadValue > 0))
+		{
+			alarm = alarm_pool_add_alarm_in_us(timerPool, (uint64_t)obj->ReloadValue * 1000, alarmCallback, (void *)(intptr_t)idx, false);
+		}
 	}
-}
-void cb_timer_8(void)
-{
-	if (timer_event_thread != NULL)
+	timer[idx].alarm = alarm > 0 ? alarm : 0;
+	restore_interrupts(irqState);
+
+	if (alarm < 0)
 	{
-		osSignalSet(timer_event_thread, 0x80);
+		LOG_LIB("TIM", "No alarm slot for timer %d", idx);
 	}
-}
-void cb_timer_9(void)
-{
-	if (timer_event_thread != NULL)
+	if (expired)
 	{
-		osSignalSet(timer_event_thread, 0x100);
-	}
-}
-void cb_timer_10(void)
-{
-	if (timer_event_thread != NULL)
-	{
-		osSignalSet(timer_event_thread, 0x200);
+		wakeLoRaTask();
 	}
 }
 
 /**
  * @brief Configure the RP2040 timers
- * Starts the background thread to handle timer events
- * Starts the Hardware timer to wakeup the handler thread
+ * Claims a hardware alarm for the timer alarm pool.
+ * Expired timers are handled by the LoRa task, no separate timer task is needed.
  *
  */
 void TimerConfig(void)
 {
-	for (int idx = 0; idx < 10; idx++)
+	if (timerPool == NULL)
 	{
-		timer[idx].in_use = false;
+		int hwAlarm = hardware_alarm_claim_unused(false);
+		if (hwAlarm < 0)
+		{
+			LOG_LIB("TIM", "FATAL ERROR, NO HARDWARE TIMER AVAILABLE");
+			return;
+		}
+		timerPool = alarm_pool_create(hwAlarm, RP2040_MAX_TIMERS);
+		LOG_LIB("TIM", "Alarm pool on hardware alarm %d", hwAlarm);
 	}
 
-	// LOG_LIB("TIM", "threads start");
-	thread_handle_timers.start(handle_timer_events);
-	thread_handle_timers.set_priority(osPriorityAboveNormal);
+	for (int idx = 0; idx < RP2040_MAX_TIMERS; idx++)
+	{
+		if (timer[idx].in_use)
+		{
+			cancelAlarm(idx);
+		}
+		timer[idx].in_use = false;
+		timer[idx].obj = NULL;
+	}
 }
 
 /**
  * @brief Initialize a new timer
- * Checks for available timer slot (limited to 10)
+ * Checks for available timer slot (limited to RP2040_MAX_TIMERS)
  *
  * @param obj structure with timer settings
  * @param callback callback that the timer should call
  */
 void TimerInit(TimerEvent_t *obj, void (*callback)(void))
 {
-	// Look for an available Ticker
-	for (int idx = 0; idx < 10; idx++)
+	obj->Callback = callback;
+
+	// Look for the slot of a timer initialized before or a free slot
+	int freeSlot = -1;
+	for (int idx = 0; idx < RP2040_MAX_TIMERS; idx++)
 	{
-		if (timer[idx].in_use == false)
+		if (timer[idx].in_use && (timer[idx].obj == obj))
 		{
-			timer[idx].signal = 1 << idx; // + 1;
-			timer[idx].in_use = true;
-			timer[idx].active = false;
-			timer[idx].callback = callback;
-			timer[idx].duration = obj->ReloadValue * 1000;
+			cancelAlarm(idx);
 			obj->timerNum = idx;
-			obj->Callback = callback;
-			LOG_LIB("TIM", "Timer %d assigned", idx);
 			return;
 		}
+		if (!timer[idx].in_use && (freeSlot == -1))
+		{
+			freeSlot = idx;
+		}
+	}
+	if (freeSlot == -1)
+	{
+		LOG_LIB("TIM", "No more timers available!");
+		return;
 	}
-	LOG_LIB("TIM", "No more timers available!");
+	timer[freeSlot].in_use = true;
+	timer[freeSlot].alarm = 0;
+	timer[freeSlot].obj = obj;
+	obj->timerNum = freeSlot;
+	LOG_LIB("TIM", "Timer %d assigned", freeSlot);
 }
 
 /**
@@ -244,11 +249,30 @@ void TimerInit(TimerEvent_t *obj, void (*callback)(void))
 void TimerStart(TimerEvent_t *obj)
 {
 	int idx = obj->timerNum;
+	uint32_t value = obj->ReloadValue;
 
-	// t_attach(idx);
-	timerTickers[idx].attach(cb_callback[idx], (microseconds)timer[idx].duration);
+	cancelAlarm(idx);
+	if (TimerCoalesce(obj, &value))
+	{
+		armAlarm(idx, value);
+	}
 
-	// LOG_LIB("TIM", "Timer %d started with %d ms", idx, timer[idx].duration);
+	// LOG_LIB("TIM", "Timer %d started with %d ms", idx, obj->ReloadValue);
+}
+
+/**
+ * @brief Arm the alarm of a timer that takes over the expiry of a coalesced group
+ * CAUTION requires the timer was initialized before
+ *
+ * @param obj structure with timer settings
+ * @param value duration time in milliseconds
+ */
+void TimerArm(TimerEvent_t *obj, uint32_t value)
+{
+	int idx = obj->timerNum;
+
+	cancelAlarm(idx);
+	armAlarm(idx, value);
 }
 
 /**
@@ -261,7 +285,8 @@ void TimerStop(TimerEvent_t *obj)
 {
 	int idx = obj->timerNum;
 
-	timerTickers[idx].detach();
+	cancelAlarm(idx);
+	TimerRemove(obj);
 
 	// LOG_LIB("TIM", "Timer %d stopped", idx);
 }
@@ -274,12 +299,7 @@ void TimerStop(TimerEvent_t *obj)
  */
 void TimerReset(TimerEvent_t *obj)
 {
-	int idx = obj->timerNum;
-
-	timerTickers[idx].detach();
-	timerTickers[idx].attach(cb_callback[idx], (microseconds)timer[idx].duration);
-
-	// LOG_LIB("TIM", "Timer %d reset with %d ms", idx, timerTimes[idx]);
+	TimerStart(obj);
 }
 
 /**
@@ -291,10 +311,36 @@ void TimerReset(TimerEvent_t *obj)
  */
 void TimerSetValue(TimerEvent_t *obj, uint32_t value)
 {
-	int idx = obj->timerNum;
-	timer[idx].duration = value * 1000;
+	obj->ReloadValue = value;
+
+	// LOG_LIB("TIM", "Timer %d setup to %d ms", obj->timerNum, value);
+}
 
-	// LOG_LIB("TIM", "Timer %d setup to %d ms", idx, value);
+/**
+ * @brief Call the callbacks of the expired timers
+ * Called by the LoRa task after it was woken up
+ *
+ */
+void TimerHandleEvents(void)
+{
+	uint32_t irqState = save_and_disable_interrupts();
+	uint32_t pending = timerPending;
+	timerPending = 0;
+	restore_interrupts(irqState);
+
+	for (int idx = 0; (idx < RP2040_MAX_TIMERS) && (pending != 0); idx++)
+	{
+		if ((pending & (1UL << idx)) == 0)
+		{
+			continue;
+		}
+		pending &= ~(1UL << idx);
+		TimerEvent_t *obj = timer[idx].obj;
+		if (obj != NULL)
+		{
+			TimerDispatch(obj);
+		}
+	}
 }
 
 /**
@@ -321,4 +367,4 @@ TimerTime_t TimerGetElapsedTime(TimerTime_t past)
 
 	return diff;
 }
-#endif // ARDUINO_ARCH_RP2040
+#endif // ARDUINO_ARCH_RP2040 || ARDUINO_RAKWIRELESS_RAK11300
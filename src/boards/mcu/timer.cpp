@@ -0,0 +1,271 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+	(C)2013 Semtech
+
+Description: Timer coalescing shared by the MCU timer backends
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+
+Maintainer: Miguel Luis and Gregory Cristian
+*/
+#include "boards/mcu/timer.h"
+#include "boards/mcu/board.h"
+#if defined ARDUINO_ARCH_RP2040 || defined ARDUINO_RAKWIRELESS_RAK11300
+#include <hardware/sync.h>
+#endif
+
+/**
+ * Short critical section for the coalescing state.
+ * BoardDisableIrq() is not used here, it is held around SPI waits by the radio driver.
+ * On nRF52 the FreeRTOS critical section leaves the SoftDevice interrupts enabled,
+ * all callers run in tasks. ESP8266 timers run in the SDK task and need no lock.
+ */
+#if defined NRF52_SERIES
+#define TIMER_LOCK_DECLARE
+#define TIMER_LOCK() taskENTER_CRITICAL()
+#define TIMER_UNLOCK() taskEXIT_CRITICAL()
+#elif defined ESP32
+static portMUX_TYPE timerMux = portMUX_INITIALIZER_UNLOCKED;
+#define TIMER_LOCK_DECLARE
+#define TIMER_LOCK() portENTER_CRITICAL(&timerMux)
+#define TIMER_UNLOCK() portEXIT_CRITICAL(&timerMux)
+#elif defined ARDUINO_ARCH_RP2040 || defined ARDUINO_RAKWIRELESS_RAK11300
+#define TIMER_LOCK_DECLARE uint32_t irqState
+#define TIMER_LOCK() irqState = save_and_disable_interrupts()
+#define TIMER_UNLOCK() restore_interrupts(irqState)
+#else
+#define TIMER_LOCK_DECLARE
+#define TIMER_LOCK()
+#define TIMER_UNLOCK()
+#endif
+
+/** Running timers, the armed ones and the ones sharing their expiry
+ * Accessed from the timer callbacks and the LoRa task, only inside TIMER_LOCK/TIMER_UNLOCK */
+static TimerEvent_t *runningTimers[TIMER_MAX_COALESCE];
+
+/** Wake-up statistics */
+static volatile TimerStats_t timerStats = {0, 0, 0};
+
+/**
+ * @brief Check if a registered timer is still waiting for its expiry
+ *
+ * @param obj timer to check
+ * @param now current time in ms
+ * @return true if the timer expires in the future
+ */
+static bool isPending(TimerEvent_t *obj, uint32_t now)
+{
+	return (obj != NULL) && obj->IsRunning && ((int32_t)(obj->Timestamp - now) > 0);
+}
+
+/**
+ * @brief Take a timer out of the registry
+ * If other timers share its expiry, the first of them becomes the timer
+ * that is armed for the group. Must be called inside TIMER_LOCK.
+ *
+ * @param obj timer to remove
+ * @return TimerEvent_t* timer that must be armed now, NULL if none
+ */
+static TimerEvent_t *detachTimer(TimerEvent_t *obj)
+{
+	TimerEvent_t *newLeader = NULL;
+
+	for (int idx = 0; idx < TIMER_MAX_COALESCE; idx++)
+	{
+		TimerEvent_t *other = runningTimers[idx];
+		if (other == obj)
+		{
+			runningTimers[idx] = NULL;
+		}
+		else if ((other != NULL) && (other->Leader == obj) && (obj->Leader == NULL))
+		{
+			if (newLeader == NULL)
+			{
+				newLeader = other;
+				other->Leader = NULL;
+			}
+			else
+			{
+				other->Leader = newLeader;
+			}
+		}
+	}
+	obj->Leader = NULL;
+	obj->IsRunning = false;
+	return newLeader;
+}
+
+/**
+ * @brief Arm the timer that took over a group after its armed timer was stopped or restarted
+ *
+ * @param obj timer to arm, can be NULL
+ */
+static void armNewLeader(TimerEvent_t *obj)
+{
+	if (obj == NULL)
+	{
+		return;
+	}
+	int32_t left = (int32_t)(obj->Timestamp - millis());
+	TimerArm(obj, left > 0 ? (uint32_t)left : 0);
+}
+
+void TimerSetSlack(TimerEvent_t *obj, uint32_t slack)
+{
+	obj->Slack = slack;
+}
+
+void TimerGetStats(TimerStats_t *stats)
+{
+	TIMER_LOCK_DECLARE;
+	TIMER_LOCK();
+	stats->Expirations = timerStats.Expirations;
+	stats->WakeUps = timerStats.WakeUps;
+	stats->Coalesced = timerStats.Coalesced;
+	TIMER_UNLOCK();
+}
+
+void TimerResetStats(void)
+{
+	TIMER_LOCK_DECLARE;
+	TIMER_LOCK();
+	timerStats.Expirations = 0;
+	timerStats.WakeUps = 0;
+	timerStats.Coalesced = 0;
+	TIMER_UNLOCK();
+}
+
+bool TimerCoalesce(TimerEvent_t *obj, uint32_t *value)
+{
+	TIMER_LOCK_DECLARE;
+	TIMER_LOCK();
+	uint32_t now = millis();
+	uint32_t requested = now + *value;
+	TimerEvent_t *leader = NULL;
+	int freeSlot = -1;
+
+	TimerEvent_t *newLeader = detachTimer(obj);
+
+	if ((obj->Slack != 0) && obj->oneShot)
+	{
+		// Find the armed timer expiring first within [requested, requested + slack], never earlier
+		for (int idx = 0; idx < TIMER_MAX_COALESCE; idx++)
+		{
+			TimerEvent_t *other = runningTimers[idx];
+			if (!isPending(other, now) || (other->Leader != NULL))
+			{
+				continue;
+			}
+			uint32_t delay = other->Timestamp - requested;
+			if (((int32_t)delay >= 0) && (delay <= obj->Slack) &&
+				((leader == NULL) || ((int32_t)(other->Timestamp - leader->Timestamp) < 0)))
+			{
+				leader = other;
+			}
+		}
+	}
+
+	obj->Timestamp = (leader != NULL) ? leader->Timestamp : requested;
+	obj->Leader = leader;
+	obj->IsRunning = true;
+
+	for (int idx = 0; idx < TIMER_MAX_COALESCE; idx++)
+	{
+		if ((runningTimers[idx] == NULL) || !runningTimers[idx]->IsRunning)
+		{
+			freeSlot = idx;
+			break;
+		}
+	}
+	if (freeSlot != -1)
+	{
+		runningTimers[freeSlot] = obj;
+	}
+	else
+	{
+		// Without a slot the timer cannot be found by its group, it is armed alone
+		obj->Timestamp = requested;
+		obj->Leader = NULL;
+		leader = NULL;
+	}
+	if (leader != NULL)
+	{
+		timerStats.Coalesced++;
+	}
+	TIMER_UNLOCK();
+
+	armNewLeader(newLeader);
+
+	*value = obj->Timestamp - now;
+	return leader == NULL;
+}
+
+void TimerRemove(TimerEvent_t *obj)
+{
+	TIMER_LOCK_DECLARE;
+	TIMER_LOCK();
+	TimerEvent_t *newLeader = detachTimer(obj);
+	TIMER_UNLOCK();
+
+	armNewLeader(newLeader);
+}
+
+void TimerDispatch(TimerEvent_t *obj)
+{
+	TimerEvent_t *due[TIMER_MAX_COALESCE];
+	int dueCount = 0;
+	uint32_t now = millis();
+
+	trace_add(TRACE_TIMER, obj->timerNum, 0);
+
+	TIMER_LOCK_DECLARE;
+	TIMER_LOCK();
+	uint32_t expiry = obj->Timestamp;
+	// Take the timers sharing this expiry, they were not armed themselves
+	for (int idx = 0; idx < TIMER_MAX_COALESCE; idx++)
+	{
+		TimerEvent_t *other = runningTimers[idx];
+		if ((other != NULL) && (other != obj) && (other->Leader == obj))
+		{
+			other->Leader = NULL;
+			due[dueCount++] = other;
+		}
+	}
+	if (obj->oneShot)
+	{
+		detachTimer(obj);
+	}
+	else
+	{
+		obj->Timestamp = now + obj->ReloadValue;
+	}
+	timerStats.WakeUps++;
+	timerStats.Expirations++;
+	TIMER_UNLOCK();
+
+	obj->Callback();
+
+	for (int idx = 0; idx < dueCount; idx++)
+	{
+		TimerEvent_t *other = due[idx];
+		TIMER_LOCK();
+		// Skip a timer stopped or restarted by an earlier callback
+		bool expired = other->IsRunning && (other->Leader == NULL) && (other->Timestamp == expiry);
+		if (expired)
+		{
+			detachTimer(other);
+			timerStats.Expirations++;
+		}
+		TIMER_UNLOCK();
+
+		if (expired)
+		{
+			trace_add(TRACE_TIMER, other->timerNum, 0);
+			other->Callback();
+		}
+	}
+}
@@ -39,6 +39,7 @@ Maintainer: Miguel Luis and Gregory Cristian
 
 #include "stdint.h"
 #include "stdbool.h"
+#include "stddef.h"
 #if defined(ESP32) || defined(ESP8266)
 #include <Ticker.h>
 #endif
@@ -56,7 +57,9 @@ typedef struct TimerEvent_s
 	bool oneShot = true;		  /**< True if it is a one shot timer */
 	uint32_t Timestamp;			  /**< Current timer value */
 	uint32_t ReloadValue = 10000; /**< Timer delay value	*/
+	uint32_t Slack = 0;			  /**< Allowed delay of the expiry in ms, 0 for exact timers */
 	bool IsRunning;				  /**< Is the timer currently running	*/
+	struct TimerEvent_s *Leader = NULL; /**< Armed timer whose expiry this timer shares, NULL if armed itself */
 	void (*Callback)(void);		  /**< Timer IRQ callback function	*/
 	struct TimerEvent_s *Next;	  /**< Pointer to the next Timer object.	*/
 } TimerEvent_t;
@@ -67,6 +70,19 @@ typedef struct TimerEvent_s
 typedef uint32_t TimerTime_t;
 #endif
 
+/**@brief Timer wake-up statistics
+ */
+typedef struct TimerStats_s
+{
+	uint32_t Expirations; /**< Number of expired timers, the wake-ups without coalescing */
+	uint32_t WakeUps;	  /**< Number of expired backend timers, the wake-ups with coalescing */
+	uint32_t Coalesced;	  /**< Number of timer starts that joined the expiry of another timer */
+} TimerStats_t;
+
+/**@brief Maximum number of running timers considered for coalescing
+ */
+#define TIMER_MAX_COALESCE 16
+
 /**@brief Initializes the RTC2 timer
  *
  * @details Set prescaler to 31 in order to have Fs=1kHz
@@ -125,6 +141,74 @@ TimerTime_t TimerGetElapsedTime(TimerTime_t savedTime);
  */
 TimerTime_t TimerGetCurrentTime(void);
 
+/**@brief Set the allowed deviation of the timer expiry
+ *
+ * @details A timer with slack may fire up to slack ms late to share the
+ *          wake-up of another running timer. It never fires early. Timers
+ *          that need an exact expiry, like the RX windows, keep a slack of 0.
+ *
+ * @param  obj   Structure containing the timer object parameters
+ *
+ * @param  slack Allowed delay in ms
+ */
+void TimerSetSlack(TimerEvent_t *obj, uint32_t slack);
+
+/**@brief Get the timer wake-up statistics
+ *
+ * @param  stats Structure to fill with the statistics
+ */
+void TimerGetStats(TimerStats_t *stats);
+
+/**@brief Reset the timer wake-up statistics
+ */
+void TimerResetStats(void);
+
+/**@brief Register a started timer, used by the timer backends
+ *
+ * @details A timer with slack joins an armed timer that expires within the
+ *          slack after the requested expiry. It then shares the expiry of
+ *          that timer and is not armed in the backend.
+ *
+ * @param  obj   Structure containing the timer object parameters
+ *
+ * @param  value Requested timer delay in ms, returns the delay to arm the timer with
+ *
+ * @retval true if the backend must arm the timer, false if it shares the expiry of another timer
+ */
+bool TimerCoalesce(TimerEvent_t *obj, uint32_t *value);
+
+/**@brief Unregister a stopped timer, used by the timer backends
+ *
+ * @param  obj Structure containing the timer object parameters
+ */
+void TimerRemove(TimerEvent_t *obj);
+
+/**@brief Handle an expired backend timer, used by the timer backends
+ *
+ * @details Calls the callback of the timer and of the timers sharing its expiry.
+ *
+ * @param  obj Structure containing the timer object parameters
+ */
+void TimerDispatch(TimerEvent_t *obj);
+
+/**@brief Arm the backend timer of a timer, implemented by the timer backends
+ *
+ * @details Used when a timer takes over the expiry of a group whose armed timer
+ *          was stopped or restarted.
+ *
+ * @param  obj   Structure containing the timer object parameters
+ *
+ * @param  value Delay in ms
+ */
+void TimerArm(TimerEvent_t *obj, uint32_t value);
+
+#if defined ARDUINO_ARCH_RP2040 || defined ARDUINO_RAKWIRELESS_RAK11300
+/**@brief Call the callbacks of the expired timers
+ *
+ * @details Used on RP2040, where the timer alarms only flag the expired
+ *          timers and wake up the LoRa task, which then calls this function.
+ */
 void TimerHandleEvents(void);
+#endif
 
 #endif // __TIMER_H__
@@ -0,0 +1,252 @@
+/**
+ * @file trace.cpp
+ * @brief Trace ring of radio IRQs, timer expirations and SPI commands with replay, see sx126x-trace.h
+ */
+#include "boards/mcu/board.h"
+
+#if LIB_TRACE > 0
+
+/** DIO1 interrupt handler of the radio */
+void RadioOnDioIrq(void);
+
+static trace_entry_t traceRing[LIB_TRACE_SIZE];
+static volatile uint16_t traceHead = 0;
+static volatile uint16_t traceCount = 0;
+static volatile bool traceEnabled = true;
+
+/** Trace of the running replay */
+static const trace_entry_t *replayEntries = NULL;
+static uint16_t replayCount = 0;
+static uint16_t replayIndex = 0;
+static uint16_t replayScale = 100;
+static volatile bool replayPending = false;
+static volatile uint16_t replayStatus = 0;
+static volatile uint8_t replayRxSize = 0;
+/** The IRQ status in process is replayed */
+static bool replayCurrent = false;
+static TimerEvent_t replayTimer;
+static bool replayTimerInit = false;
+
+static const char *const traceTypes[] = {"DIO", "IRQ", "TIM", "SPI", "RX"};
+
+#if defined ESP32
+void IRAM_ATTR trace_add(trace_type_t type, uint8_t arg, uint16_t value)
+#else
+void trace_add(trace_type_t type, uint8_t arg, uint16_t value)
+#endif
+{
+	if (!traceEnabled)
+	{
+		return;
+	}
+	uint32_t time = micros();
+	BoardDisableIrq();
+	trace_entry_t *entry = &traceRing[traceHead];
+	entry->time = time;
+	entry->type = type;
+	entry->arg = arg;
+	entry->value = value;
+	traceHead = (traceHead + 1) % LIB_TRACE_SIZE;
+	if (traceCount < LIB_TRACE_SIZE)
+	{
+		traceCount++;
+	}
+	BoardEnableIrq();
+}
+
+uint16_t trace_irq_status(uint16_t status)
+{
+	replayCurrent = (replayEntries != NULL);
+	if (replayEntries != NULL)
+	{
+		// The radio does not drive the MAC during a replay
+		status = 0;
+		BoardDisableIrq();
+		if (replayPending)
+		{
+			status = replayStatus;
+			replayPending = false;
+		}
+		BoardEnableIrq();
+		if ((replayIndex >= replayCount) && !replayPending)
+		{
+			replayEntries = NULL;
+		}
+	}
+	trace_add(TRACE_IRQ, 0, status);
+	return status;
+}
+
+bool trace_rx_replayed(uint8_t *size)
+{
+	if (!replayCurrent)
+	{
+		return false;
+	}
+	*size = replayRxSize;
+	trace_add(TRACE_RX, 0, *size);
+	return true;
+}
+
+void trace_enable(bool enable)
+{
+	traceEnabled = enable;
+}
+
+void trace_clear(void)
+{
+	BoardDisableIrq();
+	traceHead = 0;
+	traceCount = 0;
+	BoardEnableIrq();
+}
+
+uint16_t trace_get(trace_entry_t *entries, uint16_t max)
+{
+	BoardDisableIrq();
+	uint16_t count = traceCount < max ? traceCount : max;
+	// Oldest first, skip the entries that do not fit
+	uint16_t start = (traceHead + LIB_TRACE_SIZE - traceCount + (traceCount - count)) % LIB_TRACE_SIZE;
+	for (uint16_t idx = 0; idx < count; idx++)
+	{
+		entries[idx] = traceRing[(start + idx) % LIB_TRACE_SIZE];
+	}
+	BoardEnableIrq();
+	return count;
+}
+
+void trace_dump(void)
+{
+	trace_entry_t entry;
+	bool enabled = traceEnabled;
+
+	// Stop the recording, the output must not change the ring
+	traceEnabled = false;
+	uint16_t start = (traceHead + LIB_TRACE_SIZE - traceCount) % LIB_TRACE_SIZE;
+	Serial.printf("# trace %u entries\n", traceCount);
+	for (uint16_t idx = 0; idx < traceCount; idx++)
+	{
+		entry = traceRing[(start + idx) % LIB_TRACE_SIZE];
+		Serial.printf("%lu %s %02X %04X\n", (unsigned long)entry.time,
+					  entry.type < sizeof(traceTypes) / sizeof(traceTypes[0]) ? traceTypes[entry.type] : "???",
+					  entry.arg, entry.value);
+	}
+	traceEnabled = enabled;
+}
+
+bool trace_parse(const char *line, trace_entry_t *entry)
+{
+	unsigned long time;
+	char type[4];
+	unsigned int arg;
+	unsigned int value;
+
+	if (sscanf(line, "%lu %3s %x %x", &time, type, &arg, &value) != 4)
+	{
+		return false;
+	}
+	for (uint8_t idx = 0; idx < sizeof(traceTypes) / sizeof(traceTypes[0]); idx++)
+	{
+		if (strcmp(type, traceTypes[idx]) == 0)
+		{
+			entry->time = time;
+			entry->type = idx;
+			entry->arg = arg;
+			entry->value = value;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Find the next IRQ status of the replay
+ *
+ * @param from index to start the search
+ * @return index of the entry, replayCount if there is none
+ */
+static uint16_t nextReplayIrq(uint16_t from)
+{
+	while ((from < replayCount) && ((replayEntries[from].type != TRACE_IRQ) || (replayEntries[from].value == 0)))
+	{
+		from++;
+	}
+	return from;
+}
+
+/**
+ * @brief Start the timer of the next replayed IRQ
+ *
+ * @param last index of the last replayed IRQ
+ */
+static void scheduleReplay(uint16_t last)
+{
+	replayIndex = nextReplayIrq(last + 1);
+	if (replayIndex >= replayCount)
+	{
+		return;
+	}
+	uint32_t delay = replayEntries[replayIndex].time - replayEntries[last].time;
+	delay = (uint32_t)(((uint64_t)delay * replayScale) / 100000);
+	TimerSetValue(&replayTimer, delay > 0 ? delay : 1);
+	TimerStart(&replayTimer);
+}
+
+/**
+ * @brief Hand the IRQ status of the replay to the radio
+ */
+static void onReplayTimer(void)
+{
+	uint16_t current = replayIndex;
+
+	// Payload length of a packet of the IRQ, recorded after its IRQ status
+	uint8_t rxSize = 0;
+	for (uint16_t idx = current + 1; (idx < replayCount) && (replayEntries[idx].type != TRACE_IRQ); idx++)
+	{
+		if (replayEntries[idx].type == TRACE_RX)
+		{
+			rxSize = replayEntries[idx].value;
+			break;
+		}
+	}
+
+	BoardDisableIrq();
+	replayStatus = replayEntries[current].value;
+	replayRxSize = rxSize;
+	replayPending = true;
+	BoardEnableIrq();
+	scheduleReplay(current);
+	RadioOnDioIrq();
+}
+
+bool trace_replay(const trace_entry_t *entries, uint16_t count, uint16_t scale)
+{
+	if (replayEntries != NULL)
+	{
+		return false;
+	}
+	replayEntries = entries;
+	replayCount = count;
+	replayScale = scale;
+	replayIndex = nextReplayIrq(0);
+	if (replayIndex >= replayCount)
+	{
+		replayEntries = NULL;
+		return false;
+	}
+	if (!replayTimerInit)
+	{
+		TimerInit(&replayTimer, onReplayTimer);
+		replayTimerInit = true;
+	}
+	// The first IRQ follows at once, the others at their recorded distance
+	onReplayTimer();
+	return true;
+}
+
+bool trace_replaying(void)
+{
+	return replayEntries != NULL;
+}
+
+#endif
@@ -173,6 +173,7 @@ void SX126xWakeup(void)
 void SX126xWriteCommand(RadioCommands_t command, uint8_t *buffer, uint16_t size)
 {
 	SX126xCheckDeviceReady();
+	trace_add(TRACE_SPI, command, size);
 
 	digitalWrite(_hwConfig.PIN_LORA_NSS, LOW);
 
@@ -196,6 +197,7 @@ void SX126xWriteCommand(RadioCommands_t command, uint8_t *buffer, uint16_t size)
 void SX126xReadCommand(RadioCommands_t command, uint8_t *buffer, uint16_t size)
 {
 	SX126xCheckDeviceReady();
+	trace_add(TRACE_SPI, command, size);
 
 	digitalWrite(_hwConfig.PIN_LORA_NSS, LOW);
 
@@ -216,6 +218,7 @@ void SX126xReadCommand(RadioCommands_t command, uint8_t *buffer, uint16_t size)
 void SX126xWriteRegisters(uint16_t address, uint8_t *buffer, uint16_t size)
 {
 	SX126xCheckDeviceReady();
+	trace_add(TRACE_SPI, RADIO_WRITE_REGISTER, address);
 
 	digitalWrite(_hwConfig.PIN_LORA_NSS, LOW);
 
@@ -243,6 +246,7 @@ void SX126xWriteRegister(uint16_t address, uint8_t value)
 void SX126xReadRegisters(uint16_t address, uint8_t *buffer, uint16_t size)
 {
 	SX126xCheckDeviceReady();
+	trace_add(TRACE_SPI, RADIO_READ_REGISTER, address);
 
 	digitalWrite(_hwConfig.PIN_LORA_NSS, LOW);
 
@@ -271,6 +275,7 @@ uint8_t SX126xReadRegister(uint16_t address)
 void SX126xWriteBuffer(uint8_t offset, uint8_t *buffer, uint8_t size)
 {
 	SX126xCheckDeviceReady();
+	trace_add(TRACE_SPI, RADIO_WRITE_BUFFER, size);
 
 	digitalWrite(_hwConfig.PIN_LORA_NSS, LOW);
 
@@ -290,6 +295,7 @@ void SX126xWriteBuffer(uint8_t offset, uint8_t *buffer, uint8_t size)
 void SX126xReadBuffer(uint8_t offset, uint8_t *buffer, uint8_t size)
 {
 	SX126xCheckDeviceReady();
+	trace_add(TRACE_SPI, RADIO_READ_BUFFER, size);
 
 	digitalWrite(_hwConfig.PIN_LORA_NSS, LOW);
 
@@ -228,6 +228,27 @@ static uint8_t MacCommandsBuffer[LORA_MAC_COMMAND_MAX_LENGTH];
  */
 static uint8_t MacCommandsBufferToRepeat[LORA_MAC_COMMAND_MAX_LENGTH];
 
+/*!
+ * Contains the current MacCommandsBufferHeld index
+ */
+static uint8_t MacCommandsBufferHeldIndex = 0;
+
+/*!
+ * Buffer containing the MAC layer commands which did not fit into the last
+ * uplink and wait for the next one
+ */
+static uint8_t MacCommandsBufferHeld[LORA_MAC_COMMAND_MAX_LENGTH];
+
+/*!
+ * Number of uplinks the MAC commands in MacCommandsBufferHeld were held back for
+ */
+static uint8_t MacCommandsHeldUplinks = 0;
+
+/*!
+ * Time the first MAC command in MacCommandsBufferHeld was held back
+ */
+static TimerTime_t MacCommandsHeldTime = 0;
+
 /*!
  * LoRaMac parameters
  */
@@ -304,9 +325,74 @@ enum eLoRaMacState
 uint32_t LoRaMacState = LORAMAC_IDLE;
 
 /*!
- * LoRaMac timer used to check the LoRaMacState (runs every second)
+ * LoRaMac events driving the MAC state machine
+ */
+typedef enum eLoRaMacEvent
+{
+	MAC_EVENT_TX_DONE = 0,
+	MAC_EVENT_TX_TIMEOUT,
+	MAC_EVENT_RX_DONE,
+	MAC_EVENT_RX_ERROR,
+	MAC_EVENT_RX_TIMEOUT,
+	MAC_EVENT_ACK_TIMEOUT,
+	MAC_EVENT_DELAYED_TX,
+	MAC_EVENT_MAX,
+} LoRaMacEvent_t;
+
+/*!
+ * States of the MAC state machine. They are derived from the LoRaMacState
+ * flags, see GetMacMachineState
  */
-static TimerEvent_t MacStateCheckTimer;
+typedef enum eLoRaMacMachineState
+{
+	/*!
+	 * No uplink in progress. Class B and Class C receptions only
+	 */
+	MAC_MACHINE_IDLE = 0,
+	/*!
+	 * Uplink on air or its reception windows open, LORAMAC_TX_RUNNING
+	 */
+	MAC_MACHINE_TX,
+	/*!
+	 * Uplink waiting for the duty cycle, LORAMAC_TX_DELAYED
+	 */
+	MAC_MACHINE_TX_DELAYED,
+	MAC_MACHINE_MAX,
+} LoRaMacMachineState_t;
+
+/*!
+ * LoRaMac state machine transition
+ */
+typedef struct sLoRaMacTransition
+{
+	/*!
+	 * Action executed on the event, NULL if the event is ignored in this state
+	 */
+	void (*Action)(void);
+	/*!
+	 * Condition of the transition, NULL if it is always taken. The event is
+	 * ignored if the condition is false
+	 */
+	bool (*Guard)(void);
+	/*!
+	 * Evaluate the MAC state after the action. Confirmations and
+	 * indications are delivered from the evaluation
+	 */
+	bool Evaluate;
+} LoRaMacTransition_t;
+
+/*!
+ * Parameters of the last radio Rx done event
+ */
+typedef struct sRadioRxDoneParams
+{
+	uint8_t *Payload;
+	uint16_t Size;
+	int16_t Rssi;
+	int8_t Snr;
+} RadioRxDoneParams_t;
+
+static RadioRxDoneParams_t RadioRxDoneParams;
 
 /*!
  * LoRaMac upper layer event functions
@@ -415,6 +501,29 @@ static uint8_t RxSlot = 0;
 LoRaMacFlags_t LoRaMacFlags;
 
 static lorawanTXParams_t *_txParams;
+
+#if (LORAMAC_REGION_CONTEXTS > 0)
+/*!
+ * Saved region contexts
+ */
+static LoRaMacRegionContext_t RegionContexts[LORAMAC_REGION_CONTEXTS];
+
+/*!
+ * Last use of each region context slot, the least recently used one is reused first
+ */
+static uint32_t RegionContextsLastUse[LORAMAC_REGION_CONTEXTS];
+
+/*!
+ * Counter stamped into RegionContextsLastUse
+ */
+static uint32_t RegionContextsUseCounter = 0;
+#endif
+
+/*!
+ * LoRaMac channels remaining, used by the regions with a fixed channel plan
+ */
+extern uint16_t ChannelsMaskRemaining[6];
+
 /*!
  * \brief Function to be executed on Radio Tx Done event
  */
@@ -422,7 +531,7 @@ static void OnRadioTxDone(void);
 
 /*!
  * \brief This function prepares the MAC to abort the execution of function
- *        OnRadioRxDone in case of a reception error.
+ *        ProcessRadioRxDone in case of a reception error.
  */
 static void PrepareRxDoneAbort(void);
 
@@ -446,11 +555,6 @@ static void OnRadioRxError(void);
  */
 static void OnRadioRxTimeout(void);
 
-/*!
- * \brief Function executed on Resend Frame timer event.
- */
-static void OnMacStateCheckTimerEvent(void);
-
 /*!
  * \brief Function executed on duty cycle delayed Tx  timer event
  */
@@ -471,6 +575,131 @@ static void OnRxWindow2TimerEvent(void);
  */
 static void OnAckTimeoutTimerEvent(void);
 
+/*!
+ * \brief Action of the Tx done event
+ */
+static void ProcessRadioTxDone(void);
+
+/*!
+ * \brief Action of the Rx done event, the frame is taken from RadioRxDoneParams
+ */
+static void ProcessRadioRxDone(void);
+
+/*!
+ * \brief Action of the Tx timeout event
+ */
+static void ProcessRadioTxTimeout(void);
+
+/*!
+ * \brief Action of the Rx error event
+ */
+static void ProcessRadioRxError(void);
+
+/*!
+ * \brief Action of the Rx timeout event
+ */
+static void ProcessRadioRxTimeout(void);
+
+/*!
+ * \brief Action of the AckTimeout event
+ */
+static void ProcessAckTimeout(void);
+
+/*!
+ * \brief Action of the delayed Tx event, (re)schedules the pending frame
+ */
+static void ProcessTxDelayed(void);
+
+/*!
+ * \brief Evaluates LoRaMacFlags and LoRaMacState after an event. Handles
+ *        retransmissions and delivers the confirmations and indications
+ *        once the MAC is idle.
+ */
+static void LoRaMacEvaluateState(void);
+
+/*!
+ * \brief Dispatches an event to the transition of the current state and evaluates the MAC state
+ *
+ * \param  event       Event to process
+ */
+static void LoRaMacProcessEvent(LoRaMacEvent_t event);
+
+/*!
+ * \brief Returns the state machine state of the LoRaMacState flags
+ *
+ * \retval state       Current state
+ */
+static LoRaMacMachineState_t GetMacMachineState(void);
+
+/*!
+ * \brief Function executed on the Tx delayed timer event in the Tx delayed state
+ */
+static void ProcessDelayedTxEvent(void);
+
+/*!
+ * \brief Guard of the events that only Class C handles outside of an uplink
+ *
+ * \retval isClassC    True if the device is in Class C
+ */
+static bool IsClassC(void);
+
+/*!
+ * LoRaMac state machine, indexed by LoRaMacMachineState_t and LoRaMacEvent_t
+ */
+static const LoRaMacTransition_t LoRaMacTransitions[MAC_MACHINE_MAX][MAC_EVENT_MAX] = {
+	// MAC_MACHINE_IDLE, receptions of Class B and Class C only
+	{
+		// MAC_EVENT_TX_DONE, nothing is on air
+		{NULL, NULL, false},
+		// MAC_EVENT_TX_TIMEOUT, nothing is on air
+		{NULL, NULL, false},
+		// MAC_EVENT_RX_DONE
+		{ProcessRadioRxDone, NULL, true},
+		// MAC_EVENT_RX_ERROR
+		{ProcessRadioRxError, NULL, true},
+		// MAC_EVENT_RX_TIMEOUT
+		{ProcessRadioRxTimeout, NULL, true},
+		// MAC_EVENT_ACK_TIMEOUT, completes a Class C uplink answered before the timeout
+		{ProcessAckTimeout, IsClassC, true},
+		// MAC_EVENT_DELAYED_TX, no frame is waiting
+		{NULL, NULL, false},
+	},
+	// MAC_MACHINE_TX
+	{
+		// MAC_EVENT_TX_DONE
+		{ProcessRadioTxDone, NULL, true},
+		// MAC_EVENT_TX_TIMEOUT
+		{ProcessRadioTxTimeout, NULL, true},
+		// MAC_EVENT_RX_DONE
+		{ProcessRadioRxDone, NULL, true},
+		// MAC_EVENT_RX_ERROR
+		{ProcessRadioRxError, NULL, true},
+		// MAC_EVENT_RX_TIMEOUT
+		{ProcessRadioRxTimeout, NULL, true},
+		// MAC_EVENT_ACK_TIMEOUT
+		{ProcessAckTimeout, NULL, true},
+		// MAC_EVENT_DELAYED_TX, no frame is waiting
+		{NULL, NULL, false},
+	},
+	// MAC_MACHINE_TX_DELAYED
+	{
+		// MAC_EVENT_TX_DONE, nothing is on air
+		{NULL, NULL, false},
+		// MAC_EVENT_TX_TIMEOUT, nothing is on air
+		{NULL, NULL, false},
+		// MAC_EVENT_RX_DONE, Class C receives while the frame waits
+		{ProcessRadioRxDone, NULL, true},
+		// MAC_EVENT_RX_ERROR
+		{ProcessRadioRxError, NULL, true},
+		// MAC_EVENT_RX_TIMEOUT
+		{ProcessRadioRxTimeout, NULL, true},
+		// MAC_EVENT_ACK_TIMEOUT, the retransmission waits for MAC_EVENT_DELAYED_TX
+		{ProcessAckTimeout, NULL, true},
+		// MAC_EVENT_DELAYED_TX, the outcome is reported by the Tx done or Tx timeout event
+		{ProcessDelayedTxEvent, NULL, false},
+	},
+};
+
 /*!
  * \brief Initializes and opens the reception window
  *
@@ -490,10 +719,15 @@ static void RxWindowSetup(bool rxContinuous, uint32_t maxRxWindow);
  *                  MOTE_MAC_DUTY_CYCLE_ANS,
  *                  MOTE_MAC_RX2_PARAM_SET_ANS,
  *                  MOTE_MAC_DEV_STATUS_ANS
- *                  MOTE_MAC_NEW_CHANNEL_ANS]
+ *                  MOTE_MAC_NEW_CHANNEL_ANS,
+ *                  MOTE_MAC_DEVICE_TIME_REQ]
  * \param  p1  1st parameter ( optional depends on the command )
  * \param  p2  2nd parameter ( optional depends on the command )
  *
+ * \remark The held commands and the commands to repeat are merged with the
+ *         added ones before the next uplink, a command is only added if all
+ *         of them fit into LORA_MAC_COMMAND_MAX_LENGTH.
+ *
  * \retval status  Function status [0: OK, 1: Unknown command, 2: Buffer full]
  */
 static LoRaMacStatus_t AddMacCommand(uint8_t cmd, uint8_t p1, uint8_t p2);
@@ -512,6 +746,37 @@ static LoRaMacStatus_t AddMacCommand(uint8_t cmd, uint8_t p1, uint8_t p2);
  */
 static uint8_t ParseMacCommandsToRepeat(uint8_t *cmdBufIn, uint8_t length, uint8_t *cmdBufOut);
 
+/*!
+ * \brief Keeps the MAC commands which fit into the given space in the MAC
+ *        command buffer and holds the others back for the next uplink.
+ *        No command is dropped.
+ *
+ * \remark MAC layer internal function
+ *
+ * \param  space  Bytes available for MAC commands in the frame
+ */
+static void HoldMacCommands(uint8_t space);
+
+/*!
+ * \brief Checks if the held MAC commands are due and do not fit next to an
+ *        application payload. The payload is then not sent, the answers have
+ *        to be flushed with a frame without payload first.
+ *
+ * \param  size  Size of the application payload
+ *
+ * \retval blocked True if the payload can not be sent with the current datarate
+ */
+static bool MacCommandsHeldBlockPayload(uint8_t size);
+
+/*!
+ * \brief Gets the maximum MAC payload of a datarate.
+ *
+ * \param datarate Datarate
+ *
+ * \retval Maximum size of the MAC payload, FOpts and FRMPayload
+ */
+static uint8_t GetMaxPayload(int8_t datarate);
+
 /*!
  * \brief Validates if the payload fits into the frame, taking the datarate
  *        into account.
@@ -610,8 +875,126 @@ LoRaMacStatus_t SetTxContinuousWave1(uint16_t timeout, uint32_t frequency, uint8
  */
 static void ResetMacParameters(void);
 
+/*!
+ * \brief Loads the default parameters of the current region
+ */
+static void LoadRegionDefaults(void);
+
+#if (LORAMAC_REGION_CONTEXTS > 0)
+/*!
+ * \brief Saves the session of the current region
+ *
+ * \param  context     Region context to fill
+ */
+static void SaveRegionContext(LoRaMacRegionContext_t *context);
+
+/*!
+ * \brief Restores the session of the current region
+ *
+ * \param  context     Region context to apply
+ */
+static void RestoreRegionContext(LoRaMacRegionContext_t *context);
+
+/*!
+ * \brief Finds the context slot of a region
+ *
+ * \param  region      Region to search for
+ * \param  allocate    If true, returns a free or reusable slot if the region has none
+ * \param  keep        Region whose slot must not be reused for the allocation
+ * \retval context      Pointer to the slot, NULL if not found
+ */
+static LoRaMacRegionContext_t *GetRegionContext(LoRaMacRegion_t region, bool allocate, LoRaMacRegion_t keep);
+
+/*!
+ * \brief Converts the Tx done times of the bands of a context between time stamps and
+ *        the time elapsed since the Tx done. Time stamps are only valid until the next reset
+ *
+ * \param  context     Region context to convert
+ * \param  toElapsed   If true, time stamps are converted to elapsed times, otherwise back
+ */
+static void RebaseRegionContextBands(LoRaMacRegionContext_t *context, bool toElapsed);
+#endif
+
+static LoRaMacMachineState_t GetMacMachineState(void)
+{
+	if ((LoRaMacState & LORAMAC_TX_DELAYED) == LORAMAC_TX_DELAYED)
+	{
+		return MAC_MACHINE_TX_DELAYED;
+	}
+	if ((LoRaMacState & LORAMAC_TX_RUNNING) == LORAMAC_TX_RUNNING)
+	{
+		return MAC_MACHINE_TX;
+	}
+	return MAC_MACHINE_IDLE;
+}
+
+static void LoRaMacProcessEvent(LoRaMacEvent_t event)
+{
+	if (event >= MAC_EVENT_MAX)
+	{
+		return;
+	}
+
+	LoRaMacMachineState_t state = GetMacMachineState();
+	const LoRaMacTransition_t *transition = &LoRaMacTransitions[state][event];
+
+	if ((transition->Action == NULL) || ((transition->Guard != NULL) && (transition->Guard() == false)))
+	{
+		LOG_LIB("LM", "Event %d ignored in state %d", event, state);
+		return;
+	}
+
+	transition->Action();
+
+	if (transition->Evaluate == true)
+	{
+		LoRaMacEvaluateState();
+	}
+}
+
 static void OnRadioTxDone(void)
 {
+	LoRaMacProcessEvent(MAC_EVENT_TX_DONE);
+}
+
+static void OnRadioRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+{
+	RadioRxDoneParams.Payload = payload;
+	RadioRxDoneParams.Size = size;
+	RadioRxDoneParams.Rssi = rssi;
+	RadioRxDoneParams.Snr = snr;
+
+	LoRaMacProcessEvent(MAC_EVENT_RX_DONE);
+}
+
+static void OnRadioTxTimeout(void)
+{
+	LoRaMacProcessEvent(MAC_EVENT_TX_TIMEOUT);
+}
+
+static void OnRadioRxError(void)
+{
+	LoRaMacProcessEvent(MAC_EVENT_RX_ERROR);
+}
+
+static void OnRadioRxTimeout(void)
+{
+	LoRaMacProcessEvent(MAC_EVENT_RX_TIMEOUT);
+}
+
+static void OnTxDelayedTimerEvent(void)
+{
+	LoRaMacProcessEvent(MAC_EVENT_DELAYED_TX);
+}
+
+static void OnAckTimeoutTimerEvent(void)
+{
+	LoRaMacProcessEvent(MAC_EVENT_ACK_TIMEOUT);
+}
+
+static void ProcessRadioTxDone(void)
+{
+	PROFILE_ZONE("mac_tx_done");
 	LOG_LIB("LM", "OnRadioTxDone");
 
 	GetPhyParams_t getPhy;
@@ -689,23 +1072,23 @@ static void PrepareRxDoneAbort(void)
 
 	if (NodeAckRequested)
 	{
-		OnAckTimeoutTimerEvent();
+		ProcessAckTimeout();
 	}
 
 	LoRaMacFlags.Bits.McpsInd = 1;
 	LoRaMacFlags.Bits.MacDone = 1;
-
-	// Trig OnMacCheckTimerEvent call as soon as possible
-	// TimerSetValue(&MacStateCheckTimer, 100);
-	// TimerStart(&MacStateCheckTimer);
-	TimerStop(&MacStateCheckTimer);
-	OnMacStateCheckTimerEvent();
 }
 
-static void OnRadioRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+static void ProcessRadioRxDone(void)
 {
+	PROFILE_ZONE("mac_rx_done");
 	LOG_LIB("LM", "OnRadioRxDone");
 
+	uint8_t *payload = RadioRxDoneParams.Payload;
+	uint16_t size = RadioRxDoneParams.Size;
+	int16_t rssi = RadioRxDoneParams.Rssi;
+	int8_t snr = RadioRxDoneParams.Snr;
+
 	LoRaMacHeader_t macHdr;
 	LoRaMacFrameCtrl_t fCtrl;
 	ApplyCFListParams_t applyCFList;
@@ -997,7 +1380,7 @@ static void OnRadioRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t
 			// This must be done before parsing the payload and the MAC commands.
 			// We need to reset the MacCommandsBufferIndex here, since we need
 			// to take retransmissions and repetitions into account. Error cases
-			// will be handled in function OnMacStateCheckTimerEvent.
+			// will be handled in function LoRaMacEvaluateState.
 			if (McpsConfirm.McpsRequest == MCPS_CONFIRMED)
 			{
 				if (fCtrl.Bits.Ack == 1)
@@ -1132,15 +1515,9 @@ static void OnRadioRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t
 		break;
 	}
 	LoRaMacFlags.Bits.MacDone = 1;
-
-	// Trig OnMacCheckTimerEvent call as soon as possible
-	// TimerSetValue(&MacStateCheckTimer, 100);
-	// TimerStart(&MacStateCheckTimer);
-	TimerStop(&MacStateCheckTimer);
-	OnMacStateCheckTimerEvent();
 }
 
-static void OnRadioTxTimeout(void)
+static void ProcessRadioTxTimeout(void)
 {
 	LOG_LIB("LM", "OnRadioTxTimeout");
 
@@ -1158,7 +1535,7 @@ static void OnRadioTxTimeout(void)
 	LoRaMacFlags.Bits.MacDone = 1;
 }
 
-static void OnRadioRxError(void)
+static void ProcessRadioRxError(void)
 {
 	LOG_LIB("LM", "OnRadioRxError");
 
@@ -1195,7 +1572,7 @@ static void OnRadioRxError(void)
 	}
 }
 
-static void OnRadioRxTimeout(void)
+static void ProcessRadioRxTimeout(void)
 {
 	LOG_LIB("LM", "OnRadioRxTimeout");
 
@@ -1234,19 +1611,15 @@ static void OnRadioRxTimeout(void)
 			LoRaMacFlags.Bits.MacDone = 1;
 		}
 	}
-	TimerSetValue(&MacStateCheckTimer, MAC_STATE_CHECK_TIMEOUT);
-	TimerStart(&MacStateCheckTimer);
 }
 
-static void OnMacStateCheckTimerEvent(void)
+static void LoRaMacEvaluateState(void)
 {
 	GetPhyParams_t getPhy;
 	PhyParam_t phyParam;
 	bool txTimeout = false;
 
-	TimerStop(&MacStateCheckTimer);
-
-	LOG_LIB("LM", "OnMacStateCheckTimerEvent");
+	LOG_LIB("LM", "LoRaMacEvaluateState");
 	if (LoRaMacFlags.Bits.MacDone == 1)
 	{
 		if ((LoRaMacState & LORAMAC_RX_ABORT) == LORAMAC_RX_ABORT)
@@ -1298,7 +1671,7 @@ static void OnMacStateCheckTimerEvent(void)
 							IsLoRaMacNetworkJoined = JOIN_ONGOING;
 							LoRaMacFlags.Bits.MacDone = 0;
 							// Sends the same frame again
-							OnTxDelayedTimerEvent();
+							ProcessTxDelayed();
 						}
 					}
 				}
@@ -1326,7 +1699,7 @@ static void OnMacStateCheckTimerEvent(void)
 					{
 						LoRaMacFlags.Bits.MacDone = 0;
 						// Sends the same frame again
-						OnTxDelayedTimerEvent();
+						ProcessTxDelayed();
 					}
 				}
 			}
@@ -1434,12 +1807,8 @@ static void OnMacStateCheckTimerEvent(void)
 		// Procedure done. Reset variables.
 		LoRaMacFlags.Bits.MacDone = 0;
 	}
-	else
-	{
-		// Operation not finished restart timer
-		TimerSetValue(&MacStateCheckTimer, MAC_STATE_CHECK_TIMEOUT);
-		TimerStart(&MacStateCheckTimer);
-	}
+	// Otherwise the operation is not finished, the next radio or timer
+	// event evaluates the state again
 
 	if (LoRaMacFlags.Bits.McpsInd == 1)
 	{
@@ -1461,7 +1830,29 @@ static void OnMacStateCheckTimerEvent(void)
 	}
 }
 
-static void OnTxDelayedTimerEvent(void)
+static bool IsClassC(void)
+{
+	return LoRaMacDeviceClass == CLASS_C;
+}
+
+static void ProcessDelayedTxEvent(void)
+{
+	// Leaving the Tx delayed state
+	LoRaMacState &= ~LORAMAC_TX_DELAYED;
+
+	if ((AckTimeoutRetry == true) && (LoRaMacFlags.Bits.MacDone == 1))
+	{
+		// The ack timeout retransmission was held back while the frame
+		// waited for the duty cycle, the evaluation sends it now
+		TimerStop(&TxDelayedTimer);
+		LoRaMacEvaluateState();
+		return;
+	}
+
+	ProcessTxDelayed();
+}
+
+static void ProcessTxDelayed(void)
 {
 	LoRaMacHeader_t macHdr;
 	LoRaMacFrameCtrl_t fCtrl;
@@ -1559,7 +1950,7 @@ static void OnRxWindow2TimerEvent(void)
 	}
 }
 
-static void OnAckTimeoutTimerEvent(void)
+static void ProcessAckTimeout(void)
 {
 	TimerStop(&AckTimeoutTimer);
 
@@ -1573,8 +1964,6 @@ static void OnAckTimeoutTimerEvent(void)
 	{
 		LoRaMacFlags.Bits.MacDone = 1;
 	}
-	TimerStop(&MacStateCheckTimer);
-	OnMacStateCheckTimerEvent();
 }
 
 static void RxWindowSetup(bool rxContinuous, uint32_t maxRxWindow)
@@ -1589,12 +1978,10 @@ static void RxWindowSetup(bool rxContinuous, uint32_t maxRxWindow)
 	}
 }
 
-static bool ValidatePayloadLength(uint8_t lenN, int8_t datarate, uint8_t fOptsLen)
+static uint8_t GetMaxPayload(int8_t datarate)
 {
 	GetPhyParams_t getPhy;
 	PhyParam_t phyParam;
-	uint16_t maxN = 0;
-	uint16_t payloadSize = 0;
 
 	// Setup PHY request
 	getPhy.UplinkDwellTime = LoRaMacParams.UplinkDwellTime;
@@ -1607,7 +1994,13 @@ static bool ValidatePayloadLength(uint8_t lenN, int8_t datarate, uint8_t fOptsLe
 		getPhy.Attribute = PHY_MAX_PAYLOAD_REPEATER;
 	}
 	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
-	maxN = phyParam.Value;
+	return phyParam.Value;
+}
+
+static bool ValidatePayloadLength(uint8_t lenN, int8_t datarate, uint8_t fOptsLen)
+{
+	uint16_t maxN = GetMaxPayload(datarate);
+	uint16_t payloadSize = 0;
 
 	// Calculate the resulting payload size
 	payloadSize = (lenN + fOptsLen);
@@ -1624,11 +2017,12 @@ static LoRaMacStatus_t AddMacCommand(uint8_t cmd, uint8_t p1, uint8_t p2)
 {
 	LoRaMacStatus_t status = LORAMAC_STATUS_BUSY;
 	// The maximum buffer length must take MAC commands to re-send into account.
-	uint8_t bufLen = LORA_MAC_COMMAND_MAX_LENGTH - MacCommandsBufferToRepeatIndex;
+	uint8_t bufLen = LORA_MAC_COMMAND_MAX_LENGTH - MacCommandsBufferToRepeatIndex - MacCommandsBufferHeldIndex;
 
 	switch (cmd)
 	{
 	case MOTE_MAC_LINK_CHECK_REQ:
+	case MOTE_MAC_DEVICE_TIME_REQ:
 		if (MacCommandsBufferIndex < bufLen)
 		{
 			MacCommandsBuffer[MacCommandsBufferIndex++] = cmd;
@@ -1699,7 +2093,7 @@ static LoRaMacStatus_t AddMacCommand(uint8_t cmd, uint8_t p1, uint8_t p2)
 		}
 		break;
 	case MOTE_MAC_DL_CHANNEL_ANS:
-		if (MacCommandsBufferIndex < bufLen)
+		if (MacCommandsBufferIndex < (bufLen - 1))
 		{
 			MacCommandsBuffer[MacCommandsBufferIndex++] = cmd;
 			// Status: Uplink frequency exists, Channel frequency OK
@@ -1759,6 +2153,7 @@ static uint8_t ParseMacCommandsToRepeat(uint8_t *cmdBufIn, uint8_t length, uint8
 		case MOTE_MAC_TX_PARAM_SETUP_ANS:
 		case MOTE_MAC_DUTY_CYCLE_ANS:
 		case MOTE_MAC_LINK_CHECK_REQ:
+		case MOTE_MAC_DEVICE_TIME_REQ:
 		{ // 0 byte payload
 			break;
 		}
@@ -1770,6 +2165,86 @@ static uint8_t ParseMacCommandsToRepeat(uint8_t *cmdBufIn, uint8_t length, uint8
 	return cmdCount;
 }
 
+static void HoldMacCommands(uint8_t space)
+{
+	uint8_t kept = 0;
+	uint8_t i = 0;
+
+	while (i < MacCommandsBufferIndex)
+	{
+		uint8_t cmdLen;
+
+		switch (MacCommandsBuffer[i])
+		{
+		case MOTE_MAC_DEV_STATUS_ANS:
+			cmdLen = 3;
+			break;
+		case MOTE_MAC_LINK_ADR_ANS:
+		case MOTE_MAC_RX_PARAM_SETUP_ANS:
+		case MOTE_MAC_NEW_CHANNEL_ANS:
+		case MOTE_MAC_DL_CHANNEL_ANS:
+			cmdLen = 2;
+			break;
+		case MOTE_MAC_LINK_CHECK_REQ:
+		case MOTE_MAC_DUTY_CYCLE_ANS:
+		case MOTE_MAC_RX_TIMING_SETUP_ANS:
+		case MOTE_MAC_TX_PARAM_SETUP_ANS:
+		case MOTE_MAC_DEVICE_TIME_REQ:
+			cmdLen = 1;
+			break;
+		default:
+			// Unknown command, the rest of the buffer can not be split
+			cmdLen = MacCommandsBufferIndex - i;
+			break;
+		}
+		if (cmdLen > MacCommandsBufferIndex - i)
+		{
+			cmdLen = MacCommandsBufferIndex - i;
+		}
+
+		// First fit, a shorter command behind a long one can still go with this frame
+		if ((kept + cmdLen) <= space)
+		{
+			memmove(&MacCommandsBuffer[kept], &MacCommandsBuffer[i], cmdLen);
+			kept += cmdLen;
+		}
+		else
+		{
+			// Always fits, the held commands are a part of MacCommandsBuffer of the same size
+			if ((MacCommandsBufferHeldIndex == 0) && (MacCommandsHeldUplinks == 0))
+			{
+				MacCommandsHeldTime = TimerGetCurrentTime();
+			}
+			memcpy1(&MacCommandsBufferHeld[MacCommandsBufferHeldIndex], &MacCommandsBuffer[i], cmdLen);
+			MacCommandsBufferHeldIndex += cmdLen;
+		}
+		i += cmdLen;
+	}
+	MacCommandsBufferIndex = kept;
+}
+
+static bool MacCommandsHeldBlockPayload(uint8_t size)
+{
+	if ((MacCommandsBufferHeldIndex == 0) || (size == 0))
+	{
+		return false;
+	}
+	// Due with this uplink
+	if (((MacCommandsHeldUplinks + 1) < LORAMAC_MAX_HELD_UPLINKS) &&
+		(TimerGetElapsedTime(MacCommandsHeldTime) < LORAMAC_MAX_HELD_TIME))
+	{
+		return false;
+	}
+
+	uint8_t maxN = GetMaxPayload(LoRaMacParams.ChannelsDatarate);
+	uint8_t space = LORA_MAC_COMMAND_MAX_FOPTS_LENGTH;
+	if ((size + space) > maxN)
+	{
+		space = maxN > size ? maxN - size : 0;
+	}
+	return MacCommandsBufferHeldIndex > space;
+}
+
 static void ProcessMacCommands(uint8_t *payload, uint8_t macIndex, uint8_t commandsSize, uint8_t snr)
 {
 	uint8_t status = 0;
@@ -1942,6 +2417,16 @@ static void ProcessMacCommands(uint8_t *payload, uint8_t macIndex, uint8_t comma
 			AddMacCommand(MOTE_MAC_DL_CHANNEL_ANS, status, 0);
 		}
 		break;
+		case SRV_MAC_DEVICE_TIME_ANS:
+			MlmeConfirm.Status = LORAMAC_EVENT_INFO_STATUS_OK;
+			MlmeConfirm.GpsSeconds = (uint32_t)payload[macIndex++];
+			MlmeConfirm.GpsSeconds |= (uint32_t)payload[macIndex++] << 8;
+			MlmeConfirm.GpsSeconds |= (uint32_t)payload[macIndex++] << 16;
+			MlmeConfirm.GpsSeconds |= (uint32_t)payload[macIndex++] << 24;
+			MlmeConfirm.GpsFraction = payload[macIndex++];
+			// The network time refers to the end of the uplink that carried the request
+			MlmeConfirm.GpsReference = AggregatedLastTxDoneTime;
+			break;
 		default:
 			// Unknown command. ABORT MAC commands processing
 			return;
@@ -2119,6 +2604,8 @@ void ResetMacCounters(void)
 
 	MacCommandsBufferIndex = 0;
 	MacCommandsBufferToRepeatIndex = 0;
+	MacCommandsBufferHeldIndex = 0;
+	MacCommandsHeldUplinks = 0;
 
 	IsRxWindowsEnabled = true;
 
@@ -2169,6 +2656,8 @@ static void ResetMacParameters(void)
 
 	MacCommandsBufferIndex = 0;
 	MacCommandsBufferToRepeatIndex = 0;
+	MacCommandsBufferHeldIndex = 0;
+	MacCommandsHeldUplinks = 0;
 
 	IsRxWindowsEnabled = true;
 
@@ -2203,6 +2692,7 @@ static void ResetMacParameters(void)
 
 LoRaMacStatus_t PrepareFrame(LoRaMacHeader_t *macHdr, LoRaMacFrameCtrl_t *fCtrl, uint8_t fPort, void *fBuffer, uint16_t fBufferSize)
 {
+	PROFILE_ZONE("mac_prepare_frame");
 	AdrNextParams_t adrNext;
 	uint16_t i;
 	uint8_t pktHeaderLen = 0;
@@ -2255,6 +2745,12 @@ LoRaMacStatus_t PrepareFrame(LoRaMacHeader_t *macHdr, LoRaMacFrameCtrl_t *fCtrl,
 			return LORAMAC_STATUS_NO_NETWORK_JOINED; // No network has been joined yet
 		}
 
+		if (MacCommandsHeldBlockPayload(LoRaMacTxPayloadLen) == true)
+		{
+			LOG_LIB("LM", "PrepareFrame -> MAC answers held for %d uplinks, flush them first", MacCommandsHeldUplinks);
+			return LORAMAC_STATUS_LENGTH_ERROR;
+		}
+
 		// Adr next request
 		adrNext.UpdateChanMask = true;
 		adrNext.AdrEnabled = fCtrl->Bits.Adr;
@@ -2282,48 +2778,70 @@ LoRaMacStatus_t PrepareFrame(LoRaMacHeader_t *macHdr, LoRaMacFrameCtrl_t *fCtrl,
 		LoRaMacBuffer[pktHeaderLen++] = UpLinkCounter & 0xFF;
 		LoRaMacBuffer[pktHeaderLen++] = (UpLinkCounter >> 8) & 0xFF;
 
-		// Copy the MAC commands which must be re-send into the MAC command buffer
-		memcpy1(&MacCommandsBuffer[MacCommandsBufferIndex], MacCommandsBufferToRepeat, MacCommandsBufferToRepeatIndex);
-		MacCommandsBufferIndex += MacCommandsBufferToRepeatIndex;
+		// The MAC commands held back by the last uplink go first
+		if (MacCommandsBufferHeldIndex > 0)
+		{
+			memmove(&MacCommandsBuffer[MacCommandsBufferHeldIndex], MacCommandsBuffer, MacCommandsBufferIndex);
+			memcpy1(MacCommandsBuffer, MacCommandsBufferHeld, MacCommandsBufferHeldIndex);
+			MacCommandsBufferIndex += MacCommandsBufferHeldIndex;
+			MacCommandsBufferHeldIndex = 0;
 
-		if ((payload != NULL) && (LoRaMacTxPayloadLen > 0))
+			MacCommandsHeldUplinks++;
+		}
+
+		// Copy the MAC commands which must be re-send into the MAC command buffer
+		memcpy1(&MacCommandsBuffer[MacCommandsBufferIndex], MacCommandsBufferToRepeat, MacCommandsBufferToRepeatIndex);
+		MacCommandsBufferIndex += MacCommandsBufferToRepeatIndex;
+
+		if ((MacCommandsBufferIndex > 0) && (MacCommandsInNextTx == true))
 		{
-			if (MacCommandsInNextTx == true)
+			uint8_t maxN = GetMaxPayload(LoRaMacParams.ChannelsDatarate);
+			uint8_t space = LORA_MAC_COMMAND_MAX_FOPTS_LENGTH;
+			if ((LoRaMacTxPayloadLen + space) > maxN)
 			{
-				if (MacCommandsBufferIndex <= LORA_MAC_COMMAND_MAX_FOPTS_LENGTH)
-				{
-					fCtrl->Bits.FOptsLen += MacCommandsBufferIndex;
+				space = maxN > LoRaMacTxPayloadLen ? maxN - LoRaMacTxPayloadLen : 0;
+			}
 
-					// Update FCtrl field with new value of OptionsLength
-					LoRaMacBuffer[0x05] = fCtrl->Value;
-					for (i = 0; i < MacCommandsBufferIndex; i++)
-					{
-						LoRaMacBuffer[pktHeaderLen++] = MacCommandsBuffer[i];
-					}
-				}
-				else
-				{
-					LoRaMacTxPayloadLen = MacCommandsBufferIndex;
-					payload = MacCommandsBuffer;
-					framePort = 0;
-				}
+			if ((payload != NULL) && (LoRaMacTxPayloadLen > 0))
+			{
+				// The MAC commands go into the FOpts as far as they fit next to the
+				// application payload. The others wait for the next uplink instead
+				// of replacing the application payload or forcing an extra frame.
+				HoldMacCommands(space);
 			}
-		}
-		else
-		{
-			if ((MacCommandsBufferIndex > 0) && (MacCommandsInNextTx == true))
+			else if (MacCommandsBufferIndex > LORA_MAC_COMMAND_MAX_FOPTS_LENGTH)
 			{
+				// Frame without application payload, on port 0 as much as fits
+				HoldMacCommands(maxN);
 				LoRaMacTxPayloadLen = MacCommandsBufferIndex;
 				payload = MacCommandsBuffer;
 				framePort = 0;
 			}
+			else
+			{
+				// Frame without application payload, up to 15 bytes go into the FOpts,
+				// one byte shorter than on port 0 as the FPort is omitted
+				HoldMacCommands(maxN);
+			}
+
+			if ((framePort != 0) && (MacCommandsBufferIndex > 0))
+			{
+				fCtrl->Bits.FOptsLen += MacCommandsBufferIndex;
+
+				// Update FCtrl field with new value of OptionsLength
+				LoRaMacBuffer[0x05] = fCtrl->Value;
+				for (i = 0; i < MacCommandsBufferIndex; i++)
+				{
+					LoRaMacBuffer[pktHeaderLen++] = MacCommandsBuffer[i];
+				}
+			}
 		}
-		MacCommandsInNextTx = false;
 		// Store MAC commands which must be re-send in case the device does not receive a downlink anymore
 		MacCommandsBufferToRepeatIndex = ParseMacCommandsToRepeat(MacCommandsBuffer, MacCommandsBufferIndex, MacCommandsBufferToRepeat);
-		if (MacCommandsBufferToRepeatIndex > 0)
+		MacCommandsInNextTx = (MacCommandsBufferToRepeatIndex > 0) || (MacCommandsBufferHeldIndex > 0);
+		if (MacCommandsBufferHeldIndex == 0)
 		{
-			MacCommandsInNextTx = true;
+			MacCommandsHeldUplinks = 0;
 		}
 
 		if ((payload != NULL) && (LoRaMacTxPayloadLen > 0))
@@ -2369,6 +2887,7 @@ LoRaMacStatus_t PrepareFrame(LoRaMacHeader_t *macHdr, LoRaMacFrameCtrl_t *fCtrl,
 
 LoRaMacStatus_t SendFrameOnChannel(uint8_t channel)
 {
+	PROFILE_ZONE("mac_send_frame");
 	TxConfigParams_t txConfig;
 	int8_t txPower = 0;
 
@@ -2397,10 +2916,6 @@ LoRaMacStatus_t SendFrameOnChannel(uint8_t channel)
 	McpsConfirm.TxTimeOnAir = TxTimeOnAir;
 	MlmeConfirm.TxTimeOnAir = TxTimeOnAir;
 
-	// Starts the MAC layer status check timer
-	TimerSetValue(&MacStateCheckTimer, MAC_STATE_CHECK_TIMEOUT);
-	TimerStart(&MacStateCheckTimer);
-
 	if (IsLoRaMacNetworkJoined != JOIN_OK)
 	{
 		JoinRequestTrials++;
@@ -2438,10 +2953,6 @@ LoRaMacStatus_t SetTxContinuousWave(uint16_t timeout)
 
 	RegionSetContinuousWave(LoRaMacRegion, &continuousWave);
 
-	// Starts the MAC layer status check timer
-	TimerSetValue(&MacStateCheckTimer, MAC_STATE_CHECK_TIMEOUT);
-	TimerStart(&MacStateCheckTimer);
-
 	LoRaMacState |= LORAMAC_TX_RUNNING;
 
 	return LORAMAC_STATUS_OK;
@@ -2451,55 +2962,16 @@ LoRaMacStatus_t SetTxContinuousWave1(uint16_t timeout, uint32_t frequency, uint8
 {
 	Radio.SetTxContinuousWave(frequency, power, timeout);
 
-	// Starts the MAC layer status check timer
-	TimerSetValue(&MacStateCheckTimer, MAC_STATE_CHECK_TIMEOUT);
-	TimerStart(&MacStateCheckTimer);
-
 	LoRaMacState |= LORAMAC_TX_RUNNING;
 
 	return LORAMAC_STATUS_OK;
 }
 
-LoRaMacStatus_t LoRaMacInitialization(LoRaMacPrimitives_t *primitives, LoRaMacCallback_t *callbacks, LoRaMacRegion_t region, eDeviceClass nodeClass, bool region_change, lorawanTXParams_t *txParams)
+static void LoadRegionDefaults(void)
 {
 	GetPhyParams_t getPhy;
 	PhyParam_t phyParam;
 
-	if (primitives == NULL)
-	{
-		return LORAMAC_STATUS_PARAMETER_INVALID;
-	}
-
-	if ((primitives->MacMcpsConfirm == NULL) ||
-		(primitives->MacMcpsIndication == NULL) ||
-		(primitives->MacMlmeConfirm == NULL))
-	{
-		return LORAMAC_STATUS_PARAMETER_INVALID;
-	}
-	// Verify if the region is supported
-	if (RegionIsActive(region) == false)
-	{
-		return LORAMAC_STATUS_REGION_NOT_SUPPORTED;
-	}
-
-	LoRaMacPrimitives = primitives;
-	LoRaMacCallbacks = callbacks;
-	LoRaMacRegion = region;
-	_txParams = txParams;
-
-	LoRaMacFlags.Value = 0;
-
-	LoRaMacDeviceClass = nodeClass;
-	LoRaMacState = LORAMAC_IDLE;
-
-	JoinRequestTrials = 0;
-	MaxJoinRequestTrials = 1;
-	RepeaterSupport = false;
-
-	// Reset duty cycle times
-	AggregatedLastTxDoneTime = 0;
-	AggregatedTimeOff = 0;
-
 	// Reset to defaults
 	getPhy.Attribute = PHY_DUTY_CYCLE;
 	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
@@ -2576,20 +3048,61 @@ LoRaMacStatus_t LoRaMacInitialization(LoRaMacPrimitives_t *primitives, LoRaMacCa
 	LoRaMacParams.JoinAcceptDelay1 = LoRaMacParamsDefaults.JoinAcceptDelay1;
 	LoRaMacParams.JoinAcceptDelay2 = LoRaMacParamsDefaults.JoinAcceptDelay2;
 	LoRaMacParams.ChannelsNbRep = LoRaMacParamsDefaults.ChannelsNbRep;
+}
+
+LoRaMacStatus_t LoRaMacInitialization(LoRaMacPrimitives_t *primitives, LoRaMacCallback_t *callbacks, LoRaMacRegion_t region, eDeviceClass nodeClass, bool region_change, lorawanTXParams_t *txParams)
+{
+	if (primitives == NULL)
+	{
+		return LORAMAC_STATUS_PARAMETER_INVALID;
+	}
+
+	if ((primitives->MacMcpsConfirm == NULL) ||
+		(primitives->MacMcpsIndication == NULL) ||
+		(primitives->MacMlmeConfirm == NULL))
+	{
+		return LORAMAC_STATUS_PARAMETER_INVALID;
+	}
+	// Verify if the region is supported
+	if (RegionIsActive(region) == false)
+	{
+		return LORAMAC_STATUS_REGION_NOT_SUPPORTED;
+	}
+
+	LoRaMacPrimitives = primitives;
+	LoRaMacCallbacks = callbacks;
+	LoRaMacRegion = region;
+	_txParams = txParams;
+
+	LoRaMacFlags.Value = 0;
+
+	LoRaMacDeviceClass = nodeClass;
+	LoRaMacState = LORAMAC_IDLE;
+
+	JoinRequestTrials = 0;
+	MaxJoinRequestTrials = 1;
+	RepeaterSupport = false;
+
+	// Reset duty cycle times
+	AggregatedLastTxDoneTime = 0;
+	AggregatedTimeOff = 0;
+
+	LoadRegionDefaults();
 
 	ResetMacParameters();
 
 	if (!region_change)
 	{
 		// Initialize timers
-		TimerInit(&MacStateCheckTimer, OnMacStateCheckTimerEvent);
-		TimerSetValue(&MacStateCheckTimer, MAC_STATE_CHECK_TIMEOUT);
-
 		TimerInit(&TxDelayedTimer, OnTxDelayedTimerEvent);
 		TimerInit(&RxWindowTimer1, OnRxWindow1TimerEvent);
 		TimerInit(&RxWindowTimer2, OnRxWindow2TimerEvent);
 		TimerInit(&AckTimeoutTimer, OnAckTimeoutTimerEvent);
 
+		// RX windows need an exact timing, the other timers can share wake-ups
+		TimerSetSlack(&TxDelayedTimer, TX_DELAYED_TIMER_SLACK);
+		TimerSetSlack(&AckTimeoutTimer, ACK_TIMEOUT_TIMER_SLACK);
+
 		// Store the current initialization time
 		LoRaMacInitializationTime = TimerGetCurrentTime();
 	}
@@ -2626,6 +3139,300 @@ LoRaMacStatus_t LoRaMacInitialization(LoRaMacPrimitives_t *primitives, LoRaMacCa
 	return LORAMAC_STATUS_OK;
 }
 
+#if (LORAMAC_REGION_CONTEXTS > 0)
+static LoRaMacRegionContext_t *GetRegionContext(LoRaMacRegion_t region, bool allocate, LoRaMacRegion_t keep)
+{
+	LoRaMacRegionContext_t *freeSlot = NULL;
+	int8_t slot = -1;
+
+	for (uint8_t i = 0; i < LORAMAC_REGION_CONTEXTS; i++)
+	{
+		if (RegionContexts[i].Valid == true)
+		{
+			if (RegionContexts[i].Region == region)
+			{
+				RegionContextsLastUse[i] = ++RegionContextsUseCounter;
+				return &RegionContexts[i];
+			}
+		}
+		else if (freeSlot == NULL)
+		{
+			freeSlot = &RegionContexts[i];
+			slot = i;
+		}
+	}
+
+	if (allocate == false)
+	{
+		return NULL;
+	}
+
+	if (freeSlot == NULL)
+	{
+		// All slots are used, reuse the least recently used one that holds neither the active nor the kept region
+		for (uint8_t i = 0; i < LORAMAC_REGION_CONTEXTS; i++)
+		{
+			if ((RegionContexts[i].Region == LoRaMacRegion) || (RegionContexts[i].Region == keep))
+			{
+				continue;
+			}
+			if ((freeSlot == NULL) || (RegionContextsLastUse[i] < RegionContextsLastUse[slot]))
+			{
+				freeSlot = &RegionContexts[i];
+				slot = i;
+			}
+		}
+	}
+	if (freeSlot != NULL)
+	{
+		RegionContextsLastUse[slot] = ++RegionContextsUseCounter;
+	}
+	return freeSlot;
+}
+
+static void SaveRegionContext(LoRaMacRegionContext_t *context)
+{
+	GetPhyParams_t getPhy;
+	PhyParam_t phyParam;
+
+	memset(context, 0, sizeof(LoRaMacRegionContext_t));
+
+	context->Region = LoRaMacRegion;
+	context->Valid = true;
+	context->JoinStatus = IsLoRaMacNetworkJoined;
+	context->NetID = LoRaMacNetID;
+	context->DevAddr = LoRaMacDevAddr;
+	memcpy(context->NwkSKey, LoRaMacNwkSKey, sizeof(context->NwkSKey));
+	memcpy(context->AppSKey, LoRaMacAppSKey, sizeof(context->AppSKey));
+	context->UpLinkCounter = UpLinkCounter;
+	context->DownLinkCounter = DownLinkCounter;
+	context->AdrCtrlOn = AdrCtrlOn;
+	context->AdrAckCounter = AdrAckCounter;
+	context->Params = LoRaMacParams;
+
+	getPhy.Attribute = PHY_CHANNELS_MASK;
+	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+	memcpy(context->ChannelsMask, phyParam.ChannelsMask, sizeof(context->ChannelsMask));
+
+	getPhy.Attribute = PHY_CHANNELS_DEFAULT_MASK;
+	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+	memcpy(context->ChannelsDefaultMask, phyParam.ChannelsMask, sizeof(context->ChannelsDefaultMask));
+
+	memcpy(context->ChannelsMaskRemaining, ChannelsMaskRemaining, sizeof(context->ChannelsMaskRemaining));
+
+	// Regions with more channels have a fixed channel plan that is rebuilt on initialization
+	getPhy.Attribute = PHY_MAX_NB_CHANNELS;
+	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+	if (phyParam.Value <= LORAMAC_REGION_CONTEXT_MAX_CHANNELS)
+	{
+		context->NbChannels = phyParam.Value;
+		getPhy.Attribute = PHY_CHANNELS;
+		phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+		memcpy(context->Channels, phyParam.Channels, context->NbChannels * sizeof(ChannelParams_t));
+	}
+
+	getPhy.Attribute = PHY_MAX_NB_BANDS;
+	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+	context->NbBands = T_MIN(phyParam.Value, LORAMAC_REGION_CONTEXT_MAX_BANDS);
+	getPhy.Attribute = PHY_BANDS;
+	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+	memcpy(context->Bands, phyParam.Bands, context->NbBands * sizeof(Band_t));
+}
+
+static void RestoreRegionContext(LoRaMacRegionContext_t *context)
+{
+	GetPhyParams_t getPhy;
+	PhyParam_t phyParam;
+
+	IsLoRaMacNetworkJoined = context->JoinStatus;
+	LoRaMacNetID = context->NetID;
+	LoRaMacDevAddr = context->DevAddr;
+	memcpy(LoRaMacNwkSKey, context->NwkSKey, sizeof(context->NwkSKey));
+	memcpy(LoRaMacAppSKey, context->AppSKey, sizeof(context->AppSKey));
+	UpLinkCounter = context->UpLinkCounter;
+	DownLinkCounter = context->DownLinkCounter;
+	AdrCtrlOn = context->AdrCtrlOn;
+	AdrAckCounter = context->AdrAckCounter;
+	LoRaMacParams = context->Params;
+
+	getPhy.Attribute = PHY_CHANNELS_MASK;
+	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+	memcpy(phyParam.ChannelsMask, context->ChannelsMask, sizeof(context->ChannelsMask));
+
+	getPhy.Attribute = PHY_CHANNELS_DEFAULT_MASK;
+	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+	memcpy(phyParam.ChannelsMask, context->ChannelsDefaultMask, sizeof(context->ChannelsDefaultMask));
+
+	memcpy(ChannelsMaskRemaining, context->ChannelsMaskRemaining, sizeof(context->ChannelsMaskRemaining));
+
+	getPhy.Attribute = PHY_MAX_NB_CHANNELS;
+	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+	if ((context->NbChannels != 0) && (context->NbChannels == phyParam.Value))
+	{
+		getPhy.Attribute = PHY_CHANNELS;
+		phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+		memcpy(phyParam.Channels, context->Channels, context->NbChannels * sizeof(ChannelParams_t));
+	}
+
+	getPhy.Attribute = PHY_MAX_NB_BANDS;
+	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+	if (context->NbBands == phyParam.Value)
+	{
+		getPhy.Attribute = PHY_BANDS;
+		phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
+		memcpy(phyParam.Bands, context->Bands, context->NbBands * sizeof(Band_t));
+	}
+}
+
+static void RebaseRegionContextBands(LoRaMacRegionContext_t *context, bool toElapsed)
+{
+	// now - (now - x) == x, the conversion is exact across a wrap of the time
+	TimerTime_t curTime = TimerGetCurrentTime();
+
+	for (uint8_t i = 0; i < context->NbBands; i++)
+	{
+		if (toElapsed == true)
+		{
+			context->Bands[i].LastJoinTxDoneTime = TimerGetElapsedTime(context->Bands[i].LastJoinTxDoneTime);
+			context->Bands[i].LastTxDoneTime = TimerGetElapsedTime(context->Bands[i].LastTxDoneTime);
+		}
+		else
+		{
+			context->Bands[i].LastJoinTxDoneTime = curTime - context->Bands[i].LastJoinTxDoneTime;
+			context->Bands[i].LastTxDoneTime = curTime - context->Bands[i].LastTxDoneTime;
+		}
+	}
+}
+
+LoRaMacStatus_t LoRaMacRegionSwitch(LoRaMacRegion_t region)
+{
+	LoRaMacRegionContext_t *context;
+
+	if (LoRaMacState != LORAMAC_IDLE)
+	{
+		return LORAMAC_STATUS_BUSY;
+	}
+	if (RegionIsActive(region) == false)
+	{
+		return LORAMAC_STATUS_REGION_NOT_SUPPORTED;
+	}
+	if (region == LoRaMacRegion)
+	{
+		return LORAMAC_STATUS_OK;
+	}
+
+	LOG_LIB("LM", "Switch region %d => %d", LoRaMacRegion, region);
+
+	// Save the session of the region we leave, without evicting the session of the region we go to
+	context = GetRegionContext(LoRaMacRegion, true, region);
+	if (context == NULL)
+	{
+		// No context left to save it, refuse instead of losing the session
+		return LORAMAC_STATUS_PARAMETER_INVALID;
+	}
+	SaveRegionContext(context);
+
+	Radio.Sleep();
+	TimerStop(&TxDelayedTimer);
+	TimerStop(&RxWindowTimer1);
+	TimerStop(&RxWindowTimer2);
+	TimerStop(&AckTimeoutTimer);
+
+	LoRaMacRegion = region;
+	LoadRegionDefaults();
+
+	// The aggregated duty cycle is a regulatory limit of the old region
+	AggregatedLastTxDoneTime = 0;
+	AggregatedTimeOff = 0;
+
+	ResetMacParameters();
+
+	context = GetRegionContext(region, false, region);
+	if (context != NULL)
+	{
+		RestoreRegionContext(context);
+	}
+	else
+	{
+		// No saved session, the device has to join in the new region
+		IsLoRaMacNetworkJoined = JOIN_NOT_START;
+	}
+
+	if (LoRaMacDeviceClass == CLASS_C)
+	{
+		// Reopen the continuous RX2 window on the channel of the new region
+		NodeAckRequested = false;
+		OnRxWindow2TimerEvent();
+	}
+	return LORAMAC_STATUS_OK;
+}
+
+LoRaMacStatus_t LoRaMacRegionContextGet(LoRaMacRegion_t region, LoRaMacRegionContext_t *context)
+{
+	LoRaMacRegionContext_t *slot;
+
+	if (context == NULL)
+	{
+		return LORAMAC_STATUS_PARAMETER_INVALID;
+	}
+
+	if (region == LoRaMacRegion)
+	{
+		SaveRegionContext(context);
+	}
+	else
+	{
+		slot = GetRegionContext(region, false, region);
+		if (slot == NULL)
+		{
+			return LORAMAC_STATUS_PARAMETER_INVALID;
+		}
+		memcpy(context, slot, sizeof(LoRaMacRegionContext_t));
+	}
+	RebaseRegionContextBands(context, true);
+	return LORAMAC_STATUS_OK;
+}
+
+LoRaMacStatus_t LoRaMacRegionContextSet(LoRaMacRegionContext_t *context)
+{
+	LoRaMacRegionContext_t *slot;
+	LoRaMacRegionContext_t rebased;
+
+	if ((context == NULL) || (context->Valid == false) ||
+		(context->NbChannels > LORAMAC_REGION_CONTEXT_MAX_CHANNELS) ||
+		(context->NbBands > LORAMAC_REGION_CONTEXT_MAX_BANDS))
+	{
+		return LORAMAC_STATUS_PARAMETER_INVALID;
+	}
+	if (RegionIsActive(context->Region) == false)
+	{
+		return LORAMAC_STATUS_REGION_NOT_SUPPORTED;
+	}
+
+	// The Tx done times of the bands are relative to the call, see LoRaMacRegionContextGet
+	memcpy(&rebased, context, sizeof(LoRaMacRegionContext_t));
+	RebaseRegionContextBands(&rebased, false);
+
+	if (context->Region == LoRaMacRegion)
+	{
+		if (LoRaMacState != LORAMAC_IDLE)
+		{
+			return LORAMAC_STATUS_BUSY;
+		}
+		RestoreRegionContext(&rebased);
+		return LORAMAC_STATUS_OK;
+	}
+
+	slot = GetRegionContext(context->Region, true, context->Region);
+	if (slot == NULL)
+	{
+		return LORAMAC_STATUS_PARAMETER_INVALID;
+	}
+	memcpy(slot, &rebased, sizeof(LoRaMacRegionContext_t));
+	return LORAMAC_STATUS_OK;
+}
+#endif
+
 LoRaMacStatus_t LoRaMacQueryTxPossible(uint8_t size, LoRaMacTxInfo_t *txInfo)
 {
 	AdrNextParams_t adrNext;
@@ -2633,7 +3440,6 @@ LoRaMacStatus_t LoRaMacQueryTxPossible(uint8_t size, LoRaMacTxInfo_t *txInfo)
 	PhyParam_t phyParam;
 	int8_t datarate = LoRaMacParamsDefaults.ChannelsDatarate;
 	int8_t txPower = LoRaMacParamsDefaults.ChannelsTxPower;
-	uint8_t fOptLen = MacCommandsBufferIndex + MacCommandsBufferToRepeatIndex;
 
 	if (txInfo == NULL)
 	{
@@ -2665,24 +3471,17 @@ LoRaMacStatus_t LoRaMacQueryTxPossible(uint8_t size, LoRaMacTxInfo_t *txInfo)
 	phyParam = RegionGetPhyParam(LoRaMacRegion, &getPhy);
 	txInfo->CurrentPayloadSize = phyParam.Value;
 
-	// Verify if the fOpts fit into the maximum payload
-	if (txInfo->CurrentPayloadSize >= fOptLen)
+	// MAC commands which do not fit next to the payload are held back for the
+	// next uplink. The held ones go first, the application gets the rest
+	uint8_t heldLen = MacCommandsBufferHeldIndex;
+	if (heldLen > LORA_MAC_COMMAND_MAX_FOPTS_LENGTH)
 	{
-		txInfo->MaxPossiblePayload = txInfo->CurrentPayloadSize - fOptLen;
-		fOptLen = 0;
-	}
-	else
-	{
-		txInfo->MaxPossiblePayload = txInfo->CurrentPayloadSize;
-		// The fOpts don't fit into the maximum payload. Omit the MAC commands to
-		// ensure that another uplink is possible.
-		fOptLen = 0;
-		MacCommandsBufferIndex = 0;
-		MacCommandsBufferToRepeatIndex = 0;
+		heldLen = LORA_MAC_COMMAND_MAX_FOPTS_LENGTH;
 	}
+	txInfo->MaxPossiblePayload = txInfo->CurrentPayloadSize > heldLen ? txInfo->CurrentPayloadSize - heldLen : 0;
 
-	// Verify if the fOpts and the payload fit into the maximum payload
-	if (ValidatePayloadLength(size, datarate, fOptLen) == false)
+	// Verify if the payload fits into the maximum payload
+	if (ValidatePayloadLength(size, datarate, 0) == false)
 	{
 		LOG_LIB("LM", "LoRaMacQueryTxPossible -> ValidatePayloadLength failed size = %d DR = %d", size, datarate);
 
@@ -3374,6 +4173,15 @@ LoRaMacStatus_t LoRaMacMlmeRequest(MlmeReq_t *mlmeRequest)
 		status = AddMacCommand(MOTE_MAC_LINK_CHECK_REQ, 0, 0);
 		break;
 	}
+	case MLME_DEVICE_TIME:
+	{
+		LoRaMacFlags.Bits.MlmeReq = 1;
+		// LoRaMac will send this command piggy-pack
+		MlmeConfirm.MlmeRequest = mlmeRequest->Type;
+
+		status = AddMacCommand(MOTE_MAC_DEVICE_TIME_REQ, 0, 0);
+		break;
+	}
 	case MLME_TXCW:
 	{
 		MlmeConfirm.MlmeRequest = mlmeRequest->Type;
@@ -41,10 +41,6 @@
 #ifndef __LORAMAC_H__
 #define __LORAMAC_H__
 #include "loraEvents.h"
-/*!
- * Check the Mac layer state every MAC_STATE_CHECK_TIMEOUT in ms
- */
-#define MAC_STATE_CHECK_TIMEOUT 250 // 1000
 
 /*!
  * Maximum number of times the MAC layer tries to get an acknowledge.
@@ -77,6 +73,32 @@ extern uint32_t LoRaMacState;
  */
 #define LORA_MAC_FRMPAYLOAD_OVERHEAD 13 // MHDR(1) + FHDR(7) + Port(1) + MIC(4)
 
+/*!
+ * Allowed expiry delay in ms of the TX back-off timer
+ */
+#define TX_DELAYED_TIMER_SLACK 100
+
+/*!
+ * Allowed expiry delay in ms of the ACK timeout timer
+ */
+#define ACK_TIMEOUT_TIMER_SLACK 50
+
+/*!
+ * Number of uplinks a MAC answer may be held back for when it does not fit
+ * next to the application payload. The next uplink then sends the held
+ * answers instead of the application payload.
+ */
+#ifndef LORAMAC_MAX_HELD_UPLINKS
+#define LORAMAC_MAX_HELD_UPLINKS 2
+#endif
+
+/*!
+ * Time in ms a MAC answer may be held back for, see LORAMAC_MAX_HELD_UPLINKS
+ */
+#ifndef LORAMAC_MAX_HELD_TIME
+#define LORAMAC_MAX_HELD_TIME 60000
+#endif
+
 /*!
  * FRMPayload minimum size
  * 
@@ -397,7 +419,13 @@ typedef enum eLoRaMacMoteCmd
 	/*!
      * DlChannelAns
      */
-	MOTE_MAC_DL_CHANNEL_ANS = 0x0A
+	MOTE_MAC_DL_CHANNEL_ANS = 0x0A,
+	/*!
+     * DeviceTimeReq
+     *
+     * LoRaWAN Specification V1.0.3, chapter 5.9
+     */
+	MOTE_MAC_DEVICE_TIME_REQ = 0x0D
 } LoRaMacMoteCmd_t;
 
 /*!
@@ -443,6 +471,12 @@ typedef enum eLoRaMacSrvCmd
      * DlChannelReq
      */
 	SRV_MAC_DL_CHANNEL_REQ = 0x0A,
+	/*!
+     * DeviceTimeAns
+     *
+     * LoRaWAN Specification V1.0.3, chapter 5.9
+     */
+	SRV_MAC_DEVICE_TIME_ANS = 0x0D,
 } LoRaMacSrvCmd_t;
 
 /*!
@@ -921,6 +955,7 @@ typedef struct sMcpsIndication
  * --------------------- | :-----: | :--------: | :------: | :-----:
  * \ref MLME_JOIN        | YES     | NO         | NO       | YES
  * \ref MLME_LINK_CHECK  | YES     | NO         | NO       | YES
+ * \ref MLME_DEVICE_TIME | YES     | NO         | NO       | YES
  * \ref MLME_TXCW        | YES     | NO         | NO       | YES
  *
  * The following table provides links to the function implementations of the
@@ -957,6 +992,12 @@ typedef enum eMlme
      * LoRaWAN end-device certification
      */
 	MLME_TXCW_1,
+	/*!
+     * DeviceTimeReq - Network time in GPS epoch
+     *
+     * LoRaWAN Specification V1.0.3, chapter 5.9
+     */
+	MLME_DEVICE_TIME,
 } Mlme_t;
 
 /*!
@@ -1063,6 +1104,19 @@ typedef struct sMlmeConfirm
      * Provides the number of retransmissions
      */
 	uint8_t NbRetries;
+	/*!
+     * Seconds since the GPS epoch of the last DeviceTimeAns
+     */
+	uint32_t GpsSeconds;
+	/*!
+     * Fractional second of the last DeviceTimeAns in 1/256 s
+     */
+	uint8_t GpsFraction;
+	/*!
+     * Local time of the end of the uplink the last DeviceTimeAns refers to,
+     * see TimerGetCurrentTime
+     */
+	TimerTime_t GpsReference;
 } MlmeConfirm_t;
 
 /*!
@@ -1651,6 +1705,125 @@ typedef enum eLoRaMacRegion_t
 } LoRaMacRegion_t;
 
 extern LoRaMacRegion_t LoRaMacRegion;
+
+/*!
+ * Number of region contexts held by the MAC for \ref LoRaMacRegionSwitch.
+ * The region switch and its contexts are only compiled if it is above 0.
+ * A switch needs one context for the region it leaves and one for the
+ * region it goes to, so the value is 0 or at least 2
+ */
+#ifndef LORAMAC_REGION_CONTEXTS
+#define LORAMAC_REGION_CONTEXTS 0
+#endif
+
+#if (LORAMAC_REGION_CONTEXTS == 1)
+#error "LORAMAC_REGION_CONTEXTS must be 0 or at least 2, a single context can not hold the sessions of both regions of a switch."
+#endif
+
+#if (LORAMAC_REGION_CONTEXTS > 0)
+/*!
+ * Maximum number of channels saved in a region context.
+ * Regions with more channels (US915, AU915, CN470) have a fixed channel
+ * plan, for them only the channels masks are saved.
+ */
+#define LORAMAC_REGION_CONTEXT_MAX_CHANNELS 16
+
+/*!
+ * Maximum number of bands saved in a region context
+ */
+#define LORAMAC_REGION_CONTEXT_MAX_BANDS 5
+
+/*!
+ * LoRaMAC region context
+ *
+ * \remark Holds the complete network session of one region. The structure
+ *          contains no pointers and can be stored as is in non volatile
+ *          memory and restored with \ref LoRaMacRegionContextSet.
+ */
+typedef struct sLoRaMacRegionContext
+{
+	/*!
+     * Region the context belongs to
+     */
+	LoRaMacRegion_t Region;
+	/*!
+     * Set to true if the context holds a saved session
+     */
+	bool Valid;
+	/*!
+     * Network join status
+     */
+	eJoinStatus_t JoinStatus;
+	/*!
+     * Network ID ( 3 bytes )
+     */
+	uint32_t NetID;
+	/*!
+     * Device address
+     */
+	uint32_t DevAddr;
+	/*!
+     * Network session key
+     */
+	uint8_t NwkSKey[16];
+	/*!
+     * Application session key
+     */
+	uint8_t AppSKey[16];
+	/*!
+     * Uplink frame counter
+     */
+	uint32_t UpLinkCounter;
+	/*!
+     * Downlink frame counter
+     */
+	uint32_t DownLinkCounter;
+	/*!
+     * ADR control status
+     */
+	bool AdrCtrlOn;
+	/*!
+     * ADR acknowledgement counter
+     */
+	uint32_t AdrAckCounter;
+	/*!
+     * LoRaMac parameters, including the datarate and TX power selected by ADR
+     */
+	LoRaMacParams_t Params;
+	/*!
+     * Channels mask
+     */
+	uint16_t ChannelsMask[6];
+	/*!
+     * Channels default mask
+     */
+	uint16_t ChannelsDefaultMask[6];
+	/*!
+     * Channels remaining mask
+     */
+	uint16_t ChannelsMaskRemaining[6];
+	/*!
+     * Number of saved channels, 0 if the region has a fixed channel plan
+     */
+	uint8_t NbChannels;
+	/*!
+     * Channels
+     */
+	ChannelParams_t Channels[LORAMAC_REGION_CONTEXT_MAX_CHANNELS];
+	/*!
+     * Number of saved bands
+     */
+	uint8_t NbBands;
+	/*!
+     * Bands, including the duty cycle time off. In a context of
+     * \ref LoRaMacRegionContextGet and \ref LoRaMacRegionContextSet the
+     * LastJoinTxDoneTime and LastTxDoneTime hold the time in ms elapsed
+     * since the Tx done, not time stamps
+     */
+	Band_t Bands[LORAMAC_REGION_CONTEXT_MAX_BANDS];
+} LoRaMacRegionContext_t;
+#endif
+
 /*!
  * LoRaMAC events structure
  * Used to notify upper layers of MAC events
@@ -1724,6 +1897,61 @@ static const uint8_t LoRaMacMaxEirpTable[] = {8, 10, 12, 13, 14, 16, 18, 20, 21,
  */
 LoRaMacStatus_t LoRaMacInitialization(LoRaMacPrimitives_t *primitives, LoRaMacCallback_t *callbacks, LoRaMacRegion_t region, eDeviceClass nodeClass = CLASS_A, bool region_change = false, lorawanTXParams_t *txParams = NULL);
 
+#if (LORAMAC_REGION_CONTEXTS > 0)
+/*!
+ * \brief   Switches the MAC to another region
+ *
+ * \details The session of the current region is saved in its region context.
+ *          If a saved context exists for the new region, channels, masks,
+ *          bands, session keys, counters and ADR state are restored and no
+ *          new join is required. Otherwise the new region starts with its
+ *          defaults and the device has to join.
+ *
+ * \param    region - The region to switch to.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_BUSY,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID,
+ *          \ref LORAMAC_STATUS_REGION_NOT_SUPPORTED.
+ */
+LoRaMacStatus_t LoRaMacRegionSwitch(LoRaMacRegion_t region);
+
+/*!
+ * \brief   Gets the context of a region, e.g. to store it in non volatile memory
+ *
+ * \details The Tx done times of the bands are converted to the time elapsed
+ *          until this call, the context stays valid across a reset.
+ *
+ * \param    region - The region of the context.
+ *
+ * \param    context - Pointer to the structure to fill.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID.
+ */
+LoRaMacStatus_t LoRaMacRegionContextGet(LoRaMacRegion_t region, LoRaMacRegionContext_t *context);
+
+/*!
+ * \brief   Sets the context of a region, e.g. after reading it from non volatile memory
+ *
+ * \details If the context belongs to the current region it is applied immediately,
+ *          otherwise it is used on the next switch to its region. The elapsed
+ *          Tx done times of the bands are counted from this call, time spent
+ *          e.g. in a reset extends the duty cycle time off.
+ *
+ * \param    context - Pointer to the context.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_BUSY,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID,
+ *          \ref LORAMAC_STATUS_REGION_NOT_SUPPORTED.
+ */
+LoRaMacStatus_t LoRaMacRegionContextSet(LoRaMacRegionContext_t *context);
+#endif
+
 /*!
  * \brief   Returns the Device Address set by the LoRaWan server
  *          after OTAA join was successful
@@ -1955,6 +2183,10 @@ LoRaMacStatus_t LoRaMacMlmeRequest(MlmeReq_t *mlmeRequest);
  *          \ref LORAMAC_STATUS_NO_NETWORK_JOINED,
  *          \ref LORAMAC_STATUS_LENGTH_ERROR,
  *          \ref LORAMAC_STATUS_DEVICE_OFF.
+ *          \ref LORAMAC_STATUS_LENGTH_ERROR is also returned if MAC answers
+ *          were held back for LORAMAC_MAX_HELD_UPLINKS uplinks or
+ *          LORAMAC_MAX_HELD_TIME and do not fit next to the payload. Nothing
+ *          is sent, a request without payload flushes the answers.
  */
 LoRaMacStatus_t LoRaMacMcpsRequest(McpsReq_t *mcpsRequest);
 
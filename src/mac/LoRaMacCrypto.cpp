@@ -25,6 +25,7 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #include "system/crypto/cmac.h"
 
 #include "LoRaMacCrypto.h"
+#include "sx126x-profile.h"
 
 /*!
  * CMAC/AES Message Integrity Code (MIC) Block B0 size
@@ -64,6 +65,7 @@ static AES_CMAC_CTX AesCmacCtx[1];
 
 void LoRaMacComputeMic(const uint8_t *buffer, uint16_t size, const uint8_t *key, uint32_t address, uint8_t dir, uint32_t sequenceCounter, uint32_t *mic)
 {
+	PROFILE_ZONE("crypto_mic");
 	MicBlockB0[5] = dir;
 
 	MicBlockB0[6] = (address)&0xFF;
@@ -93,6 +95,7 @@ void LoRaMacComputeMic(const uint8_t *buffer, uint16_t size, const uint8_t *key,
 
 void LoRaMacPayloadEncrypt(const uint8_t *buffer, uint16_t size, const uint8_t *key, uint32_t address, uint8_t dir, uint32_t sequenceCounter, uint8_t *encBuffer)
 {
+	PROFILE_ZONE("crypto_encrypt");
 	uint16_t i;
 	uint8_t bufferIndex = 0;
 	uint16_t ctr = 1;
@@ -102,6 +102,26 @@ static lmh_compliance_test_t m_compliance_test; /**< LoRaWAN compliance tests da
 static bool m_adr_enable_init;
 static TimerEvent_t ComplianceTestTxNextPacketTimer;
 
+/* Uplink desynchronization, see lmh_setUplinkJitter */
+static uint32_t m_join_window = 0;		   /**< Max random delay before a join request in ms */
+static uint8_t m_send_tolerance = 0;	   /**< Max deviation of a periodic uplink in percent */
+static uint8_t m_jitter_widening = 1;	   /**< Factor of the windows after collisions */
+static uint32_t m_jitter_state = 0;		   /**< Random generator state, 0 until seeded */
+static int32_t m_jitter_drift = 0;		   /**< Node specific share of the tolerance [-512..512] */
+static bool m_join_pending = false;		   /**< Join request waits for its delay */
+static TimerEvent_t JoinDelayTimer;
+
+/* Network time, see lmh_device_time_request */
+static bool m_time_synced = false;		   /**< Network time was received */
+static uint64_t m_time_gps = 0;			   /**< Network time at the reference in ms since the GPS epoch */
+static TimerTime_t m_time_ref = 0;		   /**< Local time of the reference */
+static int32_t m_time_drift = 0;		   /**< Drift of the local clock in ppb */
+static bool m_time_drift_valid = false;	   /**< Drift was measured once */
+static uint64_t m_drift_gps = 0;		   /**< Network time at the drift reference */
+static TimerTime_t m_drift_ref = 0;		   /**< Local time of the drift reference */
+
+static void OnJoinDelayTimerEvent(void);
+
 void lmh_setDevEui(uint8_t userDevEui[])
 {
 	memcpy(DevEui, userDevEui, 8);
@@ -364,6 +384,76 @@ static void OnComplianceTestTxNextPacketTimerEvent(void)
 	compliance_test_tx();
 }
 
+/**@brief Seed the random numbers of the uplink desynchronization
+ * Seeded from the DevEUI, the board random seed and the radio, so nodes that
+ * boot together draw different numbers even with a poor board seed. The radio
+ * is only asked while the MAC is idle, it has to receive to measure the noise.
+ *
+ * @param use_radio true to add the random number of the radio
+ */
+static void jitterSeed(bool use_radio)
+{
+	// FNV-1a hash of the DevEUI
+	uint32_t hash = 2166136261u;
+	for (int idx = 0; idx < 8; idx++)
+	{
+		hash = (hash ^ DevEui[idx]) * 16777619u;
+	}
+	m_jitter_state = hash;
+	if (use_radio)
+	{
+		m_jitter_state ^= Radio.Random();
+	}
+	if ((m_callbacks != NULL) && (m_callbacks->BoardGetRandomSeed != NULL))
+	{
+		m_jitter_state ^= m_callbacks->BoardGetRandomSeed();
+	}
+	if (m_jitter_state == 0)
+	{
+		m_jitter_state = hash | 1;
+	}
+	// Fixed share of the tolerance per node, spreads the phases of equal periods over time
+	m_jitter_drift = (int32_t)(hash % 1025) - 512;
+}
+
+/**@brief Random number of the uplink desynchronization, see jitterSeed()
+ *
+ * @param max upper limit, exclusive
+ * @retval random number
+ */
+static uint32_t jitterRandom(uint32_t max)
+{
+	if (m_jitter_state == 0)
+	{
+		// Used before lmh_init(), the radio may not be initialized
+		jitterSeed(false);
+	}
+	m_jitter_state ^= m_jitter_state << 13;
+	m_jitter_state ^= m_jitter_state >> 17;
+	m_jitter_state ^= m_jitter_state << 5;
+	return max == 0 ? 0 : m_jitter_state % max;
+}
+
+/**@brief Widen the desynchronization windows after a collision
+ */
+static void jitterWiden(void)
+{
+	if (m_jitter_widening < LMH_JITTER_MAX_WIDENING)
+	{
+		m_jitter_widening *= 2;
+	}
+}
+
+/**@brief Narrow the desynchronization windows after a successful exchange
+ */
+static void jitterNarrow(void)
+{
+	if (m_jitter_widening > 1)
+	{
+		m_jitter_widening /= 2;
+	}
+}
+
 #define LORAMAC_TX_RUNNING 0x00000001
 /**@brief MCPS-Confirm event function
  *
@@ -399,6 +489,15 @@ static void McpsConfirm(McpsConfirm_t *mcpsConfirm)
 		// Report confirmed TX finished with result
 		if (!statusOk)
 			LOG_LIB("LMH", "Timeout Conf TX finished %s", mcpsConfirm->AckReceived ? "SUCC" : "FAIL");
+		// A missing acknowledge is taken as a collision with the uplinks of other nodes
+		if (mcpsConfirm->AckReceived)
+		{
+			jitterNarrow();
+		}
+		else
+		{
+			jitterWiden();
+		}
 		if (m_callbacks->lmh_conf_result != 0)
 		{
 			m_callbacks->lmh_conf_result(mcpsConfirm->AckReceived);
@@ -508,6 +607,7 @@ static void McpsIndication(McpsIndication_t *mcpsIndication)
 
 					TimerInit(&ComplianceTestTxNextPacketTimer, OnComplianceTestTxNextPacketTimerEvent);
 					TimerSetValue(&ComplianceTestTxNextPacketTimer, 5000);
+					TimerSetSlack(&ComplianceTestTxNextPacketTimer, 500);
 
 					// confirm test mode activation
 					compliance_test_tx();
@@ -642,6 +742,59 @@ static void McpsIndication(McpsIndication_t *mcpsIndication)
 	}
 }
 
+/**@brief Network time at a local time
+ *
+ * @param local Local time, see TimerGetCurrentTime
+ * @retval network time in ms since the GPS epoch
+ */
+static uint64_t timeAt(TimerTime_t local)
+{
+	uint32_t elapsed = local - m_time_ref;
+	return m_time_gps + elapsed + ((int64_t)elapsed * m_time_drift) / 1000000000;
+}
+
+/**@brief Discipline the local clock with a DeviceTimeAns
+ * The offset is taken over at once. The drift is estimated from the error of
+ * the prediction since the drift reference, at least LMH_TIME_DRIFT_INTERVAL ago.
+ *
+ * @param mlmeConfirm confirm with the network time
+ */
+static void timeSync(MlmeConfirm_t *mlmeConfirm)
+{
+	uint64_t gps = (uint64_t)mlmeConfirm->GpsSeconds * 1000 + ((uint32_t)mlmeConfirm->GpsFraction * 1000) / 256;
+	uint32_t elapsed = mlmeConfirm->GpsReference - m_drift_ref;
+
+	if (!m_time_synced)
+	{
+		m_drift_gps = gps;
+		m_drift_ref = mlmeConfirm->GpsReference;
+	}
+	else if (elapsed >= LMH_TIME_DRIFT_INTERVAL)
+	{
+		uint64_t predicted = m_drift_gps + elapsed + ((int64_t)elapsed * m_time_drift) / 1000000000;
+		int64_t error = (int64_t)(gps - predicted);
+		int32_t correction = (int32_t)((error * 1000000000) / elapsed);
+		// The first estimate is taken over, later ones are filtered against the jitter of the answers
+		int64_t drift = m_time_drift + (m_time_drift_valid ? correction / 4 : correction);
+		if (drift > LMH_TIME_MAX_DRIFT)
+		{
+			drift = LMH_TIME_MAX_DRIFT;
+		}
+		else if (drift < -LMH_TIME_MAX_DRIFT)
+		{
+			drift = -LMH_TIME_MAX_DRIFT;
+		}
+		m_time_drift = (int32_t)drift;
+		m_time_drift_valid = true;
+		m_drift_gps = gps;
+		m_drift_ref = mlmeConfirm->GpsReference;
+		LOG_LIB("LMH", "Time error %ld ms drift %ld ppb", (long)error, (long)m_time_drift);
+	}
+	m_time_gps = gps;
+	m_time_ref = mlmeConfirm->GpsReference;
+	m_time_synced = true;
+}
+
 /**@brief MLME-Confirm event function
  *
  * @param mlmeConfirm	Pointer to the confirm structure, containing confirm attributes.
@@ -654,6 +807,7 @@ static void MlmeConfirm(MlmeConfirm_t *mlmeConfirm)
 	{
 		if (mlmeConfirm->Status == LORAMAC_EVENT_INFO_STATUS_OK)
 		{
+			jitterNarrow();
 			// Status is OK, node has joined the network
 			if (m_callbacks->lmh_has_joined != NULL)
 			{
@@ -662,6 +816,7 @@ static void MlmeConfirm(MlmeConfirm_t *mlmeConfirm)
 		}
 		else
 		{
+			jitterWiden();
 			// call joined failed callback here
 			if (m_callbacks->lmh_has_joined_failed != NULL)
 			{
@@ -676,6 +831,15 @@ static void MlmeConfirm(MlmeConfirm_t *mlmeConfirm)
 		break;
 	}
 
+	case MLME_DEVICE_TIME:
+	{
+		if (mlmeConfirm->Status == LORAMAC_EVENT_INFO_STATUS_OK)
+		{
+			timeSync(mlmeConfirm);
+		}
+		break;
+	}
+
 	case MLME_LINK_CHECK:
 	{
 		if (mlmeConfirm->Status == LORAMAC_EVENT_INFO_STATUS_OK)
@@ -746,6 +910,10 @@ lmh_error_status lmh_init(lmh_callback_t *callbacks, lmh_param_t lora_param, boo
 		LOG_LIB("LMH", "ABP \n%s\nDevAdd=%08X\n%s\n%s", strlog1, (unsigned int)DevAddr, strlog2, strlog3);
 	}
 
+	JoinDelayTimer.oneShot = true;
+	TimerInit(&JoinDelayTimer, OnJoinDelayTimerEvent);
+	m_join_pending = false;
+
 	LoRaMacPrimitives.MacMcpsConfirm = McpsConfirm;
 	LoRaMacPrimitives.MacMcpsIndication = McpsIndication;
 	LoRaMacPrimitives.MacMlmeConfirm = MlmeConfirm;
@@ -757,6 +925,9 @@ lmh_error_status lmh_init(lmh_callback_t *callbacks, lmh_param_t lora_param, boo
 		return LMH_ERROR;
 	}
 
+	// The MAC is idle and no Class C reception is running yet
+	jitterSeed(true);
+
 	mibReq.Type = MIB_ADR;
 	mibReq.Param.AdrEnable = lora_param.adr_enable;
 	LoRaMacMibSetRequestConfirm(&mibReq);
@@ -892,7 +1063,9 @@ void lmh_tx_power_set(uint8_t tx_power)
 	LoRaMacMibSetRequestConfirm(&mibReq);
 }
 
-void lmh_join(void)
+/**@brief Send the join request or activate the ABP session
+ */
+static void joinRequest(void)
 {
 	MlmeReq_t mlmeReq;
 
@@ -934,6 +1107,122 @@ void lmh_join(void)
 	}
 }
 
+/**@brief Join delay timer, the random delay of the join request is over
+ */
+static void OnJoinDelayTimerEvent(void)
+{
+	m_join_pending = false;
+	joinRequest();
+}
+
+void lmh_join(void)
+{
+	if (m_join_pending)
+	{
+		return;
+	}
+	if (!_otaa || (m_join_window == 0))
+	{
+		joinRequest();
+		return;
+	}
+
+	uint32_t delay = jitterRandom(m_join_window * m_jitter_widening);
+	LOG_LIB("LMH", "Join in %lu ms", (unsigned long)delay);
+	if (delay == 0)
+	{
+		joinRequest();
+		return;
+	}
+	m_join_pending = true;
+	TimerSetValue(&JoinDelayTimer, delay);
+	TimerStart(&JoinDelayTimer);
+}
+
+void lmh_setUplinkJitter(uint32_t join_window, uint8_t send_tolerance)
+{
+	m_join_window = join_window;
+	m_send_tolerance = send_tolerance > 50 ? 50 : send_tolerance;
+	m_jitter_widening = 1;
+}
+
+uint32_t lmh_uplink_delay(uint32_t period)
+{
+	uint32_t tolerance = m_send_tolerance * m_jitter_widening;
+	if (tolerance == 0)
+	{
+		return period;
+	}
+	if (tolerance > 50)
+	{
+		tolerance = 50;
+	}
+
+	// Half of the tolerance is a fixed drift of the node, the other half a random deviation per uplink
+	uint32_t window = (uint32_t)(((uint64_t)period * tolerance) / 100);
+	int32_t deviation = (int32_t)jitterRandom(window + 1) - (int32_t)(window / 2);
+	int32_t drift = (int32_t)(((int64_t)(window / 2) * m_jitter_drift) / 512);
+	return (uint32_t)((int64_t)period + drift + deviation);
+}
+
+lmh_error_status lmh_device_time_request(void)
+{
+	MlmeReq_t mlmeReq;
+	mlmeReq.Type = MLME_DEVICE_TIME;
+
+	if (LoRaMacMlmeRequest(&mlmeReq) != LORAMAC_STATUS_OK)
+	{
+		return LMH_ERROR;
+	}
+	return LMH_SUCCESS;
+}
+
+bool lmh_time_get(uint64_t *gps_time)
+{
+	if (!m_time_synced)
+	{
+		return false;
+	}
+	*gps_time = timeAt(TimerGetCurrentTime());
+	return true;
+}
+
+int32_t lmh_time_drift_get(void)
+{
+	return m_time_drift;
+}
+
+uint16_t lmh_slot_get(uint16_t slots)
+{
+	if (slots == 0)
+	{
+		return 0;
+	}
+	return lmh_getDevAddr() % slots;
+}
+
+uint32_t lmh_slot_delay(uint32_t period, uint16_t slot, uint16_t slots)
+{
+	if (!m_time_synced || (period == 0) || (slots == 0))
+	{
+		return lmh_uplink_delay(period);
+	}
+
+	uint32_t phase = timeAt(TimerGetCurrentTime()) % period;
+	uint32_t start = (uint32_t)(((uint64_t)period * (slot % slots)) / slots);
+	uint32_t delay = start >= phase ? start - phase : period - phase + start;
+
+	// Network time to local time
+	return (uint32_t)((int64_t)delay - ((int64_t)delay * m_time_drift) / 1000000000);
+}
+
+uint8_t lmh_getMaxPayload(void)
+{
+	LoRaMacTxInfo_t txInfo;
+	LoRaMacQueryTxPossible(0, &txInfo);
+	return txInfo.MaxPossiblePayload;
+}
+
 lmh_join_status lmh_join_status_get(void)
 {
 	MibRequestConfirm_t mibReq;
@@ -970,14 +1259,9 @@ lmh_error_status lmh_send(lmh_app_data_t *app_data, lmh_confirm is_tx_confirmed)
 
 	if (LoRaMacQueryTxPossible(app_data->buffsize, &txInfo) != LORAMAC_STATUS_OK)
 	{
-		LOG_LIB("LMH", "lmh_send -> LoRaMacQueryTxPossible failed");
-
-		// Send empty frame in order to flush MAC commands
-		mcpsReq.Type = MCPS_UNCONFIRMED;
-		mcpsReq.Req.Unconfirmed.fBuffer = NULL;
-		mcpsReq.Req.Unconfirmed.fBufferSize = 0;
-		mcpsReq.Req.Unconfirmed.Datarate = m_param.tx_data_rate;
-		// cannot send
+		// Pending MAC answers are held back by the MAC, only a payload above
+		// the max of the datarate fails, see lmh_getMaxPayload
+		LOG_LIB("LMH", "lmh_send -> payload %d exceeds max %d", app_data->buffsize, txInfo.CurrentPayloadSize);
 		return LMH_ERROR;
 	}
 	else
@@ -1012,11 +1296,27 @@ lmh_error_status lmh_send(lmh_app_data_t *app_data, lmh_confirm is_tx_confirmed)
 			mcpsReq.Req.Confirmed.Datarate = m_param.tx_data_rate;
 		}
 
-		if (LoRaMacMcpsRequest(&mcpsReq) == LORAMAC_STATUS_OK)
+		LoRaMacStatus_t status = LoRaMacMcpsRequest(&mcpsReq);
+		if (status == LORAMAC_STATUS_OK)
 		{
 			lmh_mac_is_busy = true;
 			return LMH_SUCCESS;
 		}
+		if (status == LORAMAC_STATUS_LENGTH_ERROR)
+		{
+			// MAC answers held too long, send them in a frame without payload, the data is sent by the next lmh_send
+			mcpsReq.Type = MCPS_UNCONFIRMED;
+			mcpsReq.Req.Unconfirmed.fPort = 0;
+			mcpsReq.Req.Unconfirmed.fBuffer = NULL;
+			mcpsReq.Req.Unconfirmed.fBufferSize = 0;
+			mcpsReq.Req.Unconfirmed.Datarate = m_param.tx_data_rate;
+			if (LoRaMacMcpsRequest(&mcpsReq) == LORAMAC_STATUS_OK)
+			{
+				LOG_LIB("LMH", "lmh_send -> flushing held MAC answers, payload not sent");
+				lmh_mac_is_busy = true;
+				return LMH_BUSY;
+			}
+		}
 		LOG_LIB("LMH", "lmh_send -> LoRaMacMcpsRequest failed");
 	}
 
@@ -1195,3 +1495,25 @@ void lmh_reset_mac(void)
 {
 	ResetMacCounters();
 }
+
+#if (LORAMAC_REGION_CONTEXTS > 0)
+/**
+ * @brief Switch to another region without a new join
+ *
+ * @param new_region region to switch to
+ * @return lmh_error_status LMH_SUCCESS if the region was switched
+ */
+lmh_error_status lmh_region_switch(LoRaMacRegion_t new_region)
+{
+	switch (LoRaMacRegionSwitch(new_region))
+	{
+	case LORAMAC_STATUS_OK:
+		region = new_region;
+		return LMH_SUCCESS;
+	case LORAMAC_STATUS_BUSY:
+		return LMH_BUSY;
+	default:
+		return LMH_ERROR;
+	}
+}
+#endif
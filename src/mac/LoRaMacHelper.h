@@ -36,6 +36,15 @@
 #define LORAWAN_APP_DATA_MAX_SIZE 242		/**< LoRaWAN User application data buffer size*/
 #define LORAWAN_DEFAULT_DATARATE DR_3		/**< LoRaWAN Default datarate*/
 #define LORAWAN_DEFAULT_TX_POWER TX_POWER_0 /**< LoRaWAN Default tx power*/
+#ifndef LMH_JITTER_MAX_WIDENING
+#define LMH_JITTER_MAX_WIDENING 8			/**< Max factor the desynchronization windows grow by after collisions */
+#endif
+#ifndef LMH_TIME_DRIFT_INTERVAL
+#define LMH_TIME_DRIFT_INTERVAL 600000		/**< Min time in ms between two network time syncs to estimate the clock drift */
+#endif
+#ifndef LMH_TIME_MAX_DRIFT
+#define LMH_TIME_MAX_DRIFT 500000			/**< Max drift of the local clock in ppb */
+#endif
 
 typedef struct lmh_param_s
 {
@@ -163,7 +172,9 @@ lmh_error_status lmh_init(lmh_callback_t *callbacks, lmh_param_t lora_param,
  * @param app_data Pointer to data structure to be sent
  * @param is_txconfirmed do we need confirmation?
  *
- * @retval error status
+ * @retval error status, LMH_BUSY if the MAC is busy or if it sends held MAC
+ *         answers without payload first, see lmh_getMaxPayload. The data is
+ *         not sent then and has to be sent again.
  */
 lmh_error_status lmh_send(lmh_app_data_t *app_data, lmh_confirm is_txconfirmed);
 
@@ -180,6 +191,87 @@ lmh_error_status lmh_send_blocking(lmh_app_data_t *app_data, lmh_confirm is_tx_c
  */
 void lmh_join(void);
 
+/**@brief Spread the joins and uplinks of nodes that start at the same time
+ * After a power outage a whole fleet boots together and joins and sends on
+ * the same schedule. With a join window, lmh_join() waits a random time up to
+ * the window before the join request. lmh_uplink_delay() spreads the periodic
+ * uplinks. Failed joins and unacknowledged confirmed uplinks double both
+ * windows up to LMH_JITTER_MAX_WIDENING, successful ones narrow them again.
+ * The random numbers are seeded in lmh_init() from the DevEUI, the board
+ * random seed and the radio. Disabled by default.
+ *
+ * @param join_window Max random delay in ms before a join request, 0 joins at once
+ * @param send_tolerance Max deviation of a periodic uplink from its period in percent, max 50
+ */
+void lmh_setUplinkJitter(uint32_t join_window, uint8_t send_tolerance);
+
+/**@brief Get the delay until the next periodic uplink
+ * Each node drifts by a fixed share of the tolerance and deviates randomly per uplink,
+ * so the phases of nodes with equal periods move apart.
+ *
+ * @param period Nominal period of the uplinks in ms
+ *
+ * @retval delay in ms for the application timer of the next uplink
+ */
+uint32_t lmh_uplink_delay(uint32_t period);
+
+/**@brief Request the network time with the next uplink
+ * The DeviceTimeReq MAC command is sent piggy-back with the next uplink. The
+ * answer sets the network time of the node. The offset and the drift of the
+ * local clock are tracked over the answers, request the time again at least
+ * once a day to keep the slots aligned.
+ *
+ * @retval LMH_ERROR if the request could not be queued
+ */
+lmh_error_status lmh_device_time_request(void);
+
+/**@brief Get the network time
+ *
+ * @param gps_time Milliseconds since the GPS epoch, 6 January 1980
+ *
+ * @retval false if the network time was never received
+ */
+bool lmh_time_get(uint64_t *gps_time);
+
+/**@brief Get the drift of the local clock against the network time
+ *
+ * @retval drift in ppb, positive if the local clock is slow
+ */
+int32_t lmh_time_drift_get(void);
+
+/**@brief Get the slot of the node for lmh_slot_delay()
+ * Network servers assign the device addresses mostly in sequence, the slot
+ * is the device address modulo the number of slots.
+ *
+ * @param slots Number of slots per period
+ *
+ * @retval slot [0..slots-1]
+ */
+uint16_t lmh_slot_get(uint16_t slots);
+
+/**@brief Get the delay until a slot of a period on the network time
+ * The periods are aligned to the GPS epoch, nodes that send in different slots
+ * of the same period do not collide. Without the network time the delay of
+ * lmh_uplink_delay() is returned.
+ *
+ * @param period Period of the uplinks in ms
+ * @param slot Slot to send in [0..slots-1]
+ * @param slots Number of slots per period
+ *
+ * @retval delay in ms of the local clock for the application timer of the uplink
+ */
+uint32_t lmh_slot_delay(uint32_t period, uint16_t slot, uint16_t slots);
+
+/**@brief Get the max application payload of the next uplink
+ * The size depends on the current datarate, less the MAC answers held back by
+ * the last uplink. A larger payload is still sent, but after
+ * LORAMAC_MAX_HELD_UPLINKS uplinks lmh_send() sends the held answers alone
+ * and returns LMH_BUSY. Larger data has to be split by the application.
+ *
+ * @retval max payload size in bytes
+ */
+uint8_t lmh_getMaxPayload(void);
+
 /**@brief Check whether the Device is joined to the network
  *
  * @retval returns LORAMACHELPER_SET if joined
@@ -316,4 +408,18 @@ uint8_t lmh_getConfRetries(void);
  */
 void lmh_reset_mac(void);
 
+#if (LORAMAC_REGION_CONTEXTS > 0)
+/**
+ * @brief Switch to another region without a new join
+ * The session of the current region is kept in a region context.
+ * If the new region has a saved context, its session is restored,
+ * otherwise lmh_join() has to be called after the switch.
+ * Only available if LORAMAC_REGION_CONTEXTS is above 0.
+ *
+ * \param new_region Region to switch to
+ * \retval LMH_SUCCESS if the region was switched, LMH_BUSY if the MAC is busy, LMH_ERROR otherwise
+ */
+lmh_error_status lmh_region_switch(LoRaMacRegion_t new_region);
+#endif
+
 #endif
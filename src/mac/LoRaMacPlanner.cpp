@@ -0,0 +1,289 @@
+/**
+ * @file LoRaMacPlanner.cpp
+ * @brief Airtime, duty cycle and battery lifetime planning of LoRaWAN uplink schedules
+ */
+#include <math.h>
+
+#include "mac/LoRaMacPlanner.h"
+#include "mac/region/Region.h"
+#include "mac/region/RegionCommon.h"
+#include "radio/sx126x/sx126x.h"
+
+/** Preamble length of the LoRaWAN frames in symbols */
+#define PLAN_PREAMBLE_LENGTH 8
+
+/** Size of a downlink without payload, MHDR(1) + FHDR(7) + MIC(4) */
+#define PLAN_ACK_SIZE 12
+
+/** Default MinRxSymbols and SystemMaxRxError of the MAC */
+#define PLAN_MIN_RX_SYMBOLS 6
+#define PLAN_MAX_RX_ERROR 10
+
+/** RX current of the SX126x with DCDC and LDO regulator in 0.1 mA */
+#define PLAN_RX_CURRENT_DCDC 46
+#define PLAN_RX_CURRENT_LDO 88
+
+/** Sleep current of the SX126x with warm start in nA */
+#define PLAN_SLEEP_CURRENT 1200
+
+/** Milliseconds per day */
+#define PLAN_DAY 86400000.0
+
+/** Region data of a datarate, shared by the schedules of a batch */
+typedef struct
+{
+	bool valid;
+	LoRaMacRegion_t region;
+	int8_t datarate;
+	uint8_t sf;
+	uint32_t bandwidth;
+	uint8_t max_payload;
+	double capacity;	 // Sum of the duty cycles of the usable bands
+	uint8_t bands;		 // Number of usable bands
+	uint16_t dcycle;	 // Lowest duty cycle divider of the usable bands
+	uint32_t rx1_time;	 // RX1 window without downlink in ms
+	uint32_t rx2_time;	 // RX2 window without downlink in ms
+	uint32_t ack_time;	 // RX1 window with an ACK in ms
+	uint32_t rx_delay2;	 // Delay of RX2 in ms
+	uint32_t ack_timeout; // Delay of a retry of a confirmed uplink in ms
+} plan_region_t;
+
+/**
+ * @brief Get a PHY parameter of a datarate
+ *
+ * @param region region
+ * @param attribute PHY attribute
+ * @param datarate datarate
+ * @return PhyParam_t value
+ */
+static PhyParam_t getPhy(LoRaMacRegion_t region, PhyAttribute_t attribute, int8_t datarate)
+{
+	GetPhyParams_t getPhy;
+	getPhy.Attribute = PHY_DEF_UPLINK_DWELL_TIME;
+	getPhy.UplinkDwellTime = RegionGetPhyParam(region, &getPhy).Value;
+	getPhy.DownlinkDwellTime = 0;
+	getPhy.Attribute = attribute;
+	getPhy.Datarate = datarate;
+	return RegionGetPhyParam(region, &getPhy);
+}
+
+/**
+ * @brief Time on air of a LoRaWAN frame
+ *
+ * @param sf spreading factor
+ * @param bandwidth bandwidth in Hz
+ * @param uplink uplinks have a payload CRC, downlinks not
+ * @param size frame size
+ * @return time on air in ms
+ */
+static uint32_t frameTime(uint8_t sf, uint32_t bandwidth, bool uplink, uint8_t size)
+{
+	// Low datarate optimization for symbols of 16.38 ms and longer, as Radio.SetTxConfig()
+	bool ldro = (((uint64_t)1000000 << sf) / bandwidth) >= 16380;
+	return SX126xGetLoRaTimeOnAir(sf, bandwidth, LORA_CR_4_5, ldro, PLAN_PREAMBLE_LENGTH, false, uplink, size);
+}
+
+/**
+ * @brief Time the radio listens in an RX window without downlink
+ *
+ * @param region region
+ * @param datarate datarate of the window
+ * @return time in ms
+ */
+static uint32_t windowTime(LoRaMacRegion_t region, int8_t datarate)
+{
+	RxConfigParams_t rxConfig;
+	double tSymbol;
+
+	RegionComputeRxWindowParameters(region, datarate, PLAN_MIN_RX_SYMBOLS, PLAN_MAX_RX_ERROR, &rxConfig);
+	uint8_t sf = getPhy(region, PHY_SF, rxConfig.Datarate).Value;
+	if ((sf < 5) || (sf > 12))
+	{ // FSK
+		tSymbol = RegionCommonComputeSymbolTimeFsk(sf);
+	}
+	else
+	{ // LoRa
+		tSymbol = RegionCommonComputeSymbolTimeLoRa(sf, getPhy(region, PHY_BANDWIDTH, rxConfig.Datarate).Value);
+	}
+	return (uint32_t)ceil(rxConfig.WindowTimeout * tSymbol) + RADIO_WAKEUP_TIME;
+}
+
+/**
+ * @brief Read the region data of the datarate of a schedule
+ *
+ * @param plan schedule
+ * @param data region data to fill
+ * @return LMH_PLAN_ERROR if the datarate can not be planned
+ */
+static lmh_plan_status planRegion(const lmh_plan_t *plan, plan_region_t *data)
+{
+	data->valid = false;
+	if (!RegionIsActive(plan->region))
+	{
+		return LMH_PLAN_ERROR;
+	}
+	// Bands of the default channels that support the datarate, from the region tables.
+	// Checked first, it keeps the datarate inside the datarate tables
+	uint32_t usedBands = 0;
+	if (plan->datarate >= (int8_t)getPhy(plan->region, PHY_MIN_TX_DR, 0).Value)
+	{
+		usedBands = getPhy(plan->region, PHY_DEF_DR_BANDS, plan->datarate).Value;
+	}
+	if (usedBands == 0)
+	{
+		return LMH_PLAN_ERROR;
+	}
+	data->sf = getPhy(plan->region, PHY_SF, plan->datarate).Value;
+	data->bandwidth = getPhy(plan->region, PHY_BANDWIDTH, plan->datarate).Value;
+	if ((data->sf < 5) || (data->sf > 12) || (data->bandwidth == 0))
+	{
+		return LMH_PLAN_ERROR;
+	}
+	data->max_payload = getPhy(plan->region, PHY_MAX_PAYLOAD, plan->datarate).Value;
+
+	// Duty cycle of the bands
+	GetPhyParams_t bandPhy = {PHY_DEF_BAND_DCYCLE, 0, 0, 0, 0};
+	data->capacity = 0;
+	data->bands = 0;
+	data->dcycle = UINT16_MAX;
+	for (uint8_t band = 0; band < 32; band++)
+	{
+		if ((usedBands & (1UL << band)) == 0)
+		{
+			continue;
+		}
+		bandPhy.Band = band;
+		uint16_t dcycle = RegionGetPhyParam(plan->region, &bandPhy).Value;
+		dcycle = dcycle > 0 ? dcycle : 1;
+		data->capacity += 1.0 / dcycle;
+		data->bands++;
+		if (dcycle < data->dcycle)
+		{
+			data->dcycle = dcycle;
+		}
+	}
+
+	int8_t rx1Dr = RegionApplyDrOffset(plan->region, getPhy(plan->region, PHY_DEF_DOWNLINK_DWELL_TIME, 0).Value,
+									   plan->datarate, getPhy(plan->region, PHY_DEF_DR1_OFFSET, 0).Value);
+	int8_t rx2Dr = getPhy(plan->region, PHY_DEF_RX2_DR, 0).Value;
+	data->rx1_time = windowTime(plan->region, rx1Dr);
+	data->rx2_time = windowTime(plan->region, rx2Dr);
+	data->ack_time = RADIO_WAKEUP_TIME + frameTime(getPhy(plan->region, PHY_SF, rx1Dr).Value,
+												   getPhy(plan->region, PHY_BANDWIDTH, rx1Dr).Value, false, PLAN_ACK_SIZE);
+	data->rx_delay2 = getPhy(plan->region, PHY_RECEIVE_DELAY2, 0).Value;
+	data->ack_timeout = getPhy(plan->region, PHY_ACK_TIMEOUT, 0).Value;
+
+	data->region = plan->region;
+	data->datarate = plan->datarate;
+	data->valid = true;
+	return LMH_PLAN_SUCCESS;
+}
+
+/**
+ * @brief Evaluate a schedule with the region data of its datarate
+ *
+ * @param plan schedule
+ * @param data region data
+ * @param result result to fill
+ * @return LMH_PLAN_ERROR if the payload does not fit
+ */
+static lmh_plan_status planSchedule(const lmh_plan_t *plan, const plan_region_t *data, lmh_plan_result_t *result)
+{
+	if ((plan->period == 0) || (plan->payload + plan->fopts > data->max_payload) || (plan->fopts > 15))
+	{
+		return LMH_PLAN_ERROR;
+	}
+	uint8_t nbTrans = plan->nb_trans > 0 ? plan->nb_trans : 1;
+	uint8_t size = PLAN_ACK_SIZE + plan->fopts + (plan->payload > 0 ? plan->payload + 1 : 0);
+
+	result->time_on_air = frameTime(data->sf, data->bandwidth, true, size);
+	result->rx_time = plan->confirmed ? data->ack_time : data->rx1_time + data->rx2_time;
+
+	// Transmissions without answer listen in both windows, the last try of a confirmed uplink gets the ACK
+	double txTime = (double)nbTrans * result->time_on_air;
+	double rxTime = (double)nbTrans * (data->rx1_time + data->rx2_time);
+	double cycle = nbTrans * ((double)result->time_on_air + data->rx_delay2 + data->rx2_time);
+	if (plan->confirmed)
+	{
+		rxTime += (double)data->ack_time - data->rx1_time - data->rx2_time;
+		cycle += (nbTrans - 1) * (double)data->ack_timeout;
+	}
+
+	result->airtime_hour = (uint32_t)(txTime * 3600000.0 / plan->period);
+	double duty = (txTime * 1000.0) / (plan->period * data->capacity);
+	result->duty_cycle = duty < UINT16_MAX ? (uint16_t)ceil(duty) : UINT16_MAX;
+	double minPeriod = txTime / data->capacity;
+	result->min_period = (uint32_t)ceil(minPeriod > cycle ? minPeriod : cycle);
+	result->next_tx = data->bands > 1 ? 0 : result->time_on_air * (data->dcycle - 1);
+
+	// TX current of the PA; the DCDC halves the current the regulator supplies, the HP PA of
+	// the SX1262 runs from the battery, the LP PA of the SX1261 from the regulator
+	uint8_t device = plan->chip == SX1261_CHIP ? SX1261 : SX1262;
+	double txCurrent = SX126xGetDeviceTxCurrent(device, plan->tx_power);
+	double rxCurrent = PLAN_RX_CURRENT_DCDC;
+	if (plan->use_ldo)
+	{
+		if (device == SX1261)
+		{
+			txCurrent = txCurrent * PLAN_RX_CURRENT_LDO / PLAN_RX_CURRENT_DCDC;
+		}
+		else
+		{
+			txCurrent += PLAN_RX_CURRENT_LDO - PLAN_RX_CURRENT_DCDC;
+		}
+		rxCurrent = PLAN_RX_CURRENT_LDO;
+	}
+
+	// Charge in 0.1 mA * ms, 36000 of it are one uAh
+	double uplinks = PLAN_DAY / plan->period;
+	double active = uplinks * (txTime + rxTime);
+	double charge = uplinks * (txTime * txCurrent + rxTime * rxCurrent) / 36000.0;
+	if (active < PLAN_DAY)
+	{
+		charge += (PLAN_DAY - active) * (PLAN_SLEEP_CURRENT / 1000.0 + plan->sleep_current) / 3600000.0;
+	}
+	result->charge_day = (uint32_t)ceil(charge);
+	result->lifetime = (plan->battery > 0) ? (uint32_t)((plan->battery * 1000.0) / charge) : 0;
+	return LMH_PLAN_SUCCESS;
+}
+
+lmh_plan_status lmh_plan_evaluate(const lmh_plan_t *plan, lmh_plan_result_t *result)
+{
+	plan_region_t data;
+
+	memset(result, 0, sizeof(lmh_plan_result_t));
+	if (planRegion(plan, &data) != LMH_PLAN_SUCCESS)
+	{
+		return LMH_PLAN_ERROR;
+	}
+	return planSchedule(plan, &data, result);
+}
+
+uint16_t lmh_plan_batch(const lmh_plan_t *plans, lmh_plan_result_t *results, uint16_t count)
+{
+	plan_region_t data;
+	uint16_t evaluated = 0;
+
+	data.valid = false;
+	for (uint16_t idx = 0; idx < count; idx++)
+	{
+		const lmh_plan_t *plan = &plans[idx];
+		memset(&results[idx], 0, sizeof(lmh_plan_result_t));
+		if (!data.valid || (data.region != plan->region) || (data.datarate != plan->datarate))
+		{
+			if (planRegion(plan, &data) != LMH_PLAN_SUCCESS)
+			{
+				continue;
+			}
+		}
+		if (planSchedule(plan, &data, &results[idx]) == LMH_PLAN_SUCCESS)
+		{
+			evaluated++;
+		}
+		else
+		{
+			memset(&results[idx], 0, sizeof(lmh_plan_result_t));
+		}
+	}
+	return evaluated;
+}
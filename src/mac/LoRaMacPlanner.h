@@ -0,0 +1,94 @@
+/**
+ * @file LoRaMacPlanner.h
+ * @brief Airtime, duty cycle and battery lifetime planning of LoRaWAN uplink schedules
+ *
+ * The planner evaluates a send schedule with the same time on air calculation
+ * as the radio, see SX126xGetLoRaTimeOnAir(), and the datarates, default
+ * channels and bands of the region tables. It needs no radio and neither reads
+ * nor changes the MAC state, so any active region can be planned, also before
+ * lmh_init() and on a host. Channels added or masked by the network are not
+ * included.
+ *
+ * For each schedule the planner computes
+ * - the time on air and the receive time of the RX windows of an uplink
+ * - the used share of the duty cycle of the bands the datarate can use
+ * - the shortest period that keeps the duty cycle
+ * - the charge per day of the SX126x and the board, and the battery lifetime
+ *
+ * The charge is based on the typical currents of the datasheet for the TX
+ * power, the chip type and the regulator mode. MCU activity besides sleep is
+ * not included.
+ *
+ * Usage:
+ * 1. fill a lmh_plan_t per schedule
+ * 2. lmh_plan_evaluate() for a single schedule or lmh_plan_batch() for a sweep
+ */
+#ifndef __LORAMACPLANNER_H__
+#define __LORAMACPLANNER_H__
+
+#include "stdint.h"
+#include "boards/mcu/board.h"
+#include "mac/LoRaMac.h"
+
+typedef enum
+{
+	LMH_PLAN_ERROR = -1,
+	LMH_PLAN_SUCCESS = 0
+} lmh_plan_status;
+
+/**@brief Uplink schedule to plan
+ */
+typedef struct lmh_plan_s
+{
+	LoRaMacRegion_t region;	/**< Region of the network */
+	int8_t datarate;		/**< Uplink datarate, LoRa datarates only */
+	int8_t tx_power;		/**< TX power in dBm */
+	uint8_t payload;		/**< Application payload size, 0 for frames without FPort */
+	uint8_t fopts;			/**< MAC command bytes piggybacked on an uplink */
+	uint32_t period;		/**< Uplink period in ms */
+	bool confirmed;			/**< Confirmed uplinks, the ACK is received in RX1 */
+	uint8_t nb_trans;		/**< Transmissions per uplink, NbTrans of unconfirmed or the expected tries of confirmed uplinks */
+	uint8_t chip;			/**< SX1261_CHIP or SX1262_CHIP */
+	bool use_ldo;			/**< SX126x uses the LDO instead of the DCDC regulator */
+	uint16_t sleep_current; /**< Sleep current of the board without the SX126x in uA */
+	uint16_t battery;		/**< Battery capacity in mAh, 0 skips the lifetime */
+} lmh_plan_t;
+
+/**@brief Result of a planned schedule
+ */
+typedef struct lmh_plan_result_s
+{
+	uint32_t time_on_air;  /**< Time on air of one transmission in ms */
+	uint32_t rx_time;	   /**< Receive time of the RX windows of one transmission in ms */
+	uint32_t airtime_hour; /**< Time on air per hour in ms */
+	uint16_t duty_cycle;   /**< Used share of the allowed airtime in per mille, above 1000 violates the duty cycle */
+	uint32_t min_period;   /**< Shortest period in ms that keeps the duty cycle */
+	uint32_t next_tx;	   /**< Time in ms after a transmission until the next one is allowed, 0 if another band is free */
+	uint32_t charge_day;   /**< Charge per day in uAh */
+	uint32_t lifetime;	   /**< Battery lifetime in days, 0 without battery */
+} lmh_plan_result_t;
+
+/**@brief Evaluate an uplink schedule
+ *
+ * @param plan Schedule to evaluate
+ * @param result Structure to fill with the result
+ *
+ * @retval LMH_PLAN_ERROR if the region is not active, the datarate is not an
+ * 			uplink LoRa datarate of a default channel or the payload is too long
+ */
+lmh_plan_status lmh_plan_evaluate(const lmh_plan_t *plan, lmh_plan_result_t *result);
+
+/**@brief Evaluate a batch of uplink schedules
+ * The schedules can be of different regions. The region data of a datarate is
+ * read again when the region or the datarate differs from the previous
+ * schedule, consecutive schedules with the same region and datarate share it.
+ *
+ * @param plans Schedules to evaluate
+ * @param results Results, a failed schedule gets a result with time_on_air 0
+ * @param count Number of schedules
+ *
+ * @retval number of schedules evaluated successfully
+ */
+uint16_t lmh_plan_batch(const lmh_plan_t *plans, lmh_plan_result_t *results, uint16_t count);
+
+#endif // __LORAMACPLANNER_H__
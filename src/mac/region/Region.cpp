@@ -422,73 +422,73 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #define AU915_IS_ACTIVE() \
 	AU915_CASE { return true; }
 #define AU915_GET_PHY_PARAM() \
-	AU915_CASE { return RegionAU915GetPhyParam(getPhy); }
-#define AU915_SET_BAND_TX_DONE()          \
-	AU915_CASE                            \
-	{                                     \
-		RegionAU915SetBandTxDone(txDone); \
-		break;                            \
-	}
-#define AU915_INIT_DEFAULTS()          \
-	AU915_CASE                         \
-	{                                  \
-		RegionAU915InitDefaults(type); \
-		break;                         \
+	AU915_CASE { return RegionFixedGetPhyParam(&RegionAU915Plan, getPhy); }
+#define AU915_SET_BAND_TX_DONE()                            \
+	AU915_CASE                                              \
+	{                                                       \
+		RegionFixedSetBandTxDone(&RegionAU915Plan, txDone); \
+		break;                                              \
+	}
+#define AU915_INIT_DEFAULTS()                            \
+	AU915_CASE                                           \
+	{                                                    \
+		RegionFixedInitDefaults(&RegionAU915Plan, type); \
+		break;                                           \
 	}
 #define AU915_VERIFY() \
-	AU915_CASE { return RegionAU915Verify(verify, phyAttribute); }
-#define AU915_APPLY_CF_LIST()                \
-	AU915_CASE                               \
-	{                                        \
-		RegionAU915ApplyCFList(applyCFList); \
-		break;                               \
+	AU915_CASE { return RegionFixedVerify(&RegionAU915Plan, verify, phyAttribute); }
+#define AU915_APPLY_CF_LIST()                                  \
+	AU915_CASE                                                 \
+	{                                                          \
+		RegionFixedApplyCFList(&RegionAU915Plan, applyCFList); \
+		break;                                                 \
 	}
 #define AU915_CHAN_MASK_SET() \
-	AU915_CASE { return RegionAU915ChanMaskSet(chanMaskSet); }
+	AU915_CASE { return RegionFixedChanMaskSet(&RegionAU915Plan, chanMaskSet); }
 #define AU915_ADR_NEXT() \
-	AU915_CASE { return RegionAU915AdrNext(adrNext, drOut, txPowOut, adrAckCounter); }
-#define AU915_COMPUTE_RX_WINDOW_PARAMETERS()                                                   \
-	AU915_CASE                                                                                 \
-	{                                                                                          \
-		RegionAU915ComputeRxWindowParameters(datarate, minRxSymbols, rxError, rxConfigParams); \
-		break;                                                                                 \
+	AU915_CASE { return RegionFixedAdrNext(&RegionAU915Plan, adrNext, drOut, txPowOut, adrAckCounter); }
+#define AU915_COMPUTE_RX_WINDOW_PARAMETERS()                                                                     \
+	AU915_CASE                                                                                                   \
+	{                                                                                                            \
+		RegionFixedComputeRxWindowParameters(&RegionAU915Plan, datarate, minRxSymbols, rxError, rxConfigParams); \
+		break;                                                                                                   \
 	}
 #define AU915_RX_CONFIG() \
-	AU915_CASE { return RegionAU915RxConfig(rxConfig, datarate); }
+	AU915_CASE { return RegionFixedRxConfig(&RegionAU915Plan, rxConfig, datarate); }
 #define AU915_TX_CONFIG() \
-	AU915_CASE { return RegionAU915TxConfig(txConfig, txPower, txTimeOnAir); }
+	AU915_CASE { return RegionFixedTxConfig(&RegionAU915Plan, txConfig, txPower, txTimeOnAir); }
 #define AU915_LINK_ADR_REQ() \
-	AU915_CASE { return RegionAU915LinkAdrReq(linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
+	AU915_CASE { return RegionFixedLinkAdrReq(&RegionAU915Plan, linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
 #define AU915_RX_PARAM_SETUP_REQ() \
-	AU915_CASE { return RegionAU915RxParamSetupReq(rxParamSetupReq); }
+	AU915_CASE { return RegionFixedRxParamSetupReq(&RegionAU915Plan, rxParamSetupReq); }
 #define AU915_NEW_CHANNEL_REQ() \
-	AU915_CASE { return RegionAU915NewChannelReq(newChannelReq); }
+	AU915_CASE { return RegionFixedNewChannelReq(&RegionAU915Plan, newChannelReq); }
 #define AU915_TX_PARAM_SETUP_REQ() \
-	AU915_CASE { return RegionAU915TxParamSetupReq(txParamSetupReq); }
+	AU915_CASE { return RegionFixedTxParamSetupReq(&RegionAU915Plan, txParamSetupReq); }
 #define AU915_DL_CHANNEL_REQ() \
-	AU915_CASE { return RegionAU915DlChannelReq(dlChannelReq); }
+	AU915_CASE { return RegionFixedDlChannelReq(&RegionAU915Plan, dlChannelReq); }
 #define AU915_ALTERNATE_DR() \
-	AU915_CASE { return RegionAU915AlternateDr(alternateDr); }
-#define AU915_CALC_BACKOFF()                 \
-	AU915_CASE                               \
-	{                                        \
-		RegionAU915CalcBackOff(calcBackOff); \
-		break;                               \
+	AU915_CASE { return RegionFixedAlternateDr(&RegionAU915Plan, alternateDr); }
+#define AU915_CALC_BACKOFF()                                   \
+	AU915_CASE                                                 \
+	{                                                          \
+		RegionFixedCalcBackOff(&RegionAU915Plan, calcBackOff); \
+		break;                                                 \
 	}
 #define AU915_NEXT_CHANNEL() \
-	AU915_CASE { return RegionAU915NextChannel(nextChanParams, channel, time, aggregatedTimeOff); }
+	AU915_CASE { return RegionFixedNextChannel(&RegionAU915Plan, nextChanParams, channel, time, aggregatedTimeOff); }
 #define AU915_CHANNEL_ADD() \
-	AU915_CASE { return RegionAU915ChannelAdd(channelAdd); }
+	AU915_CASE { return RegionFixedChannelAdd(&RegionAU915Plan, channelAdd); }
 #define AU915_CHANNEL_REMOVE() \
-	AU915_CASE { return RegionAU915ChannelsRemove(channelRemove); }
-#define AU915_SET_CONTINUOUS_WAVE()                   \
-	AU915_CASE                                        \
-	{                                                 \
-		RegionAU915SetContinuousWave(continuousWave); \
-		break;                                        \
+	AU915_CASE { return RegionFixedChannelsRemove(&RegionAU915Plan, channelRemove); }
+#define AU915_SET_CONTINUOUS_WAVE()                                     \
+	AU915_CASE                                                          \
+	{                                                                   \
+		RegionFixedSetContinuousWave(&RegionAU915Plan, continuousWave); \
+		break;                                                          \
 	}
 #define AU915_APPLY_DR_OFFSET() \
-	AU915_CASE { return RegionAU915ApplyDrOffset(downlinkDwellTime, dr, drOffset); }
+	AU915_CASE { return RegionFixedApplyDrOffset(&RegionAU915Plan, downlinkDwellTime, dr, drOffset); }
 #else
 #define AU915_IS_ACTIVE()
 #define AU915_GET_PHY_PARAM()
@@ -521,73 +521,73 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #define CN470_IS_ACTIVE() \
 	CN470_CASE { return true; }
 #define CN470_GET_PHY_PARAM() \
-	CN470_CASE { return RegionCN470GetPhyParam(getPhy); }
-#define CN470_SET_BAND_TX_DONE()          \
-	CN470_CASE                            \
-	{                                     \
-		RegionCN470SetBandTxDone(txDone); \
-		break;                            \
-	}
-#define CN470_INIT_DEFAULTS()          \
-	CN470_CASE                         \
-	{                                  \
-		RegionCN470InitDefaults(type); \
-		break;                         \
+	CN470_CASE { return RegionFixedGetPhyParam(&RegionCN470Plan, getPhy); }
+#define CN470_SET_BAND_TX_DONE()                            \
+	CN470_CASE                                              \
+	{                                                       \
+		RegionFixedSetBandTxDone(&RegionCN470Plan, txDone); \
+		break;                                              \
+	}
+#define CN470_INIT_DEFAULTS()                            \
+	CN470_CASE                                           \
+	{                                                    \
+		RegionFixedInitDefaults(&RegionCN470Plan, type); \
+		break;                                           \
 	}
 #define CN470_VERIFY() \
-	CN470_CASE { return RegionCN470Verify(verify, phyAttribute); }
-#define CN470_APPLY_CF_LIST()                \
-	CN470_CASE                               \
-	{                                        \
-		RegionCN470ApplyCFList(applyCFList); \
-		break;                               \
+	CN470_CASE { return RegionFixedVerify(&RegionCN470Plan, verify, phyAttribute); }
+#define CN470_APPLY_CF_LIST()                                  \
+	CN470_CASE                                                 \
+	{                                                          \
+		RegionFixedApplyCFList(&RegionCN470Plan, applyCFList); \
+		break;                                                 \
 	}
 #define CN470_CHAN_MASK_SET() \
-	CN470_CASE { return RegionCN470ChanMaskSet(chanMaskSet); }
+	CN470_CASE { return RegionFixedChanMaskSet(&RegionCN470Plan, chanMaskSet); }
 #define CN470_ADR_NEXT() \
-	CN470_CASE { return RegionCN470AdrNext(adrNext, drOut, txPowOut, adrAckCounter); }
-#define CN470_COMPUTE_RX_WINDOW_PARAMETERS()                                                   \
-	CN470_CASE                                                                                 \
-	{                                                                                          \
-		RegionCN470ComputeRxWindowParameters(datarate, minRxSymbols, rxError, rxConfigParams); \
-		break;                                                                                 \
+	CN470_CASE { return RegionFixedAdrNext(&RegionCN470Plan, adrNext, drOut, txPowOut, adrAckCounter); }
+#define CN470_COMPUTE_RX_WINDOW_PARAMETERS()                                                                     \
+	CN470_CASE                                                                                                   \
+	{                                                                                                            \
+		RegionFixedComputeRxWindowParameters(&RegionCN470Plan, datarate, minRxSymbols, rxError, rxConfigParams); \
+		break;                                                                                                   \
 	}
 #define CN470_RX_CONFIG() \
-	CN470_CASE { return RegionCN470RxConfig(rxConfig, datarate); }
+	CN470_CASE { return RegionFixedRxConfig(&RegionCN470Plan, rxConfig, datarate); }
 #define CN470_TX_CONFIG() \
-	CN470_CASE { return RegionCN470TxConfig(txConfig, txPower, txTimeOnAir); }
+	CN470_CASE { return RegionFixedTxConfig(&RegionCN470Plan, txConfig, txPower, txTimeOnAir); }
 #define CN470_LINK_ADR_REQ() \
-	CN470_CASE { return RegionCN470LinkAdrReq(linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
+	CN470_CASE { return RegionFixedLinkAdrReq(&RegionCN470Plan, linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
 #define CN470_RX_PARAM_SETUP_REQ() \
-	CN470_CASE { return RegionCN470RxParamSetupReq(rxParamSetupReq); }
+	CN470_CASE { return RegionFixedRxParamSetupReq(&RegionCN470Plan, rxParamSetupReq); }
 #define CN470_NEW_CHANNEL_REQ() \
-	CN470_CASE { return RegionCN470NewChannelReq(newChannelReq); }
+	CN470_CASE { return RegionFixedNewChannelReq(&RegionCN470Plan, newChannelReq); }
 #define CN470_TX_PARAM_SETUP_REQ() \
-	CN470_CASE { return RegionCN470TxParamSetupReq(txParamSetupReq); }
+	CN470_CASE { return RegionFixedTxParamSetupReq(&RegionCN470Plan, txParamSetupReq); }
 #define CN470_DL_CHANNEL_REQ() \
-	CN470_CASE { return RegionCN470DlChannelReq(dlChannelReq); }
+	CN470_CASE { return RegionFixedDlChannelReq(&RegionCN470Plan, dlChannelReq); }
 #define CN470_ALTERNATE_DR() \
-	CN470_CASE { return RegionCN470AlternateDr(alternateDr); }
-#define CN470_CALC_BACKOFF()                 \
-	CN470_CASE                               \
-	{                                        \
-		RegionCN470CalcBackOff(calcBackOff); \
-		break;                               \
+	CN470_CASE { return RegionFixedAlternateDr(&RegionCN470Plan, alternateDr); }
+#define CN470_CALC_BACKOFF()                                   \
+	CN470_CASE                                                 \
+	{                                                          \
+		RegionFixedCalcBackOff(&RegionCN470Plan, calcBackOff); \
+		break;                                                 \
 	}
 #define CN470_NEXT_CHANNEL() \
-	CN470_CASE { return RegionCN470NextChannel(nextChanParams, channel, time, aggregatedTimeOff); }
+	CN470_CASE { return RegionFixedNextChannel(&RegionCN470Plan, nextChanParams, channel, time, aggregatedTimeOff); }
 #define CN470_CHANNEL_ADD() \
-	CN470_CASE { return RegionCN470ChannelAdd(channelAdd); }
+	CN470_CASE { return RegionFixedChannelAdd(&RegionCN470Plan, channelAdd); }
 #define CN470_CHANNEL_REMOVE() \
-	CN470_CASE { return RegionCN470ChannelsRemove(channelRemove); }
-#define CN470_SET_CONTINUOUS_WAVE()                   \
-	CN470_CASE                                        \
-	{                                                 \
-		RegionCN470SetContinuousWave(continuousWave); \
-		break;                                        \
+	CN470_CASE { return RegionFixedChannelsRemove(&RegionCN470Plan, channelRemove); }
+#define CN470_SET_CONTINUOUS_WAVE()                                     \
+	CN470_CASE                                                          \
+	{                                                                   \
+		RegionFixedSetContinuousWave(&RegionCN470Plan, continuousWave); \
+		break;                                                          \
 	}
 #define CN470_APPLY_DR_OFFSET() \
-	CN470_CASE { return RegionCN470ApplyDrOffset(downlinkDwellTime, dr, drOffset); }
+	CN470_CASE { return RegionFixedApplyDrOffset(&RegionCN470Plan, downlinkDwellTime, dr, drOffset); }
 #else
 #define CN470_IS_ACTIVE()
 #define CN470_GET_PHY_PARAM()
@@ -620,73 +620,73 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #define CN779_IS_ACTIVE() \
 	CN779_CASE { return true; }
 #define CN779_GET_PHY_PARAM() \
-	CN779_CASE { return RegionCN779GetPhyParam(getPhy); }
-#define CN779_SET_BAND_TX_DONE()          \
-	CN779_CASE                            \
-	{                                     \
-		RegionCN779SetBandTxDone(txDone); \
-		break;                            \
-	}
-#define CN779_INIT_DEFAULTS()          \
-	CN779_CASE                         \
-	{                                  \
-		RegionCN779InitDefaults(type); \
-		break;                         \
+	CN779_CASE { return RegionDynamicGetPhyParam(&RegionCN779Plan, getPhy); }
+#define CN779_SET_BAND_TX_DONE()                              \
+	CN779_CASE                                                \
+	{                                                         \
+		RegionDynamicSetBandTxDone(&RegionCN779Plan, txDone); \
+		break;                                                \
+	}
+#define CN779_INIT_DEFAULTS()                              \
+	CN779_CASE                                             \
+	{                                                      \
+		RegionDynamicInitDefaults(&RegionCN779Plan, type); \
+		break;                                             \
 	}
 #define CN779_VERIFY() \
-	CN779_CASE { return RegionCN779Verify(verify, phyAttribute); }
-#define CN779_APPLY_CF_LIST()                \
-	CN779_CASE                               \
-	{                                        \
-		RegionCN779ApplyCFList(applyCFList); \
-		break;                               \
+	CN779_CASE { return RegionDynamicVerify(&RegionCN779Plan, verify, phyAttribute); }
+#define CN779_APPLY_CF_LIST()                                    \
+	CN779_CASE                                                   \
+	{                                                            \
+		RegionDynamicApplyCFList(&RegionCN779Plan, applyCFList); \
+		break;                                                   \
 	}
 #define CN779_CHAN_MASK_SET() \
-	CN779_CASE { return RegionCN779ChanMaskSet(chanMaskSet); }
+	CN779_CASE { return RegionDynamicChanMaskSet(&RegionCN779Plan, chanMaskSet); }
 #define CN779_ADR_NEXT() \
-	CN779_CASE { return RegionCN779AdrNext(adrNext, drOut, txPowOut, adrAckCounter); }
-#define CN779_COMPUTE_RX_WINDOW_PARAMETERS()                                                   \
-	CN779_CASE                                                                                 \
-	{                                                                                          \
-		RegionCN779ComputeRxWindowParameters(datarate, minRxSymbols, rxError, rxConfigParams); \
-		break;                                                                                 \
+	CN779_CASE { return RegionDynamicAdrNext(&RegionCN779Plan, adrNext, drOut, txPowOut, adrAckCounter); }
+#define CN779_COMPUTE_RX_WINDOW_PARAMETERS()                                                                       \
+	CN779_CASE                                                                                                     \
+	{                                                                                                              \
+		RegionDynamicComputeRxWindowParameters(&RegionCN779Plan, datarate, minRxSymbols, rxError, rxConfigParams); \
+		break;                                                                                                     \
 	}
 #define CN779_RX_CONFIG() \
-	CN779_CASE { return RegionCN779RxConfig(rxConfig, datarate); }
+	CN779_CASE { return RegionDynamicRxConfig(&RegionCN779Plan, rxConfig, datarate); }
 #define CN779_TX_CONFIG() \
-	CN779_CASE { return RegionCN779TxConfig(txConfig, txPower, txTimeOnAir); }
+	CN779_CASE { return RegionDynamicTxConfig(&RegionCN779Plan, txConfig, txPower, txTimeOnAir); }
 #define CN779_LINK_ADR_REQ() \
-	CN779_CASE { return RegionCN779LinkAdrReq(linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
+	CN779_CASE { return RegionDynamicLinkAdrReq(&RegionCN779Plan, linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
 #define CN779_RX_PARAM_SETUP_REQ() \
-	CN779_CASE { return RegionCN779RxParamSetupReq(rxParamSetupReq); }
+	CN779_CASE { return RegionDynamicRxParamSetupReq(&RegionCN779Plan, rxParamSetupReq); }
 #define CN779_NEW_CHANNEL_REQ() \
-	CN779_CASE { return RegionCN779NewChannelReq(newChannelReq); }
+	CN779_CASE { return RegionDynamicNewChannelReq(&RegionCN779Plan, newChannelReq); }
 #define CN779_TX_PARAM_SETUP_REQ() \
-	CN779_CASE { return RegionCN779TxParamSetupReq(txParamSetupReq); }
+	CN779_CASE { return RegionDynamicTxParamSetupReq(&RegionCN779Plan, txParamSetupReq); }
 #define CN779_DL_CHANNEL_REQ() \
-	CN779_CASE { return RegionCN779DlChannelReq(dlChannelReq); }
+	CN779_CASE { return RegionDynamicDlChannelReq(&RegionCN779Plan, dlChannelReq); }
 #define CN779_ALTERNATE_DR() \
-	CN779_CASE { return RegionCN779AlternateDr(alternateDr); }
-#define CN779_CALC_BACKOFF()                 \
-	CN779_CASE                               \
-	{                                        \
-		RegionCN779CalcBackOff(calcBackOff); \
-		break;                               \
+	CN779_CASE { return RegionDynamicAlternateDr(&RegionCN779Plan, alternateDr); }
+#define CN779_CALC_BACKOFF()                                     \
+	CN779_CASE                                                   \
+	{                                                            \
+		RegionDynamicCalcBackOff(&RegionCN779Plan, calcBackOff); \
+		break;                                                   \
 	}
 #define CN779_NEXT_CHANNEL() \
-	CN779_CASE { return RegionCN779NextChannel(nextChanParams, channel, time, aggregatedTimeOff); }
+	CN779_CASE { return RegionDynamicNextChannel(&RegionCN779Plan, nextChanParams, channel, time, aggregatedTimeOff); }
 #define CN779_CHANNEL_ADD() \
-	CN779_CASE { return RegionCN779ChannelAdd(channelAdd); }
+	CN779_CASE { return RegionDynamicChannelAdd(&RegionCN779Plan, channelAdd); }
 #define CN779_CHANNEL_REMOVE() \
-	CN779_CASE { return RegionCN779ChannelsRemove(channelRemove); }
-#define CN779_SET_CONTINUOUS_WAVE()                   \
-	CN779_CASE                                        \
-	{                                                 \
-		RegionCN779SetContinuousWave(continuousWave); \
-		break;                                        \
+	CN779_CASE { return RegionDynamicChannelsRemove(&RegionCN779Plan, channelRemove); }
+#define CN779_SET_CONTINUOUS_WAVE()                                       \
+	CN779_CASE                                                            \
+	{                                                                     \
+		RegionDynamicSetContinuousWave(&RegionCN779Plan, continuousWave); \
+		break;                                                            \
 	}
 #define CN779_APPLY_DR_OFFSET() \
-	CN779_CASE { return RegionCN779ApplyDrOffset(downlinkDwellTime, dr, drOffset); }
+	CN779_CASE { return RegionDynamicApplyDrOffset(&RegionCN779Plan, downlinkDwellTime, dr, drOffset); }
 #else
 #define CN779_IS_ACTIVE()
 #define CN779_GET_PHY_PARAM()
@@ -719,73 +719,73 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #define EU433_IS_ACTIVE() \
 	EU433_CASE { return true; }
 #define EU433_GET_PHY_PARAM() \
-	EU433_CASE { return RegionEU433GetPhyParam(getPhy); }
-#define EU433_SET_BAND_TX_DONE()          \
-	EU433_CASE                            \
-	{                                     \
-		RegionEU433SetBandTxDone(txDone); \
-		break;                            \
-	}
-#define EU433_INIT_DEFAULTS()          \
-	EU433_CASE                         \
-	{                                  \
-		RegionEU433InitDefaults(type); \
-		break;                         \
+	EU433_CASE { return RegionDynamicGetPhyParam(&RegionEU433Plan, getPhy); }
+#define EU433_SET_BAND_TX_DONE()                              \
+	EU433_CASE                                                \
+	{                                                         \
+		RegionDynamicSetBandTxDone(&RegionEU433Plan, txDone); \
+		break;                                                \
+	}
+#define EU433_INIT_DEFAULTS()                              \
+	EU433_CASE                                             \
+	{                                                      \
+		RegionDynamicInitDefaults(&RegionEU433Plan, type); \
+		break;                                             \
 	}
 #define EU433_VERIFY() \
-	EU433_CASE { return RegionEU433Verify(verify, phyAttribute); }
-#define EU433_APPLY_CF_LIST()                \
-	EU433_CASE                               \
-	{                                        \
-		RegionEU433ApplyCFList(applyCFList); \
-		break;                               \
+	EU433_CASE { return RegionDynamicVerify(&RegionEU433Plan, verify, phyAttribute); }
+#define EU433_APPLY_CF_LIST()                                    \
+	EU433_CASE                                                   \
+	{                                                            \
+		RegionDynamicApplyCFList(&RegionEU433Plan, applyCFList); \
+		break;                                                   \
 	}
 #define EU433_CHAN_MASK_SET() \
-	EU433_CASE { return RegionEU433ChanMaskSet(chanMaskSet); }
+	EU433_CASE { return RegionDynamicChanMaskSet(&RegionEU433Plan, chanMaskSet); }
 #define EU433_ADR_NEXT() \
-	EU433_CASE { return RegionEU433AdrNext(adrNext, drOut, txPowOut, adrAckCounter); }
-#define EU433_COMPUTE_RX_WINDOW_PARAMETERS()                                                   \
-	EU433_CASE                                                                                 \
-	{                                                                                          \
-		RegionEU433ComputeRxWindowParameters(datarate, minRxSymbols, rxError, rxConfigParams); \
-		break;                                                                                 \
+	EU433_CASE { return RegionDynamicAdrNext(&RegionEU433Plan, adrNext, drOut, txPowOut, adrAckCounter); }
+#define EU433_COMPUTE_RX_WINDOW_PARAMETERS()                                                                       \
+	EU433_CASE                                                                                                     \
+	{                                                                                                              \
+		RegionDynamicComputeRxWindowParameters(&RegionEU433Plan, datarate, minRxSymbols, rxError, rxConfigParams); \
+		break;                                                                                                     \
 	}
 #define EU433_RX_CONFIG() \
-	EU433_CASE { return RegionEU433RxConfig(rxConfig, datarate); }
+	EU433_CASE { return RegionDynamicRxConfig(&RegionEU433Plan, rxConfig, datarate); }
 #define EU433_TX_CONFIG() \
-	EU433_CASE { return RegionEU433TxConfig(txConfig, txPower, txTimeOnAir); }
+	EU433_CASE { return RegionDynamicTxConfig(&RegionEU433Plan, txConfig, txPower, txTimeOnAir); }
 #define EU433_LINK_ADR_REQ() \
-	EU433_CASE { return RegionEU433LinkAdrReq(linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
+	EU433_CASE { return RegionDynamicLinkAdrReq(&RegionEU433Plan, linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
 #define EU433_RX_PARAM_SETUP_REQ() \
-	EU433_CASE { return RegionEU433RxParamSetupReq(rxParamSetupReq); }
+	EU433_CASE { return RegionDynamicRxParamSetupReq(&RegionEU433Plan, rxParamSetupReq); }
 #define EU433_NEW_CHANNEL_REQ() \
-	EU433_CASE { return RegionEU433NewChannelReq(newChannelReq); }
+	EU433_CASE { return RegionDynamicNewChannelReq(&RegionEU433Plan, newChannelReq); }
 #define EU433_TX_PARAM_SETUP_REQ() \
-	EU433_CASE { return RegionEU433TxParamSetupReq(txParamSetupReq); }
+	EU433_CASE { return RegionDynamicTxParamSetupReq(&RegionEU433Plan, txParamSetupReq); }
 #define EU433_DL_CHANNEL_REQ() \
-	EU433_CASE { return RegionEU433DlChannelReq(dlChannelReq); }
+	EU433_CASE { return RegionDynamicDlChannelReq(&RegionEU433Plan, dlChannelReq); }
 #define EU433_ALTERNATE_DR() \
-	EU433_CASE { return RegionEU433AlternateDr(alternateDr); }
-#define EU433_CALC_BACKOFF()                 \
-	EU433_CASE                               \
-	{                                        \
-		RegionEU433CalcBackOff(calcBackOff); \
-		break;                               \
+	EU433_CASE { return RegionDynamicAlternateDr(&RegionEU433Plan, alternateDr); }
+#define EU433_CALC_BACKOFF()                                     \
+	EU433_CASE                                                   \
+	{                                                            \
+		RegionDynamicCalcBackOff(&RegionEU433Plan, calcBackOff); \
+		break;                                                   \
 	}
 #define EU433_NEXT_CHANNEL() \
-	EU433_CASE { return RegionEU433NextChannel(nextChanParams, channel, time, aggregatedTimeOff); }
+	EU433_CASE { return RegionDynamicNextChannel(&RegionEU433Plan, nextChanParams, channel, time, aggregatedTimeOff); }
 #define EU433_CHANNEL_ADD() \
-	EU433_CASE { return RegionEU433ChannelAdd(channelAdd); }
+	EU433_CASE { return RegionDynamicChannelAdd(&RegionEU433Plan, channelAdd); }
 #define EU433_CHANNEL_REMOVE() \
-	EU433_CASE { return RegionEU433ChannelsRemove(channelRemove); }
-#define EU433_SET_CONTINUOUS_WAVE()                   \
-	EU433_CASE                                        \
-	{                                                 \
-		RegionEU433SetContinuousWave(continuousWave); \
-		break;                                        \
+	EU433_CASE { return RegionDynamicChannelsRemove(&RegionEU433Plan, channelRemove); }
+#define EU433_SET_CONTINUOUS_WAVE()                                       \
+	EU433_CASE                                                            \
+	{                                                                     \
+		RegionDynamicSetContinuousWave(&RegionEU433Plan, continuousWave); \
+		break;                                                            \
 	}
 #define EU433_APPLY_DR_OFFSET() \
-	EU433_CASE { return RegionEU433ApplyDrOffset(downlinkDwellTime, dr, drOffset); }
+	EU433_CASE { return RegionDynamicApplyDrOffset(&RegionEU433Plan, downlinkDwellTime, dr, drOffset); }
 #else
 #define EU433_IS_ACTIVE()
 #define EU433_GET_PHY_PARAM()
@@ -818,73 +818,73 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #define EU868_IS_ACTIVE() \
 	EU868_CASE { return true; }
 #define EU868_GET_PHY_PARAM() \
-	EU868_CASE { return RegionEU868GetPhyParam(getPhy); }
-#define EU868_SET_BAND_TX_DONE()          \
-	EU868_CASE                            \
-	{                                     \
-		RegionEU868SetBandTxDone(txDone); \
-		break;                            \
-	}
-#define EU868_INIT_DEFAULTS()          \
-	EU868_CASE                         \
-	{                                  \
-		RegionEU868InitDefaults(type); \
-		break;                         \
+	EU868_CASE { return RegionDynamicGetPhyParam(&RegionEU868Plan, getPhy); }
+#define EU868_SET_BAND_TX_DONE()                              \
+	EU868_CASE                                                \
+	{                                                         \
+		RegionDynamicSetBandTxDone(&RegionEU868Plan, txDone); \
+		break;                                                \
+	}
+#define EU868_INIT_DEFAULTS()                              \
+	EU868_CASE                                             \
+	{                                                      \
+		RegionDynamicInitDefaults(&RegionEU868Plan, type); \
+		break;                                             \
 	}
 #define EU868_VERIFY() \
-	EU868_CASE { return RegionEU868Verify(verify, phyAttribute); }
-#define EU868_APPLY_CF_LIST()                \
-	EU868_CASE                               \
-	{                                        \
-		RegionEU868ApplyCFList(applyCFList); \
-		break;                               \
+	EU868_CASE { return RegionDynamicVerify(&RegionEU868Plan, verify, phyAttribute); }
+#define EU868_APPLY_CF_LIST()                                    \
+	EU868_CASE                                                   \
+	{                                                            \
+		RegionDynamicApplyCFList(&RegionEU868Plan, applyCFList); \
+		break;                                                   \
 	}
 #define EU868_CHAN_MASK_SET() \
-	EU868_CASE { return RegionEU868ChanMaskSet(chanMaskSet); }
+	EU868_CASE { return RegionDynamicChanMaskSet(&RegionEU868Plan, chanMaskSet); }
 #define EU868_ADR_NEXT() \
-	EU868_CASE { return RegionEU868AdrNext(adrNext, drOut, txPowOut, adrAckCounter); }
-#define EU868_COMPUTE_RX_WINDOW_PARAMETERS()                                                   \
-	EU868_CASE                                                                                 \
-	{                                                                                          \
-		RegionEU868ComputeRxWindowParameters(datarate, minRxSymbols, rxError, rxConfigParams); \
-		break;                                                                                 \
+	EU868_CASE { return RegionDynamicAdrNext(&RegionEU868Plan, adrNext, drOut, txPowOut, adrAckCounter); }
+#define EU868_COMPUTE_RX_WINDOW_PARAMETERS()                                                                       \
+	EU868_CASE                                                                                                     \
+	{                                                                                                              \
+		RegionDynamicComputeRxWindowParameters(&RegionEU868Plan, datarate, minRxSymbols, rxError, rxConfigParams); \
+		break;                                                                                                     \
 	}
 #define EU868_RX_CONFIG() \
-	EU868_CASE { return RegionEU868RxConfig(rxConfig, datarate); }
+	EU868_CASE { return RegionDynamicRxConfig(&RegionEU868Plan, rxConfig, datarate); }
 #define EU868_TX_CONFIG() \
-	EU868_CASE { return RegionEU868TxConfig(txConfig, txPower, txTimeOnAir); }
+	EU868_CASE { return RegionDynamicTxConfig(&RegionEU868Plan, txConfig, txPower, txTimeOnAir); }
 #define EU868_LINK_ADR_REQ() \
-	EU868_CASE { return RegionEU868LinkAdrReq(linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
+	EU868_CASE { return RegionDynamicLinkAdrReq(&RegionEU868Plan, linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
 #define EU868_RX_PARAM_SETUP_REQ() \
-	EU868_CASE { return RegionEU868RxParamSetupReq(rxParamSetupReq); }
+	EU868_CASE { return RegionDynamicRxParamSetupReq(&RegionEU868Plan, rxParamSetupReq); }
 #define EU868_NEW_CHANNEL_REQ() \
-	EU868_CASE { return RegionEU868NewChannelReq(newChannelReq); }
+	EU868_CASE { return RegionDynamicNewChannelReq(&RegionEU868Plan, newChannelReq); }
 #define EU868_TX_PARAM_SETUP_REQ() \
-	EU868_CASE { return RegionEU868TxParamSetupReq(txParamSetupReq); }
+	EU868_CASE { return RegionDynamicTxParamSetupReq(&RegionEU868Plan, txParamSetupReq); }
 #define EU868_DL_CHANNEL_REQ() \
-	EU868_CASE { return RegionEU868DlChannelReq(dlChannelReq); }
+	EU868_CASE { return RegionDynamicDlChannelReq(&RegionEU868Plan, dlChannelReq); }
 #define EU868_ALTERNATE_DR() \
-	EU868_CASE { return RegionEU868AlternateDr(alternateDr); }
-#define EU868_CALC_BACKOFF()                 \
-	EU868_CASE                               \
-	{                                        \
-		RegionEU868CalcBackOff(calcBackOff); \
-		break;                               \
+	EU868_CASE { return RegionDynamicAlternateDr(&RegionEU868Plan, alternateDr); }
+#define EU868_CALC_BACKOFF()                                     \
+	EU868_CASE                                                   \
+	{                                                            \
+		RegionDynamicCalcBackOff(&RegionEU868Plan, calcBackOff); \
+		break;                                                   \
 	}
 #define EU868_NEXT_CHANNEL() \
-	EU868_CASE { return RegionEU868NextChannel(nextChanParams, channel, time, aggregatedTimeOff); }
+	EU868_CASE { return RegionDynamicNextChannel(&RegionEU868Plan, nextChanParams, channel, time, aggregatedTimeOff); }
 #define EU868_CHANNEL_ADD() \
-	EU868_CASE { return RegionEU868ChannelAdd(channelAdd); }
+	EU868_CASE { return RegionDynamicChannelAdd(&RegionEU868Plan, channelAdd); }
 #define EU868_CHANNEL_REMOVE() \
-	EU868_CASE { return RegionEU868ChannelsRemove(channelRemove); }
-#define EU868_SET_CONTINUOUS_WAVE()                   \
-	EU868_CASE                                        \
-	{                                                 \
-		RegionEU868SetContinuousWave(continuousWave); \
-		break;                                        \
+	EU868_CASE { return RegionDynamicChannelsRemove(&RegionEU868Plan, channelRemove); }
+#define EU868_SET_CONTINUOUS_WAVE()                                       \
+	EU868_CASE                                                            \
+	{                                                                     \
+		RegionDynamicSetContinuousWave(&RegionEU868Plan, continuousWave); \
+		break;                                                            \
 	}
 #define EU868_APPLY_DR_OFFSET() \
-	EU868_CASE { return RegionEU868ApplyDrOffset(downlinkDwellTime, dr, drOffset); }
+	EU868_CASE { return RegionDynamicApplyDrOffset(&RegionEU868Plan, downlinkDwellTime, dr, drOffset); }
 #else
 #define EU868_IS_ACTIVE()
 #define EU868_GET_PHY_PARAM()
@@ -917,73 +917,73 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #define KR920_IS_ACTIVE() \
 	KR920_CASE { return true; }
 #define KR920_GET_PHY_PARAM() \
-	KR920_CASE { return RegionKR920GetPhyParam(getPhy); }
-#define KR920_SET_BAND_TX_DONE()          \
-	KR920_CASE                            \
-	{                                     \
-		RegionKR920SetBandTxDone(txDone); \
-		break;                            \
-	}
-#define KR920_INIT_DEFAULTS()          \
-	KR920_CASE                         \
-	{                                  \
-		RegionKR920InitDefaults(type); \
-		break;                         \
+	KR920_CASE { return RegionDynamicGetPhyParam(&RegionKR920Plan, getPhy); }
+#define KR920_SET_BAND_TX_DONE()                              \
+	KR920_CASE                                                \
+	{                                                         \
+		RegionDynamicSetBandTxDone(&RegionKR920Plan, txDone); \
+		break;                                                \
+	}
+#define KR920_INIT_DEFAULTS()                              \
+	KR920_CASE                                             \
+	{                                                      \
+		RegionDynamicInitDefaults(&RegionKR920Plan, type); \
+		break;                                             \
 	}
 #define KR920_VERIFY() \
-	KR920_CASE { return RegionKR920Verify(verify, phyAttribute); }
-#define KR920_APPLY_CF_LIST()                \
-	KR920_CASE                               \
-	{                                        \
-		RegionKR920ApplyCFList(applyCFList); \
-		break;                               \
+	KR920_CASE { return RegionDynamicVerify(&RegionKR920Plan, verify, phyAttribute); }
+#define KR920_APPLY_CF_LIST()                                    \
+	KR920_CASE                                                   \
+	{                                                            \
+		RegionDynamicApplyCFList(&RegionKR920Plan, applyCFList); \
+		break;                                                   \
 	}
 #define KR920_CHAN_MASK_SET() \
-	KR920_CASE { return RegionKR920ChanMaskSet(chanMaskSet); }
+	KR920_CASE { return RegionDynamicChanMaskSet(&RegionKR920Plan, chanMaskSet); }
 #define KR920_ADR_NEXT() \
-	KR920_CASE { return RegionKR920AdrNext(adrNext, drOut, txPowOut, adrAckCounter); }
-#define KR920_COMPUTE_RX_WINDOW_PARAMETERS()                                                   \
-	KR920_CASE                                                                                 \
-	{                                                                                          \
-		RegionKR920ComputeRxWindowParameters(datarate, minRxSymbols, rxError, rxConfigParams); \
-		break;                                                                                 \
+	KR920_CASE { return RegionDynamicAdrNext(&RegionKR920Plan, adrNext, drOut, txPowOut, adrAckCounter); }
+#define KR920_COMPUTE_RX_WINDOW_PARAMETERS()                                                                       \
+	KR920_CASE                                                                                                     \
+	{                                                                                                              \
+		RegionDynamicComputeRxWindowParameters(&RegionKR920Plan, datarate, minRxSymbols, rxError, rxConfigParams); \
+		break;                                                                                                     \
 	}
 #define KR920_RX_CONFIG() \
-	KR920_CASE { return RegionKR920RxConfig(rxConfig, datarate); }
+	KR920_CASE { return RegionDynamicRxConfig(&RegionKR920Plan, rxConfig, datarate); }
 #define KR920_TX_CONFIG() \
-	KR920_CASE { return RegionKR920TxConfig(txConfig, txPower, txTimeOnAir); }
+	KR920_CASE { return RegionDynamicTxConfig(&RegionKR920Plan, txConfig, txPower, txTimeOnAir); }
 #define KR920_LINK_ADR_REQ() \
-	KR920_CASE { return RegionKR920LinkAdrReq(linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
+	KR920_CASE { return RegionDynamicLinkAdrReq(&RegionKR920Plan, linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
 #define KR920_RX_PARAM_SETUP_REQ() \
-	KR920_CASE { return RegionKR920RxParamSetupReq(rxParamSetupReq); }
+	KR920_CASE { return RegionDynamicRxParamSetupReq(&RegionKR920Plan, rxParamSetupReq); }
 #define KR920_NEW_CHANNEL_REQ() \
-	KR920_CASE { return RegionKR920NewChannelReq(newChannelReq); }
+	KR920_CASE { return RegionDynamicNewChannelReq(&RegionKR920Plan, newChannelReq); }
 #define KR920_TX_PARAM_SETUP_REQ() \
-	KR920_CASE { return RegionKR920TxParamSetupReq(txParamSetupReq); }
+	KR920_CASE { return RegionDynamicTxParamSetupReq(&RegionKR920Plan, txParamSetupReq); }
 #define KR920_DL_CHANNEL_REQ() \
-	KR920_CASE { return RegionKR920DlChannelReq(dlChannelReq); }
+	KR920_CASE { return RegionDynamicDlChannelReq(&RegionKR920Plan, dlChannelReq); }
 #define KR920_ALTERNATE_DR() \
-	KR920_CASE { return RegionKR920AlternateDr(alternateDr); }
-#define KR920_CALC_BACKOFF()                 \
-	KR920_CASE                               \
-	{                                        \
-		RegionKR920CalcBackOff(calcBackOff); \
-		break;                               \
+	KR920_CASE { return RegionDynamicAlternateDr(&RegionKR920Plan, alternateDr); }
+#define KR920_CALC_BACKOFF()                                     \
+	KR920_CASE                                                   \
+	{                                                            \
+		RegionDynamicCalcBackOff(&RegionKR920Plan, calcBackOff); \
+		break;                                                   \
 	}
 #define KR920_NEXT_CHANNEL() \
-	KR920_CASE { return RegionKR920NextChannel(nextChanParams, channel, time, aggregatedTimeOff); }
+	KR920_CASE { return RegionDynamicNextChannel(&RegionKR920Plan, nextChanParams, channel, time, aggregatedTimeOff); }
 #define KR920_CHANNEL_ADD() \
-	KR920_CASE { return RegionKR920ChannelAdd(channelAdd); }
+	KR920_CASE { return RegionDynamicChannelAdd(&RegionKR920Plan, channelAdd); }
 #define KR920_CHANNEL_REMOVE() \
-	KR920_CASE { return RegionKR920ChannelsRemove(channelRemove); }
-#define KR920_SET_CONTINUOUS_WAVE()                   \
-	KR920_CASE                                        \
-	{                                                 \
-		RegionKR920SetContinuousWave(continuousWave); \
-		break;                                        \
+	KR920_CASE { return RegionDynamicChannelsRemove(&RegionKR920Plan, channelRemove); }
+#define KR920_SET_CONTINUOUS_WAVE()                                       \
+	KR920_CASE                                                            \
+	{                                                                     \
+		RegionDynamicSetContinuousWave(&RegionKR920Plan, continuousWave); \
+		break;                                                            \
 	}
 #define KR920_APPLY_DR_OFFSET() \
-	KR920_CASE { return RegionKR920ApplyDrOffset(downlinkDwellTime, dr, drOffset); }
+	KR920_CASE { return RegionDynamicApplyDrOffset(&RegionKR920Plan, downlinkDwellTime, dr, drOffset); }
 #else
 #define KR920_IS_ACTIVE()
 #define KR920_GET_PHY_PARAM()
@@ -1016,73 +1016,73 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #define IN865_IS_ACTIVE() \
 	IN865_CASE { return true; }
 #define IN865_GET_PHY_PARAM() \
-	IN865_CASE { return RegionIN865GetPhyParam(getPhy); }
-#define IN865_SET_BAND_TX_DONE()          \
-	IN865_CASE                            \
-	{                                     \
-		RegionIN865SetBandTxDone(txDone); \
-		break;                            \
-	}
-#define IN865_INIT_DEFAULTS()          \
-	IN865_CASE                         \
-	{                                  \
-		RegionIN865InitDefaults(type); \
-		break;                         \
+	IN865_CASE { return RegionDynamicGetPhyParam(&RegionIN865Plan, getPhy); }
+#define IN865_SET_BAND_TX_DONE()                              \
+	IN865_CASE                                                \
+	{                                                         \
+		RegionDynamicSetBandTxDone(&RegionIN865Plan, txDone); \
+		break;                                                \
+	}
+#define IN865_INIT_DEFAULTS()                              \
+	IN865_CASE                                             \
+	{                                                      \
+		RegionDynamicInitDefaults(&RegionIN865Plan, type); \
+		break;                                             \
 	}
 #define IN865_VERIFY() \
-	IN865_CASE { return RegionIN865Verify(verify, phyAttribute); }
-#define IN865_APPLY_CF_LIST()                \
-	IN865_CASE                               \
-	{                                        \
-		RegionIN865ApplyCFList(applyCFList); \
-		break;                               \
+	IN865_CASE { return RegionDynamicVerify(&RegionIN865Plan, verify, phyAttribute); }
+#define IN865_APPLY_CF_LIST()                                    \
+	IN865_CASE                                                   \
+	{                                                            \
+		RegionDynamicApplyCFList(&RegionIN865Plan, applyCFList); \
+		break;                                                   \
 	}
 #define IN865_CHAN_MASK_SET() \
-	IN865_CASE { return RegionIN865ChanMaskSet(chanMaskSet); }
+	IN865_CASE { return RegionDynamicChanMaskSet(&RegionIN865Plan, chanMaskSet); }
 #define IN865_ADR_NEXT() \
-	IN865_CASE { return RegionIN865AdrNext(adrNext, drOut, txPowOut, adrAckCounter); }
-#define IN865_COMPUTE_RX_WINDOW_PARAMETERS()                                                   \
-	IN865_CASE                                                                                 \
-	{                                                                                          \
-		RegionIN865ComputeRxWindowParameters(datarate, minRxSymbols, rxError, rxConfigParams); \
-		break;                                                                                 \
+	IN865_CASE { return RegionDynamicAdrNext(&RegionIN865Plan, adrNext, drOut, txPowOut, adrAckCounter); }
+#define IN865_COMPUTE_RX_WINDOW_PARAMETERS()                                                                       \
+	IN865_CASE                                                                                                     \
+	{                                                                                                              \
+		RegionDynamicComputeRxWindowParameters(&RegionIN865Plan, datarate, minRxSymbols, rxError, rxConfigParams); \
+		break;                                                                                                     \
 	}
 #define IN865_RX_CONFIG() \
-	IN865_CASE { return RegionIN865RxConfig(rxConfig, datarate); }
+	IN865_CASE { return RegionDynamicRxConfig(&RegionIN865Plan, rxConfig, datarate); }
 #define IN865_TX_CONFIG() \
-	IN865_CASE { return RegionIN865TxConfig(txConfig, txPower, txTimeOnAir); }
+	IN865_CASE { return RegionDynamicTxConfig(&RegionIN865Plan, txConfig, txPower, txTimeOnAir); }
 #define IN865_LINK_ADR_REQ() \
-	IN865_CASE { return RegionIN865LinkAdrReq(linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
+	IN865_CASE { return RegionDynamicLinkAdrReq(&RegionIN865Plan, linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
 #define IN865_RX_PARAM_SETUP_REQ() \
-	IN865_CASE { return RegionIN865RxParamSetupReq(rxParamSetupReq); }
+	IN865_CASE { return RegionDynamicRxParamSetupReq(&RegionIN865Plan, rxParamSetupReq); }
 #define IN865_NEW_CHANNEL_REQ() \
-	IN865_CASE { return RegionIN865NewChannelReq(newChannelReq); }
+	IN865_CASE { return RegionDynamicNewChannelReq(&RegionIN865Plan, newChannelReq); }
 #define IN865_TX_PARAM_SETUP_REQ() \
-	IN865_CASE { return RegionIN865TxParamSetupReq(txParamSetupReq); }
+	IN865_CASE { return RegionDynamicTxParamSetupReq(&RegionIN865Plan, txParamSetupReq); }
 #define IN865_DL_CHANNEL_REQ() \
-	IN865_CASE { return RegionIN865DlChannelReq(dlChannelReq); }
+	IN865_CASE { return RegionDynamicDlChannelReq(&RegionIN865Plan, dlChannelReq); }
 #define IN865_ALTERNATE_DR() \
-	IN865_CASE { return RegionIN865AlternateDr(alternateDr); }
-#define IN865_CALC_BACKOFF()                 \
-	IN865_CASE                               \
-	{                                        \
-		RegionIN865CalcBackOff(calcBackOff); \
-		break;                               \
+	IN865_CASE { return RegionDynamicAlternateDr(&RegionIN865Plan, alternateDr); }
+#define IN865_CALC_BACKOFF()                                     \
+	IN865_CASE                                                   \
+	{                                                            \
+		RegionDynamicCalcBackOff(&RegionIN865Plan, calcBackOff); \
+		break;                                                   \
 	}
 #define IN865_NEXT_CHANNEL() \
-	IN865_CASE { return RegionIN865NextChannel(nextChanParams, channel, time, aggregatedTimeOff); }
+	IN865_CASE { return RegionDynamicNextChannel(&RegionIN865Plan, nextChanParams, channel, time, aggregatedTimeOff); }
 #define IN865_CHANNEL_ADD() \
-	IN865_CASE { return RegionIN865ChannelAdd(channelAdd); }
+	IN865_CASE { return RegionDynamicChannelAdd(&RegionIN865Plan, channelAdd); }
 #define IN865_CHANNEL_REMOVE() \
-	IN865_CASE { return RegionIN865ChannelsRemove(channelRemove); }
-#define IN865_SET_CONTINUOUS_WAVE()                   \
-	IN865_CASE                                        \
-	{                                                 \
-		RegionIN865SetContinuousWave(continuousWave); \
-		break;                                        \
+	IN865_CASE { return RegionDynamicChannelsRemove(&RegionIN865Plan, channelRemove); }
+#define IN865_SET_CONTINUOUS_WAVE()                                       \
+	IN865_CASE                                                            \
+	{                                                                     \
+		RegionDynamicSetContinuousWave(&RegionIN865Plan, continuousWave); \
+		break;                                                            \
 	}
 #define IN865_APPLY_DR_OFFSET() \
-	IN865_CASE { return RegionIN865ApplyDrOffset(downlinkDwellTime, dr, drOffset); }
+	IN865_CASE { return RegionDynamicApplyDrOffset(&RegionIN865Plan, downlinkDwellTime, dr, drOffset); }
 #else
 #define IN865_IS_ACTIVE()
 #define IN865_GET_PHY_PARAM()
@@ -1115,73 +1115,73 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #define US915_IS_ACTIVE() \
 	US915_CASE { return true; }
 #define US915_GET_PHY_PARAM() \
-	US915_CASE { return RegionUS915GetPhyParam(getPhy); }
-#define US915_SET_BAND_TX_DONE()          \
-	US915_CASE                            \
-	{                                     \
-		RegionUS915SetBandTxDone(txDone); \
-		break;                            \
-	}
-#define US915_INIT_DEFAULTS()          \
-	US915_CASE                         \
-	{                                  \
-		RegionUS915InitDefaults(type); \
-		break;                         \
+	US915_CASE { return RegionFixedGetPhyParam(&RegionUS915Plan, getPhy); }
+#define US915_SET_BAND_TX_DONE()                            \
+	US915_CASE                                              \
+	{                                                       \
+		RegionFixedSetBandTxDone(&RegionUS915Plan, txDone); \
+		break;                                              \
+	}
+#define US915_INIT_DEFAULTS()                            \
+	US915_CASE                                           \
+	{                                                    \
+		RegionFixedInitDefaults(&RegionUS915Plan, type); \
+		break;                                           \
 	}
 #define US915_VERIFY() \
-	US915_CASE { return RegionUS915Verify(verify, phyAttribute); }
-#define US915_APPLY_CF_LIST()                \
-	US915_CASE                               \
-	{                                        \
-		RegionUS915ApplyCFList(applyCFList); \
-		break;                               \
+	US915_CASE { return RegionFixedVerify(&RegionUS915Plan, verify, phyAttribute); }
+#define US915_APPLY_CF_LIST()                                  \
+	US915_CASE                                                 \
+	{                                                          \
+		RegionFixedApplyCFList(&RegionUS915Plan, applyCFList); \
+		break;                                                 \
 	}
 #define US915_CHAN_MASK_SET() \
-	US915_CASE { return RegionUS915ChanMaskSet(chanMaskSet); }
+	US915_CASE { return RegionFixedChanMaskSet(&RegionUS915Plan, chanMaskSet); }
 #define US915_ADR_NEXT() \
-	US915_CASE { return RegionUS915AdrNext(adrNext, drOut, txPowOut, adrAckCounter); }
-#define US915_COMPUTE_RX_WINDOW_PARAMETERS()                                                   \
-	US915_CASE                                                                                 \
-	{                                                                                          \
-		RegionUS915ComputeRxWindowParameters(datarate, minRxSymbols, rxError, rxConfigParams); \
-		break;                                                                                 \
+	US915_CASE { return RegionFixedAdrNext(&RegionUS915Plan, adrNext, drOut, txPowOut, adrAckCounter); }
+#define US915_COMPUTE_RX_WINDOW_PARAMETERS()                                                                     \
+	US915_CASE                                                                                                   \
+	{                                                                                                            \
+		RegionFixedComputeRxWindowParameters(&RegionUS915Plan, datarate, minRxSymbols, rxError, rxConfigParams); \
+		break;                                                                                                   \
 	}
 #define US915_RX_CONFIG() \
-	US915_CASE { return RegionUS915RxConfig(rxConfig, datarate); }
+	US915_CASE { return RegionFixedRxConfig(&RegionUS915Plan, rxConfig, datarate); }
 #define US915_TX_CONFIG() \
-	US915_CASE { return RegionUS915TxConfig(txConfig, txPower, txTimeOnAir); }
+	US915_CASE { return RegionFixedTxConfig(&RegionUS915Plan, txConfig, txPower, txTimeOnAir); }
 #define US915_LINK_ADR_REQ() \
-	US915_CASE { return RegionUS915LinkAdrReq(linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
+	US915_CASE { return RegionFixedLinkAdrReq(&RegionUS915Plan, linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
 #define US915_RX_PARAM_SETUP_REQ() \
-	US915_CASE { return RegionUS915RxParamSetupReq(rxParamSetupReq); }
+	US915_CASE { return RegionFixedRxParamSetupReq(&RegionUS915Plan, rxParamSetupReq); }
 #define US915_NEW_CHANNEL_REQ() \
-	US915_CASE { return RegionUS915NewChannelReq(newChannelReq); }
+	US915_CASE { return RegionFixedNewChannelReq(&RegionUS915Plan, newChannelReq); }
 #define US915_TX_PARAM_SETUP_REQ() \
-	US915_CASE { return RegionUS915TxParamSetupReq(txParamSetupReq); }
+	US915_CASE { return RegionFixedTxParamSetupReq(&RegionUS915Plan, txParamSetupReq); }
 #define US915_DL_CHANNEL_REQ() \
-	US915_CASE { return RegionUS915DlChannelReq(dlChannelReq); }
+	US915_CASE { return RegionFixedDlChannelReq(&RegionUS915Plan, dlChannelReq); }
 #define US915_ALTERNATE_DR() \
-	US915_CASE { return RegionUS915AlternateDr(alternateDr); }
-#define US915_CALC_BACKOFF()                 \
-	US915_CASE                               \
-	{                                        \
-		RegionUS915CalcBackOff(calcBackOff); \
-		break;                               \
+	US915_CASE { return RegionFixedAlternateDr(&RegionUS915Plan, alternateDr); }
+#define US915_CALC_BACKOFF()                                   \
+	US915_CASE                                                 \
+	{                                                          \
+		RegionFixedCalcBackOff(&RegionUS915Plan, calcBackOff); \
+		break;                                                 \
 	}
 #define US915_NEXT_CHANNEL() \
-	US915_CASE { return RegionUS915NextChannel(nextChanParams, channel, time, aggregatedTimeOff); }
+	US915_CASE { return RegionFixedNextChannel(&RegionUS915Plan, nextChanParams, channel, time, aggregatedTimeOff); }
 #define US915_CHANNEL_ADD() \
-	US915_CASE { return RegionUS915ChannelAdd(channelAdd); }
+	US915_CASE { return RegionFixedChannelAdd(&RegionUS915Plan, channelAdd); }
 #define US915_CHANNEL_REMOVE() \
-	US915_CASE { return RegionUS915ChannelsRemove(channelRemove); }
-#define US915_SET_CONTINUOUS_WAVE()                   \
-	US915_CASE                                        \
-	{                                                 \
-		RegionUS915SetContinuousWave(continuousWave); \
-		break;                                        \
+	US915_CASE { return RegionFixedChannelsRemove(&RegionUS915Plan, channelRemove); }
+#define US915_SET_CONTINUOUS_WAVE()                                     \
+	US915_CASE                                                          \
+	{                                                                   \
+		RegionFixedSetContinuousWave(&RegionUS915Plan, continuousWave); \
+		break;                                                          \
 	}
 #define US915_APPLY_DR_OFFSET() \
-	US915_CASE { return RegionUS915ApplyDrOffset(downlinkDwellTime, dr, drOffset); }
+	US915_CASE { return RegionFixedApplyDrOffset(&RegionUS915Plan, downlinkDwellTime, dr, drOffset); }
 #else
 #define US915_IS_ACTIVE()
 #define US915_GET_PHY_PARAM()
@@ -1214,73 +1214,73 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #define RU864_IS_ACTIVE() \
 	RU864_CASE { return true; }
 #define RU864_GET_PHY_PARAM() \
-	RU864_CASE { return RegionRU864GetPhyParam(getPhy); }
-#define RU864_SET_BAND_TX_DONE()          \
-	RU864_CASE                            \
-	{                                     \
-		RegionRU864SetBandTxDone(txDone); \
-		break;                            \
-	}
-#define RU864_INIT_DEFAULTS()          \
-	RU864_CASE                         \
-	{                                  \
-		RegionRU864InitDefaults(type); \
-		break;                         \
+	RU864_CASE { return RegionDynamicGetPhyParam(&RegionRU864Plan, getPhy); }
+#define RU864_SET_BAND_TX_DONE()                              \
+	RU864_CASE                                                \
+	{                                                         \
+		RegionDynamicSetBandTxDone(&RegionRU864Plan, txDone); \
+		break;                                                \
+	}
+#define RU864_INIT_DEFAULTS()                              \
+	RU864_CASE                                             \
+	{                                                      \
+		RegionDynamicInitDefaults(&RegionRU864Plan, type); \
+		break;                                             \
 	}
 #define RU864_VERIFY() \
-	RU864_CASE { return RegionRU864Verify(verify, phyAttribute); }
-#define RU864_APPLY_CF_LIST()                \
-	RU864_CASE                               \
-	{                                        \
-		RegionRU864ApplyCFList(applyCFList); \
-		break;                               \
+	RU864_CASE { return RegionDynamicVerify(&RegionRU864Plan, verify, phyAttribute); }
+#define RU864_APPLY_CF_LIST()                                    \
+	RU864_CASE                                                   \
+	{                                                            \
+		RegionDynamicApplyCFList(&RegionRU864Plan, applyCFList); \
+		break;                                                   \
 	}
 #define RU864_CHAN_MASK_SET() \
-	RU864_CASE { return RegionRU864ChanMaskSet(chanMaskSet); }
+	RU864_CASE { return RegionDynamicChanMaskSet(&RegionRU864Plan, chanMaskSet); }
 #define RU864_ADR_NEXT() \
-	RU864_CASE { return RegionRU864AdrNext(adrNext, drOut, txPowOut, adrAckCounter); }
-#define RU864_COMPUTE_RX_WINDOW_PARAMETERS()                                                   \
-	RU864_CASE                                                                                 \
-	{                                                                                          \
-		RegionRU864ComputeRxWindowParameters(datarate, minRxSymbols, rxError, rxConfigParams); \
-		break;                                                                                 \
+	RU864_CASE { return RegionDynamicAdrNext(&RegionRU864Plan, adrNext, drOut, txPowOut, adrAckCounter); }
+#define RU864_COMPUTE_RX_WINDOW_PARAMETERS()                                                                       \
+	RU864_CASE                                                                                                     \
+	{                                                                                                              \
+		RegionDynamicComputeRxWindowParameters(&RegionRU864Plan, datarate, minRxSymbols, rxError, rxConfigParams); \
+		break;                                                                                                     \
 	}
 #define RU864_RX_CONFIG() \
-	RU864_CASE { return RegionRU864RxConfig(rxConfig, datarate); }
+	RU864_CASE { return RegionDynamicRxConfig(&RegionRU864Plan, rxConfig, datarate); }
 #define RU864_TX_CONFIG() \
-	RU864_CASE { return RegionRU864TxConfig(txConfig, txPower, txTimeOnAir); }
+	RU864_CASE { return RegionDynamicTxConfig(&RegionRU864Plan, txConfig, txPower, txTimeOnAir); }
 #define RU864_LINK_ADR_REQ() \
-	RU864_CASE { return RegionRU864LinkAdrReq(linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
+	RU864_CASE { return RegionDynamicLinkAdrReq(&RegionRU864Plan, linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed); }
 #define RU864_RX_PARAM_SETUP_REQ() \
-	RU864_CASE { return RegionRU864RxParamSetupReq(rxParamSetupReq); }
+	RU864_CASE { return RegionDynamicRxParamSetupReq(&RegionRU864Plan, rxParamSetupReq); }
 #define RU864_NEW_CHANNEL_REQ() \
-	RU864_CASE { return RegionRU864NewChannelReq(newChannelReq); }
+	RU864_CASE { return RegionDynamicNewChannelReq(&RegionRU864Plan, newChannelReq); }
 #define RU864_TX_PARAM_SETUP_REQ() \
-	RU864_CASE { return RegionRU864TxParamSetupReq(txParamSetupReq); }
+	RU864_CASE { return RegionDynamicTxParamSetupReq(&RegionRU864Plan, txParamSetupReq); }
 #define RU864_DL_CHANNEL_REQ() \
-	RU864_CASE { return RegionRU864DlChannelReq(dlChannelReq); }
+	RU864_CASE { return RegionDynamicDlChannelReq(&RegionRU864Plan, dlChannelReq); }
 #define RU864_ALTERNATE_DR() \
-	RU864_CASE { return RegionRU864AlternateDr(alternateDr); }
-#define RU864_CALC_BACKOFF()                 \
-	RU864_CASE                               \
-	{                                        \
-		RegionRU864CalcBackOff(calcBackOff); \
-		break;                               \
+	RU864_CASE { return RegionDynamicAlternateDr(&RegionRU864Plan, alternateDr); }
+#define RU864_CALC_BACKOFF()                                     \
+	RU864_CASE                                                   \
+	{                                                            \
+		RegionDynamicCalcBackOff(&RegionRU864Plan, calcBackOff); \
+		break;                                                   \
 	}
 #define RU864_NEXT_CHANNEL() \
-	RU864_CASE { return RegionRU864NextChannel(nextChanParams, channel, time, aggregatedTimeOff); }
+	RU864_CASE { return RegionDynamicNextChannel(&RegionRU864Plan, nextChanParams, channel, time, aggregatedTimeOff); }
 #define RU864_CHANNEL_ADD() \
-	RU864_CASE { return RegionRU864ChannelAdd(channelAdd); }
+	RU864_CASE { return RegionDynamicChannelAdd(&RegionRU864Plan, channelAdd); }
 #define RU864_CHANNEL_REMOVE() \
-	RU864_CASE { return RegionRU864ChannelsRemove(channelRemove); }
-#define RU864_SET_CONTINUOUS_WAVE()                   \
-	RU864_CASE                                        \
-	{                                                 \
-		RegionRU864SetContinuousWave(continuousWave); \
-		break;                                        \
+	RU864_CASE { return RegionDynamicChannelsRemove(&RegionRU864Plan, channelRemove); }
+#define RU864_SET_CONTINUOUS_WAVE()                                       \
+	RU864_CASE                                                            \
+	{                                                                     \
+		RegionDynamicSetContinuousWave(&RegionRU864Plan, continuousWave); \
+		break;                                                            \
 	}
 #define RU864_APPLY_DR_OFFSET() \
-	RU864_CASE { return RegionRU864ApplyDrOffset(downlinkDwellTime, dr, drOffset); }
+	RU864_CASE { return RegionDynamicApplyDrOffset(&RegionRU864Plan, downlinkDwellTime, dr, drOffset); }
 #else
 #define RU864_IS_ACTIVE()
 #define RU864_GET_PHY_PARAM()
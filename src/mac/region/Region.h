@@ -709,6 +709,14 @@ typedef enum ePhyAttribute
      */
 	PHY_CHANNELS,
 	/*!
+     * Maximum number of bands
+     */
+	PHY_MAX_NB_BANDS,
+	/*!
+     * Bands.
+     */
+	PHY_BANDS,
+	/*!
      * Default value of the uplink dwell time.
      */
 	PHY_DEF_UPLINK_DWELL_TIME,
@@ -735,7 +743,23 @@ typedef enum ePhyAttribute
 	/*!
      * Next lower datarate.
      */
-	PHY_NEXT_LOWER_TX_DR
+	PHY_NEXT_LOWER_TX_DR,
+	/*!
+     * Spreading factor of a datarate, 50 for FSK.
+     */
+	PHY_SF,
+	/*!
+     * Bandwidth of a datarate in Hz.
+     */
+	PHY_BANDWIDTH,
+	/*!
+     * Bands of the default channels that support a datarate, one bit per band.
+     */
+	PHY_DEF_DR_BANDS,
+	/*!
+     * Duty cycle of a band of the default band table.
+     */
+	PHY_DEF_BAND_DCYCLE
 } PhyAttribute_t;
 
 /*!
@@ -792,6 +816,10 @@ typedef union uPhyParam
      * Pointer to the channels.
      */
 	ChannelParams_t *Channels;
+	/*!
+     * Pointer to the bands.
+     */
+	Band_t *Bands;
 } PhyParam_t;
 
 /*!
@@ -806,7 +834,8 @@ typedef struct sGetPhyParams
 	/*!
      * Datarate.
      * The parameter is needed for the following queries:
-     * PHY_MAX_PAYLOAD, PHY_MAX_PAYLOAD_REPEATER, PHY_NEXT_LOWER_TX_DR.
+     * PHY_MAX_PAYLOAD, PHY_MAX_PAYLOAD_REPEATER, PHY_NEXT_LOWER_TX_DR,
+     * PHY_SF, PHY_BANDWIDTH, PHY_DEF_DR_BANDS.
      */
 	int8_t Datarate;
 	/*!
@@ -821,6 +850,12 @@ typedef struct sGetPhyParams
      * PHY_MIN_RX_DR, PHY_MAX_PAYLOAD, PHY_MAX_PAYLOAD_REPEATER.
      */
 	uint8_t DownlinkDwellTime;
+	/*!
+     * Band index.
+     * The parameter is needed for the following queries:
+     * PHY_DEF_BAND_DCYCLE.
+     */
+	uint8_t Band;
 } GetPhyParams_t;
 
 /*!
@@ -213,6 +213,38 @@ PhyParam_t RegionAS923GetPhyParam(GetPhyParams_t *getPhy)
 		}
 		break;
 	}
+	case PHY_SF:
+	{
+		phyParam.Value = DataratesAS923[getPhy->Datarate];
+		break;
+	}
+	case PHY_BANDWIDTH:
+	{
+		phyParam.Value = BandwidthsAS923[getPhy->Datarate];
+		break;
+	}
+	case PHY_DEF_DR_BANDS:
+	{
+		const ChannelParams_t defaultChannels[] = {AS923_LC1, AS923_LC2};
+		for (uint8_t i = 0; i < 2; i++)
+		{
+			if (RegionCommonValueInRange(getPhy->Datarate, defaultChannels[i].DrRange.Fields.Min,
+										 defaultChannels[i].DrRange.Fields.Max) == 1)
+			{
+				phyParam.Value |= 1UL << defaultChannels[i].Band;
+			}
+		}
+		break;
+	}
+	case PHY_DEF_BAND_DCYCLE:
+	{
+		const Band_t defaultBands[AS923_MAX_NB_BANDS] = {AS923_BAND0};
+		if (getPhy->Band < AS923_MAX_NB_BANDS)
+		{
+			phyParam.Value = defaultBands[getPhy->Band].DCycle;
+		}
+		break;
+	}
 	case PHY_DEF_TX_POWER:
 	{
 		phyParam.Value = AS923_DEFAULT_TX_POWER;
@@ -317,6 +349,16 @@ PhyParam_t RegionAS923GetPhyParam(GetPhyParams_t *getPhy)
 		phyParam.Channels = Channels;
 		break;
 	}
+	case PHY_MAX_NB_BANDS:
+	{
+		phyParam.Value = AS923_MAX_NB_BANDS;
+		break;
+	}
+	case PHY_BANDS:
+	{
+		phyParam.Bands = Bands;
+		break;
+	}
 	case PHY_DEF_UPLINK_DWELL_TIME:
 	{
 		phyParam.Value = AS923_DEFAULT_UPLINK_DWELL_TIME;
@@ -24,852 +24,82 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #include <stdbool.h>
 #include <string.h>
 #include <stdint.h>
-#include <math.h>
 
 #include "boards/mcu/board.h"
 #include "mac/LoRaMac.h"
 
-#include "system/utilities.h"
-
 #include "Region.h"
 #include "RegionCommon.h"
 #include "RegionAU915.h"
 
-// Definitions
-#define CHANNELS_MASK_SIZE 6
-
-// Global attributes
-/*!
- * LoRaMAC channels
- */
-static ChannelParams_t Channels[AU915_MAX_NB_CHANNELS];
-
 /*!
  * LoRaMac bands
  */
-static Band_t Bands[AU915_MAX_NB_BANDS] =
-	{
-		AU915_BAND0};
-
-/*!
- * LoRaMac channels mask
- */
-extern uint16_t ChannelsMask[6];
-
-/*!
- * LoRaMac channels remaining
- */
-extern uint16_t ChannelsMaskRemaining[];
-
-/*!
- * LoRaMac channels default mask
- */
-extern uint16_t ChannelsDefaultMask[];
-
-// Static functions
-static int8_t GetNextLowerTxDr(int8_t dr, int8_t minDr)
-{
-	uint8_t nextLowerDr = 0;
-
-	if (dr == minDr)
-	{
-		nextLowerDr = minDr;
-	}
-	else
-	{
-		nextLowerDr = dr - 1;
-	}
-	return nextLowerDr;
-}
-
-static uint32_t GetBandwidth(uint32_t drIndex)
-{
-	switch (BandwidthsAU915[drIndex])
-	{
-	default:
-	case 125000:
-		return 0;
-	case 250000:
-		return 1;
-	case 500000:
-		return 2;
-	}
-}
-
-static int8_t LimitTxPower(int8_t txPower, int8_t maxBandTxPower, int8_t datarate, uint16_t *channelsMask)
-{
-	int8_t txPowerResult = txPower;
-
-	// Limit tx power to the band max
-	txPowerResult = T_MAX(txPower, maxBandTxPower);
-
-	return txPowerResult;
-}
-
-static uint8_t CountNbOfEnabledChannels(uint8_t datarate, uint16_t *channelsMask, ChannelParams_t *channels, Band_t *bands, uint8_t *enabledChannels, uint8_t *delayTx)
-{
-	uint8_t nbEnabledChannels = 0;
-	uint8_t delayTransmission = 0;
-
-	for (uint8_t i = 0, k = 0; i < AU915_MAX_NB_CHANNELS; i += 16, k++)
-	{
-		for (uint8_t j = 0; j < 16; j++)
-		{
-			if ((channelsMask[k] & (1 << j)) != 0)
-			{
-				if (channels[i + j].Frequency == 0)
-				{ // Check if the channel is enabled
-					continue;
-				}
-				if (RegionCommonValueInRange(datarate, channels[i + j].DrRange.Fields.Min,
-											 channels[i + j].DrRange.Fields.Max) == false)
-				{ // Check if the current channel selection supports the given datarate
-					continue;
-				}
-				if (bands[channels[i + j].Band].TimeOff > 0)
-				{ // Check if the band is available for transmission
-					delayTransmission++;
-					continue;
-				}
-				enabledChannels[nbEnabledChannels++] = i + j;
-			}
-		}
-	}
-
-	*delayTx = delayTransmission;
-	return nbEnabledChannels;
-}
-
-PhyParam_t RegionAU915GetPhyParam(GetPhyParams_t *getPhy)
-{
-	PhyParam_t phyParam = {0};
-
-	switch (getPhy->Attribute)
-	{
-	case PHY_MIN_RX_DR:
-	{
-		phyParam.Value = AU915_RX_MIN_DATARATE;
-		break;
-	}
-	case PHY_MIN_TX_DR:
-	{
-		phyParam.Value = AU915_TX_MIN_DATARATE;
-		break;
-	}
-	case PHY_DEF_TX_DR:
-	{
-		phyParam.Value = AU915_DEFAULT_DATARATE;
-		break;
-	}
-	case PHY_NEXT_LOWER_TX_DR:
-	{
-		phyParam.Value = GetNextLowerTxDr(getPhy->Datarate, AU915_TX_MIN_DATARATE);
-		break;
-	}
-	case PHY_DEF_TX_POWER:
-	{
-		phyParam.Value = AU915_DEFAULT_TX_POWER;
-		break;
-	}
-	case PHY_MAX_PAYLOAD:
-	{
-		phyParam.Value = MaxPayloadOfDatarateAU915[getPhy->Datarate];
-		break;
-	}
-	case PHY_MAX_PAYLOAD_REPEATER:
-	{
-		phyParam.Value = MaxPayloadOfDatarateRepeaterAU915[getPhy->Datarate];
-		break;
-	}
-	case PHY_DUTY_CYCLE:
-	{
-		phyParam.Value = AU915_DUTY_CYCLE_ENABLED;
-		break;
-	}
-	case PHY_MAX_RX_WINDOW:
-	{
-		phyParam.Value = AU915_MAX_RX_WINDOW;
-		break;
-	}
-	case PHY_RECEIVE_DELAY1:
-	{
-		phyParam.Value = AU915_RECEIVE_DELAY1;
-		break;
-	}
-	case PHY_RECEIVE_DELAY2:
-	{
-		phyParam.Value = AU915_RECEIVE_DELAY2;
-		break;
-	}
-	case PHY_JOIN_ACCEPT_DELAY1:
-	{
-		phyParam.Value = AU915_JOIN_ACCEPT_DELAY1;
-		break;
-	}
-	case PHY_JOIN_ACCEPT_DELAY2:
-	{
-		phyParam.Value = AU915_JOIN_ACCEPT_DELAY2;
-		break;
-	}
-	case PHY_MAX_FCNT_GAP:
-	{
-		phyParam.Value = AU915_MAX_FCNT_GAP;
-		break;
-	}
-	case PHY_ACK_TIMEOUT:
-	{
-		phyParam.Value = (AU915_ACKTIMEOUT + randr(-AU915_ACK_TIMEOUT_RND, AU915_ACK_TIMEOUT_RND));
-		break;
-	}
-	case PHY_DEF_DR1_OFFSET:
-	{
-		phyParam.Value = AU915_DEFAULT_RX1_DR_OFFSET;
-		break;
-	}
-	case PHY_DEF_RX2_FREQUENCY:
-	{
-		phyParam.Value = AU915_RX_WND_2_FREQ;
-		break;
-	}
-	case PHY_DEF_RX2_DR:
-	{
-		phyParam.Value = AU915_RX_WND_2_DR;
-		break;
-	}
-	case PHY_CHANNELS_MASK:
-	{
-		phyParam.ChannelsMask = ChannelsMask;
-		break;
-	}
-	case PHY_CHANNELS_DEFAULT_MASK:
-	{
-		phyParam.ChannelsMask = ChannelsDefaultMask;
-		break;
-	}
-	case PHY_MAX_NB_CHANNELS:
-	{
-		phyParam.Value = AU915_MAX_NB_CHANNELS;
-		break;
-	}
-	case PHY_CHANNELS:
-	{
-		phyParam.Channels = Channels;
-		break;
-	}
-	case PHY_DEF_UPLINK_DWELL_TIME:
-	case PHY_DEF_DOWNLINK_DWELL_TIME:
-	{
-		phyParam.Value = 0;
-		break;
-	}
-	case PHY_DEF_MAX_EIRP:
-	{
-		phyParam.fValue = AU915_DEFAULT_MAX_EIRP;
-		break;
-	}
-	case PHY_DEF_ANTENNA_GAIN:
-	{
-		phyParam.fValue = AU915_DEFAULT_ANTENNA_GAIN;
-		break;
-	}
-	case PHY_NB_JOIN_TRIALS:
-	case PHY_DEF_NB_JOIN_TRIALS:
-	{
-		phyParam.Value = 2;
-		break;
-	}
-	default:
-	{
-		break;
-	}
-	}
-
-	return phyParam;
-}
-
-void RegionAU915SetBandTxDone(SetBandTxDoneParams_t *txDone)
-{
-	RegionCommonSetBandTxDone(txDone->Joined, &Bands[Channels[txDone->Channel].Band], txDone->LastTxDoneTime);
-}
-
-void RegionAU915InitDefaults(InitType_t type)
-{
-	switch (type)
-	{
-	case INIT_TYPE_INIT:
-	{
-		// Channels
-		// 125 kHz channels
-		for (uint8_t i = 0; i < AU915_MAX_NB_CHANNELS - 8; i++)
-		{
-			Channels[i].Frequency = 915200000 + i * 200000;
-			Channels[i].DrRange.Value = (DR_5 << 4) | DR_0;
-			Channels[i].Band = 0;
-		}
-		// 500 kHz channels
-		for (uint8_t i = AU915_MAX_NB_CHANNELS - 8; i < AU915_MAX_NB_CHANNELS; i++)
-		{
-			Channels[i].Frequency = 915900000 + (i - (AU915_MAX_NB_CHANNELS - 8)) * 1600000;
-			Channels[i].DrRange.Value = (DR_6 << 4) | DR_6;
-			Channels[i].Band = 0;
-		}
-
-		// Initialize channels default mask
-		ChannelsDefaultMask[0] = 0xFFFF;
-		ChannelsDefaultMask[1] = 0xFFFF;
-		ChannelsDefaultMask[2] = 0xFFFF;
-		ChannelsDefaultMask[3] = 0xFFFF;
-		ChannelsDefaultMask[4] = 0x00FF;
-		ChannelsDefaultMask[5] = 0x0000;
-
-		// Copy channels default mask
-		RegionCommonChanMaskCopy(ChannelsMask, ChannelsDefaultMask, 6);
-
-		// Copy into channels mask remaining
-		RegionCommonChanMaskCopy(ChannelsMaskRemaining, ChannelsMask, 6);
-		break;
-	}
-	case INIT_TYPE_RESTORE:
-	{
-		// Copy channels default mask
-		RegionCommonChanMaskCopy(ChannelsMask, ChannelsDefaultMask, 6);
-
-		for (uint8_t i = 0; i < 6; i++)
-		{ // Copy-And the channels mask
-			ChannelsMaskRemaining[i] &= ChannelsMask[i];
-		}
-		break;
-	}
-	case INIT_TYPE_APP_DEFAULTS:
-	{
-		// Copy channels default mask
-		RegionCommonChanMaskCopy(ChannelsMask, ChannelsDefaultMask, 6);
-
-		// Copy into channels mask remaining
-		RegionCommonChanMaskCopy(ChannelsMaskRemaining, ChannelsMask, 6);
-		break;
-	}
-	default:
-	{
-		break;
-	}
-	}
-}
-
-bool RegionAU915Verify(VerifyParams_t *verify, PhyAttribute_t phyAttribute)
-{
-	switch (phyAttribute)
-	{
-	case PHY_TX_DR:
-	case PHY_DEF_TX_DR:
-	{
-		return RegionCommonValueInRange(verify->DatarateParams.Datarate, AU915_TX_MIN_DATARATE, AU915_TX_MAX_DATARATE);
-	}
-	case PHY_RX_DR:
-	{
-		return RegionCommonValueInRange(verify->DatarateParams.Datarate, AU915_RX_MIN_DATARATE, AU915_RX_MAX_DATARATE);
-	}
-	case PHY_DEF_TX_POWER:
-	case PHY_TX_POWER:
-	{
-		// Remark: switched min and max!
-		return RegionCommonValueInRange(verify->TxPower, AU915_MAX_TX_POWER, AU915_MIN_TX_POWER);
-	}
-	case PHY_DUTY_CYCLE:
-	{
-		return AU915_DUTY_CYCLE_ENABLED;
-	}
-	case PHY_NB_JOIN_TRIALS:
-	{
-		if (verify->NbJoinTrials < 2)
-		{
-			return false;
-		}
-		break;
-	}
-	default:
-		return false;
-	}
-	return true;
-}
-
-void RegionAU915ApplyCFList(ApplyCFListParams_t *applyCFList)
-{
-	return;
-}
-
-bool RegionAU915ChanMaskSet(ChanMaskSetParams_t *chanMaskSet)
-{
-	uint8_t nbChannels = RegionCommonCountChannels(chanMaskSet->ChannelsMaskIn, 0, 4);
-
-	// Check the number of active channels
-	// According to ACMA regulation, we require at least 20 125KHz channels, if
-	// the node shall utilize 125KHz channels.
-	if ((nbChannels < 20) &&
-		(nbChannels > 0))
-	{
-		return false;
-	}
-
-	switch (chanMaskSet->ChannelsMaskType)
-	{
-	case CHANNELS_MASK:
-	{
-		RegionCommonChanMaskCopy(ChannelsMask, chanMaskSet->ChannelsMaskIn, 6);
-
-		for (uint8_t i = 0; i < 6; i++)
-		{ // Copy-And the channels mask
-			ChannelsMaskRemaining[i] &= ChannelsMask[i];
-		}
-		break;
-	}
-	case CHANNELS_DEFAULT_MASK:
-	{
-		RegionCommonChanMaskCopy(ChannelsDefaultMask, chanMaskSet->ChannelsMaskIn, 6);
-		break;
-	}
-	default:
-		return false;
-	}
-	return true;
-}
-
-bool RegionAU915AdrNext(AdrNextParams_t *adrNext, int8_t *drOut, int8_t *txPowOut, uint32_t *adrAckCounter)
-{
-	bool adrAckReq = false;
-	int8_t datarate = adrNext->Datarate;
-	int8_t txPower = adrNext->TxPower;
-	GetPhyParams_t getPhy;
-	PhyParam_t phyParam;
-
-	// Report back the adr ack counter
-	*adrAckCounter = adrNext->AdrAckCounter;
-
-	if (adrNext->AdrEnabled == true)
-	{
-		if (datarate == AU915_TX_MIN_DATARATE)
-		{
-			*adrAckCounter = 0;
-			adrAckReq = false;
-		}
-		else
-		{
-			if (adrNext->AdrAckCounter >= AU915_ADR_ACK_LIMIT)
-			{
-				adrAckReq = true;
-				txPower = AU915_MAX_TX_POWER;
-			}
-			else
-			{
-				adrAckReq = false;
-			}
-			if (adrNext->AdrAckCounter >= (AU915_ADR_ACK_LIMIT + AU915_ADR_ACK_DELAY))
-			{
-				if ((adrNext->AdrAckCounter % AU915_ADR_ACK_DELAY) == 1)
-				{
-					// Decrease the datarate
-					getPhy.Attribute = PHY_NEXT_LOWER_TX_DR;
-					getPhy.Datarate = datarate;
-					getPhy.UplinkDwellTime = adrNext->UplinkDwellTime;
-					phyParam = RegionAU915GetPhyParam(&getPhy);
-					datarate = phyParam.Value;
-
-					if (datarate == AU915_TX_MIN_DATARATE)
-					{
-						// We must set adrAckReq to false as soon as we reach the lowest datarate
-						adrAckReq = false;
-						if (adrNext->UpdateChanMask == true)
-						{
-							// Re-enable default channels
-							ChannelsMask[0] = 0xFFFF;
-							ChannelsMask[1] = 0xFFFF;
-							ChannelsMask[2] = 0xFFFF;
-							ChannelsMask[3] = 0xFFFF;
-							ChannelsMask[4] = 0x00FF;
-							ChannelsMask[5] = 0x0000;
-						}
-					}
-				}
-			}
-		}
-	}
-
-	*drOut = datarate;
-	*txPowOut = txPower;
-	return adrAckReq;
-}
-
-void RegionAU915ComputeRxWindowParameters(int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams)
-{
-	double tSymbol = 0.0;
-
-	// Get the datarate, perform a boundary check
-	rxConfigParams->Datarate = T_MIN(datarate, AU915_RX_MAX_DATARATE);
-	rxConfigParams->Bandwidth = GetBandwidth(rxConfigParams->Datarate);
-
-	tSymbol = RegionCommonComputeSymbolTimeLoRa(DataratesAU915[rxConfigParams->Datarate], BandwidthsAU915[rxConfigParams->Datarate]);
-
-	RegionCommonComputeRxWindowParameters(tSymbol, minRxSymbols, rxError, RADIO_WAKEUP_TIME, &rxConfigParams->WindowTimeout, &rxConfigParams->WindowOffset);
-}
-
-bool RegionAU915RxConfig(RxConfigParams_t *rxConfig, int8_t *datarate)
-{
-	int8_t dr = rxConfig->Datarate;
-	uint8_t maxPayload = 0;
-	int8_t phyDr = 0;
-	uint32_t frequency = rxConfig->Frequency;
-
-	if (Radio.GetStatus() != RF_IDLE)
-	{
-		return false;
-	}
-
-	if (rxConfig->Window == 0)
-	{
-		// Apply window 1 frequency
-		frequency = AU915_FIRST_RX1_CHANNEL + (rxConfig->Channel % 8) * AU915_STEPWIDTH_RX1_CHANNEL;
-	}
-
-	// Read the physical datarate from the datarates table
-	phyDr = DataratesAU915[dr];
-
-	Radio.SetChannel(frequency);
-
-	// Radio configuration
-	// Radio.SetRxConfig(MODEM_LORA, rxConfig->Bandwidth, phyDr, 1, 0, 8, rxConfig->WindowTimeout, false, 0, false, 0, 0, true, rxConfig->RxContinuous);
-	// RAKwireless symbTimeout changed after tests done by RAKwireless
-	Radio.SetRxConfig(MODEM_LORA, rxConfig->Bandwidth, phyDr, 1, 0, 8, 0, false, 0, false, 0, 0, true, rxConfig->RxContinuous);
-
-	if (rxConfig->RepeaterSupport == true)
-	{
-		maxPayload = MaxPayloadOfDatarateRepeaterAU915[dr];
-	}
-	else
-	{
-		maxPayload = MaxPayloadOfDatarateAU915[dr];
-	}
-	Radio.SetMaxPayloadLength(MODEM_LORA, maxPayload + LORA_MAC_FRMPAYLOAD_OVERHEAD);
-
-	*datarate = (uint8_t)dr;
-	return true;
-}
-
-bool RegionAU915TxConfig(TxConfigParams_t *txConfig, int8_t *txPower, TimerTime_t *txTimeOnAir)
-{
-	int8_t phyDr = DataratesAU915[txConfig->Datarate];
-	int8_t txPowerLimited = LimitTxPower(txConfig->TxPower, Bands[Channels[txConfig->Channel].Band].TxMaxPower, txConfig->Datarate, ChannelsMask);
-	uint32_t bandwidth = GetBandwidth(txConfig->Datarate);
-	int8_t phyTxPower = 0;
-
-	// Calculate physical TX power
-	phyTxPower = RegionCommonComputeTxPower(txPowerLimited, txConfig->MaxEirp, txConfig->AntennaGain);
-
-	// Setup the radio frequency
-	Radio.SetChannel(Channels[txConfig->Channel].Frequency);
-
-	Radio.SetTxConfig(MODEM_LORA, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000);
-
-	// Setup maximum payload lenght of the radio driver
-	Radio.SetMaxPayloadLength(MODEM_LORA, txConfig->PktLen);
-
-	*txTimeOnAir = Radio.TimeOnAir(MODEM_LORA, txConfig->PktLen);
-	*txPower = txPowerLimited;
-
-	return true;
-}
-
-uint8_t RegionAU915LinkAdrReq(LinkAdrReqParams_t *linkAdrReq, int8_t *drOut, int8_t *txPowOut, uint8_t *nbRepOut, uint8_t *nbBytesParsed)
-{
-	uint8_t status = 0x07;
-	RegionCommonLinkAdrParams_t linkAdrParams;
-	uint8_t nextIndex = 0;
-	uint8_t bytesProcessed = 0;
-	uint16_t channelsMask[6] = {0, 0, 0, 0, 0, 0};
-	GetPhyParams_t getPhy;
-	PhyParam_t phyParam;
-	RegionCommonLinkAdrReqVerifyParams_t linkAdrVerifyParams;
-
-	// Initialize local copy of channels mask
-	RegionCommonChanMaskCopy(channelsMask, ChannelsMask, 6);
-
-	while (bytesProcessed < linkAdrReq->PayloadSize)
-	{
-		nextIndex = RegionCommonParseLinkAdrReq(&(linkAdrReq->Payload[bytesProcessed]), &linkAdrParams);
-
-		if (nextIndex == 0)
-			break; // break loop, since no more request has been found
-
-		// Update bytes processed
-		bytesProcessed += nextIndex;
-
-		// Revert status, as we only check the last ADR request for the channel mask KO
-		status = 0x07;
-
-		if (linkAdrParams.ChMaskCtrl == 6)
-		{
-			// Enable all 125 kHz channels
-			channelsMask[0] = 0xFFFF;
-			channelsMask[1] = 0xFFFF;
-			channelsMask[2] = 0xFFFF;
-			channelsMask[3] = 0xFFFF;
-			// Apply chMask to channels 64 to 71
-			channelsMask[4] = linkAdrParams.ChMask;
-		}
-		else if (linkAdrParams.ChMaskCtrl == 7)
-		{
-			// Disable all 125 kHz channels
-			channelsMask[0] = 0x0000;
-			channelsMask[1] = 0x0000;
-			channelsMask[2] = 0x0000;
-			channelsMask[3] = 0x0000;
-			// Apply chMask to channels 64 to 71
-			channelsMask[4] = linkAdrParams.ChMask;
-		}
-		else if (linkAdrParams.ChMaskCtrl == 5)
-		{
-			// RFU
-			status &= 0xFE; // Channel mask KO
-		}
-		else
-		{
-			channelsMask[linkAdrParams.ChMaskCtrl] = linkAdrParams.ChMask;
-		}
-	}
-
-	// FCC 15.247 paragraph F mandates to hop on at least 2 125 kHz channels
-	if ((linkAdrParams.Datarate < DR_6) && (RegionCommonCountChannels(channelsMask, 0, 4) < 2))
-	{
-		status &= 0xFE; // Channel mask KO
-	}
-
-	// Get the minimum possible datarate
-	getPhy.Attribute = PHY_MIN_TX_DR;
-	getPhy.UplinkDwellTime = linkAdrReq->UplinkDwellTime;
-	phyParam = RegionAU915GetPhyParam(&getPhy);
-
-	linkAdrVerifyParams.Status = status;
-	linkAdrVerifyParams.AdrEnabled = linkAdrReq->AdrEnabled;
-	linkAdrVerifyParams.Datarate = linkAdrParams.Datarate;
-	linkAdrVerifyParams.TxPower = linkAdrParams.TxPower;
-	linkAdrVerifyParams.NbRep = linkAdrParams.NbRep;
-	linkAdrVerifyParams.CurrentDatarate = linkAdrReq->CurrentDatarate;
-	linkAdrVerifyParams.CurrentTxPower = linkAdrReq->CurrentTxPower;
-	linkAdrVerifyParams.CurrentNbRep = linkAdrReq->CurrentNbRep;
-	linkAdrVerifyParams.NbChannels = AU915_MAX_NB_CHANNELS;
-	linkAdrVerifyParams.ChannelsMask = channelsMask;
-	linkAdrVerifyParams.MinDatarate = (int8_t)phyParam.Value;
-	linkAdrVerifyParams.MaxDatarate = AU915_TX_MAX_DATARATE;
-	linkAdrVerifyParams.Channels = Channels;
-	linkAdrVerifyParams.MinTxPower = AU915_MIN_TX_POWER;
-	linkAdrVerifyParams.MaxTxPower = AU915_MAX_TX_POWER;
-
-	// Verify the parameters and update, if necessary
-	status = RegionCommonLinkAdrReqVerifyParams(&linkAdrVerifyParams, &linkAdrParams.Datarate, &linkAdrParams.TxPower, &linkAdrParams.NbRep);
-
-	// Update channelsMask if everything is correct
-	if (status == 0x07)
-	{
-		// Copy Mask
-		RegionCommonChanMaskCopy(ChannelsMask, channelsMask, 6);
-
-		ChannelsMaskRemaining[0] &= ChannelsMask[0];
-		ChannelsMaskRemaining[1] &= ChannelsMask[1];
-		ChannelsMaskRemaining[2] &= ChannelsMask[2];
-		ChannelsMaskRemaining[3] &= ChannelsMask[3];
-		ChannelsMaskRemaining[4] = ChannelsMask[4];
-		ChannelsMaskRemaining[5] = ChannelsMask[5];
-	}
-
-	// Update status variables
-	*drOut = linkAdrParams.Datarate;
-	*txPowOut = linkAdrParams.TxPower;
-	*nbRepOut = linkAdrParams.NbRep;
-	*nbBytesParsed = bytesProcessed;
-
-	return status;
-}
-
-uint8_t RegionAU915RxParamSetupReq(RxParamSetupReqParams_t *rxParamSetupReq)
-{
-	uint8_t status = 0x07;
-	uint32_t freq = rxParamSetupReq->Frequency;
-
-	// Verify radio frequency
-	if ((Radio.CheckRfFrequency(freq) == false) ||
-		(freq < AU915_FIRST_RX1_CHANNEL) ||
-		(freq > AU915_LAST_RX1_CHANNEL) ||
-		(((freq - (uint32_t)AU915_FIRST_RX1_CHANNEL) % (uint32_t)AU915_STEPWIDTH_RX1_CHANNEL) != 0))
-	{
-		status &= 0xFE; // Channel frequency KO
-	}
-
-	// Verify datarate
-	if (RegionCommonValueInRange(rxParamSetupReq->Datarate, AU915_RX_MIN_DATARATE, AU915_RX_MAX_DATARATE) == false)
-	{
-		status &= 0xFD; // Datarate KO
-	}
-	if ((rxParamSetupReq->Datarate == DR_7) ||
-		(rxParamSetupReq->Datarate > DR_13))
-	{
-		status &= 0xFD; // Datarate KO
-	}
-
-	// Verify datarate offset
-	if (RegionCommonValueInRange(rxParamSetupReq->DrOffset, AU915_MIN_RX1_DR_OFFSET, AU915_MAX_RX1_DR_OFFSET) == false)
-	{
-		status &= 0xFB; // Rx1DrOffset range KO
-	}
-
-	return status;
-}
-
-uint8_t RegionAU915NewChannelReq(NewChannelReqParams_t *newChannelReq)
-{
-	// Datarate and frequency KO
-	return 0;
-}
-
-int8_t RegionAU915TxParamSetupReq(TxParamSetupReqParams_t *txParamSetupReq)
-{
-	return -1;
-}
-
-uint8_t RegionAU915DlChannelReq(DlChannelReqParams_t *dlChannelReq)
-{
-	return 0;
-}
-
-int8_t RegionAU915AlternateDr(AlternateDrParams_t *alternateDr)
-{
-	static int8_t trialsCount = 0;
-	uint8_t currentDr = 0;
-
-	// Re-enable 500 kHz default channels
-	ChannelsMask[4] = 0x00FF;
-
-	if ((trialsCount & 0x01) == 0x01)
-	{
-		currentDr = DR_6;
-	}
-	else
-	{
-		currentDr = DR_2;
-	}
-	trialsCount++;
-	return currentDr;
-}
-
-void RegionAU915CalcBackOff(CalcBackOffParams_t *calcBackOff)
-{
-	RegionCommonCalcBackOffParams_t calcBackOffParams;
-
-	calcBackOffParams.Channels = Channels;
-	calcBackOffParams.Bands = Bands;
-	calcBackOffParams.LastTxIsJoinRequest = calcBackOff->LastTxIsJoinRequest;
-	calcBackOffParams.Joined = calcBackOff->Joined;
-	calcBackOffParams.DutyCycleEnabled = calcBackOff->DutyCycleEnabled;
-	calcBackOffParams.Channel = calcBackOff->Channel;
-	calcBackOffParams.ElapsedTime = calcBackOff->ElapsedTime;
-	calcBackOffParams.TxTimeOnAir = calcBackOff->TxTimeOnAir;
-
-	RegionCommonCalcBackOff(&calcBackOffParams);
-}
-
-bool RegionAU915NextChannel(NextChanParams_t *nextChanParams, uint8_t *channel, TimerTime_t *time, TimerTime_t *aggregatedTimeOff)
-{
-	uint8_t nbEnabledChannels = 0;
-	uint8_t delayTx = 0;
-	uint8_t enabledChannels[AU915_MAX_NB_CHANNELS] = {0};
-	TimerTime_t nextTxDelay = 0;
-
-	// Count 125kHz channels
-	if (RegionCommonCountChannels(ChannelsMaskRemaining, 0, 4) == 0)
-	{ // Reactivate default channels
-		RegionCommonChanMaskCopy(ChannelsMaskRemaining, ChannelsMask, 4);
-	}
-	// Check other channels
-	if (nextChanParams->Datarate >= DR_6)
-	{
-		if ((ChannelsMaskRemaining[4] & 0x00FF) == 0)
-		{
-			ChannelsMaskRemaining[4] = ChannelsMask[4];
-		}
-	}
-
-	if (nextChanParams->AggrTimeOff <= TimerGetElapsedTime(nextChanParams->LastAggrTx))
-	{
-		// Reset Aggregated time off
-		*aggregatedTimeOff = 0;
-
-		// Update bands Time OFF
-		nextTxDelay = RegionCommonUpdateBandTimeOff(nextChanParams->Joined, nextChanParams->DutyCycleEnabled, Bands, AU915_MAX_NB_BANDS);
-
-		// Search how many channels are enabled
-		nbEnabledChannels = CountNbOfEnabledChannels(nextChanParams->Datarate,
-													 ChannelsMaskRemaining, Channels,
-													 Bands, enabledChannels, &delayTx);
-	}
-	else
-	{
-		delayTx++;
-		nextTxDelay = nextChanParams->AggrTimeOff - TimerGetElapsedTime(nextChanParams->LastAggrTx);
-	}
-
-	if (nbEnabledChannels > 0)
-	{
-		// We found a valid channel
-		*channel = enabledChannels[randr(0, nbEnabledChannels - 1)];
-		// Disable the channel in the mask
-		RegionCommonChanDisable(ChannelsMaskRemaining, *channel, AU915_MAX_NB_CHANNELS - 8);
-
-		*time = 0;
-		return true;
-	}
-	else
-	{
-		if (delayTx > 0)
-		{
-			// Delay transmission due to AggregatedTimeOff or to a band time off
-			*time = nextTxDelay;
-			return true;
-		}
-		// Datarate not supported by any channel
-		*time = 0;
-		return false;
-	}
-}
-
-LoRaMacStatus_t RegionAU915ChannelAdd(ChannelAddParams_t *channelAdd)
-{
-	return LORAMAC_STATUS_PARAMETER_INVALID;
-}
-
-bool RegionAU915ChannelsRemove(ChannelRemoveParams_t *channelRemove)
-{
-	return false; // LORAMAC_STATUS_PARAMETER_INVALID;
-}
-
-void RegionAU915SetContinuousWave(ContinuousWaveParams_t *continuousWave)
-{
-	int8_t txPowerLimited = LimitTxPower(continuousWave->TxPower, Bands[Channels[continuousWave->Channel].Band].TxMaxPower, continuousWave->Datarate, ChannelsMask);
-	int8_t phyTxPower = 0;
-	uint32_t frequency = Channels[continuousWave->Channel].Frequency;
-
-	// Calculate physical TX power
-	phyTxPower = RegionCommonComputeTxPower(txPowerLimited, continuousWave->MaxEirp, continuousWave->AntennaGain);
-
-	Radio.SetTxContinuousWave(frequency, phyTxPower, continuousWave->Timeout);
-}
-
-uint8_t RegionAU915ApplyDrOffset(uint8_t downlinkDwellTime, int8_t dr, int8_t drOffset)
-{
-	int8_t datarate = DatarateOffsetsAU915[dr][drOffset];
-
-	if (datarate < 0)
-	{
-		datarate = DR_0;
-	}
-	return datarate;
-}
-
-#endif
\ No newline at end of file
+static const Band_t BandsAU915[AU915_MAX_NB_BANDS] =
+	{
+		AU915_BAND0,
+};
+
+const RegionFixedPlan_t RegionAU915Plan =
+	{
+		"AU915", // Name
+		AU915_MAX_NB_CHANNELS, // NbChannels
+		AU915_MAX_NB_CHANNELS - 8, // Nb125Channels
+		915200000, // Channel125Frequency
+		(DR_5 << 4) | DR_0, // Channel125DrRange
+		915900000, // Channel500Frequency
+		(DR_6 << 4) | DR_6, // Channel500DrRange
+		DR_6, // Datarate500
+		{0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x00FF, 0x0000}, // DefaultChannelsMask
+		true, // UseChannelsMaskRemaining
+		20, // MinNb125Channels
+		2, // MinNbLinkAdrChannels
+		false, // LinkAdrChecksChannels
+		false, // FccTxPowerLimit
+		BandsAU915, // Bands
+		AU915_MAX_NB_BANDS, // NbBands
+		AU915_FIRST_RX1_CHANNEL, // FirstRx1Frequency
+		AU915_LAST_RX1_CHANNEL, // LastRx1Frequency
+		AU915_STEPWIDTH_RX1_CHANNEL, // Rx1Stepwidth
+		8, // NbRx1Channels
+		DataratesAU915, // Datarates
+		BandwidthsAU915, // Bandwidths
+		MaxPayloadOfDatarateAU915, // MaxPayload
+		MaxPayloadOfDatarateRepeaterAU915, // MaxPayloadRepeater
+		&DatarateOffsetsAU915[0][0], // DatarateOffsets
+		6, // NbRx1DrOffsets
+		(1 << DR_7), // RxRfuDatarates
+		AU915_TX_MIN_DATARATE, // TxMinDatarate
+		AU915_TX_MAX_DATARATE, // TxMaxDatarate
+		AU915_RX_MIN_DATARATE, // RxMinDatarate
+		AU915_RX_MAX_DATARATE, // RxMaxDatarate
+		AU915_DEFAULT_DATARATE, // DefaultDatarate
+		AU915_TX_MAX_DATARATE, // DefMaxDatarate
+		AU915_MIN_RX1_DR_OFFSET, // MinRx1DrOffset
+		AU915_MAX_RX1_DR_OFFSET, // MaxRx1DrOffset
+		AU915_DEFAULT_RX1_DR_OFFSET, // DefaultRx1DrOffset
+		AU915_MIN_TX_POWER, // MinTxPower
+		AU915_MAX_TX_POWER, // MaxTxPower
+		AU915_DEFAULT_TX_POWER, // DefaultTxPower
+		AU915_DEFAULT_MAX_EIRP, // DefaultMaxEirp
+		AU915_DEFAULT_ANTENNA_GAIN, // DefaultAntennaGain
+		0, // FixedMaxErp
+		AU915_ADR_ACK_LIMIT, // AdrAckLimit
+		AU915_ADR_ACK_DELAY, // AdrAckDelay
+		AU915_DUTY_CYCLE_ENABLED, // DutyCycleEnabled
+		AU915_MAX_RX_WINDOW, // MaxRxWindow
+		AU915_RECEIVE_DELAY1, // ReceiveDelay1
+		AU915_RECEIVE_DELAY2, // ReceiveDelay2
+		AU915_JOIN_ACCEPT_DELAY1, // JoinAcceptDelay1
+		AU915_JOIN_ACCEPT_DELAY2, // JoinAcceptDelay2
+		AU915_MAX_FCNT_GAP, // MaxFCntGap
+		AU915_ACKTIMEOUT, // AckTimeout
+		AU915_ACK_TIMEOUT_RND, // AckTimeoutRnd
+		AU915_RX_WND_2_FREQ, // Rx2Frequency
+		AU915_RX_WND_2_DR, // Rx2Datarate
+		4000, // TxTimeout
+		2, // NbJoinTrials
+		FIXED_JOIN_DR_ALTERNATE_500KHZ, // JoinDr
+};
+
+#endif
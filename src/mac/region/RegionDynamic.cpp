@@ -0,0 +1,1199 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+    (C)2013 Semtech
+ ___ _____ _   ___ _  _____ ___  ___  ___ ___
+/ __|_   _/_\ / __| |/ / __/ _ \| _ \/ __| __|
+\__ \ | |/ _ \ (__| ' <| _| (_) |   / (__| _|
+|___/ |_/_/ \_\___|_|\_\_| \___/|_|_\\___|___|
+embedded.connectivity.solutions===============
+
+Description: LoRa MAC dynamic channel plan implementation, shared by
+             EU868, EU433, CN779, IN865, KR920 and RU864
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+
+Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jaeckle ( STACKFORCE )
+*/
+#include "mac/Commissioning.h"
+
+#if defined(REGION_EU868) || defined(REGION_EU433) || defined(REGION_CN779) || defined(REGION_IN865) || defined(REGION_KR920) || defined(REGION_RU864)
+
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "boards/mcu/board.h"
+#include "mac/LoRaMac.h"
+
+#include "system/utilities.h"
+
+#include "Region.h"
+#include "RegionCommon.h"
+#include "RegionDynamic.h"
+
+// Definitions
+#define CHANNELS_MASK_SIZE 1
+
+// Global attributes
+/*!
+ * LoRaMAC channels, shared by all dynamic channel plans
+ */
+static ChannelParams_t Channels[DYNAMIC_MAX_NB_CHANNELS];
+
+/*!
+ * LoRaMac bands, shared by all dynamic channel plans
+ */
+static Band_t Bands[DYNAMIC_MAX_NB_BANDS];
+
+/*!
+ * Channel plan that owns the channels and bands
+ */
+static const RegionDynamicPlan_t *ActivePlan = NULL;
+
+/*!
+ * LoRaMac channels mask
+ */
+extern uint16_t ChannelsMask[6];
+
+/*!
+ * LoRaMac channels remaining
+ */
+extern uint16_t ChannelsMaskRemaining[];
+
+/*!
+ * LoRaMac channels default mask
+ */
+extern uint16_t ChannelsDefaultMask[];
+
+// Static functions
+static int8_t GetNextLowerTxDr(const RegionDynamicPlan_t *plan, int8_t dr, int8_t minDr)
+{
+	uint8_t nextLowerDr = 0;
+
+	if (dr == minDr)
+	{
+		nextLowerDr = minDr;
+	}
+	else
+	{
+		nextLowerDr = dr - 1;
+		if ((nextLowerDr == plan->RfuDatarate) && (nextLowerDr > minDr))
+		{
+			nextLowerDr--;
+		}
+	}
+	return nextLowerDr;
+}
+
+static uint32_t GetBandwidth(const RegionDynamicPlan_t *plan, uint32_t drIndex)
+{
+	switch (plan->Bandwidths[drIndex])
+	{
+	default:
+	case 125000:
+		return 0;
+	case 250000:
+		return 1;
+	case 500000:
+		return 2;
+	}
+}
+
+static int8_t LimitTxPower(int8_t txPower, int8_t maxBandTxPower)
+{
+	int8_t txPowerResult = txPower;
+
+	// Limit tx power to the band max
+	txPowerResult = T_MAX(txPower, maxBandTxPower);
+
+	return txPowerResult;
+}
+
+static float GetMaxEirp(const RegionDynamicPlan_t *plan, uint32_t freq, float maxEirp)
+{
+	if (plan->MaxEirpHighFreq == 0)
+	{
+		return maxEirp;
+	}
+	if (freq >= plan->MaxEirpHighFreq)
+	{
+		return T_MIN(maxEirp, plan->DefaultMaxEirp);
+	}
+	return T_MIN(maxEirp, plan->MaxEirpLow);
+}
+
+static bool VerifyTxFreq(const RegionDynamicPlan_t *plan, uint32_t freq, uint8_t *band)
+{
+	// Check radio driver support
+	if (Radio.CheckRfFrequency(freq) == false)
+	{
+		return false;
+	}
+
+	// Check frequency bands
+	for (uint8_t i = 0; i < plan->NbFreqRanges; i++)
+	{
+		if ((freq >= plan->FreqRanges[i].Min) && (freq <= plan->FreqRanges[i].Max))
+		{
+			if ((plan->FreqRaster != 0) && (((freq - plan->FreqRanges[i].Min) % plan->FreqRaster) != 0))
+			{
+				return false;
+			}
+			*band = plan->FreqRanges[i].Band;
+			return true;
+		}
+	}
+	return false;
+}
+
+static uint8_t CountNbOfEnabledChannels(const RegionDynamicPlan_t *plan, bool joined, uint8_t datarate, uint16_t *channelsMask, ChannelParams_t *channels, Band_t *bands, uint8_t *enabledChannels, uint8_t *delayTx)
+{
+	uint8_t nbEnabledChannels = 0;
+	uint8_t delayTransmission = 0;
+
+	for (uint8_t i = 0, k = 0; i < DYNAMIC_MAX_NB_CHANNELS; i += 16, k++)
+	{
+		for (uint8_t j = 0; j < 16; j++)
+		{
+			if ((channelsMask[k] & (1 << j)) != 0)
+			{
+				LOG_LIB(plan->Name, "Channel count ch# %d, freq %ld", i + j, channels[i + j].Frequency);
+				if (channels[i + j].Frequency == 0)
+				{ // Check if the channel is enabled
+					continue;
+				}
+				if (joined == false)
+				{
+					if ((plan->JoinChannels & (1 << j)) == 0)
+					{
+						continue;
+					}
+				}
+				if (RegionCommonValueInRange(datarate, channels[i + j].DrRange.Fields.Min,
+											 channels[i + j].DrRange.Fields.Max) == false)
+				{ // Check if the current channel selection supports the given datarate
+					continue;
+				}
+				if (bands[channels[i + j].Band].TimeOff > 0)
+				{ // Check if the band is available for transmission
+					delayTransmission++;
+					continue;
+				}
+				enabledChannels[nbEnabledChannels++] = i + j;
+				LOG_LIB(plan->Name, "Set channel %d, frequency %ld", nbEnabledChannels - 1, channels[i + j].Frequency);
+			}
+		}
+	}
+
+	*delayTx = delayTransmission;
+	return nbEnabledChannels;
+}
+
+PhyParam_t RegionDynamicGetPhyParam(const RegionDynamicPlan_t *plan, GetPhyParams_t *getPhy)
+{
+	PhyParam_t phyParam = {0};
+
+	switch (getPhy->Attribute)
+	{
+	case PHY_MIN_RX_DR:
+	{
+		phyParam.Value = plan->RxMinDatarate;
+		break;
+	}
+	case PHY_MIN_TX_DR:
+	{
+		phyParam.Value = plan->TxMinDatarate;
+		break;
+	}
+	case PHY_DEF_TX_DR:
+	{
+		phyParam.Value = plan->DefaultDatarate;
+		break;
+	}
+	case PHY_NEXT_LOWER_TX_DR:
+	{
+		phyParam.Value = GetNextLowerTxDr(plan, getPhy->Datarate, plan->TxMinDatarate);
+		break;
+	}
+	case PHY_SF:
+	{
+		phyParam.Value = plan->Datarates[getPhy->Datarate];
+		break;
+	}
+	case PHY_BANDWIDTH:
+	{
+		phyParam.Value = plan->Bandwidths[getPhy->Datarate];
+		break;
+	}
+	case PHY_DEF_DR_BANDS:
+	{
+		for (uint8_t i = 0; i < plan->NbInitChannels; i++)
+		{
+			if (((plan->DefaultChannelsMask & (1 << i)) != 0) &&
+				(RegionCommonValueInRange(getPhy->Datarate, plan->InitChannels[i].DrRange.Fields.Min,
+										  plan->InitChannels[i].DrRange.Fields.Max) == 1))
+			{
+				phyParam.Value |= 1UL << plan->InitChannels[i].Band;
+			}
+		}
+		break;
+	}
+	case PHY_DEF_BAND_DCYCLE:
+	{
+		if (getPhy->Band < plan->NbBands)
+		{
+			phyParam.Value = plan->Bands[getPhy->Band].DCycle;
+		}
+		break;
+	}
+	case PHY_DEF_TX_POWER:
+	{
+		phyParam.Value = plan->DefaultTxPower;
+		break;
+	}
+	case PHY_MAX_PAYLOAD:
+	{
+		phyParam.Value = plan->MaxPayload[getPhy->Datarate];
+		break;
+	}
+	case PHY_MAX_PAYLOAD_REPEATER:
+	{
+		phyParam.Value = plan->MaxPayloadRepeater[getPhy->Datarate];
+		break;
+	}
+	case PHY_DUTY_CYCLE:
+	{
+		phyParam.Value = plan->DutyCycleEnabled;
+		break;
+	}
+	case PHY_MAX_RX_WINDOW:
+	{
+		phyParam.Value = plan->MaxRxWindow;
+		break;
+	}
+	case PHY_RECEIVE_DELAY1:
+	{
+		phyParam.Value = plan->ReceiveDelay1;
+		break;
+	}
+	case PHY_RECEIVE_DELAY2:
+	{
+		phyParam.Value = plan->ReceiveDelay2;
+		break;
+	}
+	case PHY_JOIN_ACCEPT_DELAY1:
+	{
+		phyParam.Value = plan->JoinAcceptDelay1;
+		break;
+	}
+	case PHY_JOIN_ACCEPT_DELAY2:
+	{
+		phyParam.Value = plan->JoinAcceptDelay2;
+		break;
+	}
+	case PHY_MAX_FCNT_GAP:
+	{
+		phyParam.Value = plan->MaxFCntGap;
+		break;
+	}
+	case PHY_ACK_TIMEOUT:
+	{
+		phyParam.Value = (plan->AckTimeout + randr(-(int32_t)plan->AckTimeoutRnd, plan->AckTimeoutRnd));
+		break;
+	}
+	case PHY_DEF_DR1_OFFSET:
+	{
+		phyParam.Value = plan->DefaultRx1DrOffset;
+		break;
+	}
+	case PHY_DEF_RX2_FREQUENCY:
+	{
+		phyParam.Value = plan->Rx2Frequency;
+		break;
+	}
+	case PHY_DEF_RX2_DR:
+	{
+		phyParam.Value = plan->Rx2Datarate;
+		break;
+	}
+	case PHY_CHANNELS_MASK:
+	{
+		phyParam.ChannelsMask = ChannelsMask;
+		break;
+	}
+	case PHY_CHANNELS_DEFAULT_MASK:
+	{
+		phyParam.ChannelsMask = ChannelsDefaultMask;
+		break;
+	}
+	case PHY_MAX_NB_CHANNELS:
+	{
+		phyParam.Value = DYNAMIC_MAX_NB_CHANNELS;
+		break;
+	}
+	case PHY_CHANNELS:
+	{
+		phyParam.Channels = Channels;
+		break;
+	}
+	case PHY_MAX_NB_BANDS:
+	{
+		phyParam.Value = plan->NbBands;
+		break;
+	}
+	case PHY_BANDS:
+	{
+		phyParam.Bands = Bands;
+		break;
+	}
+	case PHY_DEF_UPLINK_DWELL_TIME:
+	case PHY_DEF_DOWNLINK_DWELL_TIME:
+	{
+		phyParam.Value = 0;
+		break;
+	}
+	case PHY_DEF_MAX_EIRP:
+	{
+		// For frequency dependent limits the higher maximum EIRP is the default value.
+		// The value is recalculated in the TX configuration for the selected channel.
+		phyParam.fValue = plan->DefaultMaxEirp;
+		break;
+	}
+	case PHY_DEF_ANTENNA_GAIN:
+	{
+		phyParam.fValue = plan->DefaultAntennaGain;
+		break;
+	}
+	case PHY_NB_JOIN_TRIALS:
+	case PHY_DEF_NB_JOIN_TRIALS:
+	{
+		phyParam.Value = plan->NbJoinTrials;
+		break;
+	}
+	default:
+	{
+		break;
+	}
+	}
+
+	return phyParam;
+}
+
+void RegionDynamicSetBandTxDone(const RegionDynamicPlan_t *plan, SetBandTxDoneParams_t *txDone)
+{
+	(void)plan;
+	RegionCommonSetBandTxDone(txDone->Joined, &Bands[Channels[txDone->Channel].Band], txDone->LastTxDoneTime);
+}
+
+void RegionDynamicInitDefaults(const RegionDynamicPlan_t *plan, InitType_t type)
+{
+	switch (type)
+	{
+	case INIT_TYPE_INIT:
+	{
+		if (ActivePlan != plan)
+		{
+			// The channels and bands of the previous region are not valid anymore
+			memset(Channels, 0, sizeof(Channels));
+			memset(Bands, 0, sizeof(Bands));
+			memcpy(Bands, plan->Bands, plan->NbBands * sizeof(Band_t));
+			ActivePlan = plan;
+		}
+
+		// Channels
+		for (uint8_t i = 0; i < plan->NbInitChannels; i++)
+		{
+			Channels[i] = plan->InitChannels[i];
+		}
+
+		// Initialize the channels default mask
+		ChannelsDefaultMask[0] = plan->DefaultChannelsMask;
+		// Update the channels mask
+		RegionCommonChanMaskCopy(ChannelsMask, ChannelsDefaultMask, CHANNELS_MASK_SIZE);
+		break;
+	}
+	case INIT_TYPE_RESTORE:
+	{
+		// Restore channels default mask
+		ChannelsMask[0] |= ChannelsDefaultMask[0];
+		break;
+	}
+	case INIT_TYPE_APP_DEFAULTS:
+	{
+		// Update the channels mask defaults
+		RegionCommonChanMaskCopy(ChannelsMask, ChannelsDefaultMask, CHANNELS_MASK_SIZE);
+		break;
+	}
+	default:
+	{
+		break;
+	}
+	}
+}
+
+bool RegionDynamicVerify(const RegionDynamicPlan_t *plan, VerifyParams_t *verify, PhyAttribute_t phyAttribute)
+{
+	switch (phyAttribute)
+	{
+	case PHY_TX_DR:
+	{
+		return RegionCommonValueInRange(verify->DatarateParams.Datarate, plan->TxMinDatarate, plan->TxMaxDatarate);
+	}
+	case PHY_DEF_TX_DR:
+	{
+		return RegionCommonValueInRange(verify->DatarateParams.Datarate, DR_0, DR_5);
+	}
+	case PHY_RX_DR:
+	{
+		return RegionCommonValueInRange(verify->DatarateParams.Datarate, plan->RxMinDatarate, plan->RxMaxDatarate);
+	}
+	case PHY_DEF_TX_POWER:
+	case PHY_TX_POWER:
+	{
+		// Remark: switched min and max!
+		return RegionCommonValueInRange(verify->TxPower, plan->MaxTxPower, plan->MinTxPower);
+	}
+	case PHY_DUTY_CYCLE:
+	{
+		return plan->DutyCycleEnabled;
+	}
+	case PHY_NB_JOIN_TRIALS:
+	{
+		if (verify->NbJoinTrials < plan->MinNbJoinTrials)
+		{
+			return false;
+		}
+		break;
+	}
+	default:
+		return false;
+	}
+	return true;
+}
+
+void RegionDynamicApplyCFList(const RegionDynamicPlan_t *plan, ApplyCFListParams_t *applyCFList)
+{
+	ChannelParams_t newChannel;
+	ChannelAddParams_t channelAdd;
+	ChannelRemoveParams_t channelRemove;
+
+	// Setup default datarate range
+	newChannel.DrRange.Value = (DR_5 << 4) | DR_0;
+
+	// Size of the optional CF list
+	if (applyCFList->Size != 16)
+	{
+		return;
+	}
+
+	// Last byte is RFU, don't take it into account
+	for (uint8_t i = 0, chanIdx = plan->NbDefaultChannels; chanIdx < DYNAMIC_MAX_NB_CHANNELS; i += 3, chanIdx++)
+	{
+		if (chanIdx < (plan->NbChannelsCfList + plan->NbDefaultChannels))
+		{
+			// Channel frequency
+			newChannel.Frequency = (uint32_t)applyCFList->Payload[i];
+			newChannel.Frequency |= ((uint32_t)applyCFList->Payload[i + 1] << 8);
+			newChannel.Frequency |= ((uint32_t)applyCFList->Payload[i + 2] << 16);
+			newChannel.Frequency *= 100;
+
+			LOG_LIB(plan->Name, "Apply CF list: new channel at Freq = %ld", newChannel.Frequency);
+			// Initialize alternative frequency to 0
+			newChannel.Rx1Frequency = 0;
+		}
+		else
+		{
+			newChannel.Frequency = 0;
+			newChannel.DrRange.Value = 0;
+			newChannel.Rx1Frequency = 0;
+		}
+
+		if (newChannel.Frequency != 0)
+		{
+			channelAdd.NewChannel = &newChannel;
+			channelAdd.ChannelId = chanIdx;
+
+			// Try to add all channels
+			RegionDynamicChannelAdd(plan, &channelAdd);
+		}
+		else
+		{
+			channelRemove.ChannelId = chanIdx;
+
+			RegionDynamicChannelsRemove(plan, &channelRemove);
+		}
+	}
+}
+
+bool RegionDynamicChanMaskSet(const RegionDynamicPlan_t *plan, ChanMaskSetParams_t *chanMaskSet)
+{
+	(void)plan;
+
+	switch (chanMaskSet->ChannelsMaskType)
+	{
+	case CHANNELS_MASK:
+	{
+		RegionCommonChanMaskCopy(ChannelsMask, chanMaskSet->ChannelsMaskIn, CHANNELS_MASK_SIZE);
+		break;
+	}
+	case CHANNELS_DEFAULT_MASK:
+	{
+		RegionCommonChanMaskCopy(ChannelsDefaultMask, chanMaskSet->ChannelsMaskIn, CHANNELS_MASK_SIZE);
+		break;
+	}
+	default:
+		return false;
+	}
+	return true;
+}
+
+bool RegionDynamicAdrNext(const RegionDynamicPlan_t *plan, AdrNextParams_t *adrNext, int8_t *drOut, int8_t *txPowOut, uint32_t *adrAckCounter)
+{
+	bool adrAckReq = false;
+	int8_t datarate = adrNext->Datarate;
+	int8_t txPower = adrNext->TxPower;
+	GetPhyParams_t getPhy;
+	PhyParam_t phyParam;
+
+	// Report back the adr ack counter
+	*adrAckCounter = adrNext->AdrAckCounter;
+
+	if (adrNext->AdrEnabled == true)
+	{
+		if (datarate == plan->TxMinDatarate)
+		{
+			*adrAckCounter = 0;
+			adrAckReq = false;
+		}
+		else
+		{
+			if (adrNext->AdrAckCounter >= plan->AdrAckLimit)
+			{
+				adrAckReq = true;
+				txPower = plan->MaxTxPower;
+			}
+			else
+			{
+				adrAckReq = false;
+			}
+			if (adrNext->AdrAckCounter >= (uint32_t)(plan->AdrAckLimit + plan->AdrAckDelay))
+			{
+				if ((adrNext->AdrAckCounter % plan->AdrAckDelay) == 1)
+				{
+					// Decrease the datarate
+					getPhy.Attribute = PHY_NEXT_LOWER_TX_DR;
+					getPhy.Datarate = datarate;
+					getPhy.UplinkDwellTime = adrNext->UplinkDwellTime;
+					phyParam = RegionDynamicGetPhyParam(plan, &getPhy);
+					datarate = phyParam.Value;
+
+					if (datarate == plan->TxMinDatarate)
+					{
+						// We must set adrAckReq to false as soon as we reach the lowest datarate
+						adrAckReq = false;
+						if (adrNext->UpdateChanMask == true)
+						{
+							// Re-enable default channels
+							ChannelsMask[0] |= plan->AdrRestoreChannelsMask;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	*drOut = datarate;
+	*txPowOut = txPower;
+	return adrAckReq;
+}
+
+void RegionDynamicComputeRxWindowParameters(const RegionDynamicPlan_t *plan, int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams)
+{
+	double tSymbol = 0.0;
+
+	// Get the datarate, perform a boundary check
+	rxConfigParams->Datarate = T_MIN(datarate, plan->RxMaxDatarate);
+	rxConfigParams->Bandwidth = GetBandwidth(plan, rxConfigParams->Datarate);
+
+	if (rxConfigParams->Datarate == DR_7)
+	{ // FSK
+		tSymbol = RegionCommonComputeSymbolTimeFsk(plan->Datarates[rxConfigParams->Datarate]);
+	}
+	else
+	{ // LoRa
+		tSymbol = RegionCommonComputeSymbolTimeLoRa(plan->Datarates[rxConfigParams->Datarate], plan->Bandwidths[rxConfigParams->Datarate]);
+	}
+
+	RegionCommonComputeRxWindowParameters(tSymbol, minRxSymbols, rxError, RADIO_WAKEUP_TIME, &rxConfigParams->WindowTimeout, &rxConfigParams->WindowOffset);
+}
+
+bool RegionDynamicRxConfig(const RegionDynamicPlan_t *plan, RxConfigParams_t *rxConfig, int8_t *datarate)
+{
+	RadioModems_t modem;
+	int8_t dr = rxConfig->Datarate;
+	uint8_t maxPayload = 0;
+	int8_t phyDr = 0;
+	uint32_t frequency = rxConfig->Frequency;
+
+	if (Radio.GetStatus() != RF_IDLE)
+	{
+		return false;
+	}
+
+	if (rxConfig->Window == 0)
+	{
+		// Apply window 1 frequency
+		frequency = Channels[rxConfig->Channel].Frequency;
+		// Apply the alternative RX 1 window frequency, if it is available
+		if (Channels[rxConfig->Channel].Rx1Frequency != 0)
+		{
+			frequency = Channels[rxConfig->Channel].Rx1Frequency;
+		}
+	}
+
+	// Read the physical datarate from the datarates table
+	phyDr = plan->Datarates[dr];
+
+	Radio.SetChannel(frequency);
+
+	// Radio configuration
+	if (dr == DR_7)
+	{
+		modem = MODEM_FSK;
+		// Radio.SetRxConfig(modem, 50000, phyDr * 1000, 0, 83333, 5, rxConfig->WindowTimeout, false, 0, true, 0, 0, false, rxConfig->RxContinuous);
+		// RAKwireless symbTimeout changed after tests done by RAKwireless
+		Radio.SetRxConfig(modem, 50000, phyDr * 1000, 0, 83333, 5, 0, false, 0, true, 0, 0, false, rxConfig->RxContinuous);
+	}
+	else
+	{
+		modem = MODEM_LORA;
+		// Radio.SetRxConfig(modem, rxConfig->Bandwidth, phyDr, 1, 0, 8, rxConfig->WindowTimeout, false, 0, false, 0, 0, true, rxConfig->RxContinuous);
+		// RAKwireless symbTimeout changed after tests done by RAKwireless
+		Radio.SetRxConfig(modem, rxConfig->Bandwidth, phyDr, 1, 0, 8, 0, false, 0, false, 0, 0, true, rxConfig->RxContinuous);
+	}
+
+	if ((rxConfig->RepeaterSupport == true) && (plan->RxRepeaterSupport == true))
+	{
+		maxPayload = plan->MaxPayloadRepeater[dr];
+	}
+	else
+	{
+		maxPayload = plan->MaxPayload[dr];
+	}
+
+	Radio.SetMaxPayloadLength(modem, maxPayload + LORA_MAC_FRMPAYLOAD_OVERHEAD);
+
+	*datarate = (uint8_t)dr;
+	return true;
+}
+
+bool RegionDynamicTxConfig(const RegionDynamicPlan_t *plan, TxConfigParams_t *txConfig, int8_t *txPower, TimerTime_t *txTimeOnAir)
+{
+	RadioModems_t modem;
+	int8_t phyDr = plan->Datarates[txConfig->Datarate];
+	int8_t txPowerLimited = LimitTxPower(txConfig->TxPower, Bands[Channels[txConfig->Channel].Band].TxMaxPower);
+	uint32_t bandwidth = GetBandwidth(plan, txConfig->Datarate);
+	// The value of txConfig->MaxEirp could have changed during runtime, e.g. due to a MAC command.
+	float maxEIRP = GetMaxEirp(plan, Channels[txConfig->Channel].Frequency, txConfig->MaxEirp);
+	int8_t phyTxPower = 0;
+
+	// Calculate physical TX power
+	phyTxPower = RegionCommonComputeTxPower(txPowerLimited, maxEIRP, txConfig->AntennaGain);
+
+	// Setup the radio frequency
+	Radio.SetChannel(Channels[txConfig->Channel].Frequency);
+
+	if (txConfig->Datarate == DR_7)
+	{ // High Speed FSK channel
+		modem = MODEM_FSK;
+		Radio.SetTxConfig(modem, phyTxPower, 25000, bandwidth, phyDr * 1000, 0, 5, false, true, 0, 0, false, 3000);
+	}
+	else
+	{
+		modem = MODEM_LORA;
+		Radio.SetTxConfig(modem, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 3000);
+	}
+
+	// Setup maximum payload lenght of the radio driver
+	Radio.SetMaxPayloadLength(modem, txConfig->PktLen);
+	// Get the time-on-air of the next tx frame
+	*txTimeOnAir = Radio.TimeOnAir(modem, txConfig->PktLen);
+
+	*txPower = txPowerLimited;
+	return true;
+}
+
+uint8_t RegionDynamicLinkAdrReq(const RegionDynamicPlan_t *plan, LinkAdrReqParams_t *linkAdrReq, int8_t *drOut, int8_t *txPowOut, uint8_t *nbRepOut, uint8_t *nbBytesParsed)
+{
+	uint8_t status = 0x07;
+	RegionCommonLinkAdrParams_t linkAdrParams;
+	uint8_t nextIndex = 0;
+	uint8_t bytesProcessed = 0;
+	uint16_t chMask = 0;
+	GetPhyParams_t getPhy;
+	PhyParam_t phyParam;
+	RegionCommonLinkAdrReqVerifyParams_t linkAdrVerifyParams;
+
+	while (bytesProcessed < linkAdrReq->PayloadSize)
+	{
+		// Get ADR request parameters
+		nextIndex = RegionCommonParseLinkAdrReq(&(linkAdrReq->Payload[bytesProcessed]), &linkAdrParams);
+
+		if (nextIndex == 0)
+			break; // break loop, since no more request has been found
+
+		// Update bytes processed
+		bytesProcessed += nextIndex;
+
+		// Revert status, as we only check the last ADR request for the channel mask KO
+		status = 0x07;
+
+		// Setup temporary channels mask
+		chMask = linkAdrParams.ChMask;
+
+		// Verify channels mask
+		if ((linkAdrParams.ChMaskCtrl == 0) && (chMask == 0))
+		{
+			status &= 0xFE; // Channel mask KO
+		}
+		else if (((linkAdrParams.ChMaskCtrl >= 1) && (linkAdrParams.ChMaskCtrl <= 5)) ||
+				 (linkAdrParams.ChMaskCtrl >= 7))
+		{
+			// RFU
+			status &= 0xFE; // Channel mask KO
+		}
+		else
+		{
+			for (uint8_t i = 0; i < DYNAMIC_MAX_NB_CHANNELS; i++)
+			{
+				if (linkAdrParams.ChMaskCtrl == 6)
+				{
+					if (Channels[i].Frequency != 0)
+					{
+						chMask |= 1 << i;
+					}
+				}
+				else
+				{
+					if (((chMask & (1 << i)) != 0) &&
+						(Channels[i].Frequency == 0))
+					{					// Trying to enable an undefined channel
+						status &= 0xFE; // Channel mask KO
+					}
+				}
+			}
+		}
+	}
+
+	// Get the minimum possible datarate
+	getPhy.Attribute = PHY_MIN_TX_DR;
+	getPhy.UplinkDwellTime = linkAdrReq->UplinkDwellTime;
+	phyParam = RegionDynamicGetPhyParam(plan, &getPhy);
+
+	linkAdrVerifyParams.Status = status;
+	linkAdrVerifyParams.AdrEnabled = linkAdrReq->AdrEnabled;
+	linkAdrVerifyParams.Datarate = linkAdrParams.Datarate;
+	linkAdrVerifyParams.TxPower = linkAdrParams.TxPower;
+	linkAdrVerifyParams.NbRep = linkAdrParams.NbRep;
+	linkAdrVerifyParams.CurrentDatarate = linkAdrReq->CurrentDatarate;
+	linkAdrVerifyParams.CurrentTxPower = linkAdrReq->CurrentTxPower;
+	linkAdrVerifyParams.CurrentNbRep = linkAdrReq->CurrentNbRep;
+	linkAdrVerifyParams.NbChannels = DYNAMIC_MAX_NB_CHANNELS;
+	linkAdrVerifyParams.ChannelsMask = &chMask;
+	linkAdrVerifyParams.MinDatarate = (int8_t)phyParam.Value;
+	linkAdrVerifyParams.MaxDatarate = plan->TxMaxDatarate;
+	linkAdrVerifyParams.Channels = Channels;
+	linkAdrVerifyParams.MinTxPower = plan->MinTxPower;
+	linkAdrVerifyParams.MaxTxPower = plan->MaxTxPower;
+
+	// Verify the parameters and update, if necessary
+	status = RegionCommonLinkAdrReqVerifyParams(&linkAdrVerifyParams, &linkAdrParams.Datarate, &linkAdrParams.TxPower, &linkAdrParams.NbRep);
+
+	// Update channelsMask if everything is correct
+	if (status == 0x07)
+	{
+		// Set the channels mask to a default value
+		memset(ChannelsMask, 0, sizeof(ChannelsMask));
+		// Update the channels mask
+		ChannelsMask[0] = chMask;
+	}
+
+	// Update status variables
+	*drOut = linkAdrParams.Datarate;
+	*txPowOut = linkAdrParams.TxPower;
+	*nbRepOut = linkAdrParams.NbRep;
+	*nbBytesParsed = bytesProcessed;
+
+	return status;
+}
+
+uint8_t RegionDynamicRxParamSetupReq(const RegionDynamicPlan_t *plan, RxParamSetupReqParams_t *rxParamSetupReq)
+{
+	uint8_t status = 0x07;
+
+	// Verify radio frequency
+	if (Radio.CheckRfFrequency(rxParamSetupReq->Frequency) == false)
+	{
+		status &= 0xFE; // Channel frequency KO
+	}
+
+	// Verify datarate
+	if (RegionCommonValueInRange(rxParamSetupReq->Datarate, plan->RxMinDatarate, plan->RxMaxDatarate) == false)
+	{
+		status &= 0xFD; // Datarate KO
+	}
+
+	// Verify datarate offset
+	if (RegionCommonValueInRange(rxParamSetupReq->DrOffset, plan->MinRx1DrOffset, plan->MaxRx1DrOffset) == false)
+	{
+		status &= 0xFB; // Rx1DrOffset range KO
+	}
+
+	return status;
+}
+
+uint8_t RegionDynamicNewChannelReq(const RegionDynamicPlan_t *plan, NewChannelReqParams_t *newChannelReq)
+{
+	uint8_t status = 0x03;
+	ChannelAddParams_t channelAdd;
+	ChannelRemoveParams_t channelRemove;
+
+	if (newChannelReq->NewChannel->Frequency == 0)
+	{
+		channelRemove.ChannelId = newChannelReq->ChannelId;
+
+		// Remove
+		if (RegionDynamicChannelsRemove(plan, &channelRemove) == false)
+		{
+			status &= 0xFC;
+		}
+	}
+	else
+	{
+		if (plan->FixNegativeMaxDr == true)
+		{
+			// Workaround Chirpstack bug that requests wrong max DR
+			LOG_LIB(plan->Name, "Requested DR was %d", newChannelReq->NewChannel->DrRange.Fields.Max);
+
+			if (newChannelReq->NewChannel->DrRange.Fields.Max < 0)
+			{
+				LOG_LIB(plan->Name, "Requested DR was %d, changed to %d", newChannelReq->NewChannel->DrRange.Fields.Max, abs(newChannelReq->NewChannel->DrRange.Fields.Max));
+				newChannelReq->NewChannel->DrRange.Fields.Max = abs(newChannelReq->NewChannel->DrRange.Fields.Max);
+			}
+		}
+
+		channelAdd.NewChannel = newChannelReq->NewChannel;
+		channelAdd.ChannelId = newChannelReq->ChannelId;
+
+		switch (RegionDynamicChannelAdd(plan, &channelAdd))
+		{
+		case LORAMAC_STATUS_OK:
+		{
+			LOG_LIB(plan->Name, "New Channel Request accepted");
+			break;
+		}
+		case LORAMAC_STATUS_FREQUENCY_INVALID:
+		{
+			LOG_LIB(plan->Name, "New Channel Request frequency invalid");
+			status &= 0xFE;
+			break;
+		}
+		case LORAMAC_STATUS_DATARATE_INVALID:
+		{
+			LOG_LIB(plan->Name, "New Channel Request DR invalid");
+			status &= 0xFD;
+			break;
+		}
+		case LORAMAC_STATUS_FREQ_AND_DR_INVALID:
+		{
+			LOG_LIB(plan->Name, "New Channel Request frequency & DR invalid");
+			status &= 0xFC;
+			break;
+		}
+		default:
+		{
+			LOG_LIB(plan->Name, "New Channel Request unknown failure");
+			status &= 0xFC;
+			break;
+		}
+		}
+	}
+
+	return status;
+}
+
+int8_t RegionDynamicTxParamSetupReq(const RegionDynamicPlan_t *plan, TxParamSetupReqParams_t *txParamSetupReq)
+{
+	(void)txParamSetupReq;
+
+	if (plan->TxParamSetupSupported == true)
+	{
+		// Accept the request
+		return 0;
+	}
+	return -1;
+}
+
+uint8_t RegionDynamicDlChannelReq(const RegionDynamicPlan_t *plan, DlChannelReqParams_t *dlChannelReq)
+{
+	uint8_t status = 0x03;
+	uint8_t band = 0;
+
+	// Verify if the frequency is supported
+	if (VerifyTxFreq(plan, dlChannelReq->Rx1Frequency, &band) == false)
+	{
+		status &= 0xFE;
+	}
+
+	// Verify if an uplink frequency exists
+	if (Channels[dlChannelReq->ChannelId].Frequency == 0)
+	{
+		status &= 0xFD;
+	}
+
+	// Apply Rx1 frequency, if the status is OK
+	if (status == 0x03)
+	{
+		Channels[dlChannelReq->ChannelId].Rx1Frequency = dlChannelReq->Rx1Frequency;
+	}
+
+	return status;
+}
+
+int8_t RegionDynamicAlternateDr(const RegionDynamicPlan_t *plan, AlternateDrParams_t *alternateDr)
+{
+	int8_t datarate = 0;
+
+	(void)plan;
+
+	if ((alternateDr->NbTrials % 48) == 0)
+	{
+		datarate = DR_0;
+	}
+	else if ((alternateDr->NbTrials % 32) == 0)
+	{
+		datarate = DR_1;
+	}
+	else if ((alternateDr->NbTrials % 24) == 0)
+	{
+		datarate = DR_2;
+	}
+	else if ((alternateDr->NbTrials % 16) == 0)
+	{
+		datarate = DR_3;
+	}
+	else if ((alternateDr->NbTrials % 8) == 0)
+	{
+		datarate = DR_4;
+	}
+	else
+	{
+		datarate = DR_5;
+	}
+	return datarate;
+}
+
+void RegionDynamicCalcBackOff(const RegionDynamicPlan_t *plan, CalcBackOffParams_t *calcBackOff)
+{
+	RegionCommonCalcBackOffParams_t calcBackOffParams;
+
+	(void)plan;
+
+	calcBackOffParams.Channels = Channels;
+	calcBackOffParams.Bands = Bands;
+	calcBackOffParams.LastTxIsJoinRequest = calcBackOff->LastTxIsJoinRequest;
+	calcBackOffParams.Joined = calcBackOff->Joined;
+	calcBackOffParams.DutyCycleEnabled = calcBackOff->DutyCycleEnabled;
+	calcBackOffParams.Channel = calcBackOff->Channel;
+	calcBackOffParams.ElapsedTime = calcBackOff->ElapsedTime;
+	calcBackOffParams.TxTimeOnAir = calcBackOff->TxTimeOnAir;
+
+	RegionCommonCalcBackOff(&calcBackOffParams);
+}
+
+bool RegionDynamicNextChannel(const RegionDynamicPlan_t *plan, NextChanParams_t *nextChanParams, uint8_t *channel, TimerTime_t *time, TimerTime_t *aggregatedTimeOff)
+{
+	uint8_t nbEnabledChannels = 0;
+	uint8_t delayTx = 0;
+	uint8_t enabledChannels[DYNAMIC_MAX_NB_CHANNELS] = {0};
+	TimerTime_t nextTxDelay = 0;
+
+	if (RegionCommonCountChannels(ChannelsMask, 0, 1) == 0)
+	{ // Reactivate default channels
+		ChannelsMask[0] |= plan->ReactivateChannelsMask;
+	}
+
+	if (nextChanParams->AggrTimeOff <= TimerGetElapsedTime(nextChanParams->LastAggrTx))
+	{
+		// Reset Aggregated time off
+		*aggregatedTimeOff = 0;
+
+		// Update bands Time OFF
+		nextTxDelay = RegionCommonUpdateBandTimeOff(nextChanParams->Joined, nextChanParams->DutyCycleEnabled, Bands, plan->NbBands);
+
+		// Search how many channels are enabled
+		nbEnabledChannels = CountNbOfEnabledChannels(plan, nextChanParams->Joined, nextChanParams->Datarate,
+													 ChannelsMask, Channels,
+													 Bands, enabledChannels, &delayTx);
+	}
+	else
+	{
+		delayTx++;
+		nextTxDelay = nextChanParams->AggrTimeOff - TimerGetElapsedTime(nextChanParams->LastAggrTx);
+	}
+
+	if (nbEnabledChannels > 0)
+	{
+		// We found a valid channel
+		*channel = enabledChannels[randr(0, nbEnabledChannels - 1)];
+		LOG_LIB(plan->Name, "Using channel %d, frequency %ld", channel[0], Channels[channel[0]].Frequency);
+		*time = 0;
+		return true;
+	}
+	else
+	{
+		if (delayTx > 0)
+		{
+			// Delay transmission due to AggregatedTimeOff or to a band time off
+			*time = nextTxDelay;
+			return true;
+		}
+		// Datarate not supported by any channel, restore defaults
+		LOG_LIB(plan->Name, "NextChannel Datarate not supported by any channel");
+		ChannelsMask[0] |= plan->RestoreChannelsMask;
+		*time = 0;
+		return false;
+	}
+}
+
+LoRaMacStatus_t RegionDynamicChannelAdd(const RegionDynamicPlan_t *plan, ChannelAddParams_t *channelAdd)
+{
+	uint8_t band = 0;
+	bool drInvalid = false;
+	bool freqInvalid = false;
+	uint8_t id = channelAdd->ChannelId;
+
+	if (id >= DYNAMIC_MAX_NB_CHANNELS)
+	{
+		return LORAMAC_STATUS_PARAMETER_INVALID;
+	}
+
+	// Validate the datarate range
+	if (RegionCommonValueInRange(channelAdd->NewChannel->DrRange.Fields.Min, plan->TxMinDatarate, plan->TxMaxDatarate) == false)
+	{
+		drInvalid = true;
+	}
+	if (RegionCommonValueInRange(channelAdd->NewChannel->DrRange.Fields.Max, plan->TxMinDatarate, plan->TxMaxDatarate) == false)
+	{
+		drInvalid = true;
+	}
+	if (channelAdd->NewChannel->DrRange.Fields.Min > channelAdd->NewChannel->DrRange.Fields.Max)
+	{
+		drInvalid = true;
+	}
+
+	// Default channels don't accept all values
+	if (id < plan->NbDefaultChannels)
+	{
+		if (plan->DefaultChannelsDrLocked == true)
+		{
+			// Validate the datarate range for min: must be DR_0
+			if (channelAdd->NewChannel->DrRange.Fields.Min > DR_0)
+			{
+				drInvalid = true;
+			}
+			// Validate the datarate range for max: must be DR_5 <= Max <= TX_MAX_DATARATE
+			if (RegionCommonValueInRange(channelAdd->NewChannel->DrRange.Fields.Max, DR_5, plan->TxMaxDatarate) == false)
+			{
+				drInvalid = true;
+			}
+		}
+		// We are not allowed to change the frequency
+		if (channelAdd->NewChannel->Frequency != Channels[id].Frequency)
+		{
+			freqInvalid = true;
+		}
+	}
+
+	// Check frequency
+	if (freqInvalid == false)
+	{
+		if (VerifyTxFreq(plan, channelAdd->NewChannel->Frequency, &band) == false)
+		{
+			freqInvalid = true;
+		}
+	}
+
+	// Check status
+	if ((drInvalid == true) && (freqInvalid == true))
+	{
+		return LORAMAC_STATUS_FREQ_AND_DR_INVALID;
+	}
+	if (drInvalid == true)
+	{
+		return LORAMAC_STATUS_DATARATE_INVALID;
+	}
+	if (freqInvalid == true)
+	{
+		return LORAMAC_STATUS_FREQUENCY_INVALID;
+	}
+
+	memcpy(&(Channels[id]), channelAdd->NewChannel, sizeof(Channels[id]));
+	Channels[id].Band = band;
+	ChannelsMask[0] |= (1 << id);
+	return LORAMAC_STATUS_OK;
+}
+
+bool RegionDynamicChannelsRemove(const RegionDynamicPlan_t *plan, ChannelRemoveParams_t *channelRemove)
+{
+	uint8_t id = channelRemove->ChannelId;
+
+	if (id < plan->NbDefaultChannels)
+	{
+		return false;
+	}
+
+	// Remove the channel from the list of channels
+	Channels[id] = (ChannelParams_t){0, 0, {0}, 0};
+
+	return RegionCommonChanDisable(ChannelsMask, id, DYNAMIC_MAX_NB_CHANNELS);
+}
+
+void RegionDynamicSetContinuousWave(const RegionDynamicPlan_t *plan, ContinuousWaveParams_t *continuousWave)
+{
+	int8_t txPowerLimited = LimitTxPower(continuousWave->TxPower, Bands[Channels[continuousWave->Channel].Band].TxMaxPower);
+	int8_t phyTxPower = 0;
+	uint32_t frequency = Channels[continuousWave->Channel].Frequency;
+	float maxEIRP = GetMaxEirp(plan, frequency, continuousWave->MaxEirp);
+
+	// Calculate physical TX power
+	phyTxPower = RegionCommonComputeTxPower(txPowerLimited, maxEIRP, continuousWave->AntennaGain);
+
+	Radio.SetTxContinuousWave(frequency, phyTxPower, continuousWave->Timeout);
+}
+
+uint8_t RegionDynamicApplyDrOffset(const RegionDynamicPlan_t *plan, uint8_t downlinkDwellTime, int8_t dr, int8_t drOffset)
+{
+	(void)downlinkDwellTime;
+
+	if (plan->EffectiveRx1DrOffset != NULL)
+	{
+		// Apply offset formula
+		return T_MIN(DR_5, T_MAX(DR_0, dr - plan->EffectiveRx1DrOffset[drOffset]));
+	}
+
+	int8_t datarate = dr - drOffset;
+
+	if (datarate < 0)
+	{
+		datarate = DR_0;
+	}
+	return datarate;
+}
+
+#endif
@@ -0,0 +1,496 @@
+/*!
+ * \file      RegionDynamic.h
+ *
+ * \brief     Generic implementation of the regions with a dynamic channel plan
+ *
+ * \copyright Revised BSD License, see file LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013 Semtech
+ *
+ *               ___ _____ _   ___ _  _____ ___  ___  ___ ___
+ *              / __|_   _/_\ / __| |/ / __/ _ \| _ \/ __| __|
+ *              \__ \ | |/ _ \ (__| ' <| _| (_) |   / (__| _|
+ *              |___/ |_/_/ \_\___|_|\_\_| \___/|_|_\\___|___|
+ *              embedded.connectivity.solutions===============
+ *
+ * \endcode
+ *
+ * \author    Miguel Luis ( Semtech )
+ *
+ * \author    Gregory Cristian ( Semtech )
+ *
+ * \author    Daniel Jaeckle ( STACKFORCE )
+ *
+ * \defgroup  REGIONDYNAMIC Dynamic channel plan
+ *            Implementation shared by EU868, EU433, CN779, IN865, KR920 and RU864.
+ *            The regions only differ by their RegionDynamicPlan_t. The channels
+ *            and bands storage is shared, only one region is active at a time.
+ * \{
+ */
+#ifndef __REGION_DYNAMIC_H__
+#define __REGION_DYNAMIC_H__
+
+/*!
+ * Maximum number of channels of a dynamic channel plan
+ */
+#define DYNAMIC_MAX_NB_CHANNELS 16
+
+/*!
+ * Maximum number of bands of a dynamic channel plan
+ */
+#define DYNAMIC_MAX_NB_BANDS 5
+
+/*!
+ * Frequency range of a dynamic channel plan and the band it belongs to
+ */
+typedef struct sRegionFreqRange
+{
+	/*!
+	 * Lowest allowed frequency [Hz], inclusive
+	 */
+	uint32_t Min;
+	/*!
+	 * Highest allowed frequency [Hz], inclusive
+	 */
+	uint32_t Max;
+	/*!
+	 * Band index of the range
+	 */
+	uint8_t Band;
+} RegionFreqRange_t;
+
+/*!
+ * Region specific parameters of a dynamic channel plan
+ */
+typedef struct sRegionDynamicPlan
+{
+	/*!
+	 * Region name, used for debug output
+	 */
+	const char *Name;
+	/*!
+	 * Channels set on initialization
+	 */
+	const ChannelParams_t *InitChannels;
+	/*!
+	 * Number of channels set on initialization
+	 */
+	uint8_t NbInitChannels;
+	/*!
+	 * Number of default channels, they can not be removed or changed
+	 */
+	uint8_t NbDefaultChannels;
+	/*!
+	 * Number of channels that can be added by a CF list
+	 */
+	uint8_t NbChannelsCfList;
+	/*!
+	 * Channels mask set on initialization
+	 */
+	uint16_t DefaultChannelsMask;
+	/*!
+	 * Channels allowed for the join request
+	 */
+	uint16_t JoinChannels;
+	/*!
+	 * Channels enabled when the channels mask is empty. 0 if not used
+	 */
+	uint16_t ReactivateChannelsMask;
+	/*!
+	 * Channels enabled when no channel supports the datarate. 0 if not used
+	 */
+	uint16_t RestoreChannelsMask;
+	/*!
+	 * Channels enabled when ADR reaches the lowest datarate
+	 */
+	uint16_t AdrRestoreChannelsMask;
+	/*!
+	 * Default channels only accept DR_0 as min and DR_5 as lowest max datarate
+	 */
+	bool DefaultChannelsDrLocked;
+	/*!
+	 * Band definitions
+	 */
+	const Band_t *Bands;
+	/*!
+	 * Number of bands
+	 */
+	uint8_t NbBands;
+	/*!
+	 * Allowed uplink frequency ranges
+	 */
+	const RegionFreqRange_t *FreqRanges;
+	/*!
+	 * Number of frequency ranges
+	 */
+	uint8_t NbFreqRanges;
+	/*!
+	 * Channel raster inside a frequency range [Hz]. 0 if any frequency is allowed
+	 */
+	uint32_t FreqRaster;
+	/*!
+	 * Datarate to spreading factor (LoRa) or bitrate in kbps (FSK) table
+	 */
+	const uint8_t *Datarates;
+	/*!
+	 * Datarate to bandwidth table
+	 */
+	const uint32_t *Bandwidths;
+	/*!
+	 * Maximum payload per datarate
+	 */
+	const uint8_t *MaxPayload;
+	/*!
+	 * Maximum payload per datarate with repeater
+	 */
+	const uint8_t *MaxPayloadRepeater;
+	/*!
+	 * Use the repeater payload table in the Rx configuration
+	 */
+	bool RxRepeaterSupport;
+	/*!
+	 * Effective RX1 datarate offsets. NULL for a plain subtraction
+	 */
+	const int8_t *EffectiveRx1DrOffset;
+	/*!
+	 * Datarate that is skipped when lowering the datarate. -1 if none
+	 */
+	int8_t RfuDatarate;
+	int8_t TxMinDatarate;
+	int8_t TxMaxDatarate;
+	int8_t RxMinDatarate;
+	int8_t RxMaxDatarate;
+	int8_t DefaultDatarate;
+	int8_t MinRx1DrOffset;
+	int8_t MaxRx1DrOffset;
+	int8_t DefaultRx1DrOffset;
+	int8_t MinTxPower;
+	int8_t MaxTxPower;
+	int8_t DefaultTxPower;
+	/*!
+	 * Default maximum EIRP. The high limit if MaxEirpHighFreq is set
+	 */
+	float DefaultMaxEirp;
+	/*!
+	 * Maximum EIRP below MaxEirpHighFreq
+	 */
+	float MaxEirpLow;
+	/*!
+	 * Lowest frequency allowed to use DefaultMaxEirp. 0 if the EIRP does not depend on the frequency
+	 */
+	uint32_t MaxEirpHighFreq;
+	float DefaultAntennaGain;
+	uint16_t AdrAckLimit;
+	uint16_t AdrAckDelay;
+	bool DutyCycleEnabled;
+	uint32_t MaxRxWindow;
+	uint32_t ReceiveDelay1;
+	uint32_t ReceiveDelay2;
+	uint32_t JoinAcceptDelay1;
+	uint32_t JoinAcceptDelay2;
+	uint32_t MaxFCntGap;
+	uint32_t AckTimeout;
+	uint32_t AckTimeoutRnd;
+	uint32_t Rx2Frequency;
+	int8_t Rx2Datarate;
+	/*!
+	 * Default number of join trials
+	 */
+	uint8_t NbJoinTrials;
+	/*!
+	 * Minimum number of join trials accepted by the verification
+	 */
+	uint8_t MinNbJoinTrials;
+	/*!
+	 * TxParamSetupReq is accepted
+	 */
+	bool TxParamSetupSupported;
+	/*!
+	 * Workaround for network servers sending a negative max datarate in NewChannelReq
+	 */
+	bool FixNegativeMaxDr;
+} RegionDynamicPlan_t;
+
+/*!
+ * \brief The function gets a value of a specific phy attribute.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  getPhy Pointer to the function parameters.
+ *
+ * \retval Returns a structure containing the PHY parameter.
+ */
+PhyParam_t RegionDynamicGetPhyParam(const RegionDynamicPlan_t *plan, GetPhyParams_t *getPhy);
+
+/*!
+ * \brief Updates the last TX done parameters of the current channel.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  txDone Pointer to the function parameters.
+ */
+void RegionDynamicSetBandTxDone(const RegionDynamicPlan_t *plan, SetBandTxDoneParams_t *txDone);
+
+/*!
+ * \brief Initializes the channels masks and the channels.
+ *        Switching to another plan clears the channels and reloads the bands.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  type Sets the initialization type.
+ */
+void RegionDynamicInitDefaults(const RegionDynamicPlan_t *plan, InitType_t type);
+
+/*!
+ * \brief Verifies a parameter.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  verify Pointer to the function parameters.
+ *
+ * \param  phyAttribute Sets the initialization type.
+ *
+ * \retval Returns true, if the parameter is valid.
+ */
+bool RegionDynamicVerify(const RegionDynamicPlan_t *plan, VerifyParams_t *verify, PhyAttribute_t phyAttribute);
+
+/*!
+ * \brief The function parses the input buffer and sets up the channels of the
+ *        CF list.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  applyCFList Pointer to the function parameters.
+ */
+void RegionDynamicApplyCFList(const RegionDynamicPlan_t *plan, ApplyCFListParams_t *applyCFList);
+
+/*!
+ * \brief Sets a channels mask.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  chanMaskSet Pointer to the function parameters.
+ *
+ * \retval Returns true, if the channels mask could be set.
+ */
+bool RegionDynamicChanMaskSet(const RegionDynamicPlan_t *plan, ChanMaskSetParams_t *chanMaskSet);
+
+/*!
+ * \brief Calculates the next datarate to set, when ADR is on or off.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  adrNext Pointer to the function parameters.
+ *
+ * \param  drOut The calculated datarate for the next TX.
+ *
+ * \param  txPowOut The TX power for the next TX.
+ *
+ * \param  adrAckCounter The calculated ADR acknowledgement counter.
+ *
+ * \retval Returns true, if an ADR request should be performed.
+ */
+bool RegionDynamicAdrNext(const RegionDynamicPlan_t *plan, AdrNextParams_t *adrNext, int8_t *drOut, int8_t *txPowOut, uint32_t *adrAckCounter);
+
+/*!
+ * Computes the Rx window timeout and offset.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  datarate     Rx window datarate index to be used
+ *
+ * \param  minRxSymbols Minimum required number of symbols to detect an Rx frame.
+ *
+ * \param  rxError      System maximum timing error of the receiver. In milliseconds
+ *                      The receiver will turn on in a [-rxError : +rxError] ms
+ *                      interval around RxOffset
+ *
+ * \param  rxConfigParams Returns updated WindowTimeout and WindowOffset fields.
+ */
+void RegionDynamicComputeRxWindowParameters(const RegionDynamicPlan_t *plan, int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams);
+
+/*!
+ * \brief Configuration of the RX windows.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  rxConfig Pointer to the function parameters.
+ *
+ * \param  datarate The datarate index which was set.
+ *
+ * \retval Returns true, if the configuration was applied successfully.
+ */
+bool RegionDynamicRxConfig(const RegionDynamicPlan_t *plan, RxConfigParams_t *rxConfig, int8_t *datarate);
+
+/*!
+ * \brief TX configuration.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  txConfig Pointer to the function parameters.
+ *
+ * \param  txPower The tx power index which was set.
+ *
+ * \param  txTimeOnAir The time-on-air of the frame.
+ *
+ * \retval Returns true, if the configuration was applied successfully.
+ */
+bool RegionDynamicTxConfig(const RegionDynamicPlan_t *plan, TxConfigParams_t *txConfig, int8_t *txPower, TimerTime_t *txTimeOnAir);
+
+/*!
+ * \brief The function processes a Link ADR Request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  linkAdrReq Pointer to the function parameters.
+ *
+ * \param  drOut The datarate which was applied.
+ *
+ * \param  txPowOut The TX power which was applied.
+ *
+ * \param  nbRepOut The number of repetitions to apply.
+ *
+ * \param  nbBytesParsed The number bytes which were parsed.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+uint8_t RegionDynamicLinkAdrReq(const RegionDynamicPlan_t *plan, LinkAdrReqParams_t *linkAdrReq, int8_t *drOut, int8_t *txPowOut, uint8_t *nbRepOut, uint8_t *nbBytesParsed);
+
+/*!
+ * \brief The function processes a RX Parameter Setup Request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  rxParamSetupReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+uint8_t RegionDynamicRxParamSetupReq(const RegionDynamicPlan_t *plan, RxParamSetupReqParams_t *rxParamSetupReq);
+
+/*!
+ * \brief The function processes a Channel Request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  newChannelReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+uint8_t RegionDynamicNewChannelReq(const RegionDynamicPlan_t *plan, NewChannelReqParams_t *newChannelReq);
+
+/*!
+ * \brief The function processes a TX ParamSetup Request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  txParamSetupReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ *         Returns -1, if the functionality is not implemented. In this case, the end node
+ *         shall not process the command.
+ */
+int8_t RegionDynamicTxParamSetupReq(const RegionDynamicPlan_t *plan, TxParamSetupReqParams_t *txParamSetupReq);
+
+/*!
+ * \brief The function processes a DlChannel Request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  dlChannelReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+uint8_t RegionDynamicDlChannelReq(const RegionDynamicPlan_t *plan, DlChannelReqParams_t *dlChannelReq);
+
+/*!
+ * \brief Alternates the datarate of the channel for the join request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  alternateDr Pointer to the function parameters.
+ *
+ * \retval Datarate to apply.
+ */
+int8_t RegionDynamicAlternateDr(const RegionDynamicPlan_t *plan, AlternateDrParams_t *alternateDr);
+
+/*!
+ * \brief Calculates the back-off time.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  calcBackOff Pointer to the function parameters.
+ */
+void RegionDynamicCalcBackOff(const RegionDynamicPlan_t *plan, CalcBackOffParams_t *calcBackOff);
+
+/*!
+ * \brief Searches and set the next random available channel
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  nextChanParams Pointer to the function parameters.
+ *
+ * \param  channel Next channel to use for TX.
+ *
+ * \param  time Time to wait for the next transmission according to the duty
+ *              cycle.
+ *
+ * \param  aggregatedTimeOff Updates the aggregated time off.
+ *
+ * \retval Function status [1: OK, 0: Unable to find a channel on the current datarate]
+ */
+bool RegionDynamicNextChannel(const RegionDynamicPlan_t *plan, NextChanParams_t *nextChanParams, uint8_t *channel, TimerTime_t *time, TimerTime_t *aggregatedTimeOff);
+
+/*!
+ * \brief Adds a channel.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  channelAdd Pointer to the function parameters.
+ *
+ * \retval Status of the operation.
+ */
+LoRaMacStatus_t RegionDynamicChannelAdd(const RegionDynamicPlan_t *plan, ChannelAddParams_t *channelAdd);
+
+/*!
+ * \brief Removes a channel.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  channelRemove Pointer to the function parameters.
+ *
+ * \retval Returns true, if the channel was removed successfully.
+ */
+bool RegionDynamicChannelsRemove(const RegionDynamicPlan_t *plan, ChannelRemoveParams_t *channelRemove);
+
+/*!
+ * \brief Sets the radio into continuous wave mode.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  continuousWave Pointer to the function parameters.
+ */
+void RegionDynamicSetContinuousWave(const RegionDynamicPlan_t *plan, ContinuousWaveParams_t *continuousWave);
+
+/*!
+ * \brief Computes new datarate according to the given offset
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  downlinkDwellTime Downlink dwell time configuration. 0: No limit, 1: 400ms
+ *
+ * \param  dr Current datarate
+ *
+ * \param  drOffset Offset to be applied
+ *
+ * \retval newDr Computed datarate.
+ */
+uint8_t RegionDynamicApplyDrOffset(const RegionDynamicPlan_t *plan, uint8_t downlinkDwellTime, int8_t dr, int8_t drOffset);
+
+#endif // __REGION_DYNAMIC_H__
@@ -35,6 +35,8 @@
 #ifndef __REGION_EU433_H__
 #define __REGION_EU433_H__
 
+#include "RegionDynamic.h"
+
 /*!
  * LoRaMac maximum number of channels
  */
@@ -254,233 +256,8 @@ static const uint8_t MaxPayloadOfDatarateEU433[] = {51, 51, 51, 115, 242, 242, 2
 static const uint8_t MaxPayloadOfDatarateRepeaterEU433[] = {51, 51, 51, 115, 222, 222, 222, 222};
 
 /*!
- * \brief The function gets a value of a specific phy attribute.
- *
- * \param  getPhy Pointer to the function parameters.
- *
- * \retval Returns a structure containing the PHY parameter.
- */
-PhyParam_t RegionEU433GetPhyParam(GetPhyParams_t *getPhy);
-
-/*!
- * \brief Updates the last TX done parameters of the current channel.
- *
- * \param  txDone Pointer to the function parameters.
- */
-void RegionEU433SetBandTxDone(SetBandTxDoneParams_t *txDone);
-
-/*!
- * \brief Initializes the channels masks and the channels.
- *
- * \param  type Sets the initialization type.
- */
-void RegionEU433InitDefaults(InitType_t type);
-
-/*!
- * \brief Verifies a parameter.
- *
- * \param  verify Pointer to the function parameters.
- *
- * \param  phyAttribute Sets the initialization type.
- *
- * \retval Returns true, if the parameter is valid.
- */
-bool RegionEU433Verify(VerifyParams_t *verify, PhyAttribute_t phyAttribute);
-
-/*!
- * \brief The function parses the input buffer and sets up the channels of the
- *        CF list.
- *
- * \param  applyCFList Pointer to the function parameters.
- */
-void RegionEU433ApplyCFList(ApplyCFListParams_t *applyCFList);
-
-/*!
- * \brief Sets a channels mask.
- *
- * \param  chanMaskSet Pointer to the function parameters.
- *
- * \retval Returns true, if the channels mask could be set.
- */
-bool RegionEU433ChanMaskSet(ChanMaskSetParams_t *chanMaskSet);
-
-/*!
- * \brief Calculates the next datarate to set, when ADR is on or off.
- *
- * \param  adrNext Pointer to the function parameters.
- *
- * \param  drOut The calculated datarate for the next TX.
- *
- * \param  txPowOut The TX power for the next TX.
- *
- * \param  adrAckCounter The calculated ADR acknowledgement counter.
- *
- * \retval Returns true, if an ADR request should be performed.
- */
-bool RegionEU433AdrNext(AdrNextParams_t *adrNext, int8_t *drOut, int8_t *txPowOut, uint32_t *adrAckCounter);
-
-/*!
- * Computes the Rx window timeout and offset.
- *
- * \param  datarate     Rx window datarate index to be used
- *
- * \param  minRxSymbols Minimum required number of symbols to detect an Rx frame.
- *
- * \param  rxError      System maximum timing error of the receiver. In milliseconds
- *                          The receiver will turn on in a [-rxError : +rxError] ms
- *                          interval around RxOffset
- *
- * \param rxConfigParams Returns updated WindowTimeout and WindowOffset fields.
- */
-void RegionEU433ComputeRxWindowParameters(int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams);
-
-/*!
- * \brief Configuration of the RX windows.
- *
- * \param  rxConfig Pointer to the function parameters.
- *
- * \param  datarate The datarate index which was set.
- *
- * \retval Returns true, if the configuration was applied successfully.
- */
-bool RegionEU433RxConfig(RxConfigParams_t *rxConfig, int8_t *datarate);
-
-/*!
- * \brief TX configuration.
- *
- * \param  txConfig Pointer to the function parameters.
- *
- * \param  txPower The tx power index which was set.
- *
- * \param  txTimeOnAir The time-on-air of the frame.
- *
- * \retval Returns true, if the configuration was applied successfully.
- */
-bool RegionEU433TxConfig(TxConfigParams_t *txConfig, int8_t *txPower, TimerTime_t *txTimeOnAir);
-
-/*!
- * \brief The function processes a Link ADR Request.
- *
- * \param  linkAdrReq Pointer to the function parameters.
- *
- * \param  drOut Data rate.
- *
- * \param  txPowOut TX power.
- *
- * \param  nbRepOut Number of repeats.
- *
- * \param  nbBytesParsed Number of parsed bytes.
- *
- * \retval Returns the status of the operation, according to the LoRaMAC specification.
- */
-uint8_t RegionEU433LinkAdrReq(LinkAdrReqParams_t *linkAdrReq, int8_t *drOut, int8_t *txPowOut, uint8_t *nbRepOut, uint8_t *nbBytesParsed);
-
-/*!
- * \brief The function processes a RX Parameter Setup Request.
- *
- * \param  rxParamSetupReq Pointer to the function parameters.
- *
- * \retval Returns the status of the operation, according to the LoRaMAC specification.
- */
-uint8_t RegionEU433RxParamSetupReq(RxParamSetupReqParams_t *rxParamSetupReq);
-
-/*!
- * \brief The function processes a Channel Request.
- *
- * \param  newChannelReq Pointer to the function parameters.
- *
- * \retval Returns the status of the operation, according to the LoRaMAC specification.
- */
-uint8_t RegionEU433NewChannelReq(NewChannelReqParams_t *newChannelReq);
-
-/*!
- * \brief The function processes a TX ParamSetup Request.
- *
- * \param  txParamSetupReq Pointer to the function parameters.
- *
- * \retval Returns the status of the operation, according to the LoRaMAC specification.
- *         Returns -1, if the functionality is not implemented. In this case, the end node
- *         shall not process the command.
- */
-int8_t RegionEU433TxParamSetupReq(TxParamSetupReqParams_t *txParamSetupReq);
-
-/*!
- * \brief The function processes a DlChannel Request.
- *
- * \param  dlChannelReq Pointer to the function parameters.
- *
- * \retval Returns the status of the operation, according to the LoRaMAC specification.
- */
-uint8_t RegionEU433DlChannelReq(DlChannelReqParams_t *dlChannelReq);
-
-/*!
- * \brief Alternates the datarate of the channel for the join request.
- *
- * \param  alternateDr Pointer to the function parameters.
- *
- * \retval Datarate to apply.
- */
-int8_t RegionEU433AlternateDr(AlternateDrParams_t *alternateDr);
-
-/*!
- * \brief Calculates the back-off time.
- *
- * \param  calcBackOff Pointer to the function parameters.
- */
-void RegionEU433CalcBackOff(CalcBackOffParams_t *calcBackOff);
-
-/*!
- * \brief Searches and set the next random available channel
- *
- * \param  nextChanParams Parameters of next channel to use for TX.
- *
- * \param  channel Next channel to use for TX.
- *
- * \param  time Time to wait for the next transmission according to the duty
- *              cycle.
- *
- * \param  aggregatedTimeOff Updates the aggregated time off.
- *
- * \retval Function status [1: OK, 0: Unable to find a channel on the current datarate]
- */
-bool RegionEU433NextChannel(NextChanParams_t *nextChanParams, uint8_t *channel, TimerTime_t *time, TimerTime_t *aggregatedTimeOff);
-
-/*!
- * \brief Adds a channel.
- *
- * \param  channelAdd Pointer to the function parameters.
- *
- * \retval Status of the operation.
- */
-LoRaMacStatus_t RegionEU433ChannelAdd(ChannelAddParams_t *channelAdd);
-
-/*!
- * \brief Removes a channel.
- *
- * \param  channelRemove Pointer to the function parameters.
- *
- * \retval Returns true, if the channel was removed successfully.
- */
-bool RegionEU433ChannelsRemove(ChannelRemoveParams_t *channelRemove);
-
-/*!
- * \brief Sets the radio into continuous wave mode.
- *
- * \param  continuousWave Pointer to the function parameters.
- */
-void RegionEU433SetContinuousWave(ContinuousWaveParams_t *continuousWave);
-
-/*!
- * \brief Computes new datarate according to the given offset
- *
- * \param  downlinkDwellTime Downlink dwell time configuration. 0: No limit, 1: 400ms
- *
- * \param  dr Current datarate
- *
- * \param  drOffset Offset to be applied
- *
- * \retval newDr Computed datarate.
+ * Region EU433 channel plan, see RegionDynamic.h
  */
-uint8_t RegionEU433ApplyDrOffset(uint8_t downlinkDwellTime, int8_t dr, int8_t drOffset);
+extern const RegionDynamicPlan_t RegionEU433Plan;
 
 #endif // __REGION_EU433_H__
@@ -0,0 +1,1071 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+    (C)2013 Semtech
+ ___ _____ _   ___ _  _____ ___  ___  ___ ___
+/ __|_   _/_\ / __| |/ / __/ _ \| _ \/ __| __|
+\__ \ | |/ _ \ (__| ' <| _| (_) |   / (__| _|
+|___/ |_/_/ \_\___|_|\_\_| \___/|_|_\\___|___|
+embedded.connectivity.solutions===============
+
+Description: LoRa MAC fixed channel plan implementation, shared by
+             US915, AU915 and CN470
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+
+Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jaeckle ( STACKFORCE )
+*/
+#include "mac/Commissioning.h"
+
+#if defined(REGION_US915) || defined(REGION_AU915) || defined(REGION_CN470)
+
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "boards/mcu/board.h"
+#include "mac/LoRaMac.h"
+
+#include "system/utilities.h"
+
+#include "Region.h"
+#include "RegionCommon.h"
+#include "RegionFixed.h"
+
+// Definitions
+#define CHANNELS_MASK_SIZE 6
+
+// Global attributes
+/*!
+ * LoRaMAC channels, shared by all fixed channel plans
+ */
+static ChannelParams_t Channels[FIXED_MAX_NB_CHANNELS];
+
+/*!
+ * LoRaMac bands, shared by all fixed channel plans
+ */
+static Band_t Bands[FIXED_MAX_NB_BANDS];
+
+/*!
+ * Channel plan that owns the channels and bands
+ */
+static const RegionFixedPlan_t *ActivePlan = NULL;
+
+/*!
+ * LoRaMac channels mask
+ */
+extern uint16_t ChannelsMask[6];
+
+/*!
+ * LoRaMac channels remaining
+ */
+extern uint16_t ChannelsMaskRemaining[];
+
+/*!
+ * LoRaMac channels default mask
+ */
+extern uint16_t ChannelsDefaultMask[];
+
+// Static functions
+static int8_t GetNextLowerTxDr(int8_t dr, int8_t minDr)
+{
+	uint8_t nextLowerDr = 0;
+
+	if (dr == minDr)
+	{
+		nextLowerDr = minDr;
+	}
+	else
+	{
+		nextLowerDr = dr - 1;
+	}
+	return nextLowerDr;
+}
+
+static uint32_t GetBandwidth(const RegionFixedPlan_t *plan, uint32_t drIndex)
+{
+	switch (plan->Bandwidths[drIndex])
+	{
+	default:
+	case 125000:
+		return 0;
+	case 250000:
+		return 1;
+	case 500000:
+		return 2;
+	}
+}
+
+static int8_t LimitTxPower(const RegionFixedPlan_t *plan, int8_t txPower, int8_t maxBandTxPower, int8_t datarate, uint16_t *channelsMask)
+{
+	int8_t txPowerResult = txPower;
+
+	// Limit tx power to the band max
+	txPowerResult = T_MAX(txPower, maxBandTxPower);
+
+	if (plan->FccTxPowerLimit == true)
+	{
+		if (datarate == plan->Datarate500)
+		{ // Limit tx power to max 26dBm
+			txPowerResult = T_MAX(txPower, TX_POWER_2);
+		}
+		else
+		{
+			if (RegionCommonCountChannels(channelsMask, 0, plan->Nb125Channels / 16) < 50)
+			{ // Limit tx power to max 21dBm
+				txPowerResult = T_MAX(txPower, TX_POWER_5);
+			}
+		}
+	}
+	return txPowerResult;
+}
+
+static int8_t ComputeTxPower(const RegionFixedPlan_t *plan, int8_t txPowerIndex, float maxEirp, float antennaGain)
+{
+	if (plan->FixedMaxErp != 0)
+	{
+		return RegionCommonComputeTxPower(txPowerIndex, plan->FixedMaxErp, 0);
+	}
+	return RegionCommonComputeTxPower(txPowerIndex, maxEirp, antennaGain);
+}
+
+static uint8_t CountNbOfEnabledChannels(const RegionFixedPlan_t *plan, uint8_t datarate, uint16_t *channelsMask, ChannelParams_t *channels, Band_t *bands, uint8_t *enabledChannels, uint8_t *delayTx)
+{
+	uint8_t nbEnabledChannels = 0;
+	uint8_t delayTransmission = 0;
+
+	for (uint8_t i = 0, k = 0; i < plan->NbChannels; i += 16, k++)
+	{
+		for (uint8_t j = 0; j < 16; j++)
+		{
+			if ((channelsMask[k] & (1 << j)) != 0)
+			{
+				if (channels[i + j].Frequency == 0)
+				{ // Check if the channel is enabled
+					continue;
+				}
+				if (RegionCommonValueInRange(datarate, channels[i + j].DrRange.Fields.Min,
+											 channels[i + j].DrRange.Fields.Max) == false)
+				{ // Check if the current channel selection supports the given datarate
+					continue;
+				}
+				if (bands[channels[i + j].Band].TimeOff > 0)
+				{ // Check if the band is available for transmission
+					delayTransmission++;
+					continue;
+				}
+				enabledChannels[nbEnabledChannels++] = i + j;
+			}
+		}
+	}
+
+	*delayTx = delayTransmission;
+	return nbEnabledChannels;
+}
+
+PhyParam_t RegionFixedGetPhyParam(const RegionFixedPlan_t *plan, GetPhyParams_t *getPhy)
+{
+	PhyParam_t phyParam = {0};
+
+	switch (getPhy->Attribute)
+	{
+	case PHY_MIN_RX_DR:
+	{
+		phyParam.Value = plan->RxMinDatarate;
+		break;
+	}
+	case PHY_MIN_TX_DR:
+	{
+		phyParam.Value = plan->TxMinDatarate;
+		break;
+	}
+	case PHY_DEF_TX_DR:
+	{
+		phyParam.Value = plan->DefaultDatarate;
+		break;
+	}
+	case PHY_NEXT_LOWER_TX_DR:
+	{
+		phyParam.Value = GetNextLowerTxDr(getPhy->Datarate, plan->TxMinDatarate);
+		break;
+	}
+	case PHY_SF:
+	{
+		phyParam.Value = plan->Datarates[getPhy->Datarate];
+		break;
+	}
+	case PHY_BANDWIDTH:
+	{
+		phyParam.Value = plan->Bandwidths[getPhy->Datarate];
+		break;
+	}
+	case PHY_DEF_DR_BANDS:
+	{
+		// All channels are in band 0
+		for (uint8_t i = 0; i < plan->NbChannels; i++)
+		{
+			DrRange_t drRange;
+			drRange.Value = (i < plan->Nb125Channels) ? plan->Channel125DrRange : plan->Channel500DrRange;
+			if (((plan->DefaultChannelsMask[i / 16] & (1 << (i % 16))) != 0) &&
+				(RegionCommonValueInRange(getPhy->Datarate, drRange.Fields.Min, drRange.Fields.Max) == 1))
+			{
+				phyParam.Value = 1 << 0;
+				break;
+			}
+		}
+		break;
+	}
+	case PHY_DEF_BAND_DCYCLE:
+	{
+		if (getPhy->Band < plan->NbBands)
+		{
+			phyParam.Value = plan->Bands[getPhy->Band].DCycle;
+		}
+		break;
+	}
+	case PHY_DEF_TX_POWER:
+	{
+		phyParam.Value = plan->DefaultTxPower;
+		break;
+	}
+	case PHY_MAX_PAYLOAD:
+	{
+		phyParam.Value = plan->MaxPayload[getPhy->Datarate];
+		break;
+	}
+	case PHY_MAX_PAYLOAD_REPEATER:
+	{
+		phyParam.Value = plan->MaxPayloadRepeater[getPhy->Datarate];
+		break;
+	}
+	case PHY_DUTY_CYCLE:
+	{
+		phyParam.Value = plan->DutyCycleEnabled;
+		break;
+	}
+	case PHY_MAX_RX_WINDOW:
+	{
+		phyParam.Value = plan->MaxRxWindow;
+		break;
+	}
+	case PHY_RECEIVE_DELAY1:
+	{
+		phyParam.Value = plan->ReceiveDelay1;
+		break;
+	}
+	case PHY_RECEIVE_DELAY2:
+	{
+		phyParam.Value = plan->ReceiveDelay2;
+		break;
+	}
+	case PHY_JOIN_ACCEPT_DELAY1:
+	{
+		phyParam.Value = plan->JoinAcceptDelay1;
+		break;
+	}
+	case PHY_JOIN_ACCEPT_DELAY2:
+	{
+		phyParam.Value = plan->JoinAcceptDelay2;
+		break;
+	}
+	case PHY_MAX_FCNT_GAP:
+	{
+		phyParam.Value = plan->MaxFCntGap;
+		break;
+	}
+	case PHY_ACK_TIMEOUT:
+	{
+		phyParam.Value = (plan->AckTimeout + randr(-(int32_t)plan->AckTimeoutRnd, plan->AckTimeoutRnd));
+		break;
+	}
+	case PHY_DEF_DR1_OFFSET:
+	{
+		phyParam.Value = plan->DefaultRx1DrOffset;
+		break;
+	}
+	case PHY_DEF_RX2_FREQUENCY:
+	{
+		phyParam.Value = plan->Rx2Frequency;
+		break;
+	}
+	case PHY_DEF_RX2_DR:
+	{
+		phyParam.Value = plan->Rx2Datarate;
+		break;
+	}
+	case PHY_CHANNELS_MASK:
+	{
+		phyParam.ChannelsMask = ChannelsMask;
+		break;
+	}
+	case PHY_CHANNELS_DEFAULT_MASK:
+	{
+		phyParam.ChannelsMask = ChannelsDefaultMask;
+		break;
+	}
+	case PHY_MAX_NB_CHANNELS:
+	{
+		phyParam.Value = plan->NbChannels;
+		break;
+	}
+	case PHY_CHANNELS:
+	{
+		phyParam.Channels = Channels;
+		break;
+	}
+	case PHY_MAX_NB_BANDS:
+	{
+		phyParam.Value = plan->NbBands;
+		break;
+	}
+	case PHY_BANDS:
+	{
+		phyParam.Bands = Bands;
+		break;
+	}
+	case PHY_DEF_UPLINK_DWELL_TIME:
+	case PHY_DEF_DOWNLINK_DWELL_TIME:
+	{
+		phyParam.Value = 0;
+		break;
+	}
+	case PHY_DEF_MAX_EIRP:
+	{
+		phyParam.fValue = plan->DefaultMaxEirp;
+		break;
+	}
+	case PHY_DEF_ANTENNA_GAIN:
+	{
+		phyParam.fValue = plan->DefaultAntennaGain;
+		break;
+	}
+	case PHY_NB_JOIN_TRIALS:
+	case PHY_DEF_NB_JOIN_TRIALS:
+	{
+		phyParam.Value = plan->NbJoinTrials;
+		break;
+	}
+	default:
+	{
+		break;
+	}
+	}
+
+	return phyParam;
+}
+
+void RegionFixedSetBandTxDone(const RegionFixedPlan_t *plan, SetBandTxDoneParams_t *txDone)
+{
+	(void)plan;
+	RegionCommonSetBandTxDone(txDone->Joined, &Bands[Channels[txDone->Channel].Band], txDone->LastTxDoneTime);
+}
+
+void RegionFixedInitDefaults(const RegionFixedPlan_t *plan, InitType_t type)
+{
+	switch (type)
+	{
+	case INIT_TYPE_INIT:
+	{
+		if (ActivePlan != plan)
+		{
+			// The channels and bands of the previous region are not valid anymore
+			memset(Channels, 0, sizeof(Channels));
+			memset(Bands, 0, sizeof(Bands));
+			memcpy(Bands, plan->Bands, plan->NbBands * sizeof(Band_t));
+			ActivePlan = plan;
+		}
+
+		// Channels
+		// 125 kHz channels
+		for (uint8_t i = 0; i < plan->Nb125Channels; i++)
+		{
+			Channels[i].Frequency = plan->Channel125Frequency + i * 200000;
+			Channels[i].DrRange.Value = plan->Channel125DrRange;
+			Channels[i].Band = 0;
+		}
+		// 500 kHz channels
+		for (uint8_t i = plan->Nb125Channels; i < plan->NbChannels; i++)
+		{
+			Channels[i].Frequency = plan->Channel500Frequency + (i - plan->Nb125Channels) * 1600000;
+			Channels[i].DrRange.Value = plan->Channel500DrRange;
+			Channels[i].Band = 0;
+		}
+
+		// Initialize the channels default mask
+		RegionCommonChanMaskCopy(ChannelsDefaultMask, (uint16_t *)plan->DefaultChannelsMask, CHANNELS_MASK_SIZE);
+
+		// Update the channels mask
+		RegionCommonChanMaskCopy(ChannelsMask, ChannelsDefaultMask, CHANNELS_MASK_SIZE);
+
+		if (plan->UseChannelsMaskRemaining == true)
+		{
+			// Copy into channels mask remaining
+			RegionCommonChanMaskCopy(ChannelsMaskRemaining, ChannelsMask, CHANNELS_MASK_SIZE);
+		}
+		break;
+	}
+	case INIT_TYPE_RESTORE:
+	{
+		// Restore channels default mask
+		RegionCommonChanMaskCopy(ChannelsMask, ChannelsDefaultMask, CHANNELS_MASK_SIZE);
+
+		if (plan->UseChannelsMaskRemaining == true)
+		{
+			for (uint8_t i = 0; i < CHANNELS_MASK_SIZE; i++)
+			{ // Copy-And the channels mask
+				ChannelsMaskRemaining[i] &= ChannelsMask[i];
+			}
+		}
+		break;
+	}
+	case INIT_TYPE_APP_DEFAULTS:
+	{
+		// Update the channels mask defaults
+		RegionCommonChanMaskCopy(ChannelsMask, ChannelsDefaultMask, CHANNELS_MASK_SIZE);
+
+		if (plan->UseChannelsMaskRemaining == true)
+		{
+			// Copy into channels mask remaining
+			RegionCommonChanMaskCopy(ChannelsMaskRemaining, ChannelsMask, CHANNELS_MASK_SIZE);
+		}
+		break;
+	}
+	default:
+	{
+		break;
+	}
+	}
+}
+
+bool RegionFixedVerify(const RegionFixedPlan_t *plan, VerifyParams_t *verify, PhyAttribute_t phyAttribute)
+{
+	switch (phyAttribute)
+	{
+	case PHY_TX_DR:
+	{
+		return RegionCommonValueInRange(verify->DatarateParams.Datarate, plan->TxMinDatarate, plan->TxMaxDatarate);
+	}
+	case PHY_DEF_TX_DR:
+	{
+		return RegionCommonValueInRange(verify->DatarateParams.Datarate, plan->TxMinDatarate, plan->DefMaxDatarate);
+	}
+	case PHY_RX_DR:
+	{
+		return RegionCommonValueInRange(verify->DatarateParams.Datarate, plan->RxMinDatarate, plan->RxMaxDatarate);
+	}
+	case PHY_DEF_TX_POWER:
+	case PHY_TX_POWER:
+	{
+		// Remark: switched min and max!
+		return RegionCommonValueInRange(verify->TxPower, plan->MaxTxPower, plan->MinTxPower);
+	}
+	case PHY_DUTY_CYCLE:
+	{
+		return plan->DutyCycleEnabled;
+	}
+	case PHY_NB_JOIN_TRIALS:
+	{
+		if (verify->NbJoinTrials < plan->NbJoinTrials)
+		{
+			return false;
+		}
+		break;
+	}
+	default:
+		return false;
+	}
+	return true;
+}
+
+void RegionFixedApplyCFList(const RegionFixedPlan_t *plan, ApplyCFListParams_t *applyCFList)
+{
+	(void)plan;
+	(void)applyCFList;
+	return;
+}
+
+bool RegionFixedChanMaskSet(const RegionFixedPlan_t *plan, ChanMaskSetParams_t *chanMaskSet)
+{
+	if (plan->MinNb125Channels != 0)
+	{
+		uint8_t nbChannels = RegionCommonCountChannels(chanMaskSet->ChannelsMaskIn, 0, plan->Nb125Channels / 16);
+
+		// Check the number of active channels
+		if ((nbChannels < plan->MinNb125Channels) &&
+			(nbChannels > 0))
+		{
+			return false;
+		}
+	}
+
+	switch (chanMaskSet->ChannelsMaskType)
+	{
+	case CHANNELS_MASK:
+	{
+		RegionCommonChanMaskCopy(ChannelsMask, chanMaskSet->ChannelsMaskIn, CHANNELS_MASK_SIZE);
+
+		if (plan->UseChannelsMaskRemaining == true)
+		{
+			for (uint8_t i = 0; i < CHANNELS_MASK_SIZE; i++)
+			{ // Copy-And the channels mask
+				ChannelsMaskRemaining[i] &= ChannelsMask[i];
+			}
+		}
+		break;
+	}
+	case CHANNELS_DEFAULT_MASK:
+	{
+		RegionCommonChanMaskCopy(ChannelsDefaultMask, chanMaskSet->ChannelsMaskIn, CHANNELS_MASK_SIZE);
+		break;
+	}
+	default:
+		return false;
+	}
+	return true;
+}
+
+bool RegionFixedAdrNext(const RegionFixedPlan_t *plan, AdrNextParams_t *adrNext, int8_t *drOut, int8_t *txPowOut, uint32_t *adrAckCounter)
+{
+	bool adrAckReq = false;
+	int8_t datarate = adrNext->Datarate;
+	int8_t txPower = adrNext->TxPower;
+	GetPhyParams_t getPhy;
+	PhyParam_t phyParam;
+
+	// Report back the adr ack counter
+	*adrAckCounter = adrNext->AdrAckCounter;
+
+	if (adrNext->AdrEnabled == true)
+	{
+		if (datarate == plan->TxMinDatarate)
+		{
+			*adrAckCounter = 0;
+			adrAckReq = false;
+		}
+		else
+		{
+			if (adrNext->AdrAckCounter >= plan->AdrAckLimit)
+			{
+				adrAckReq = true;
+				txPower = plan->MaxTxPower;
+			}
+			else
+			{
+				adrAckReq = false;
+			}
+			if (adrNext->AdrAckCounter >= (uint32_t)(plan->AdrAckLimit + plan->AdrAckDelay))
+			{
+				if ((adrNext->AdrAckCounter % plan->AdrAckDelay) == 1)
+				{
+					// Decrease the datarate
+					getPhy.Attribute = PHY_NEXT_LOWER_TX_DR;
+					getPhy.Datarate = datarate;
+					getPhy.UplinkDwellTime = adrNext->UplinkDwellTime;
+					phyParam = RegionFixedGetPhyParam(plan, &getPhy);
+					datarate = phyParam.Value;
+
+					if (datarate == plan->TxMinDatarate)
+					{
+						// We must set adrAckReq to false as soon as we reach the lowest datarate
+						adrAckReq = false;
+						if (adrNext->UpdateChanMask == true)
+						{
+							// Re-enable default channels
+							RegionCommonChanMaskCopy(ChannelsMask, (uint16_t *)plan->DefaultChannelsMask, CHANNELS_MASK_SIZE);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	*drOut = datarate;
+	*txPowOut = txPower;
+	return adrAckReq;
+}
+
+void RegionFixedComputeRxWindowParameters(const RegionFixedPlan_t *plan, int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams)
+{
+	double tSymbol = 0.0;
+
+	// Get the datarate, perform a boundary check
+	rxConfigParams->Datarate = T_MIN(datarate, plan->RxMaxDatarate);
+	rxConfigParams->Bandwidth = GetBandwidth(plan, rxConfigParams->Datarate);
+
+	tSymbol = RegionCommonComputeSymbolTimeLoRa(plan->Datarates[rxConfigParams->Datarate], plan->Bandwidths[rxConfigParams->Datarate]);
+
+	RegionCommonComputeRxWindowParameters(tSymbol, minRxSymbols, rxError, RADIO_WAKEUP_TIME, &rxConfigParams->WindowTimeout, &rxConfigParams->WindowOffset);
+}
+
+bool RegionFixedRxConfig(const RegionFixedPlan_t *plan, RxConfigParams_t *rxConfig, int8_t *datarate)
+{
+	int8_t dr = rxConfig->Datarate;
+	uint8_t maxPayload = 0;
+	int8_t phyDr = 0;
+	uint32_t frequency = rxConfig->Frequency;
+
+	if (Radio.GetStatus() != RF_IDLE)
+	{
+		return false;
+	}
+
+	if (rxConfig->Window == 0)
+	{
+		// Apply window 1 frequency
+		frequency = plan->FirstRx1Frequency + (rxConfig->Channel % plan->NbRx1Channels) * plan->Rx1Stepwidth;
+	}
+
+	// Read the physical datarate from the datarates table
+	phyDr = plan->Datarates[dr];
+
+	Radio.SetChannel(frequency);
+
+	// Radio configuration
+	// Radio.SetRxConfig(MODEM_LORA, rxConfig->Bandwidth, phyDr, 1, 0, 8, rxConfig->WindowTimeout, false, 0, false, 0, 0, true, rxConfig->RxContinuous);
+	// RAKwireless symbTimeout changed after tests done by RAKwireless
+	Radio.SetRxConfig(MODEM_LORA, rxConfig->Bandwidth, phyDr, 1, 0, 8, 0, false, 0, false, 0, 0, true, rxConfig->RxContinuous);
+
+	if (rxConfig->RepeaterSupport == true)
+	{
+		maxPayload = plan->MaxPayloadRepeater[dr];
+	}
+	else
+	{
+		maxPayload = plan->MaxPayload[dr];
+	}
+	Radio.SetMaxPayloadLength(MODEM_LORA, maxPayload + LORA_MAC_FRMPAYLOAD_OVERHEAD);
+
+	*datarate = (uint8_t)dr;
+	return true;
+}
+
+bool RegionFixedTxConfig(const RegionFixedPlan_t *plan, TxConfigParams_t *txConfig, int8_t *txPower, TimerTime_t *txTimeOnAir)
+{
+	int8_t phyDr = plan->Datarates[txConfig->Datarate];
+	int8_t txPowerLimited = LimitTxPower(plan, txConfig->TxPower, Bands[Channels[txConfig->Channel].Band].TxMaxPower, txConfig->Datarate, ChannelsMask);
+	uint32_t bandwidth = GetBandwidth(plan, txConfig->Datarate);
+	int8_t phyTxPower = 0;
+
+	// Calculate physical TX power
+	phyTxPower = ComputeTxPower(plan, txPowerLimited, txConfig->MaxEirp, txConfig->AntennaGain);
+
+	// Setup the radio frequency
+	Radio.SetChannel(Channels[txConfig->Channel].Frequency);
+	Radio.SetTxConfig(MODEM_LORA, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, plan->TxTimeout);
+
+	// Setup maximum payload lenght of the radio driver
+	Radio.SetMaxPayloadLength(MODEM_LORA, txConfig->PktLen);
+	// Get the time-on-air of the next tx frame
+	*txTimeOnAir = Radio.TimeOnAir(MODEM_LORA, txConfig->PktLen);
+	*txPower = txPowerLimited;
+
+	return true;
+}
+
+uint8_t RegionFixedLinkAdrReq(const RegionFixedPlan_t *plan, LinkAdrReqParams_t *linkAdrReq, int8_t *drOut, int8_t *txPowOut, uint8_t *nbRepOut, uint8_t *nbBytesParsed)
+{
+	uint8_t status = 0x07;
+	RegionCommonLinkAdrParams_t linkAdrParams;
+	uint8_t nextIndex = 0;
+	uint8_t bytesProcessed = 0;
+	uint16_t channelsMask[6] = {0, 0, 0, 0, 0, 0};
+	uint8_t nb125Blocks = plan->Nb125Channels / 16;
+	bool has500Channels = plan->Nb125Channels < plan->NbChannels;
+	GetPhyParams_t getPhy;
+	PhyParam_t phyParam;
+	RegionCommonLinkAdrReqVerifyParams_t linkAdrVerifyParams;
+
+	// Initialize local copy of channels mask
+	RegionCommonChanMaskCopy(channelsMask, ChannelsMask, CHANNELS_MASK_SIZE);
+
+	while (bytesProcessed < linkAdrReq->PayloadSize)
+	{
+		// Get ADR request parameters
+		nextIndex = RegionCommonParseLinkAdrReq(&(linkAdrReq->Payload[bytesProcessed]), &linkAdrParams);
+
+		if (nextIndex == 0)
+			break; // break loop, since no more request has been found
+
+		// Update bytes processed
+		bytesProcessed += nextIndex;
+
+		// Revert status, as we only check the last ADR request for the channel mask KO
+		status = 0x07;
+
+		if (linkAdrParams.ChMaskCtrl == 6)
+		{
+			// Enable all 125 kHz channels
+			for (uint8_t i = 0; i < nb125Blocks; i++)
+			{
+				channelsMask[i] = 0xFFFF;
+			}
+			if (has500Channels == true)
+			{
+				// Apply chMask to the 500 kHz channels
+				channelsMask[nb125Blocks] = linkAdrParams.ChMask;
+			}
+		}
+		else if ((linkAdrParams.ChMaskCtrl == 7) && (has500Channels == true))
+		{
+			// Disable all 125 kHz channels
+			for (uint8_t i = 0; i < nb125Blocks; i++)
+			{
+				channelsMask[i] = 0x0000;
+			}
+			// Apply chMask to the 500 kHz channels
+			channelsMask[nb125Blocks] = linkAdrParams.ChMask;
+		}
+		else if (linkAdrParams.ChMaskCtrl >= ((plan->NbChannels + 15) / 16))
+		{
+			// RFU
+			status &= 0xFE; // Channel mask KO
+		}
+		else
+		{
+			if (plan->LinkAdrChecksChannels == true)
+			{
+				for (uint8_t i = 0; i < 16; i++)
+				{
+					if (((linkAdrParams.ChMask & (1 << i)) != 0) &&
+						(Channels[linkAdrParams.ChMaskCtrl * 16 + i].Frequency == 0))
+					{					// Trying to enable an undefined channel
+						status &= 0xFE; // Channel mask KO
+					}
+				}
+			}
+			channelsMask[linkAdrParams.ChMaskCtrl] = linkAdrParams.ChMask;
+		}
+	}
+
+	// FCC 15.247 paragraph F mandates to hop on at least 2 125 kHz channels
+	if ((plan->MinNbLinkAdrChannels != 0) &&
+		(linkAdrParams.Datarate < plan->Datarate500) &&
+		(RegionCommonCountChannels(channelsMask, 0, nb125Blocks) < plan->MinNbLinkAdrChannels))
+	{
+		status &= 0xFE; // Channel mask KO
+	}
+
+	// Get the minimum possible datarate
+	getPhy.Attribute = PHY_MIN_TX_DR;
+	getPhy.UplinkDwellTime = linkAdrReq->UplinkDwellTime;
+	phyParam = RegionFixedGetPhyParam(plan, &getPhy);
+
+	linkAdrVerifyParams.Status = status;
+	linkAdrVerifyParams.AdrEnabled = linkAdrReq->AdrEnabled;
+	linkAdrVerifyParams.Datarate = linkAdrParams.Datarate;
+	linkAdrVerifyParams.TxPower = linkAdrParams.TxPower;
+	linkAdrVerifyParams.NbRep = linkAdrParams.NbRep;
+	linkAdrVerifyParams.CurrentDatarate = linkAdrReq->CurrentDatarate;
+	linkAdrVerifyParams.CurrentTxPower = linkAdrReq->CurrentTxPower;
+	linkAdrVerifyParams.CurrentNbRep = linkAdrReq->CurrentNbRep;
+	linkAdrVerifyParams.NbChannels = plan->NbChannels;
+	linkAdrVerifyParams.ChannelsMask = channelsMask;
+	linkAdrVerifyParams.MinDatarate = (int8_t)phyParam.Value;
+	linkAdrVerifyParams.MaxDatarate = plan->TxMaxDatarate;
+	linkAdrVerifyParams.Channels = Channels;
+	linkAdrVerifyParams.MinTxPower = plan->MinTxPower;
+	linkAdrVerifyParams.MaxTxPower = plan->MaxTxPower;
+
+	// Verify the parameters and update, if necessary
+	status = RegionCommonLinkAdrReqVerifyParams(&linkAdrVerifyParams, &linkAdrParams.Datarate, &linkAdrParams.TxPower, &linkAdrParams.NbRep);
+
+	// Update channelsMask if everything is correct
+	if (status == 0x07)
+	{
+		// Copy Mask
+		RegionCommonChanMaskCopy(ChannelsMask, channelsMask, CHANNELS_MASK_SIZE);
+
+		if (plan->UseChannelsMaskRemaining == true)
+		{
+			for (uint8_t i = 0; i < CHANNELS_MASK_SIZE; i++)
+			{
+				if (i < nb125Blocks)
+				{
+					ChannelsMaskRemaining[i] &= ChannelsMask[i];
+				}
+				else
+				{
+					ChannelsMaskRemaining[i] = ChannelsMask[i];
+				}
+			}
+		}
+	}
+
+	// Update status variables
+	*drOut = linkAdrParams.Datarate;
+	*txPowOut = linkAdrParams.TxPower;
+	*nbRepOut = linkAdrParams.NbRep;
+	*nbBytesParsed = bytesProcessed;
+
+	return status;
+}
+
+uint8_t RegionFixedRxParamSetupReq(const RegionFixedPlan_t *plan, RxParamSetupReqParams_t *rxParamSetupReq)
+{
+	uint8_t status = 0x07;
+	uint32_t freq = rxParamSetupReq->Frequency;
+
+	// Verify radio frequency
+	if ((Radio.CheckRfFrequency(freq) == false) ||
+		(freq < plan->FirstRx1Frequency) ||
+		(freq > plan->LastRx1Frequency) ||
+		(((freq - plan->FirstRx1Frequency) % plan->Rx1Stepwidth) != 0))
+	{
+		status &= 0xFE; // Channel frequency KO
+	}
+
+	// Verify datarate
+	if (RegionCommonValueInRange(rxParamSetupReq->Datarate, plan->RxMinDatarate, plan->RxMaxDatarate) == false)
+	{
+		status &= 0xFD; // Datarate KO
+	}
+	else if ((plan->RxRfuDatarates & (1 << rxParamSetupReq->Datarate)) != 0)
+	{
+		status &= 0xFD; // Datarate KO
+	}
+
+	// Verify datarate offset
+	if (RegionCommonValueInRange(rxParamSetupReq->DrOffset, plan->MinRx1DrOffset, plan->MaxRx1DrOffset) == false)
+	{
+		status &= 0xFB; // Rx1DrOffset range KO
+	}
+
+	return status;
+}
+
+uint8_t RegionFixedNewChannelReq(const RegionFixedPlan_t *plan, NewChannelReqParams_t *newChannelReq)
+{
+	(void)plan;
+	(void)newChannelReq;
+	// Datarate and frequency KO
+	return 0;
+}
+
+int8_t RegionFixedTxParamSetupReq(const RegionFixedPlan_t *plan, TxParamSetupReqParams_t *txParamSetupReq)
+{
+	(void)plan;
+	(void)txParamSetupReq;
+	return -1;
+}
+
+uint8_t RegionFixedDlChannelReq(const RegionFixedPlan_t *plan, DlChannelReqParams_t *dlChannelReq)
+{
+	(void)plan;
+	(void)dlChannelReq;
+	return 0;
+}
+
+int8_t RegionFixedAlternateDr(const RegionFixedPlan_t *plan, AlternateDrParams_t *alternateDr)
+{
+	static int8_t trialsCount = 0;
+	int8_t datarate = 0;
+
+	if (plan->JoinDr == FIXED_JOIN_DR_DR5_TO_DR0)
+	{
+		if ((alternateDr->NbTrials % 48) == 0)
+		{
+			datarate = DR_0;
+		}
+		else if ((alternateDr->NbTrials % 32) == 0)
+		{
+			datarate = DR_1;
+		}
+		else if ((alternateDr->NbTrials % 24) == 0)
+		{
+			datarate = DR_2;
+		}
+		else if ((alternateDr->NbTrials % 16) == 0)
+		{
+			datarate = DR_3;
+		}
+		else if ((alternateDr->NbTrials % 8) == 0)
+		{
+			datarate = DR_4;
+		}
+		else
+		{
+			datarate = DR_5;
+		}
+		return datarate;
+	}
+
+	// Re-enable 500 kHz default channels
+	ChannelsMask[plan->Nb125Channels / 16] = plan->DefaultChannelsMask[plan->Nb125Channels / 16];
+
+	if (plan->JoinDr == FIXED_JOIN_DR_EVERY_9TH_500KHZ)
+	{
+		// Alternates the data rate according to the channel sequence:
+		// Eight times a 125kHz channel and then one 500kHz channel
+		if (alternateDr->NbTrials % 9 == 0)
+		{
+			datarate = plan->Datarate500;
+		}
+		else
+		{
+			datarate = plan->TxMinDatarate;
+		}
+	}
+	else
+	{
+		if ((trialsCount & 0x01) == 0x01)
+		{
+			datarate = plan->Datarate500;
+		}
+		else
+		{
+			datarate = plan->TxMinDatarate;
+		}
+		trialsCount++;
+	}
+	return datarate;
+}
+
+void RegionFixedCalcBackOff(const RegionFixedPlan_t *plan, CalcBackOffParams_t *calcBackOff)
+{
+	RegionCommonCalcBackOffParams_t calcBackOffParams;
+
+	(void)plan;
+
+	calcBackOffParams.Channels = Channels;
+	calcBackOffParams.Bands = Bands;
+	calcBackOffParams.LastTxIsJoinRequest = calcBackOff->LastTxIsJoinRequest;
+	calcBackOffParams.Joined = calcBackOff->Joined;
+	calcBackOffParams.DutyCycleEnabled = calcBackOff->DutyCycleEnabled;
+	calcBackOffParams.Channel = calcBackOff->Channel;
+	calcBackOffParams.ElapsedTime = calcBackOff->ElapsedTime;
+	calcBackOffParams.TxTimeOnAir = calcBackOff->TxTimeOnAir;
+
+	RegionCommonCalcBackOff(&calcBackOffParams);
+}
+
+bool RegionFixedNextChannel(const RegionFixedPlan_t *plan, NextChanParams_t *nextChanParams, uint8_t *channel, TimerTime_t *time, TimerTime_t *aggregatedTimeOff)
+{
+	uint8_t nbEnabledChannels = 0;
+	uint8_t delayTx = 0;
+	uint8_t enabledChannels[FIXED_MAX_NB_CHANNELS] = {0};
+	uint8_t nb125Blocks = plan->Nb125Channels / 16;
+	uint16_t *channelsMask = ChannelsMask;
+	TimerTime_t nextTxDelay = 0;
+
+	if (plan->UseChannelsMaskRemaining == true)
+	{
+		channelsMask = ChannelsMaskRemaining;
+
+		// Count 125kHz channels
+		if (RegionCommonCountChannels(ChannelsMaskRemaining, 0, nb125Blocks) == 0)
+		{ // Reactivate default channels
+			RegionCommonChanMaskCopy(ChannelsMaskRemaining, ChannelsMask, nb125Blocks);
+		}
+		// Check other channels
+		if (nextChanParams->Datarate >= plan->Datarate500)
+		{
+			if ((ChannelsMaskRemaining[nb125Blocks] & 0x00FF) == 0)
+			{
+				ChannelsMaskRemaining[nb125Blocks] = ChannelsMask[nb125Blocks];
+			}
+		}
+	}
+	else
+	{
+		// Count 125kHz channels
+		if (RegionCommonCountChannels(ChannelsMask, 0, CHANNELS_MASK_SIZE) == 0)
+		{ // Reactivate default channels
+			RegionCommonChanMaskCopy(ChannelsMask, (uint16_t *)plan->DefaultChannelsMask, CHANNELS_MASK_SIZE);
+		}
+	}
+
+	if (nextChanParams->AggrTimeOff <= TimerGetElapsedTime(nextChanParams->LastAggrTx))
+	{
+		// Reset Aggregated time off
+		*aggregatedTimeOff = 0;
+
+		// Update bands Time OFF
+		nextTxDelay = RegionCommonUpdateBandTimeOff(nextChanParams->Joined, nextChanParams->DutyCycleEnabled, Bands, plan->NbBands);
+
+		// Search how many channels are enabled
+		nbEnabledChannels = CountNbOfEnabledChannels(plan, nextChanParams->Datarate,
+													 channelsMask, Channels,
+													 Bands, enabledChannels, &delayTx);
+	}
+	else
+	{
+		delayTx++;
+		nextTxDelay = nextChanParams->AggrTimeOff - TimerGetElapsedTime(nextChanParams->LastAggrTx);
+	}
+
+	if (nbEnabledChannels > 0)
+	{
+		// We found a valid channel
+		*channel = enabledChannels[randr(0, nbEnabledChannels - 1)];
+		if (plan->UseChannelsMaskRemaining == true)
+		{
+			// Disable the channel in the mask
+			RegionCommonChanDisable(ChannelsMaskRemaining, *channel, plan->Nb125Channels);
+		}
+
+		*time = 0;
+		return true;
+	}
+	else
+	{
+		if (delayTx > 0)
+		{
+			// Delay transmission due to AggregatedTimeOff or to a band time off
+			*time = nextTxDelay;
+			return true;
+		}
+		// Datarate not supported by any channel
+		*time = 0;
+		return false;
+	}
+}
+
+LoRaMacStatus_t RegionFixedChannelAdd(const RegionFixedPlan_t *plan, ChannelAddParams_t *channelAdd)
+{
+	(void)plan;
+	(void)channelAdd;
+	return LORAMAC_STATUS_PARAMETER_INVALID;
+}
+
+bool RegionFixedChannelsRemove(const RegionFixedPlan_t *plan, ChannelRemoveParams_t *channelRemove)
+{
+	(void)plan;
+	(void)channelRemove;
+	return false; // LORAMAC_STATUS_PARAMETER_INVALID;
+}
+
+void RegionFixedSetContinuousWave(const RegionFixedPlan_t *plan, ContinuousWaveParams_t *continuousWave)
+{
+	int8_t txPowerLimited = LimitTxPower(plan, continuousWave->TxPower, Bands[Channels[continuousWave->Channel].Band].TxMaxPower, continuousWave->Datarate, ChannelsMask);
+	int8_t phyTxPower = 0;
+	uint32_t frequency = Channels[continuousWave->Channel].Frequency;
+
+	// Calculate physical TX power
+	phyTxPower = ComputeTxPower(plan, txPowerLimited, continuousWave->MaxEirp, continuousWave->AntennaGain);
+
+	Radio.SetTxContinuousWave(frequency, phyTxPower, continuousWave->Timeout);
+}
+
+uint8_t RegionFixedApplyDrOffset(const RegionFixedPlan_t *plan, uint8_t downlinkDwellTime, int8_t dr, int8_t drOffset)
+{
+	int8_t datarate = dr - drOffset;
+
+	(void)downlinkDwellTime;
+
+	if (plan->DatarateOffsets != NULL)
+	{
+		datarate = plan->DatarateOffsets[dr * plan->NbRx1DrOffsets + drOffset];
+	}
+
+	if (datarate < 0)
+	{
+		datarate = DR_0;
+	}
+	return datarate;
+}
+
+#endif
@@ -0,0 +1,510 @@
+/*!
+ * \file      RegionFixed.h
+ *
+ * \brief     Generic implementation of the regions with a fixed channel plan
+ *
+ * \copyright Revised BSD License, see file LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013 Semtech
+ *
+ *               ___ _____ _   ___ _  _____ ___  ___  ___ ___
+ *              / __|_   _/_\ / __| |/ / __/ _ \| _ \/ __| __|
+ *              \__ \ | |/ _ \ (__| ' <| _| (_) |   / (__| _|
+ *              |___/ |_/_/ \_\___|_|\_\_| \___/|_|_\\___|___|
+ *              embedded.connectivity.solutions===============
+ *
+ * \endcode
+ *
+ * \author    Miguel Luis ( Semtech )
+ *
+ * \author    Gregory Cristian ( Semtech )
+ *
+ * \author    Daniel Jaeckle ( STACKFORCE )
+ *
+ * \defgroup  REGIONFIXED Fixed channel plan
+ *            Implementation shared by US915, AU915 and CN470.
+ *            The regions only differ by their RegionFixedPlan_t. The channels
+ *            and bands storage is shared, only one region is active at a time.
+ * \{
+ */
+#ifndef __REGION_FIXED_H__
+#define __REGION_FIXED_H__
+
+/*!
+ * Maximum number of channels of a fixed channel plan
+ */
+#define FIXED_MAX_NB_CHANNELS 96
+
+/*!
+ * Maximum number of bands of a fixed channel plan
+ */
+#define FIXED_MAX_NB_BANDS 1
+
+/*!
+ * Datarate sequence of the join requests
+ */
+typedef enum eRegionFixedJoinDr
+{
+	/*!
+	 * Eight times the lowest datarate, then once the 500 kHz datarate
+	 */
+	FIXED_JOIN_DR_EVERY_9TH_500KHZ,
+	/*!
+	 * Alternates between the lowest and the 500 kHz datarate
+	 */
+	FIXED_JOIN_DR_ALTERNATE_500KHZ,
+	/*!
+	 * Steps down from DR_5 to DR_0 over 48 trials
+	 */
+	FIXED_JOIN_DR_DR5_TO_DR0,
+} RegionFixedJoinDr_t;
+
+/*!
+ * Region specific parameters of a fixed channel plan
+ */
+typedef struct sRegionFixedPlan
+{
+	/*!
+	 * Region name, used for debug output
+	 */
+	const char *Name;
+	/*!
+	 * Number of channels
+	 */
+	uint8_t NbChannels;
+	/*!
+	 * Number of 125 kHz channels, they come first and fill whole mask words
+	 */
+	uint8_t Nb125Channels;
+	/*!
+	 * Frequency of the first 125 kHz channel [Hz]
+	 */
+	uint32_t Channel125Frequency;
+	/*!
+	 * Datarate range of the 125 kHz channels
+	 */
+	int8_t Channel125DrRange;
+	/*!
+	 * Frequency of the first 500 kHz channel [Hz]
+	 */
+	uint32_t Channel500Frequency;
+	/*!
+	 * Datarate range of the 500 kHz channels
+	 */
+	int8_t Channel500DrRange;
+	/*!
+	 * Datarate of the 500 kHz channels. -1 if the plan has none
+	 */
+	int8_t Datarate500;
+	/*!
+	 * Channels mask set on initialization and restored by ADR
+	 */
+	uint16_t DefaultChannelsMask[6];
+	/*!
+	 * Channels are taken from ChannelsMaskRemaining, so every enabled channel
+	 * is used once before a channel repeats
+	 */
+	bool UseChannelsMaskRemaining;
+	/*!
+	 * Minimum number of enabled 125 kHz channels accepted by the channels mask
+	 * setup. 0 if not checked
+	 */
+	uint8_t MinNb125Channels;
+	/*!
+	 * Minimum number of enabled 125 kHz channels accepted by a Link ADR Request
+	 * below the 500 kHz datarate. 0 if not checked
+	 */
+	uint8_t MinNbLinkAdrChannels;
+	/*!
+	 * Link ADR Request rejects a mask that enables an undefined channel
+	 */
+	bool LinkAdrChecksChannels;
+	/*!
+	 * Limit the TX power according to FCC part 15.247
+	 */
+	bool FccTxPowerLimit;
+	/*!
+	 * Band definitions
+	 */
+	const Band_t *Bands;
+	/*!
+	 * Number of bands
+	 */
+	uint8_t NbBands;
+	/*!
+	 * Frequency of the first RX1 channel [Hz]
+	 */
+	uint32_t FirstRx1Frequency;
+	/*!
+	 * Frequency of the last RX1 channel [Hz]
+	 */
+	uint32_t LastRx1Frequency;
+	/*!
+	 * Step between the RX1 channels [Hz]
+	 */
+	uint32_t Rx1Stepwidth;
+	/*!
+	 * Number of RX1 channels the uplink channels map to
+	 */
+	uint8_t NbRx1Channels;
+	/*!
+	 * Datarate to spreading factor table
+	 */
+	const uint8_t *Datarates;
+	/*!
+	 * Datarate to bandwidth table
+	 */
+	const uint32_t *Bandwidths;
+	/*!
+	 * Maximum payload per datarate
+	 */
+	const uint8_t *MaxPayload;
+	/*!
+	 * Maximum payload per datarate with repeater
+	 */
+	const uint8_t *MaxPayloadRepeater;
+	/*!
+	 * Up/Down link datarate table, one row of NbRx1DrOffsets per uplink
+	 * datarate. NULL for a plain subtraction
+	 */
+	const int8_t *DatarateOffsets;
+	/*!
+	 * Number of RX1 datarate offsets per row of DatarateOffsets
+	 */
+	uint8_t NbRx1DrOffsets;
+	/*!
+	 * Bit mask of the RFU datarates rejected by a RX Parameter Setup Request
+	 */
+	uint16_t RxRfuDatarates;
+	int8_t TxMinDatarate;
+	int8_t TxMaxDatarate;
+	int8_t RxMinDatarate;
+	int8_t RxMaxDatarate;
+	int8_t DefaultDatarate;
+	/*!
+	 * Highest datarate accepted as default datarate
+	 */
+	int8_t DefMaxDatarate;
+	int8_t MinRx1DrOffset;
+	int8_t MaxRx1DrOffset;
+	int8_t DefaultRx1DrOffset;
+	int8_t MinTxPower;
+	int8_t MaxTxPower;
+	int8_t DefaultTxPower;
+	float DefaultMaxEirp;
+	float DefaultAntennaGain;
+	/*!
+	 * Maximum ERP used for the TX power instead of the MAC maximum EIRP and
+	 * antenna gain. 0 to use the MAC values
+	 */
+	float FixedMaxErp;
+	uint16_t AdrAckLimit;
+	uint16_t AdrAckDelay;
+	bool DutyCycleEnabled;
+	uint32_t MaxRxWindow;
+	uint32_t ReceiveDelay1;
+	uint32_t ReceiveDelay2;
+	uint32_t JoinAcceptDelay1;
+	uint32_t JoinAcceptDelay2;
+	uint32_t MaxFCntGap;
+	uint32_t AckTimeout;
+	uint32_t AckTimeoutRnd;
+	uint32_t Rx2Frequency;
+	int8_t Rx2Datarate;
+	/*!
+	 * TX timeout of the radio [ms]
+	 */
+	uint32_t TxTimeout;
+	/*!
+	 * Default number of join trials, also the minimum accepted by the verification
+	 */
+	uint8_t NbJoinTrials;
+	/*!
+	 * Datarate sequence of the join requests
+	 */
+	RegionFixedJoinDr_t JoinDr;
+} RegionFixedPlan_t;
+
+/*!
+ * \brief The function gets a value of a specific phy attribute.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  getPhy Pointer to the function parameters.
+ *
+ * \retval Returns a structure containing the PHY parameter.
+ */
+PhyParam_t RegionFixedGetPhyParam(const RegionFixedPlan_t *plan, GetPhyParams_t *getPhy);
+
+/*!
+ * \brief Updates the last TX done parameters of the current channel.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  txDone Pointer to the function parameters.
+ */
+void RegionFixedSetBandTxDone(const RegionFixedPlan_t *plan, SetBandTxDoneParams_t *txDone);
+
+/*!
+ * \brief Initializes the channels masks and the channels.
+ *        Switching to another plan reloads the bands.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  type Sets the initialization type.
+ */
+void RegionFixedInitDefaults(const RegionFixedPlan_t *plan, InitType_t type);
+
+/*!
+ * \brief Verifies a parameter.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  verify Pointer to the function parameters.
+ *
+ * \param  phyAttribute Sets the initialization type.
+ *
+ * \retval Returns true, if the parameter is valid.
+ */
+bool RegionFixedVerify(const RegionFixedPlan_t *plan, VerifyParams_t *verify, PhyAttribute_t phyAttribute);
+
+/*!
+ * \brief The function parses the input buffer and sets up the channels of the
+ *        CF list.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  applyCFList Pointer to the function parameters.
+ */
+void RegionFixedApplyCFList(const RegionFixedPlan_t *plan, ApplyCFListParams_t *applyCFList);
+
+/*!
+ * \brief Sets a channels mask.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  chanMaskSet Pointer to the function parameters.
+ *
+ * \retval Returns true, if the channels mask could be set.
+ */
+bool RegionFixedChanMaskSet(const RegionFixedPlan_t *plan, ChanMaskSetParams_t *chanMaskSet);
+
+/*!
+ * \brief Calculates the next datarate to set, when ADR is on or off.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  adrNext Pointer to the function parameters.
+ *
+ * \param  drOut The calculated datarate for the next TX.
+ *
+ * \param  txPowOut The TX power for the next TX.
+ *
+ * \param  adrAckCounter The calculated ADR acknowledgement counter.
+ *
+ * \retval Returns true, if an ADR request should be performed.
+ */
+bool RegionFixedAdrNext(const RegionFixedPlan_t *plan, AdrNextParams_t *adrNext, int8_t *drOut, int8_t *txPowOut, uint32_t *adrAckCounter);
+
+/*!
+ * Computes the Rx window timeout and offset.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  datarate     Rx window datarate index to be used
+ *
+ * \param  minRxSymbols Minimum required number of symbols to detect an Rx frame.
+ *
+ * \param  rxError      System maximum timing error of the receiver. In milliseconds
+ *                      The receiver will turn on in a [-rxError : +rxError] ms
+ *                      interval around RxOffset
+ *
+ * \param  rxConfigParams Returns updated WindowTimeout and WindowOffset fields.
+ */
+void RegionFixedComputeRxWindowParameters(const RegionFixedPlan_t *plan, int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams);
+
+/*!
+ * \brief Configuration of the RX windows.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  rxConfig Pointer to the function parameters.
+ *
+ * \param  datarate The datarate index which was set.
+ *
+ * \retval Returns true, if the configuration was applied successfully.
+ */
+bool RegionFixedRxConfig(const RegionFixedPlan_t *plan, RxConfigParams_t *rxConfig, int8_t *datarate);
+
+/*!
+ * \brief TX configuration.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  txConfig Pointer to the function parameters.
+ *
+ * \param  txPower The tx power index which was set.
+ *
+ * \param  txTimeOnAir The time-on-air of the frame.
+ *
+ * \retval Returns true, if the configuration was applied successfully.
+ */
+bool RegionFixedTxConfig(const RegionFixedPlan_t *plan, TxConfigParams_t *txConfig, int8_t *txPower, TimerTime_t *txTimeOnAir);
+
+/*!
+ * \brief The function processes a Link ADR Request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  linkAdrReq Pointer to the function parameters.
+ *
+ * \param  drOut The datarate which was applied.
+ *
+ * \param  txPowOut The TX power which was applied.
+ *
+ * \param  nbRepOut The number of repetitions to apply.
+ *
+ * \param  nbBytesParsed The number bytes which were parsed.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+uint8_t RegionFixedLinkAdrReq(const RegionFixedPlan_t *plan, LinkAdrReqParams_t *linkAdrReq, int8_t *drOut, int8_t *txPowOut, uint8_t *nbRepOut, uint8_t *nbBytesParsed);
+
+/*!
+ * \brief The function processes a RX Parameter Setup Request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  rxParamSetupReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+uint8_t RegionFixedRxParamSetupReq(const RegionFixedPlan_t *plan, RxParamSetupReqParams_t *rxParamSetupReq);
+
+/*!
+ * \brief The function processes a Channel Request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  newChannelReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+uint8_t RegionFixedNewChannelReq(const RegionFixedPlan_t *plan, NewChannelReqParams_t *newChannelReq);
+
+/*!
+ * \brief The function processes a TX ParamSetup Request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  txParamSetupReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ *         Returns -1, if the functionality is not implemented. In this case, the end node
+ *         shall not process the command.
+ */
+int8_t RegionFixedTxParamSetupReq(const RegionFixedPlan_t *plan, TxParamSetupReqParams_t *txParamSetupReq);
+
+/*!
+ * \brief The function processes a DlChannel Request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  dlChannelReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+uint8_t RegionFixedDlChannelReq(const RegionFixedPlan_t *plan, DlChannelReqParams_t *dlChannelReq);
+
+/*!
+ * \brief Alternates the datarate of the channel for the join request.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  alternateDr Pointer to the function parameters.
+ *
+ * \retval Datarate to apply.
+ */
+int8_t RegionFixedAlternateDr(const RegionFixedPlan_t *plan, AlternateDrParams_t *alternateDr);
+
+/*!
+ * \brief Calculates the back-off time.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  calcBackOff Pointer to the function parameters.
+ */
+void RegionFixedCalcBackOff(const RegionFixedPlan_t *plan, CalcBackOffParams_t *calcBackOff);
+
+/*!
+ * \brief Searches and set the next random available channel
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  nextChanParams Pointer to the function parameters.
+ *
+ * \param  channel Next channel to use for TX.
+ *
+ * \param  time Time to wait for the next transmission according to the duty
+ *              cycle.
+ *
+ * \param  aggregatedTimeOff Updates the aggregated time off.
+ *
+ * \retval Function status [1: OK, 0: Unable to find a channel on the current datarate]
+ */
+bool RegionFixedNextChannel(const RegionFixedPlan_t *plan, NextChanParams_t *nextChanParams, uint8_t *channel, TimerTime_t *time, TimerTime_t *aggregatedTimeOff);
+
+/*!
+ * \brief Adds a channel.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  channelAdd Pointer to the function parameters.
+ *
+ * \retval Status of the operation.
+ */
+LoRaMacStatus_t RegionFixedChannelAdd(const RegionFixedPlan_t *plan, ChannelAddParams_t *channelAdd);
+
+/*!
+ * \brief Removes a channel.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  channelRemove Pointer to the function parameters.
+ *
+ * \retval Returns true, if the channel was removed successfully.
+ */
+bool RegionFixedChannelsRemove(const RegionFixedPlan_t *plan, ChannelRemoveParams_t *channelRemove);
+
+/*!
+ * \brief Sets the radio into continuous wave mode.
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  continuousWave Pointer to the function parameters.
+ */
+void RegionFixedSetContinuousWave(const RegionFixedPlan_t *plan, ContinuousWaveParams_t *continuousWave);
+
+/*!
+ * \brief Computes new datarate according to the given offset
+ *
+ * \param  plan Region channel plan.
+ *
+ * \param  downlinkDwellTime Downlink dwell time configuration. 0: No limit, 1: 400ms
+ *
+ * \param  dr Current datarate
+ *
+ * \param  drOffset Offset to be applied
+ *
+ * \retval newDr Computed datarate.
+ */
+uint8_t RegionFixedApplyDrOffset(const RegionFixedPlan_t *plan, uint8_t downlinkDwellTime, int8_t dr, int8_t drOffset);
+
+#endif // __REGION_FIXED_H__
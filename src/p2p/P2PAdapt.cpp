@@ -0,0 +1,236 @@
+/**
+ * @file P2PAdapt.cpp
+ * @brief Link adaptation that selects the LoRa modulation per peer from the link history
+ */
+#include "p2p/P2PAdapt.h"
+#include "p2p/P2PPower.h"
+
+/** Weight of a new frame in the packet error rate, 1/8 */
+#define ADAPT_PER_SHIFT 3
+
+/** Aging of the packet error rates of the unused data rates per report, 1/16 */
+#define ADAPT_AGE_SHIFT 4
+
+/** Link state of a peer */
+typedef struct
+{
+	uint8_t address;
+	bool used;
+	uint32_t last_active;
+	uint8_t fails;
+	uint16_t per[P2P_ADAPT_MAX_DR];
+	p2p_adapt_stats_t stats;
+} adapt_peer_t;
+
+static p2p_adapt_dr_t adaptRates[P2P_ADAPT_MAX_DR];
+static ModulationParams_t adaptModParams[P2P_ADAPT_MAX_DR];
+/** Demodulation threshold of a data rate relative to the noise floor in 0.1 dB */
+static int16_t adaptThreshold[P2P_ADAPT_MAX_DR];
+static uint8_t adaptCount = 0;
+static uint16_t adaptTargetPer = 100;
+static int8_t adaptTargetMargin = 5;
+
+static adapt_peer_t adaptPeers[P2P_ADAPT_MAX_PEERS];
+
+/**
+ * @brief Find the link state of a peer
+ * Unknown peers start with the slowest data rate, the least recently active peer is replaced.
+ *
+ * @param address address of the peer
+ * @param create create the state if the peer is unknown
+ * @return adapt_peer_t* link state or NULL
+ */
+static adapt_peer_t *getPeer(uint8_t address, bool create)
+{
+	adapt_peer_t *candidate = NULL;
+
+	for (int idx = 0; idx < P2P_ADAPT_MAX_PEERS; idx++)
+	{
+		adapt_peer_t *peer = &adaptPeers[idx];
+		if (peer->used && (peer->address == address))
+		{
+			peer->last_active = millis();
+			return peer;
+		}
+		if (!peer->used)
+		{
+			if ((candidate == NULL) || candidate->used)
+			{
+				candidate = peer;
+			}
+		}
+		else if ((candidate == NULL) || (candidate->used && ((int32_t)(peer->last_active - candidate->last_active) < 0)))
+		{
+			candidate = peer;
+		}
+	}
+	if (!create)
+	{
+		return NULL;
+	}
+
+	memset(candidate, 0, sizeof(adapt_peer_t));
+	candidate->address = address;
+	candidate->used = true;
+	candidate->last_active = millis();
+	candidate->stats.margin = P2P_POWER_NO_MARGIN;
+	return candidate;
+}
+
+/**
+ * @brief Set the data rate of a peer
+ *
+ * @param peer link state
+ * @param dr data rate index
+ */
+static void setDr(adapt_peer_t *peer, uint8_t dr)
+{
+	if (dr != peer->stats.dr)
+	{
+		LOG_LIB("ADAPT", "Peer %02X SF%d BW %d", peer->address, adaptRates[dr].sf, adaptRates[dr].bw);
+		peer->stats.dr = dr;
+		peer->fails = 0;
+	}
+}
+
+p2p_adapt_status p2p_adapt_init(p2p_adapt_dr_t *rates, uint8_t count, uint16_t target_per, int8_t target_margin)
+{
+	if ((rates == NULL) || (count == 0) || (count > P2P_ADAPT_MAX_DR))
+	{
+		return P2P_ADAPT_ERROR;
+	}
+
+	for (uint8_t idx = 0; idx < count; idx++)
+	{
+		uint32_t bandwidth = SX126xGetLoRaBandwidthHz((RadioLoRaBandwidths_t)rates[idx].bw);
+		if ((rates[idx].sf < 5) || (rates[idx].sf > 12) || (bandwidth == 0))
+		{
+			return P2P_ADAPT_ERROR;
+		}
+		uint32_t symbol = (uint32_t)(((uint64_t)1000000 << rates[idx].sf) / bandwidth);
+
+		adaptRates[idx] = rates[idx];
+		adaptModParams[idx].PacketType = PACKET_TYPE_LORA;
+		adaptModParams[idx].Params.LoRa.SpreadingFactor = (RadioLoRaSpreadingFactors_t)rates[idx].sf;
+		adaptModParams[idx].Params.LoRa.Bandwidth = (RadioLoRaBandwidths_t)rates[idx].bw;
+		adaptModParams[idx].Params.LoRa.CodingRate = (RadioLoRaCodingRates_t)rates[idx].cr;
+		// Low datarate optimization is required for symbols of 16.38 ms and longer
+		adaptModParams[idx].Params.LoRa.LowDatarateOptimize = symbol >= 16380 ? 0x01 : 0x00;
+		// SNR limit of -7.5 dB at SF7, 2.5 dB lower per SF step, plus the noise of the bandwidth
+		adaptThreshold[idx] = -25 * (rates[idx].sf - 4) + (int16_t)(100.0f * log10f((float)bandwidth));
+	}
+	adaptCount = count;
+	adaptTargetPer = target_per;
+	adaptTargetMargin = target_margin;
+	memset(adaptPeers, 0, sizeof(adaptPeers));
+	return P2P_ADAPT_SUCCESS;
+}
+
+uint8_t p2p_adapt_apply(uint8_t address)
+{
+	if (adaptCount == 0)
+	{
+		return 0;
+	}
+	adapt_peer_t *peer = getPeer(address, true);
+	SX126xSetModulationParams(&adaptModParams[peer->stats.dr]);
+	// Keeps the time on air in line with the data rate
+	SX126x.ModulationParams = adaptModParams[peer->stats.dr];
+	return peer->stats.dr;
+}
+
+void p2p_adapt_tx_result(uint8_t address, uint8_t size, bool success)
+{
+	if (adaptCount == 0)
+	{
+		return;
+	}
+	adapt_peer_t *peer = getPeer(address, true);
+	uint8_t dr = peer->stats.dr;
+	uint16_t *per = &peer->per[dr];
+
+	peer->stats.tx_frames++;
+	peer->stats.airtime += Radio.TimeOnAir(MODEM_LORA, size);
+	*per = *per - (*per >> ADAPT_PER_SHIFT) + (success ? 0 : (1000 >> ADAPT_PER_SHIFT));
+	if (success)
+	{
+		peer->stats.delivered += size;
+		peer->fails = 0;
+		return;
+	}
+	if ((++peer->fails >= P2P_ADAPT_MAX_FAILS) && (dr > 0))
+	{
+		peer->stats.fallbacks++;
+		setDr(peer, dr - 1);
+	}
+}
+
+void p2p_adapt_report(uint8_t address, int8_t margin)
+{
+	if ((adaptCount == 0) || (margin == P2P_POWER_NO_MARGIN))
+	{
+		return;
+	}
+	adapt_peer_t *peer = getPeer(address, true);
+	uint8_t dr = peer->stats.dr;
+	peer->stats.margin = margin;
+
+	for (uint8_t idx = 0; idx < adaptCount; idx++)
+	{
+		if (idx != dr)
+		{
+			peer->per[idx] -= peer->per[idx] >> ADAPT_AGE_SHIFT;
+		}
+	}
+
+	// Fastest data rate with enough estimated margin and a low error rate
+	uint8_t best = 0;
+	for (uint8_t idx = 0; idx < adaptCount; idx++)
+	{
+		int16_t estimate = margin * 10 - (adaptThreshold[idx] - adaptThreshold[dr]);
+		if ((estimate >= adaptTargetMargin * 10) && (peer->per[idx] <= adaptTargetPer))
+		{
+			best = idx;
+		}
+	}
+	if (best > dr)
+	{
+		// Move up carefully, one data rate per report
+		best = dr + 1;
+	}
+	setDr(peer, best);
+}
+
+void p2p_adapt_follow(uint8_t address, uint8_t sf)
+{
+	for (uint8_t idx = 0; idx < adaptCount; idx++)
+	{
+		if (adaptRates[idx].sf == sf)
+		{
+			setDr(getPeer(address, true), idx);
+			return;
+		}
+	}
+}
+
+uint16_t p2p_adapt_sf_mask(void)
+{
+	uint16_t mask = 0;
+	for (uint8_t idx = 0; idx < adaptCount; idx++)
+	{
+		mask |= 1 << adaptRates[idx].sf;
+	}
+	return mask;
+}
+
+p2p_adapt_status p2p_adapt_get_stats(uint8_t address, p2p_adapt_stats_t *stats)
+{
+	adapt_peer_t *peer = getPeer(address, false);
+	if (peer == NULL)
+	{
+		return P2P_ADAPT_ERROR;
+	}
+	*stats = peer->stats;
+	stats->per = peer->per[peer->stats.dr];
+	return P2P_ADAPT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file P2PAdapt.h
+ * @brief Link adaptation that selects the LoRa modulation per peer from the link history
+ *
+ * The application defines a table of data rates, each a combination of
+ * spreading factor, bandwidth and coding rate, ordered from the slowest to the
+ * fastest. The modulation parameters of all data rates are prepared at the
+ * start, switching a data rate is a single SPI command.
+ *
+ * For every peer the layer keeps the packet error rate of each data rate and
+ * the last link margin the peer reported, see p2p_power_margin() of P2PPower.h.
+ * After a margin report the fastest data rate is chosen whose estimated margin
+ * is above the target and whose packet error rate is below the target, moving up one
+ * data rate per report and down as far as needed. P2P_ADAPT_MAX_FAILS
+ * consecutive failed frames fall back to the next slower data rate. The error
+ * rates of the unused data rates age, so a data rate is tried again later.
+ *
+ * The initiator of the traffic, e.g. a sensor node, adapts. The receiver
+ * listens on all data rates with the CAD scanner of P2PScan.h, using
+ * p2p_adapt_sf_mask(), and answers a peer on the data rate it was heard on
+ * with p2p_adapt_follow(). With the scanner all data rates must use the
+ * same bandwidth.
+ *
+ * The P2P modules that register radio events own the radio exclusively, see
+ * initP2PEvents(). A receiver with the scanner can not run the ARQ layer of
+ * P2PArq.h at the same time, it sends its answers with the Radio API after
+ * p2p_scan_stop() and reports p2p_power_margin() in its own frames. The link
+ * adaptation and P2PPower.h register no radio events and work with any of
+ * the modules.
+ *
+ * Usage:
+ * 1. configure the radio with Radio.SetTxConfig() and Radio.SetRxConfig()
+ * 2. p2p_adapt_init() with the data rate table
+ * 3. p2p_adapt_apply() before a frame is sent to a peer
+ * 4. p2p_adapt_tx_result() with the result of the frame, p2p_adapt_report()
+ *    with the margin the peer reported
+ */
+#ifndef __P2PADAPT_H__
+#define __P2PADAPT_H__
+
+#include "stdint.h"
+#include "boards/mcu/board.h"
+
+#ifndef P2P_ADAPT_MAX_DR
+#define P2P_ADAPT_MAX_DR 8 /**< Max number of data rates */
+#endif
+#ifndef P2P_ADAPT_MAX_PEERS
+#define P2P_ADAPT_MAX_PEERS 8 /**< Peers with their own data rate */
+#endif
+#ifndef P2P_ADAPT_MAX_FAILS
+#define P2P_ADAPT_MAX_FAILS 3 /**< Consecutive failed frames before the next slower data rate is used */
+#endif
+
+typedef enum
+{
+	P2P_ADAPT_ERROR = -1,
+	P2P_ADAPT_SUCCESS = 0,
+	P2P_ADAPT_BUSY = 1
+} p2p_adapt_status;
+
+/**@brief Data rate of the table
+ */
+typedef struct p2p_adapt_dr_s
+{
+	uint8_t sf; /**< Spreading factor [5..12] */
+	uint8_t bw; /**< Bandwidth as RadioLoRaBandwidths_t, e.g. LORA_BW_125 */
+	uint8_t cr; /**< Coding rate [1: 4/5, 2: 4/6, 3: 4/7, 4: 4/8] */
+} p2p_adapt_dr_t;
+
+/**@brief Link adaptation statistics of a peer
+ */
+typedef struct p2p_adapt_stats_s
+{
+	uint8_t dr;				  /**< Current data rate index */
+	int8_t margin;			  /**< Last margin reported by the peer in dB */
+	uint16_t per;			  /**< Packet error rate of the current data rate in per mille */
+	uint32_t tx_frames;		  /**< Frames sent to the peer */
+	uint32_t fallbacks;		  /**< Data rate reductions after failed frames */
+	uint32_t delivered;		  /**< Payload bytes of the successful frames */
+	uint32_t airtime;		  /**< Time on air of all frames in ms */
+} p2p_adapt_stats_t;
+
+/**@brief Initialize the link adaptation and prepare the data rates
+ *
+ * @param rates Table of data rates, slowest first, the table is copied
+ * @param count Number of data rates, max P2P_ADAPT_MAX_DR
+ * @param target_per Max packet error rate in per mille
+ * @param target_margin Link margin in dB a faster data rate must keep
+ *
+ * @retval P2P_ADAPT_ERROR if the table is empty or invalid
+ */
+p2p_adapt_status p2p_adapt_init(p2p_adapt_dr_t *rates, uint8_t count, uint16_t target_per, int8_t target_margin);
+
+/**@brief Switch the radio to the data rate of a peer, the radio must not be in RX or TX
+ *
+ * @param address Address of the peer
+ *
+ * @retval data rate index
+ */
+uint8_t p2p_adapt_apply(uint8_t address);
+
+/**@brief Account the result of a frame sent to a peer
+ *
+ * @param address Address of the peer
+ * @param size Size of the payload
+ * @param success true if the frame was delivered
+ */
+void p2p_adapt_tx_result(uint8_t address, uint8_t size, bool success);
+
+/**@brief Select the data rate of a peer with the margin it reported
+ *
+ * @param address Address of the peer
+ * @param margin Margin in dB the peer measured on the current data rate
+ */
+void p2p_adapt_report(uint8_t address, int8_t margin);
+
+/**@brief Use the data rate a peer was heard on for the answers to it
+ *
+ * @param address Address of the peer
+ * @param sf Spreading factor of the received frame
+ */
+void p2p_adapt_follow(uint8_t address, uint8_t sf);
+
+/**@brief Get the spreading factors of the table for p2p_scan_start()
+ *
+ * @retval mask with bit n set for spreading factor n
+ */
+uint16_t p2p_adapt_sf_mask(void);
+
+/**@brief Get the link adaptation statistics of a peer
+ *
+ * @param address Address of the peer
+ * @param stats Structure to fill with the statistics
+ *
+ * @retval P2P_ADAPT_ERROR if the peer is unknown
+ */
+p2p_adapt_status p2p_adapt_get_stats(uint8_t address, p2p_adapt_stats_t *stats);
+
+#endif // __P2PADAPT_H__
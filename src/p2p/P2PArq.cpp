@@ -0,0 +1,901 @@
+/**
+ * @file P2PArq.cpp
+ * @brief Reliable P2P link layer with a selective repeat sliding window on top of the Radio API
+ */
+#include "p2p/P2PArq.h"
+#include "p2p/P2PPower.h"
+
+/** Frame header layout */
+#define ARQ_HDR_FLAGS 0
+#define ARQ_HDR_DST 1
+#define ARQ_HDR_SRC 2
+#define ARQ_HDR_SEQ 3
+#define ARQ_HDR_ACK 4
+#define ARQ_HDR_BITMAP 5
+#define ARQ_HDR_MARGIN 6
+
+/** Upper nibble of the flags, filters frames of other protocols */
+#define ARQ_MAGIC 0xA0
+#define ARQ_MAGIC_MASK 0xF0
+
+/** Frame carries data */
+#define ARQ_FLAG_DATA 0x01
+/** Frame carries the acknowledge of the reverse direction */
+#define ARQ_FLAG_ACK 0x02
+/** Last frame of a burst, the receiver should acknowledge immediately */
+#define ARQ_FLAG_ACK_REQ 0x04
+/** First frame after a link reset, the receiver restarts its window at this sequence number */
+#define ARQ_FLAG_SYNC 0x08
+
+/** Address that is not assigned to a node */
+#define ARQ_NO_ADDRESS 0xFF
+
+/** Data buffer of the radio kept free for the prepared acknowledge, including the hop header */
+#define ARQ_ACK_SPACE (P2P_ARQ_HEADER_SIZE + 3)
+
+/** Frame waiting in the send window */
+typedef struct
+{
+	uint8_t data[P2P_ARQ_MAX_PAYLOAD];
+	uint8_t size;
+	bool in_use;
+	bool acked;
+	bool need_tx;
+	bool sync;
+	uint8_t retries;
+} arq_tx_slot_t;
+
+/** Frame received out of order */
+typedef struct
+{
+	uint8_t data[P2P_ARQ_MAX_PAYLOAD];
+	uint8_t size;
+	bool valid;
+	int16_t rssi;
+	int8_t snr;
+} arq_rx_slot_t;
+
+/** Link state of a peer */
+typedef struct
+{
+	uint8_t address;
+	uint32_t last_active;
+	int8_t rx_margin;
+
+	// Send direction
+	uint8_t tx_base;
+	uint8_t tx_next;
+	bool tx_sync;
+	arq_tx_slot_t tx[P2P_ARQ_WINDOW];
+	bool rto_running;
+	uint32_t rto_deadline;
+	uint32_t srtt;
+	uint32_t rttvar;
+	uint32_t rto;
+	bool rtt_sample_valid;
+	uint8_t rtt_sample_seq;
+	uint32_t rtt_sample_time;
+
+	// Receive direction
+	bool rx_synced;
+	uint8_t rx_sync_seq;
+	uint8_t rx_base;
+	arq_rx_slot_t rx[P2P_ARQ_WINDOW];
+	bool ack_pending;
+	uint32_t ack_deadline;
+
+	p2p_arq_stats_t stats;
+} arq_peer_t;
+
+/** Frame on air */
+typedef struct
+{
+	arq_peer_t *peer;
+	bool is_data;
+	bool ack_req;
+	uint8_t seq;
+	uint8_t size;
+} arq_tx_state_t;
+
+static p2p_arq_callback_t *arqCallbacks;
+static RadioEvents_t arqRadioEvents;
+static TimerEvent_t arqTimer;
+
+static uint8_t arqAddress = ARQ_NO_ADDRESS;
+static arq_peer_t arqPeers[P2P_ARQ_MAX_PEERS];
+static uint8_t arqNextPeer = 0;
+
+static volatile bool arqTxBusy = false;
+static arq_tx_state_t arqTxState;
+static uint8_t arqTxBuffer[P2P_ARQ_HEADER_SIZE + P2P_ARQ_MAX_PAYLOAD];
+
+/** Acknowledge loaded into the radio while it receives */
+static uint8_t arqAckBuffer[P2P_ARQ_HEADER_SIZE];
+static bool arqAckPrepared = false;
+
+/** Lower limit and start value of the retransmit timeout, computed from the time on air */
+static uint32_t arqMinRto = 1000;
+
+/** State for the initial sequence numbers */
+static uint32_t arqSeqSeed = 0;
+
+static void OnArqTxDone(void);
+static void OnArqTxTimeout(void);
+static void OnArqRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr);
+static void OnArqRxTimeout(void);
+static void OnArqRxError(void);
+static void OnArqTimerEvent(void);
+
+/**
+ * @brief Check if a time stamp is reached
+ *
+ * @param deadline time stamp in ms
+ * @param now current time in ms
+ * @return true if the deadline is reached
+ */
+static bool deadlineReached(uint32_t deadline, uint32_t now)
+{
+	return (int32_t)(now - deadline) >= 0;
+}
+
+/**
+ * @brief Reset the send direction of a peer
+ * Called for a new peer and after a frame failed, the next frame restarts the window of the receiver
+ *
+ * @param peer link state
+ */
+static void resetTx(arq_peer_t *peer)
+{
+	arqSeqSeed = arqSeqSeed * 1103515245 + 12345;
+	uint8_t seq = (uint8_t)(arqSeqSeed >> 16);
+	if (peer->tx_base != peer->tx_next)
+	{
+		// Keep the sequence numbers moving, the receiver may still know the old ones
+		seq = peer->tx_next;
+	}
+	peer->tx_base = seq;
+	peer->tx_next = seq;
+	peer->tx_sync = true;
+	peer->rto_running = false;
+	peer->rtt_sample_valid = false;
+	for (int idx = 0; idx < P2P_ARQ_WINDOW; idx++)
+	{
+		peer->tx[idx].in_use = false;
+	}
+}
+
+/**
+ * @brief Find the link state of a peer
+ *
+ * @param address address of the peer
+ * @param create create the link state if the peer is unknown
+ * @return arq_peer_t* link state or NULL
+ */
+static arq_peer_t *getPeer(uint8_t address, bool create)
+{
+	arq_peer_t *candidate = NULL;
+	for (int idx = 0; idx < P2P_ARQ_MAX_PEERS; idx++)
+	{
+		arq_peer_t *peer = &arqPeers[idx];
+		// Free entries carry ARQ_NO_ADDRESS, they never match a peer
+		if ((peer->address != ARQ_NO_ADDRESS) && (peer->address == address))
+		{
+			peer->last_active = millis();
+			return peer;
+		}
+		if (!create)
+		{
+			continue;
+		}
+		// Prefer a free entry, else replace the least recently active peer without frames in flight
+		if (peer->address == ARQ_NO_ADDRESS)
+		{
+			if ((candidate == NULL) || (candidate->address != ARQ_NO_ADDRESS))
+			{
+				candidate = peer;
+			}
+		}
+		else if ((peer->tx_base == peer->tx_next) && !peer->ack_pending &&
+				 ((candidate == NULL) || ((candidate->address != ARQ_NO_ADDRESS) && ((int32_t)(peer->last_active - candidate->last_active) < 0))))
+		{
+			candidate = peer;
+		}
+	}
+	if (candidate == NULL)
+	{
+		return NULL;
+	}
+
+	memset(candidate, 0, sizeof(arq_peer_t));
+	candidate->address = address;
+	candidate->last_active = millis();
+	candidate->rx_margin = P2P_POWER_NO_MARGIN;
+	candidate->rto = 2 * arqMinRto;
+	resetTx(candidate);
+	return candidate;
+}
+
+/**
+ * @brief Build the acknowledge bitmap of the frames received after the window base
+ *
+ * @param peer link state
+ * @return uint8_t bit n set if frame rx_base + 1 + n was received
+ */
+static uint8_t rxBitmap(arq_peer_t *peer)
+{
+	uint8_t bitmap = 0;
+	for (uint8_t idx = 0; idx < P2P_ARQ_WINDOW - 1; idx++)
+	{
+		uint8_t seq = peer->rx_base + 1 + idx;
+		if (peer->rx[seq % P2P_ARQ_WINDOW].valid)
+		{
+			bitmap |= (1 << idx);
+		}
+	}
+	return bitmap;
+}
+
+/**
+ * @brief Fill the frame header
+ *
+ * @param buffer frame buffer
+ * @param peer link state
+ * @param flags frame flags
+ * @param seq sequence number
+ */
+static void buildHeader(uint8_t *buffer, arq_peer_t *peer, uint8_t flags, uint8_t seq)
+{
+	buffer[ARQ_HDR_FLAGS] = flags;
+	buffer[ARQ_HDR_DST] = peer->address;
+	buffer[ARQ_HDR_SRC] = arqAddress;
+	buffer[ARQ_HDR_SEQ] = seq;
+	buffer[ARQ_HDR_ACK] = peer->rx_base;
+	buffer[ARQ_HDR_BITMAP] = rxBitmap(peer);
+	buffer[ARQ_HDR_MARGIN] = (uint8_t)peer->rx_margin;
+}
+
+/**
+ * @brief Find the next frame of a peer that waits for transmission
+ *
+ * @param peer link state
+ * @param from first sequence number to check
+ * @param seq found sequence number
+ * @return true if a frame was found
+ */
+static bool nextTxFrame(arq_peer_t *peer, uint8_t from, uint8_t *seq)
+{
+	uint8_t outstanding = peer->tx_next - peer->tx_base;
+	for (uint8_t offset = from - peer->tx_base; offset < outstanding; offset++)
+	{
+		uint8_t check = peer->tx_base + offset;
+		arq_tx_slot_t *slot = &peer->tx[check % P2P_ARQ_WINDOW];
+		if (slot->need_tx && !slot->acked)
+		{
+			*seq = check;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Send a frame to a peer, data if available, else an acknowledge only frame
+ *
+ * @param peer link state
+ * @return true if a frame was sent
+ */
+static bool sendFrame(arq_peer_t *peer)
+{
+	uint8_t seq = 0;
+	uint8_t size = P2P_ARQ_HEADER_SIZE;
+	uint8_t flags = ARQ_MAGIC;
+	bool is_data = nextTxFrame(peer, peer->tx_base, &seq);
+
+	if (!is_data && !peer->ack_pending)
+	{
+		return false;
+	}
+
+	if (is_data)
+	{
+		arq_tx_slot_t *slot = &peer->tx[seq % P2P_ARQ_WINDOW];
+		uint8_t following;
+		flags |= ARQ_FLAG_DATA;
+		if (slot->sync)
+		{
+			flags |= ARQ_FLAG_SYNC;
+		}
+		// Ask for the acknowledge with the last frame of the burst
+		if (!nextTxFrame(peer, seq + 1, &following))
+		{
+			flags |= ARQ_FLAG_ACK_REQ;
+		}
+		memcpy(&arqTxBuffer[P2P_ARQ_HEADER_SIZE], slot->data, slot->size);
+		size += slot->size;
+	}
+	if (peer->rx_synced)
+	{
+		flags |= ARQ_FLAG_ACK;
+		peer->ack_pending = false;
+	}
+
+	buildHeader(arqTxBuffer, peer, flags, seq);
+
+	// An acknowledge that did not change since prepareAck() is already in the radio
+	uint8_t *frame = arqTxBuffer;
+	if (!is_data && arqAckPrepared && (memcmp(arqAckBuffer, arqTxBuffer, P2P_ARQ_HEADER_SIZE) == 0))
+	{
+		frame = arqAckBuffer;
+	}
+	arqAckPrepared = false;
+
+	arqTxState.peer = peer;
+	arqTxState.is_data = is_data;
+	arqTxState.ack_req = (flags & ARQ_FLAG_ACK_REQ) != 0;
+	arqTxState.seq = seq;
+	arqTxState.size = size;
+	arqTxBusy = true;
+
+	if (is_data)
+	{
+		peer->stats.tx_frames++;
+	}
+	else
+	{
+		peer->stats.acks_sent++;
+	}
+	p2p_power_apply(peer->address);
+	Radio.Send(frame, size);
+	return true;
+}
+
+/**
+ * @brief Load the requested acknowledge into the radio while it still receives
+ * Without data for the peer the acknowledge goes out as header only frame, the
+ * send then only starts the transmission.
+ *
+ * @param peer link state
+ */
+static void prepareAck(arq_peer_t *peer)
+{
+	uint8_t seq;
+
+	if (arqTxBusy || !peer->ack_pending || nextTxFrame(peer, peer->tx_base, &seq))
+	{
+		return;
+	}
+	buildHeader(arqAckBuffer, peer, ARQ_MAGIC | ARQ_FLAG_ACK, 0);
+	arqAckPrepared = Radio.PrepareTx(arqAckBuffer, P2P_ARQ_HEADER_SIZE);
+}
+
+/**
+ * @brief Send the next frame if the radio is free
+ * Acknowledges that are due go first, then the data frames of the peers in turn.
+ * Puts the radio back into RX if there is nothing to send.
+ */
+static void scheduleTx(void)
+{
+	if (arqTxBusy)
+	{
+		return;
+	}
+
+	uint32_t now = millis();
+	for (int idx = 0; idx < P2P_ARQ_MAX_PEERS; idx++)
+	{
+		arq_peer_t *peer = &arqPeers[idx];
+		if ((peer->address != ARQ_NO_ADDRESS) && peer->ack_pending && deadlineReached(peer->ack_deadline, now))
+		{
+			// Piggyback the acknowledge on data if there is any
+			if (sendFrame(peer))
+			{
+				return;
+			}
+		}
+	}
+	for (int count = 0; count < P2P_ARQ_MAX_PEERS; count++)
+	{
+		arq_peer_t *peer = &arqPeers[arqNextPeer];
+		arqNextPeer = (arqNextPeer + 1) % P2P_ARQ_MAX_PEERS;
+		uint8_t seq;
+		if ((peer->address != ARQ_NO_ADDRESS) && nextTxFrame(peer, peer->tx_base, &seq))
+		{
+			sendFrame(peer);
+			return;
+		}
+	}
+
+	if (Radio.GetStatus() != RF_RX_RUNNING)
+	{
+		Radio.Rx(0);
+	}
+}
+
+/**
+ * @brief Start the shared timer with the nearest retransmit or acknowledge deadline
+ */
+static void armTimer(void)
+{
+	uint32_t now = millis();
+	bool found = false;
+	uint32_t nearest = 0;
+
+	for (int idx = 0; idx < P2P_ARQ_MAX_PEERS; idx++)
+	{
+		arq_peer_t *peer = &arqPeers[idx];
+		if (peer->address == ARQ_NO_ADDRESS)
+		{
+			continue;
+		}
+		if (peer->rto_running && (!found || (int32_t)(peer->rto_deadline - nearest) < 0))
+		{
+			nearest = peer->rto_deadline;
+			found = true;
+		}
+		if (peer->ack_pending && (!found || (int32_t)(peer->ack_deadline - nearest) < 0))
+		{
+			nearest = peer->ack_deadline;
+			found = true;
+		}
+	}
+
+	TimerStop(&arqTimer);
+	if (found)
+	{
+		int32_t delay = (int32_t)(nearest - now);
+		TimerSetValue(&arqTimer, delay > 0 ? delay : 1);
+		TimerStart(&arqTimer);
+	}
+}
+
+/**
+ * @brief Release the acknowledged frames at the start of the send window
+ *
+ * @param peer link state
+ */
+static void advanceTxWindow(arq_peer_t *peer)
+{
+	while (peer->tx_base != peer->tx_next)
+	{
+		arq_tx_slot_t *slot = &peer->tx[peer->tx_base % P2P_ARQ_WINDOW];
+		if (!slot->acked)
+		{
+			break;
+		}
+		slot->in_use = false;
+		uint8_t seq = peer->tx_base++;
+		if ((arqCallbacks != NULL) && (arqCallbacks->TxResult != NULL))
+		{
+			arqCallbacks->TxResult(peer->address, seq, true);
+		}
+	}
+	if (peer->tx_base == peer->tx_next)
+	{
+		peer->rto_running = false;
+	}
+}
+
+/**
+ * @brief Update the round trip time estimate and the retransmit timeout
+ *
+ * @param peer link state
+ * @param rtt measured round trip time in ms
+ */
+static void updateRto(arq_peer_t *peer, uint32_t rtt)
+{
+	if (peer->srtt == 0)
+	{
+		peer->srtt = rtt;
+		peer->rttvar = rtt / 2;
+	}
+	else
+	{
+		uint32_t err = rtt > peer->srtt ? rtt - peer->srtt : peer->srtt - rtt;
+		peer->rttvar = (3 * peer->rttvar + err) / 4;
+		peer->srtt = (7 * peer->srtt + rtt) / 8;
+	}
+	peer->rto = peer->srtt + 4 * peer->rttvar;
+	if (peer->rto < arqMinRto)
+	{
+		peer->rto = arqMinRto;
+	}
+	if (peer->rto > P2P_ARQ_MAX_RTO)
+	{
+		peer->rto = P2P_ARQ_MAX_RTO;
+	}
+}
+
+/**
+ * @brief Handle the acknowledge of the send direction
+ *
+ * @param peer link state
+ * @param ack next sequence number expected by the peer
+ * @param bitmap frames the peer received after ack
+ */
+static void processAck(arq_peer_t *peer, uint8_t ack, uint8_t bitmap)
+{
+	uint8_t outstanding = peer->tx_next - peer->tx_base;
+	uint8_t acked = ack - peer->tx_base;
+	if (acked > outstanding)
+	{
+		// Stale acknowledge
+		return;
+	}
+
+	// Cumulative part
+	for (uint8_t offset = 0; offset < acked; offset++)
+	{
+		peer->tx[(uint8_t)(peer->tx_base + offset) % P2P_ARQ_WINDOW].acked = true;
+	}
+	// Selective part
+	int8_t highest = -1;
+	for (uint8_t idx = 0; idx < P2P_ARQ_WINDOW - 1; idx++)
+	{
+		uint8_t offset = acked + 1 + idx;
+		if ((bitmap & (1 << idx)) && (offset < outstanding))
+		{
+			peer->tx[(uint8_t)(peer->tx_base + offset) % P2P_ARQ_WINDOW].acked = true;
+			highest = offset;
+		}
+	}
+
+	// Round trip time from the end of the burst, only for frames that were not retransmitted
+	if (peer->rtt_sample_valid && (peer->tx[peer->rtt_sample_seq % P2P_ARQ_WINDOW].acked))
+	{
+		updateRto(peer, millis() - peer->rtt_sample_time);
+		peer->rtt_sample_valid = false;
+	}
+
+	// Frames before the highest selectively acknowledged one are lost, send them again now
+	for (int8_t offset = acked; offset < highest; offset++)
+	{
+		arq_tx_slot_t *slot = &peer->tx[(uint8_t)(peer->tx_base + offset) % P2P_ARQ_WINDOW];
+		if (!slot->acked && !slot->need_tx)
+		{
+			slot->need_tx = true;
+			slot->retries++;
+			peer->stats.retransmissions++;
+		}
+	}
+
+	advanceTxWindow(peer);
+}
+
+/**
+ * @brief Handle a received data frame
+ *
+ * @param peer link state
+ * @param flags frame flags
+ * @param seq sequence number
+ * @param data payload
+ * @param size payload size
+ * @param rssi RSSI of the frame
+ * @param snr SNR of the frame
+ */
+static void processData(arq_peer_t *peer, uint8_t flags, uint8_t seq, uint8_t *data, uint8_t size, int16_t rssi, int8_t snr)
+{
+	if ((flags & ARQ_FLAG_SYNC) && (!peer->rx_synced || (seq != peer->rx_sync_seq)))
+	{
+		peer->rx_synced = true;
+		peer->rx_sync_seq = seq;
+		peer->rx_base = seq;
+		for (int idx = 0; idx < P2P_ARQ_WINDOW; idx++)
+		{
+			peer->rx[idx].valid = false;
+		}
+	}
+	if (!peer->rx_synced)
+	{
+		// Wait for the start of the stream
+		return;
+	}
+
+	uint8_t offset = seq - peer->rx_base;
+	if (offset < P2P_ARQ_WINDOW)
+	{
+		arq_rx_slot_t *slot = &peer->rx[seq % P2P_ARQ_WINDOW];
+		if (slot->valid)
+		{
+			peer->stats.duplicates++;
+		}
+		else if (offset == 0)
+		{
+			// In order, no need to buffer
+			peer->rx_base++;
+			peer->stats.rx_frames++;
+			if ((arqCallbacks != NULL) && (arqCallbacks->RxData != NULL))
+			{
+				arqCallbacks->RxData(peer->address, data, size, rssi, snr);
+			}
+		}
+		else
+		{
+			memcpy(slot->data, data, size);
+			slot->size = size;
+			slot->rssi = rssi;
+			slot->snr = snr;
+			slot->valid = true;
+		}
+
+		// Deliver the buffered frames that are in order now
+		while (peer->rx[peer->rx_base % P2P_ARQ_WINDOW].valid)
+		{
+			slot = &peer->rx[peer->rx_base % P2P_ARQ_WINDOW];
+			slot->valid = false;
+			peer->rx_base++;
+			peer->stats.rx_frames++;
+			if ((arqCallbacks != NULL) && (arqCallbacks->RxData != NULL))
+			{
+				arqCallbacks->RxData(peer->address, slot->data, slot->size, slot->rssi, slot->snr);
+			}
+		}
+	}
+	else
+	{
+		// Already delivered, the acknowledge was lost
+		peer->stats.duplicates++;
+	}
+
+	// A delayed acknowledge restarts with every frame of the burst, a requested one is not delayed again
+	uint32_t now = millis();
+	if (!peer->ack_pending || (flags & ARQ_FLAG_ACK_REQ) || ((int32_t)(peer->ack_deadline - now) > P2P_ARQ_TURNAROUND))
+	{
+		peer->ack_deadline = now + ((flags & ARQ_FLAG_ACK_REQ) ? P2P_ARQ_TURNAROUND : P2P_ARQ_ACK_DELAY);
+	}
+	peer->ack_pending = true;
+}
+
+p2p_arq_status p2p_arq_init(p2p_arq_callback_t *callbacks, uint8_t address)
+{
+	if (address == ARQ_NO_ADDRESS)
+	{
+		return P2P_ARQ_ERROR;
+	}
+	arqCallbacks = callbacks;
+	arqAddress = address;
+	arqTxBusy = false;
+	arqAckPrepared = false;
+	arqNextPeer = 0;
+	for (int idx = 0; idx < P2P_ARQ_MAX_PEERS; idx++)
+	{
+		arqPeers[idx].address = ARQ_NO_ADDRESS;
+	}
+
+	arqRadioEvents.TxDone = OnArqTxDone;
+	arqRadioEvents.TxTimeout = OnArqTxTimeout;
+	arqRadioEvents.RxDone = OnArqRxDone;
+	arqRadioEvents.RxTimeout = OnArqRxTimeout;
+	arqRadioEvents.RxError = OnArqRxError;
+	arqRadioEvents.CadDone = NULL;
+	if (!initP2PEvents(&arqRadioEvents))
+	{
+		// Another P2P module owns the radio
+		return P2P_ARQ_BUSY;
+	}
+
+	arqTimer.oneShot = true;
+	TimerInit(&arqTimer, OnArqTimerEvent);
+
+	return P2P_ARQ_SUCCESS;
+}
+
+void p2p_arq_start(void)
+{
+	// An acknowledge can be piggybacked on a full data frame
+	arqMinRto = Radio.TimeOnAir(MODEM_LORA, P2P_ARQ_HEADER_SIZE + P2P_ARQ_MAX_PAYLOAD) + 2 * P2P_ARQ_TURNAROUND + 10;
+	arqSeqSeed = Radio.Random();
+	LOG_LIB("ARQ", "Min RTO %ld ms", arqMinRto);
+
+	// Leave room for a prepared acknowledge at the end of the data buffer
+	Radio.SetMaxPayloadLength(MODEM_LORA, 255 - ARQ_ACK_SPACE);
+	Radio.Rx(0);
+}
+
+p2p_arq_status p2p_arq_send(uint8_t dst, uint8_t *data, uint8_t size, uint8_t *seq)
+{
+	if ((size > P2P_ARQ_MAX_PAYLOAD) || (dst == ARQ_NO_ADDRESS))
+	{
+		return P2P_ARQ_ERROR;
+	}
+	arq_peer_t *peer = getPeer(dst, true);
+	if (peer == NULL)
+	{
+		return P2P_ARQ_BUSY;
+	}
+	if ((uint8_t)(peer->tx_next - peer->tx_base) >= P2P_ARQ_WINDOW)
+	{
+		return P2P_ARQ_BUSY;
+	}
+
+	arq_tx_slot_t *slot = &peer->tx[peer->tx_next % P2P_ARQ_WINDOW];
+	memcpy(slot->data, data, size);
+	slot->size = size;
+	slot->in_use = true;
+	slot->acked = false;
+	slot->need_tx = true;
+	slot->retries = 0;
+	slot->sync = peer->tx_sync;
+	peer->tx_sync = false;
+	if (seq != NULL)
+	{
+		*seq = peer->tx_next;
+	}
+	peer->tx_next++;
+
+	scheduleTx();
+	return P2P_ARQ_SUCCESS;
+}
+
+p2p_arq_status p2p_arq_get_stats(uint8_t address, p2p_arq_stats_t *stats)
+{
+	arq_peer_t *peer = getPeer(address, false);
+	if (peer == NULL)
+	{
+		return P2P_ARQ_ERROR;
+	}
+	*stats = peer->stats;
+	stats->srtt = peer->srtt;
+	stats->rto = peer->rto;
+	return P2P_ARQ_SUCCESS;
+}
+
+/**
+ * @brief Radio TX done, start the retransmit timer at the end of a burst
+ */
+static void OnArqTxDone(void)
+{
+	arq_peer_t *peer = arqTxState.peer;
+	uint32_t now = millis();
+
+	p2p_power_tx_done(peer->address, arqTxState.size);
+	if (arqTxState.is_data)
+	{
+		arq_tx_slot_t *slot = &peer->tx[arqTxState.seq % P2P_ARQ_WINDOW];
+		slot->need_tx = false;
+		// The sync flag stays on the frame until it is acknowledged
+		if (arqTxState.ack_req)
+		{
+			peer->rto_deadline = now + peer->rto;
+			peer->rto_running = true;
+			if (slot->retries == 0)
+			{
+				peer->rtt_sample_valid = true;
+				peer->rtt_sample_seq = arqTxState.seq;
+				peer->rtt_sample_time = now;
+			}
+			else
+			{
+				peer->rtt_sample_valid = false;
+			}
+		}
+	}
+
+	arqTxBusy = false;
+	scheduleTx();
+	armTimer();
+}
+
+/**
+ * @brief Radio TX timeout, the frame is handled like a lost frame
+ */
+static void OnArqTxTimeout(void)
+{
+	LOG_LIB("ARQ", "TX timeout");
+	OnArqTxDone();
+}
+
+/**
+ * @brief Radio RX done, handle acknowledge and data of the frame
+ */
+static void OnArqRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+{
+	if ((size >= P2P_ARQ_HEADER_SIZE) && (size <= P2P_ARQ_HEADER_SIZE + P2P_ARQ_MAX_PAYLOAD) &&
+		((payload[ARQ_HDR_FLAGS] & ARQ_MAGIC_MASK) == ARQ_MAGIC) && (payload[ARQ_HDR_DST] == arqAddress) &&
+		(payload[ARQ_HDR_SRC] != ARQ_NO_ADDRESS) && (payload[ARQ_HDR_SRC] != arqAddress))
+	{
+		uint8_t flags = payload[ARQ_HDR_FLAGS];
+		arq_peer_t *peer = getPeer(payload[ARQ_HDR_SRC], (flags & ARQ_FLAG_DATA) != 0);
+		if (peer != NULL)
+		{
+			// Report the margin back to the peer and adjust the own power to the margin it reports
+			peer->rx_margin = p2p_power_margin(rssi, snr);
+			p2p_power_report(peer->address, (int8_t)payload[ARQ_HDR_MARGIN]);
+			if (flags & ARQ_FLAG_ACK)
+			{
+				processAck(peer, payload[ARQ_HDR_ACK], payload[ARQ_HDR_BITMAP]);
+			}
+			if (flags & ARQ_FLAG_DATA)
+			{
+				processData(peer, flags, payload[ARQ_HDR_SEQ], &payload[P2P_ARQ_HEADER_SIZE], size - P2P_ARQ_HEADER_SIZE, rssi, snr);
+				if (flags & ARQ_FLAG_ACK_REQ)
+				{
+					prepareAck(peer);
+				}
+			}
+		}
+	}
+
+	scheduleTx();
+	armTimer();
+}
+
+/**
+ * @brief Radio RX timeout, restart the reception
+ */
+static void OnArqRxTimeout(void)
+{
+	scheduleTx();
+}
+
+/**
+ * @brief Radio RX error, restart the reception
+ */
+static void OnArqRxError(void)
+{
+	scheduleTx();
+}
+
+/**
+ * @brief Shared timer for retransmit timeouts and delayed acknowledges
+ */
+static void OnArqTimerEvent(void)
+{
+	uint32_t now = millis();
+
+	for (int idx = 0; idx < P2P_ARQ_MAX_PEERS; idx++)
+	{
+		arq_peer_t *peer = &arqPeers[idx];
+		if ((peer->address == ARQ_NO_ADDRESS) || !peer->rto_running || !deadlineReached(peer->rto_deadline, now))
+		{
+			continue;
+		}
+
+		peer->rto_running = false;
+		peer->rtt_sample_valid = false;
+		p2p_power_tx_failed(peer->address);
+		peer->rto = peer->rto * 2 > P2P_ARQ_MAX_RTO ? P2P_ARQ_MAX_RTO : peer->rto * 2;
+
+		bool failed = false;
+		uint8_t outstanding = peer->tx_next - peer->tx_base;
+		for (uint8_t offset = 0; offset < outstanding; offset++)
+		{
+			arq_tx_slot_t *slot = &peer->tx[(uint8_t)(peer->tx_base + offset) % P2P_ARQ_WINDOW];
+			if (slot->acked || slot->need_tx)
+			{
+				continue;
+			}
+			if (slot->retries >= P2P_ARQ_MAX_RETRIES)
+			{
+				failed = true;
+				break;
+			}
+			slot->need_tx = true;
+			slot->retries++;
+			peer->stats.retransmissions++;
+		}
+
+		if (failed)
+		{
+			// Report all frames in flight as failed and restart the link
+			LOG_LIB("ARQ", "Link to %02X failed", peer->address);
+			for (uint8_t offset = 0; offset < outstanding; offset++)
+			{
+				uint8_t seq = peer->tx_base + offset;
+				arq_tx_slot_t *slot = &peer->tx[seq % P2P_ARQ_WINDOW];
+				bool success = slot->acked;
+				if (!success)
+				{
+					peer->stats.failures++;
+				}
+				if ((arqCallbacks != NULL) && (arqCallbacks->TxResult != NULL))
+				{
+					arqCallbacks->TxResult(peer->address, seq, success);
+				}
+			}
+			resetTx(peer);
+		}
+	}
+
+	scheduleTx();
+	armTimer();
+}
@@ -0,0 +1,143 @@
+/**
+ * @file P2PArq.h
+ * @brief Reliable P2P link layer with a selective repeat sliding window on top of the Radio API
+ *
+ * Frames carry a small header with the addresses, a sequence number and the
+ * acknowledge state of the reverse direction. Up to P2P_ARQ_WINDOW frames per
+ * peer are sent back to back without waiting for an acknowledge. The receiver
+ * acknowledges cumulative with a bitmap of the frames received out of order,
+ * piggybacked on its own data frames when possible. Only the missing frames are
+ * retransmitted. The retransmit timeout is derived from the measured round trip
+ * time and starts with a value based on the time on air of the frames.
+ *
+ * A requested acknowledge is loaded into the radio with Radio.PrepareTx()
+ * when the frame that requests it is received. With a turnaround mode set
+ * with Radio.SetTurnaroundMode() the radio switches to TX without reloading
+ * its configuration, P2P_ARQ_TURNAROUND can then be lowered on all nodes.
+ * Radio.GetTurnaround() reports the latency from RX done to TX start.
+ *
+ * Each frame also reports the link margin of the last frame received from the
+ * peer. With the power control of P2PPower.h initialized, the TX power to each
+ * peer follows the margin the peer reports.
+ *
+ * Usage:
+ * 1. p2p_arq_init() initializes the radio with the ARQ radio events
+ * 2. configure the radio with Radio.SetChannel(), Radio.SetTxConfig() and
+ *    Radio.SetRxConfig(), RX must be set to continuous mode
+ * 3. p2p_arq_start() starts the reception, it limits the max payload length
+ *    to keep room for the prepared acknowledge
+ * 4. send data with p2p_arq_send()
+ */
+#ifndef __P2PARQ_H__
+#define __P2PARQ_H__
+
+#include "stdint.h"
+#include "boards/mcu/board.h"
+
+#ifndef P2P_ARQ_WINDOW
+#define P2P_ARQ_WINDOW 8 /**< Frames in flight per peer, power of 2, max 8 */
+#endif
+#ifndef P2P_ARQ_MAX_PEERS
+#define P2P_ARQ_MAX_PEERS 4 /**< Peers with link state */
+#endif
+#ifndef P2P_ARQ_MAX_PAYLOAD
+#define P2P_ARQ_MAX_PAYLOAD 64 /**< Max payload size of a frame */
+#endif
+#ifndef P2P_ARQ_MAX_RETRIES
+#define P2P_ARQ_MAX_RETRIES 8 /**< Retransmissions before a frame is reported as failed */
+#endif
+#ifndef P2P_ARQ_ACK_DELAY
+#define P2P_ARQ_ACK_DELAY 50 /**< Time in ms to wait for more frames before a delayed acknowledge */
+#endif
+#ifndef P2P_ARQ_TURNAROUND
+#define P2P_ARQ_TURNAROUND 5 /**< Time in ms before an acknowledge requested by the sender */
+#endif
+#ifndef P2P_ARQ_MAX_RTO
+#define P2P_ARQ_MAX_RTO 30000 /**< Upper limit of the retransmit timeout in ms */
+#endif
+
+#if P2P_ARQ_WINDOW > 8
+#error "P2P_ARQ_WINDOW is limited by the 8 bit acknowledge bitmap"
+#endif
+#if (P2P_ARQ_WINDOW & (P2P_ARQ_WINDOW - 1)) != 0
+#error "P2P_ARQ_WINDOW must be a power of 2"
+#endif
+
+#define P2P_ARQ_HEADER_SIZE 7 /**< Size of the frame header */
+
+typedef enum
+{
+	P2P_ARQ_ERROR = -1,
+	P2P_ARQ_SUCCESS = 0,
+	P2P_ARQ_BUSY = 1
+} p2p_arq_status;
+
+/**@brief P2P ARQ callbacks
+ */
+typedef struct p2p_arq_callback_s
+{
+	/**@brief Data received in order from a peer
+	 * @param src address of the sender
+	 * @param data received payload
+	 * @param size size of the payload
+	 * @param rssi RSSI of the frame
+	 * @param snr SNR of the frame
+	 */
+	void (*RxData)(uint8_t src, uint8_t *data, uint8_t size, int16_t rssi, int8_t snr);
+
+	/**@brief Result of a frame queued with p2p_arq_send
+	 * @param dst address of the receiver
+	 * @param seq sequence number returned by p2p_arq_send
+	 * @param success true if the frame was acknowledged, false if the retries were exhausted
+	 */
+	void (*TxResult)(uint8_t dst, uint8_t seq, bool success);
+} p2p_arq_callback_t;
+
+/**@brief Link statistics of a peer
+ */
+typedef struct p2p_arq_stats_s
+{
+	uint32_t tx_frames;		  /**< Data frames sent, including retransmissions */
+	uint32_t retransmissions; /**< Data frames sent again */
+	uint32_t acks_sent;		  /**< Acknowledge only frames sent */
+	uint32_t rx_frames;		  /**< Data frames delivered to the application */
+	uint32_t duplicates;	  /**< Data frames received more than once */
+	uint32_t failures;		  /**< Frames dropped after P2P_ARQ_MAX_RETRIES */
+	uint32_t srtt;			  /**< Smoothed round trip time in ms */
+	uint32_t rto;			  /**< Current retransmit timeout in ms */
+} p2p_arq_stats_t;
+
+/**@brief Initialize the ARQ layer and the radio
+ *
+ * @param callbacks Pointer to structure containing the callback functions
+ * @param address Own node address, 0xFF is not allowed
+ *
+ * @retval error status, P2P_ARQ_BUSY if another P2P module owns the radio, see releaseP2PEvents()
+ */
+p2p_arq_status p2p_arq_init(p2p_arq_callback_t *callbacks, uint8_t address);
+
+/**@brief Start the reception, call after the radio is configured
+ */
+void p2p_arq_start(void);
+
+/**@brief Queue data for a peer
+ *
+ * @param dst Address of the receiver
+ * @param data Payload to send
+ * @param size Size of the payload, max P2P_ARQ_MAX_PAYLOAD
+ * @param seq Optional pointer to store the sequence number of the frame
+ *
+ * @retval P2P_ARQ_BUSY if the send window to the peer is full
+ */
+p2p_arq_status p2p_arq_send(uint8_t dst, uint8_t *data, uint8_t size, uint8_t *seq = NULL);
+
+/**@brief Get the link statistics of a peer
+ *
+ * @param address Address of the peer
+ * @param stats Structure to fill with the statistics
+ *
+ * @retval P2P_ARQ_ERROR if there is no link state for the peer
+ */
+p2p_arq_status p2p_arq_get_stats(uint8_t address, p2p_arq_stats_t *stats);
+
+#endif // __P2PARQ_H__
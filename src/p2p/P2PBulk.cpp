@@ -0,0 +1,798 @@
+/**
+ * @file P2PBulk.cpp
+ * @brief High throughput GFSK bulk transfer between two nodes
+ */
+#include "p2p/P2PBulk.h"
+
+/** Frame header layout */
+#define BULK_HDR_TYPE 0
+#define BULK_HDR_SRC 1
+#define BULK_HDR_DST 2
+#define BULK_HDR_ID 3
+#define BULK_HDR_SEG 4
+#define BULK_HDR_LENGTH 4
+#define BULK_HDR_BLOCK 4
+#define BULK_HDR_BITMAP 6
+
+/** Frame types, filter frames of other protocols */
+#define BULK_TYPE_START 0xD0
+#define BULK_TYPE_DATA 0xD1
+#define BULK_TYPE_DATA_ACK_REQ 0xD2
+#define BULK_TYPE_ACK 0xD3
+#define BULK_TYPE_PROBE 0xD4
+
+/** Frame sizes */
+#define BULK_START_SIZE 8
+#define BULK_ACK_SIZE 10
+#define BULK_PROBE_SIZE 4
+
+/** Preamble length in bytes */
+#define BULK_PREAMBLE 4
+
+/** Start of the two halves of the radio buffer */
+#define BULK_BUFFER_A 0x00
+#define BULK_BUFFER_B 0x80
+
+/** Time in ms added to the acknowledge time on air for processing */
+#define BULK_ACK_MARGIN 20
+
+#define BULK_MAX_BITRATE 300000
+#define BULK_NO_ADDRESS 0xFF
+
+/** Sender state */
+typedef enum
+{
+	BULK_TX_IDLE = 0,
+	BULK_TX_START,	   //!< START sent, waiting for the progress of the receiver
+	BULK_TX_DELAY,	   //!< Waiting for the receiver to switch to RX
+	BULK_TX_BURST,	   //!< Segments on air
+	BULK_TX_WAIT_ACK,  //!< Waiting for the acknowledge of a burst or probe
+	BULK_TX_SUSPENDED, //!< Receiver did not answer
+} bulk_tx_state_t;
+
+/** Frame on air */
+typedef enum
+{
+	BULK_AIR_NONE = 0,
+	BULK_AIR_BURST,
+	BULK_AIR_REQUEST, //!< START or PROBE, an acknowledge follows
+	BULK_AIR_ACK,
+} bulk_air_t;
+
+static p2p_bulk_callback_t *bulkCallbacks;
+static RadioEvents_t bulkRadioEvents;
+static TimerEvent_t bulkTxTimer;
+static TimerEvent_t bulkRxTimer;
+
+static uint8_t bulkAddress = BULK_NO_ADDRESS;
+static uint32_t bulkTxTimeout = 100;
+static uint32_t bulkAckTimeout = 50;
+static bulk_air_t bulkOnAir = BULK_AIR_NONE;
+static uint8_t bulkFallbackMode = RADIO_FALLBACK_STDBY_RC;
+static bool bulkFallbackSaved = false;
+
+/** Sender */
+static bulk_tx_state_t bulkTxState = BULK_TX_IDLE;
+static uint8_t *bulkTxData;
+static uint32_t bulkTxLength;
+static uint16_t bulkTxSegs;
+static uint8_t bulkTxDst;
+static uint8_t bulkTxId;
+static uint16_t bulkTxBlock;
+static uint32_t bulkTxAcked;
+static uint32_t bulkTxSent;
+static uint8_t bulkTxRetries;
+static uint8_t bulkTxBase;
+static int32_t bulkPreSeg = -1;
+static uint8_t bulkPreSize;
+
+/** Receiver */
+static bool bulkRxActive = false;
+static bool bulkRxComplete = false;
+static bool bulkAckPending = false;
+static uint8_t bulkRxSrc;
+static uint8_t bulkRxId;
+static uint32_t bulkRxLength;
+static uint16_t bulkRxSegs;
+static uint16_t bulkRxBlock;
+static uint32_t bulkRxBitmap;
+
+static p2p_bulk_stats_t bulkStats;
+
+static void OnBulkTxDone(void);
+static void OnBulkTxTimeout(void);
+static void OnBulkRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr);
+static void OnBulkRxTimeout(void);
+static void OnBulkRxError(void);
+static void OnBulkTxTimerEvent(void);
+static void OnBulkRxTimerEvent(void);
+
+/**
+ * @brief Number of segments of a transfer
+ *
+ * @param length size of the transfer
+ * @return segments
+ */
+static uint16_t segmentCount(uint32_t length)
+{
+	return (length + P2P_BULK_SEGMENT - 1) / P2P_BULK_SEGMENT;
+}
+
+/**
+ * @brief Payload size of a segment
+ *
+ * @param seg segment number
+ * @param length size of the transfer
+ * @return size of the segment
+ */
+static uint8_t segmentSize(uint32_t seg, uint32_t length)
+{
+	uint32_t left = length - seg * P2P_BULK_SEGMENT;
+	return left > P2P_BULK_SEGMENT ? P2P_BULK_SEGMENT : left;
+}
+
+/**
+ * @brief Bitmap with a bit for every segment of a block
+ *
+ * @param block block number
+ * @param segs segments of the transfer
+ * @return bitmap of the complete block
+ */
+static uint32_t blockMask(uint16_t block, uint16_t segs)
+{
+	uint32_t count = segs - block * P2P_BULK_BLOCK;
+	if (count >= 32)
+	{
+		return 0xFFFFFFFF;
+	}
+	return count >= P2P_BULK_BLOCK ? ((1UL << P2P_BULK_BLOCK) - 1) : ((1UL << count) - 1);
+}
+
+/**
+ * @brief Return to continuous reception
+ * The payload length is restored, as the segments overwrite it with their size.
+ */
+static void bulkListen(void)
+{
+	bulkOnAir = BULK_AIR_NONE;
+	SX126x.PacketParams.Params.Gfsk.PayloadLength = 0xFF;
+	SX126xSetPacketParams(&SX126x.PacketParams);
+	Radio.Rx(0);
+}
+
+/**
+ * @brief Prepare the radio for a transmission
+ */
+static void bulkTxBegin(void)
+{
+	SX126xTXena();
+	SX126xSetDioIrqParams(IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT,
+						  IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT,
+						  IRQ_RADIO_NONE,
+						  IRQ_RADIO_NONE);
+}
+
+/**
+ * @brief Start the transmission of a frame already in the radio buffer
+ * From FS fallback this skips the synthesizer lock.
+ *
+ * @param base start of the frame in the radio buffer
+ * @param size size of the frame
+ */
+static void bulkTxFrame(uint8_t base, uint8_t size)
+{
+	SX126xSetBufferBaseAddress(base, BULK_BUFFER_A);
+	SX126x.PacketParams.Params.Gfsk.PayloadLength = size;
+	SX126xSetPacketParams(&SX126x.PacketParams);
+	SX126xSetTx(bulkTxTimeout << 6);
+}
+
+/**
+ * @brief Send a control frame
+ *
+ * @param frame the frame
+ * @param size size of the frame
+ * @param onAir kind of the frame
+ */
+static void bulkSendControl(uint8_t *frame, uint8_t size, bulk_air_t onAir)
+{
+	bulkOnAir = onAir;
+	bulkTxBegin();
+	SX126xWriteBuffer(BULK_BUFFER_A, frame, size);
+	bulkTxFrame(BULK_BUFFER_A, size);
+}
+
+/**
+ * @brief Find the next segment of the current block that was not acknowledged
+ *
+ * @param from first segment to check
+ * @return segment number, -1 if the burst is complete
+ */
+static int32_t nextMissing(uint32_t from)
+{
+	uint32_t end = (bulkTxBlock + 1) * P2P_BULK_BLOCK;
+	if (end > bulkTxSegs)
+	{
+		end = bulkTxSegs;
+	}
+	for (uint32_t seg = from; seg < end; seg++)
+	{
+		if ((bulkTxAcked & (1UL << (seg % P2P_BULK_BLOCK))) == 0)
+		{
+			return seg;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Write a segment into the radio buffer
+ * The payload goes directly from the application buffer into the radio.
+ *
+ * @param seg segment number
+ * @param base start in the radio buffer
+ * @return size of the frame
+ */
+static uint8_t writeSegment(int32_t seg, uint8_t base)
+{
+	uint8_t header[P2P_BULK_HEADER_SIZE];
+	uint32_t offset = seg * P2P_BULK_SEGMENT;
+	uint8_t size = segmentSize(seg, bulkTxLength);
+
+	header[BULK_HDR_TYPE] = nextMissing(seg + 1) < 0 ? BULK_TYPE_DATA_ACK_REQ : BULK_TYPE_DATA;
+	header[BULK_HDR_SRC] = bulkAddress;
+	header[BULK_HDR_DST] = bulkTxDst;
+	header[BULK_HDR_ID] = bulkTxId;
+	header[BULK_HDR_SEG] = seg & 0xFF;
+	header[BULK_HDR_SEG + 1] = seg >> 8;
+	SX126xWriteBuffer(base, header, P2P_BULK_HEADER_SIZE);
+	SX126xWriteBuffer(base + P2P_BULK_HEADER_SIZE, &bulkTxData[offset], size);
+
+	bulkStats.tx_segments++;
+	if (seg < (int32_t)bulkTxSent)
+	{
+		bulkStats.tx_repeats++;
+	}
+	else
+	{
+		bulkTxSent = seg + 1;
+	}
+	return P2P_BULK_HEADER_SIZE + size;
+}
+
+/**
+ * @brief Preload the segment after the one on air into the free half of the buffer
+ *
+ * @param onAir segment on air
+ */
+static void preloadNext(int32_t onAir)
+{
+	bulkPreSeg = nextMissing(onAir + 1);
+	if (bulkPreSeg >= 0)
+	{
+		bulkPreSize = writeSegment(bulkPreSeg, bulkTxBase ^ BULK_BUFFER_B);
+	}
+}
+
+/**
+ * @brief Send the missing segments of the current block back to back
+ */
+static void startBurst(void)
+{
+	int32_t seg = nextMissing(bulkTxBlock * P2P_BULK_BLOCK);
+	if (seg < 0)
+	{
+		return;
+	}
+	bulkTxState = BULK_TX_BURST;
+	bulkOnAir = BULK_AIR_BURST;
+	bulkTxBase = BULK_BUFFER_A;
+	bulkTxBegin();
+	uint8_t size = writeSegment(seg, bulkTxBase);
+	bulkTxFrame(bulkTxBase, size);
+	preloadNext(seg);
+}
+
+/**
+ * @brief Send START or a PROBE and wait for the acknowledge
+ */
+static void sendRequest(void)
+{
+	uint8_t frame[BULK_START_SIZE];
+
+	frame[BULK_HDR_SRC] = bulkAddress;
+	frame[BULK_HDR_DST] = bulkTxDst;
+	frame[BULK_HDR_ID] = bulkTxId;
+	if (bulkTxState == BULK_TX_START)
+	{
+		frame[BULK_HDR_TYPE] = BULK_TYPE_START;
+		frame[BULK_HDR_LENGTH] = bulkTxLength & 0xFF;
+		frame[BULK_HDR_LENGTH + 1] = (bulkTxLength >> 8) & 0xFF;
+		frame[BULK_HDR_LENGTH + 2] = (bulkTxLength >> 16) & 0xFF;
+		frame[BULK_HDR_LENGTH + 3] = bulkTxLength >> 24;
+		bulkSendControl(frame, BULK_START_SIZE, BULK_AIR_REQUEST);
+	}
+	else
+	{
+		frame[BULK_HDR_TYPE] = BULK_TYPE_PROBE;
+		bulkStats.probes++;
+		bulkSendControl(frame, BULK_PROBE_SIZE, BULK_AIR_REQUEST);
+	}
+}
+
+/**
+ * @brief Send the acknowledge with the receive progress
+ */
+static void sendAck(void)
+{
+	uint8_t frame[BULK_ACK_SIZE];
+
+	frame[BULK_HDR_TYPE] = BULK_TYPE_ACK;
+	frame[BULK_HDR_SRC] = bulkAddress;
+	frame[BULK_HDR_DST] = bulkRxSrc;
+	frame[BULK_HDR_ID] = bulkRxId;
+	frame[BULK_HDR_BLOCK] = bulkRxBlock & 0xFF;
+	frame[BULK_HDR_BLOCK + 1] = bulkRxBlock >> 8;
+	frame[BULK_HDR_BITMAP] = bulkRxBitmap & 0xFF;
+	frame[BULK_HDR_BITMAP + 1] = (bulkRxBitmap >> 8) & 0xFF;
+	frame[BULK_HDR_BITMAP + 2] = (bulkRxBitmap >> 16) & 0xFF;
+	frame[BULK_HDR_BITMAP + 3] = bulkRxBitmap >> 24;
+	bulkSendControl(frame, BULK_ACK_SIZE, BULK_AIR_ACK);
+}
+
+/**
+ * @brief Schedule the acknowledge after the sender switched to RX
+ */
+static void scheduleAck(void)
+{
+	bulkAckPending = true;
+	TimerSetValue(&bulkRxTimer, P2P_BULK_TURNAROUND);
+	TimerStart(&bulkRxTimer);
+}
+
+/**
+ * @brief Finish the own transfer
+ *
+ * @param success result for the application
+ */
+static void finishTx(bool success)
+{
+	TimerStop(&bulkTxTimer);
+	bulkTxState = success ? BULK_TX_IDLE : BULK_TX_SUSPENDED;
+	if ((bulkCallbacks != NULL) && (bulkCallbacks->TxDone != NULL))
+	{
+		bulkCallbacks->TxDone(bulkTxDst, success);
+	}
+}
+
+/**
+ * @brief Sender, handle the progress reported by the receiver
+ *
+ * @param frame received acknowledge
+ */
+static void handleAck(uint8_t *frame)
+{
+	if ((bulkTxState != BULK_TX_START) && (bulkTxState != BULK_TX_WAIT_ACK))
+	{
+		return;
+	}
+	if ((frame[BULK_HDR_SRC] != bulkTxDst) || (frame[BULK_HDR_ID] != bulkTxId))
+	{
+		return;
+	}
+	uint16_t block = frame[BULK_HDR_BLOCK] | (frame[BULK_HDR_BLOCK + 1] << 8);
+	uint32_t bitmap = (uint32_t)frame[BULK_HDR_BITMAP] | ((uint32_t)frame[BULK_HDR_BITMAP + 1] << 8) | ((uint32_t)frame[BULK_HDR_BITMAP + 2] << 16) | ((uint32_t)frame[BULK_HDR_BITMAP + 3] << 24);
+
+	if ((bulkTxState == BULK_TX_START) || (block > bulkTxBlock))
+	{
+		// START reports where the receiver stands, this is where a resume continues
+		bulkTxBlock = block;
+		bulkTxAcked = bitmap;
+	}
+	else if (block == bulkTxBlock)
+	{
+		bulkTxAcked |= bitmap;
+	}
+	else
+	{
+		// Late acknowledge of an older block
+		return;
+	}
+
+	TimerStop(&bulkTxTimer);
+	bulkTxRetries = 0;
+	if (((uint32_t)bulkTxBlock * P2P_BULK_BLOCK) >= bulkTxSegs)
+	{
+		finishTx(true);
+		return;
+	}
+	if (bulkTxAcked == blockMask(bulkTxBlock, bulkTxSegs))
+	{
+		bulkTxBlock++;
+		bulkTxAcked = 0;
+		if (((uint32_t)bulkTxBlock * P2P_BULK_BLOCK) >= bulkTxSegs)
+		{
+			finishTx(true);
+			return;
+		}
+	}
+
+	// Give the receiver time to return to RX after its acknowledge
+	bulkTxState = BULK_TX_DELAY;
+	TimerSetValue(&bulkTxTimer, P2P_BULK_TURNAROUND);
+	TimerStart(&bulkTxTimer);
+}
+
+/**
+ * @brief Receiver, handle the start of a transfer
+ *
+ * @param frame received START frame
+ */
+static void handleStart(uint8_t *frame)
+{
+	uint32_t length = (uint32_t)frame[BULK_HDR_LENGTH] | ((uint32_t)frame[BULK_HDR_LENGTH + 1] << 8) | ((uint32_t)frame[BULK_HDR_LENGTH + 2] << 16) | ((uint32_t)frame[BULK_HDR_LENGTH + 3] << 24);
+
+	if (!bulkRxActive || (bulkRxSrc != frame[BULK_HDR_SRC]) || (bulkRxId != frame[BULK_HDR_ID]) || (bulkRxLength != length))
+	{
+		bulkRxActive = true;
+		bulkRxComplete = false;
+		bulkRxSrc = frame[BULK_HDR_SRC];
+		bulkRxId = frame[BULK_HDR_ID];
+		bulkRxLength = length;
+		bulkRxSegs = segmentCount(length);
+		bulkRxBlock = 0;
+		bulkRxBitmap = 0;
+	}
+	// Else the sender resumes, the acknowledge tells it where to continue
+	scheduleAck();
+}
+
+/**
+ * @brief Receiver, handle a segment
+ *
+ * @param frame received segment
+ * @param size size of the frame
+ */
+static void handleData(uint8_t *frame, uint16_t size)
+{
+	if (!bulkRxActive || (frame[BULK_HDR_SRC] != bulkRxSrc) || (frame[BULK_HDR_ID] != bulkRxId))
+	{
+		return;
+	}
+	uint16_t seg = frame[BULK_HDR_SEG] | (frame[BULK_HDR_SEG + 1] << 8);
+	uint32_t offset = (uint32_t)seg * P2P_BULK_SEGMENT;
+	if ((seg >= bulkRxSegs) || (size != (P2P_BULK_HEADER_SIZE + segmentSize(seg, bulkRxLength))))
+	{
+		return;
+	}
+
+	uint32_t bit = 1UL << (seg % P2P_BULK_BLOCK);
+	if (bulkRxComplete || ((seg / P2P_BULK_BLOCK) != bulkRxBlock) || (bulkRxBitmap & bit))
+	{
+		bulkStats.rx_duplicates++;
+	}
+	else
+	{
+		bulkStats.rx_segments++;
+		bulkRxBitmap |= bit;
+		if ((bulkCallbacks != NULL) && (bulkCallbacks->RxSegment != NULL))
+		{
+			bulkCallbacks->RxSegment(bulkRxSrc, offset, &frame[P2P_BULK_HEADER_SIZE], size - P2P_BULK_HEADER_SIZE);
+		}
+		if (bulkRxBitmap == blockMask(bulkRxBlock, bulkRxSegs))
+		{
+			bulkRxBlock++;
+			bulkRxBitmap = 0;
+			if (((uint32_t)bulkRxBlock * P2P_BULK_BLOCK) >= bulkRxSegs)
+			{
+				bulkRxComplete = true;
+				if ((bulkCallbacks != NULL) && (bulkCallbacks->RxDone != NULL))
+				{
+					bulkCallbacks->RxDone(bulkRxSrc, bulkRxLength, true);
+				}
+			}
+		}
+	}
+
+	if (frame[BULK_HDR_TYPE] == BULK_TYPE_DATA_ACK_REQ)
+	{
+		scheduleAck();
+	}
+	else if (!bulkAckPending)
+	{
+		TimerSetValue(&bulkRxTimer, P2P_BULK_RX_TIMEOUT);
+		TimerStart(&bulkRxTimer);
+	}
+}
+
+p2p_bulk_status p2p_bulk_init(p2p_bulk_callback_t *callbacks, uint8_t address)
+{
+	if (address == BULK_NO_ADDRESS)
+	{
+		return P2P_BULK_ERROR;
+	}
+	bulkCallbacks = callbacks;
+	bulkAddress = address;
+	bulkTxState = BULK_TX_IDLE;
+	bulkOnAir = BULK_AIR_NONE;
+	bulkRxActive = false;
+	bulkAckPending = false;
+	memset(&bulkStats, 0, sizeof(bulkStats));
+
+	bulkRadioEvents.TxDone = OnBulkTxDone;
+	bulkRadioEvents.TxTimeout = OnBulkTxTimeout;
+	bulkRadioEvents.RxDone = OnBulkRxDone;
+	bulkRadioEvents.RxTimeout = OnBulkRxTimeout;
+	bulkRadioEvents.RxError = OnBulkRxError;
+	bulkRadioEvents.CadDone = NULL;
+	if (!initP2PEvents(&bulkRadioEvents))
+	{
+		// Another P2P module owns the radio
+		return P2P_BULK_BUSY;
+	}
+
+	bulkTxTimer.oneShot = true;
+	TimerInit(&bulkTxTimer, OnBulkTxTimerEvent);
+	bulkRxTimer.oneShot = true;
+	TimerInit(&bulkRxTimer, OnBulkRxTimerEvent);
+
+	bulkTxId = Radio.Random();
+
+	return P2P_BULK_SUCCESS;
+}
+
+void p2p_bulk_config(uint32_t frequency, uint32_t bitrate, int8_t power)
+{
+	if (bitrate > BULK_MAX_BITRATE)
+	{
+		bitrate = BULK_MAX_BITRATE;
+	}
+	// Modulation index 0.5, the RX bandwidth covers the bitrate and both deviations
+	uint32_t fdev = bitrate / 4;
+	uint32_t bandwidth = bitrate + 2 * fdev;
+
+	Radio.Standby();
+	Radio.SetChannel(frequency);
+	Radio.SetTxConfig(MODEM_FSK, power, fdev, 0, bitrate, 0, BULK_PREAMBLE, false, true, 0, 0, false, 0);
+	Radio.SetRxConfig(MODEM_FSK, bandwidth, bitrate, 0, bandwidth, BULK_PREAMBLE, 0, false, 0, true, 0, 0, false, true);
+
+	bulkTxTimeout = Radio.TimeOnAir(MODEM_FSK, P2P_BULK_HEADER_SIZE + P2P_BULK_SEGMENT) * 2 + 10;
+	bulkAckTimeout = Radio.TimeOnAir(MODEM_FSK, BULK_ACK_SIZE) + 2 * P2P_BULK_TURNAROUND + BULK_ACK_MARGIN;
+
+	// Keep the fallback mode of the application, e.g. a turnaround mode, for p2p_bulk_stop()
+	if (!bulkFallbackSaved)
+	{
+		bulkFallbackMode = SX126xGetRxTxFallbackMode();
+		bulkFallbackSaved = true;
+	}
+	SX126xSetRxTxFallbackMode(RADIO_FALLBACK_FS);
+	bulkListen();
+}
+
+p2p_bulk_status p2p_bulk_send(uint8_t dst, uint8_t *data, uint32_t length)
+{
+	if ((data == NULL) || (length == 0) || (length > 0xFFFFUL * P2P_BULK_SEGMENT) || (dst == bulkAddress))
+	{
+		return P2P_BULK_ERROR;
+	}
+	if ((bulkTxState != BULK_TX_IDLE) && (bulkTxState != BULK_TX_SUSPENDED))
+	{
+		return P2P_BULK_BUSY;
+	}
+
+	bulkTxData = data;
+	bulkTxLength = length;
+	bulkTxSegs = segmentCount(length);
+	bulkTxDst = dst;
+	bulkTxId++;
+	bulkTxBlock = 0;
+	bulkTxAcked = 0;
+	bulkTxSent = 0;
+	bulkTxRetries = 0;
+	bulkTxState = BULK_TX_START;
+	sendRequest();
+	return P2P_BULK_SUCCESS;
+}
+
+p2p_bulk_status p2p_bulk_resume(void)
+{
+	if (bulkTxState != BULK_TX_SUSPENDED)
+	{
+		return P2P_BULK_ERROR;
+	}
+	bulkTxRetries = 0;
+	bulkTxState = BULK_TX_START;
+	sendRequest();
+	return P2P_BULK_SUCCESS;
+}
+
+void p2p_bulk_stop(void)
+{
+	TimerStop(&bulkTxTimer);
+	TimerStop(&bulkRxTimer);
+	bulkTxState = BULK_TX_IDLE;
+	bulkOnAir = BULK_AIR_NONE;
+	bulkRxActive = false;
+	bulkAckPending = false;
+
+	Radio.Standby();
+	SX126xSetRxTxFallbackMode(bulkFallbackMode);
+	bulkFallbackSaved = false;
+	SX126xSetBufferBaseAddress(0x00, 0x00);
+	SX126x.PacketParams.Params.Gfsk.PayloadLength = 0xFF;
+	SX126xSetPacketParams(&SX126x.PacketParams);
+}
+
+void p2p_bulk_get_stats(p2p_bulk_stats_t *stats)
+{
+	memcpy(stats, &bulkStats, sizeof(p2p_bulk_stats_t));
+}
+
+/**
+ * @brief Radio TX done, start the preloaded segment or wait for the acknowledge
+ */
+static void OnBulkTxDone(void)
+{
+	bulk_air_t onAir = bulkOnAir;
+
+	if ((onAir == BULK_AIR_BURST) && (bulkPreSeg >= 0))
+	{
+		// The radio is in FS, the next segment is already in the buffer
+		int32_t seg = bulkPreSeg;
+		bulkTxBase ^= BULK_BUFFER_B;
+		bulkTxFrame(bulkTxBase, bulkPreSize);
+		preloadNext(seg);
+		return;
+	}
+
+	bulkListen();
+	if ((onAir == BULK_AIR_BURST) || (onAir == BULK_AIR_REQUEST))
+	{
+		if (bulkTxState == BULK_TX_BURST)
+		{
+			bulkTxState = BULK_TX_WAIT_ACK;
+		}
+		TimerSetValue(&bulkTxTimer, bulkAckTimeout);
+		TimerStart(&bulkTxTimer);
+	}
+	else if (onAir == BULK_AIR_ACK)
+	{
+		bulkAckPending = false;
+		if (bulkRxActive && !bulkRxComplete)
+		{
+			TimerSetValue(&bulkRxTimer, P2P_BULK_RX_TIMEOUT);
+			TimerStart(&bulkRxTimer);
+		}
+	}
+}
+
+/**
+ * @brief Radio TX timeout, handled like a lost frame
+ */
+static void OnBulkTxTimeout(void)
+{
+	bulkPreSeg = -1;
+	OnBulkTxDone();
+}
+
+/**
+ * @brief Radio RX done, dispatch the frame
+ */
+static void OnBulkRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+{
+	(void)rssi;
+	(void)snr;
+
+	if ((size < BULK_PROBE_SIZE) || (payload[BULK_HDR_DST] != bulkAddress))
+	{
+		return;
+	}
+	switch (payload[BULK_HDR_TYPE])
+	{
+	case BULK_TYPE_START:
+		if (size == BULK_START_SIZE)
+		{
+			handleStart(payload);
+		}
+		break;
+	case BULK_TYPE_DATA:
+	case BULK_TYPE_DATA_ACK_REQ:
+		if (size > P2P_BULK_HEADER_SIZE)
+		{
+			handleData(payload, size);
+		}
+		break;
+	case BULK_TYPE_ACK:
+		if (size == BULK_ACK_SIZE)
+		{
+			handleAck(payload);
+		}
+		break;
+	case BULK_TYPE_PROBE:
+		if (bulkRxActive && (payload[BULK_HDR_SRC] == bulkRxSrc) && (payload[BULK_HDR_ID] == bulkRxId))
+		{
+			scheduleAck();
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief Radio RX timeout, restart the reception
+ */
+static void OnBulkRxTimeout(void)
+{
+	if (bulkOnAir == BULK_AIR_NONE)
+	{
+		bulkListen();
+	}
+}
+
+/**
+ * @brief Radio RX error, a lost segment is repeated after the acknowledge
+ */
+static void OnBulkRxError(void)
+{
+	OnBulkRxTimeout();
+}
+
+/**
+ * @brief Sender timer, start the next burst or handle a missing acknowledge
+ */
+static void OnBulkTxTimerEvent(void)
+{
+	if (bulkOnAir != BULK_AIR_NONE)
+	{
+		// The radio is busy with an acknowledge of the receiver role, try again later
+		TimerSetValue(&bulkTxTimer, P2P_BULK_TURNAROUND);
+		TimerStart(&bulkTxTimer);
+		return;
+	}
+
+	switch (bulkTxState)
+	{
+	case BULK_TX_DELAY:
+		startBurst();
+		break;
+	case BULK_TX_START:
+	case BULK_TX_WAIT_ACK:
+		if (++bulkTxRetries > P2P_BULK_MAX_RETRIES)
+		{
+			finishTx(false);
+			break;
+		}
+		sendRequest();
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief Receiver timer, send the pending acknowledge or report a stalled transfer
+ */
+static void OnBulkRxTimerEvent(void)
+{
+	if (bulkAckPending)
+	{
+		if (bulkOnAir != BULK_AIR_NONE)
+		{
+			TimerSetValue(&bulkRxTimer, P2P_BULK_TURNAROUND);
+			TimerStart(&bulkRxTimer);
+			return;
+		}
+		sendAck();
+		return;
+	}
+
+	if (bulkRxActive && !bulkRxComplete)
+	{
+		// Keep the progress, the sender can still resume
+		if ((bulkCallbacks != NULL) && (bulkCallbacks->RxDone != NULL))
+		{
+			bulkCallbacks->RxDone(bulkRxSrc, bulkRxLength, false);
+		}
+	}
+}
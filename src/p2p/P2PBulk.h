@@ -0,0 +1,148 @@
+/**
+ * @file P2PBulk.h
+ * @brief High throughput GFSK bulk transfer between two nodes
+ *
+ * A large buffer is split into segments of P2P_BULK_SEGMENT bytes that are
+ * sent back to back in bursts of up to P2P_BULK_BLOCK segments. While one
+ * segment is on air, the next one is already written into the other half of
+ * the radio buffer, and the radio falls back to FS after each packet, so the
+ * next transmission starts without a synthesizer lock.
+ *
+ * The last segment of a burst requests an acknowledge. The receiver answers
+ * with the current block and a bitmap of the segments received in it. The
+ * sender repeats only the missing segments. If the acknowledge is lost, the
+ * sender probes the receiver. After P2P_BULK_MAX_RETRIES failed probes the
+ * transfer is suspended and can be continued with p2p_bulk_resume(), the
+ * receiver reports the progress it made and the transfer continues there.
+ *
+ * At 300 kbps a transfer reaches about 25 kB/s of payload.
+ *
+ * Usage:
+ * 1. p2p_bulk_init() initializes the radio with the bulk radio events
+ * 2. p2p_bulk_config() sets up GFSK and starts the reception
+ * 3. send a buffer with p2p_bulk_send(), the buffer must stay valid until
+ *    TxDone is called
+ * 4. p2p_bulk_stop() returns the radio to its defaults and the fallback mode
+ *    of before p2p_bulk_config() before it is used
+ *    for LoRa again
+ */
+#ifndef __P2PBULK_H__
+#define __P2PBULK_H__
+
+#include "stdint.h"
+#include "boards/mcu/board.h"
+
+#ifndef P2P_BULK_SEGMENT
+#define P2P_BULK_SEGMENT 120 /**< Payload bytes per segment, max 122 */
+#endif
+#ifndef P2P_BULK_BLOCK
+#define P2P_BULK_BLOCK 32 /**< Segments per acknowledge block, max 32 */
+#endif
+#ifndef P2P_BULK_MAX_RETRIES
+#define P2P_BULK_MAX_RETRIES 5 /**< Unanswered probes before a transfer is suspended */
+#endif
+#ifndef P2P_BULK_TURNAROUND
+#define P2P_BULK_TURNAROUND 2 /**< Time in ms the other node needs to switch between TX and RX */
+#endif
+#ifndef P2P_BULK_RX_TIMEOUT
+#define P2P_BULK_RX_TIMEOUT 3000 /**< Time in ms without a frame before the receiver reports a failed transfer */
+#endif
+
+#if P2P_BULK_SEGMENT > 122
+#error "P2P_BULK_SEGMENT must fit into half of the radio buffer"
+#endif
+#if P2P_BULK_BLOCK > 32
+#error "P2P_BULK_BLOCK must fit into the acknowledge bitmap"
+#endif
+
+#define P2P_BULK_HEADER_SIZE 6 /**< Size of the segment header */
+
+typedef enum
+{
+	P2P_BULK_ERROR = -1,
+	P2P_BULK_SUCCESS = 0,
+	P2P_BULK_BUSY = 1
+} p2p_bulk_status;
+
+/**@brief P2P bulk transfer callbacks, unused callbacks can be NULL
+ */
+typedef struct p2p_bulk_callback_s
+{
+	/**@brief A new segment was received, segments can arrive out of order
+	 * @param src address of the sender
+	 * @param offset position of the segment in the transfer
+	 * @param data received segment
+	 * @param size size of the segment
+	 */
+	void (*RxSegment)(uint8_t src, uint32_t offset, uint8_t *data, uint8_t size);
+
+	/**@brief A transfer was received completely or stalled
+	 * @param src address of the sender
+	 * @param length total length of the transfer
+	 * @param success false if the sender stopped before the transfer was complete,
+	 *        the transfer continues if the sender resumes it
+	 */
+	void (*RxDone)(uint8_t src, uint32_t length, bool success);
+
+	/**@brief Result of the transfer started with p2p_bulk_send
+	 * @param dst address of the receiver
+	 * @param success false if the receiver did not answer, see p2p_bulk_resume
+	 */
+	void (*TxDone)(uint8_t dst, bool success);
+} p2p_bulk_callback_t;
+
+/**@brief Bulk transfer statistics
+ */
+typedef struct p2p_bulk_stats_s
+{
+	uint32_t tx_segments;	/**< Segments sent, including repeats */
+	uint32_t tx_repeats;	/**< Segments sent again after an acknowledge */
+	uint32_t probes;		/**< Probes sent after a missing acknowledge */
+	uint32_t rx_segments;	/**< New segments received */
+	uint32_t rx_duplicates; /**< Segments received again */
+} p2p_bulk_stats_t;
+
+/**@brief Initialize the bulk transfer layer and the radio
+ *
+ * @param callbacks Pointer to structure containing the callback functions
+ * @param address Own node address, 0xFF is not allowed
+ *
+ * @retval error status, P2P_BULK_BUSY if another P2P module owns the radio, see releaseP2PEvents()
+ */
+p2p_bulk_status p2p_bulk_init(p2p_bulk_callback_t *callbacks, uint8_t address);
+
+/**@brief Configure the radio for GFSK bulk transfers and start the reception
+ *
+ * @param frequency RF frequency in Hz
+ * @param bitrate GFSK bitrate in bit/s, max 300000
+ * @param power TX power in dBm
+ */
+void p2p_bulk_config(uint32_t frequency, uint32_t bitrate, int8_t power);
+
+/**@brief Send a buffer
+ *
+ * @param dst Address of the receiver
+ * @param data Buffer to send, it is not copied and must stay valid until TxDone
+ * @param length Size of the buffer
+ *
+ * @retval P2P_BULK_BUSY if a transfer is running
+ */
+p2p_bulk_status p2p_bulk_send(uint8_t dst, uint8_t *data, uint32_t length);
+
+/**@brief Continue a suspended transfer where the receiver stopped
+ *
+ * @retval P2P_BULK_ERROR if no transfer is suspended
+ */
+p2p_bulk_status p2p_bulk_resume(void);
+
+/**@brief Stop all transfers, return the radio buffer to its defaults and restore the fallback mode
+ */
+void p2p_bulk_stop(void);
+
+/**@brief Get the bulk transfer statistics
+ *
+ * @param stats Structure to fill with the statistics
+ */
+void p2p_bulk_get_stats(p2p_bulk_stats_t *stats);
+
+#endif // __P2PBULK_H__
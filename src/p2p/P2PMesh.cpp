@@ -0,0 +1,587 @@
+/**
+ * @file P2PMesh.cpp
+ * @brief Managed flooding mesh for P2P with duplicate suppression and route learning
+ */
+#include "p2p/P2PMesh.h"
+#include "loraEvents.h"
+
+/** Frame header layout */
+#define MESH_HDR_TYPE 0
+#define MESH_HDR_ORIGIN 1
+#define MESH_HDR_DST 2
+#define MESH_HDR_NEXT_HOP 3
+#define MESH_HDR_SEQ 4
+#define MESH_HDR_TTL 5
+#define MESH_HDR_HOPS 6
+#define MESH_HDR_SENDER 7
+
+/** Frame type, filters frames of other protocols */
+#define MESH_TYPE_DATA 0xC1
+
+/** Probes in the duplicate cache before the oldest entry is replaced */
+#define MESH_DUP_PROBES 8
+
+/** Time in ms added to the time on air for a relay slot */
+#define MESH_TURNAROUND 10
+
+/** Entry of the duplicate cache */
+typedef struct
+{
+	uint16_t key;
+	bool used;
+	uint32_t time;
+} mesh_dup_entry_t;
+
+/** Entry of the route table */
+typedef struct
+{
+	uint8_t dst;
+	uint8_t next_hop;
+	uint8_t hops;
+	bool used;
+	uint32_t time;
+} mesh_route_t;
+
+/** Frame waiting for transmission */
+typedef struct
+{
+	uint8_t frame[P2P_MESH_HEADER_SIZE + P2P_MESH_MAX_PAYLOAD];
+	uint8_t size;
+	bool in_use;
+	bool is_relay;
+	uint16_t key;
+	uint32_t due;
+	uint8_t cad_tries;
+	uint8_t overheard;
+} mesh_tx_entry_t;
+
+static p2p_mesh_callback_t *meshCallbacks;
+static RadioEvents_t meshRadioEvents;
+static TimerEvent_t meshTimer;
+
+static uint8_t meshAddress = P2P_MESH_BROADCAST;
+static uint8_t meshSeq = 0;
+static bool meshRouting = true;
+static uint8_t meshCadDetPeak = 22;
+
+static mesh_dup_entry_t meshDupCache[P2P_MESH_DUP_CACHE];
+static mesh_route_t meshRoutes[P2P_MESH_MAX_ROUTES];
+static mesh_tx_entry_t meshTxQueue[P2P_MESH_TX_QUEUE];
+
+/** Queue entry in CAD or TX, -1 if the radio is free */
+static volatile int8_t meshActive = -1;
+
+static p2p_mesh_stats_t meshStats;
+
+static void OnMeshTxDone(void);
+static void OnMeshTxTimeout(void);
+static void OnMeshRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr);
+static void OnMeshRxTimeout(void);
+static void OnMeshRxError(void);
+static void OnMeshCadDone(bool channelActivityDetected);
+static void OnMeshTimerEvent(void);
+
+/**
+ * @brief Check if an entry is older than a timeout
+ *
+ * @param time time stamp of the entry
+ * @param timeout timeout in ms
+ * @return true if expired
+ */
+static bool expired(uint32_t time, uint32_t timeout)
+{
+	return (millis() - time) > timeout;
+}
+
+/**
+ * @brief Check a frame against the duplicate cache and remember it
+ *
+ * @param key origin and sequence number of the frame
+ * @return true if the frame was seen before
+ */
+static bool dupCheckInsert(uint16_t key)
+{
+	uint32_t hash = ((uint32_t)key * 2654435761u) >> 16;
+	int freeSlot = -1;
+	int oldest = -1;
+
+	for (int probe = 0; probe < MESH_DUP_PROBES; probe++)
+	{
+		int idx = (hash + probe) & (P2P_MESH_DUP_CACHE - 1);
+		mesh_dup_entry_t *entry = &meshDupCache[idx];
+		if (!entry->used || expired(entry->time, P2P_MESH_DUP_TIMEOUT))
+		{
+			if (freeSlot == -1)
+			{
+				freeSlot = idx;
+			}
+			continue;
+		}
+		if (entry->key == key)
+		{
+			return true;
+		}
+		if ((oldest == -1) || ((int32_t)(entry->time - meshDupCache[oldest].time) < 0))
+		{
+			oldest = idx;
+		}
+	}
+
+	int idx = freeSlot != -1 ? freeSlot : oldest;
+	meshDupCache[idx].key = key;
+	meshDupCache[idx].used = true;
+	meshDupCache[idx].time = millis();
+	return false;
+}
+
+/**
+ * @brief Find a valid route
+ *
+ * @param dst destination address
+ * @return mesh_route_t* route or NULL
+ */
+static mesh_route_t *findRoute(uint8_t dst)
+{
+	for (int idx = 0; idx < P2P_MESH_MAX_ROUTES; idx++)
+	{
+		mesh_route_t *route = &meshRoutes[idx];
+		if (route->used && (route->dst == dst) && !expired(route->time, P2P_MESH_ROUTE_TIMEOUT))
+		{
+			return route;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Learn a route from a received frame
+ *
+ * @param dst node the frame came from
+ * @param next_hop neighbour that sent the frame
+ * @param hops hops from this node to dst
+ */
+static void learnRoute(uint8_t dst, uint8_t next_hop, uint8_t hops)
+{
+	mesh_route_t *route = NULL;
+	mesh_route_t *replace = NULL;
+
+	for (int idx = 0; idx < P2P_MESH_MAX_ROUTES; idx++)
+	{
+		mesh_route_t *check = &meshRoutes[idx];
+		if (check->used && (check->dst == dst))
+		{
+			route = check;
+			break;
+		}
+		if (!check->used || expired(check->time, P2P_MESH_ROUTE_TIMEOUT))
+		{
+			if ((replace == NULL) || replace->used)
+			{
+				replace = check;
+			}
+		}
+		else if ((replace == NULL) || (replace->used && ((int32_t)(check->time - replace->time) < 0)))
+		{
+			replace = check;
+		}
+	}
+
+	if (route != NULL)
+	{
+		// Keep the shorter route, but follow changes of the current next hop
+		if ((hops < route->hops) || (route->next_hop == next_hop) || expired(route->time, P2P_MESH_ROUTE_TIMEOUT))
+		{
+			route->next_hop = next_hop;
+			route->hops = hops;
+			route->time = millis();
+		}
+		return;
+	}
+	if (replace != NULL)
+	{
+		replace->dst = dst;
+		replace->next_hop = next_hop;
+		replace->hops = hops;
+		replace->used = true;
+		replace->time = millis();
+	}
+}
+
+/**
+ * @brief Length of a relay slot for a frame
+ *
+ * @param size frame size
+ * @return uint32_t slot length in ms
+ */
+static uint32_t relaySlot(uint8_t size)
+{
+	return Radio.TimeOnAir(MODEM_LORA, size) + MESH_TURNAROUND;
+}
+
+/**
+ * @brief Start the timer for the queued frame that is due first
+ */
+static void armTimer(void)
+{
+	bool found = false;
+	uint32_t nearest = 0;
+
+	TimerStop(&meshTimer);
+	if (meshActive != -1)
+	{
+		// Radio busy, rearmed after TX or CAD done
+		return;
+	}
+	for (int idx = 0; idx < P2P_MESH_TX_QUEUE; idx++)
+	{
+		mesh_tx_entry_t *entry = &meshTxQueue[idx];
+		if (entry->in_use && (!found || ((int32_t)(entry->due - nearest) < 0)))
+		{
+			nearest = entry->due;
+			found = true;
+		}
+	}
+	if (found)
+	{
+		int32_t delay = (int32_t)(nearest - millis());
+		TimerSetValue(&meshTimer, delay > 0 ? delay : 1);
+		TimerStart(&meshTimer);
+	}
+}
+
+/**
+ * @brief Add a frame to the transmit queue
+ *
+ * @param frame complete frame
+ * @param size frame size
+ * @param delay delay before the CAD in ms
+ * @param is_relay frame of another node
+ * @return true if the frame was queued
+ */
+static bool enqueue(uint8_t *frame, uint8_t size, uint32_t delay, bool is_relay)
+{
+	for (int idx = 0; idx < P2P_MESH_TX_QUEUE; idx++)
+	{
+		mesh_tx_entry_t *entry = &meshTxQueue[idx];
+		if (!entry->in_use)
+		{
+			memcpy(entry->frame, frame, size);
+			entry->size = size;
+			entry->in_use = true;
+			entry->is_relay = is_relay;
+			entry->key = (frame[MESH_HDR_ORIGIN] << 8) | frame[MESH_HDR_SEQ];
+			entry->due = millis() + delay;
+			entry->cad_tries = 0;
+			entry->overheard = 0;
+			armTimer();
+			return true;
+		}
+	}
+	meshStats.dropped++;
+	return false;
+}
+
+/**
+ * @brief Put the radio back into RX and continue with the queue
+ */
+static void radioFree(void)
+{
+	meshActive = -1;
+	Radio.Rx(0);
+	armTimer();
+}
+
+/**
+ * @brief Count an overheard relay of a queued frame and cancel the own relay if enough nodes relayed it
+ *
+ * @param key origin and sequence number of the frame
+ */
+static void overheard(uint16_t key)
+{
+	for (int idx = 0; idx < P2P_MESH_TX_QUEUE; idx++)
+	{
+		mesh_tx_entry_t *entry = &meshTxQueue[idx];
+		if (entry->in_use && entry->is_relay && (entry->key == key) && (idx != meshActive))
+		{
+			if (++entry->overheard >= P2P_MESH_SUPPRESS_COUNT)
+			{
+				entry->in_use = false;
+				meshStats.suppressed++;
+			}
+			return;
+		}
+	}
+}
+
+p2p_mesh_status p2p_mesh_init(p2p_mesh_callback_t *callbacks, uint8_t address)
+{
+	if (address == P2P_MESH_BROADCAST)
+	{
+		return P2P_MESH_ERROR;
+	}
+	meshCallbacks = callbacks;
+	meshAddress = address;
+	meshActive = -1;
+	memset(meshDupCache, 0, sizeof(meshDupCache));
+	memset(meshRoutes, 0, sizeof(meshRoutes));
+	memset(meshTxQueue, 0, sizeof(meshTxQueue));
+	memset(&meshStats, 0, sizeof(meshStats));
+
+	meshRadioEvents.TxDone = OnMeshTxDone;
+	meshRadioEvents.TxTimeout = OnMeshTxTimeout;
+	meshRadioEvents.RxDone = OnMeshRxDone;
+	meshRadioEvents.RxTimeout = OnMeshRxTimeout;
+	meshRadioEvents.RxError = OnMeshRxError;
+	meshRadioEvents.CadDone = OnMeshCadDone;
+	if (!initP2PEvents(&meshRadioEvents))
+	{
+		// Another P2P module owns the radio
+		return P2P_MESH_BUSY;
+	}
+
+	meshTimer.oneShot = true;
+	TimerInit(&meshTimer, OnMeshTimerEvent);
+
+	return P2P_MESH_SUCCESS;
+}
+
+void p2p_mesh_start(uint8_t spreading_factor, bool route_learning)
+{
+	meshCadDetPeak = spreading_factor + 13;
+	meshRouting = route_learning;
+	meshSeq = Radio.Random();
+	Radio.Rx(0);
+}
+
+p2p_mesh_status p2p_mesh_send(uint8_t dst, uint8_t *data, uint8_t size, uint8_t ttl)
+{
+	uint8_t frame[P2P_MESH_HEADER_SIZE + P2P_MESH_MAX_PAYLOAD];
+
+	if ((size > P2P_MESH_MAX_PAYLOAD) || (dst == meshAddress) || (ttl == 0))
+	{
+		return P2P_MESH_ERROR;
+	}
+
+	mesh_route_t *route = ((dst != P2P_MESH_BROADCAST) && meshRouting) ? findRoute(dst) : NULL;
+	frame[MESH_HDR_TYPE] = MESH_TYPE_DATA;
+	frame[MESH_HDR_ORIGIN] = meshAddress;
+	frame[MESH_HDR_DST] = dst;
+	frame[MESH_HDR_NEXT_HOP] = route != NULL ? route->next_hop : P2P_MESH_BROADCAST;
+	frame[MESH_HDR_SEQ] = meshSeq++;
+	frame[MESH_HDR_TTL] = ttl;
+	frame[MESH_HDR_HOPS] = 0;
+	frame[MESH_HDR_SENDER] = meshAddress;
+	memcpy(&frame[P2P_MESH_HEADER_SIZE], data, size);
+
+	// Ignore the echoes of the own frame
+	dupCheckInsert((meshAddress << 8) | frame[MESH_HDR_SEQ]);
+
+	if (!enqueue(frame, P2P_MESH_HEADER_SIZE + size, 0, false))
+	{
+		return P2P_MESH_BUSY;
+	}
+	return P2P_MESH_SUCCESS;
+}
+
+uint8_t p2p_mesh_route_hops(uint8_t dst)
+{
+	mesh_route_t *route = findRoute(dst);
+	return route != NULL ? route->hops : 0;
+}
+
+void p2p_mesh_get_stats(p2p_mesh_stats_t *stats)
+{
+	*stats = meshStats;
+}
+
+/**
+ * @brief Timer for queued frames, starts the CAD of the frame due first
+ */
+static void OnMeshTimerEvent(void)
+{
+	if (meshActive != -1)
+	{
+		return;
+	}
+
+	int8_t next = -1;
+	uint32_t now = millis();
+	for (int idx = 0; idx < P2P_MESH_TX_QUEUE; idx++)
+	{
+		mesh_tx_entry_t *entry = &meshTxQueue[idx];
+		if (entry->in_use && ((int32_t)(now - entry->due) >= 0) &&
+			((next == -1) || ((int32_t)(entry->due - meshTxQueue[next].due) < 0)))
+		{
+			next = idx;
+		}
+	}
+	if (next == -1)
+	{
+		armTimer();
+		return;
+	}
+
+	meshActive = next;
+	Radio.Standby();
+	Radio.SetCadParams(LORA_CAD_08_SYMBOL, meshCadDetPeak, 10, LORA_CAD_ONLY, 0);
+	Radio.StartCad();
+}
+
+/**
+ * @brief CAD done, send the frame if the channel is free, else back off
+ */
+static void OnMeshCadDone(bool channelActivityDetected)
+{
+	if (meshActive == -1)
+	{
+		radioFree();
+		return;
+	}
+	mesh_tx_entry_t *entry = &meshTxQueue[meshActive];
+
+	if (channelActivityDetected)
+	{
+		meshStats.cad_busy++;
+		if (++entry->cad_tries > P2P_MESH_CAD_RETRIES)
+		{
+			entry->in_use = false;
+			meshStats.dropped++;
+		}
+		else
+		{
+			// Random back off of one to P2P_MESH_RELAY_SLOTS relay slots
+			uint32_t slot = relaySlot(entry->size);
+			entry->due = millis() + slot + random(P2P_MESH_RELAY_SLOTS * slot);
+		}
+		radioFree();
+		return;
+	}
+
+	meshStats.airtime += Radio.TimeOnAir(MODEM_LORA, entry->size);
+	Radio.Send(entry->frame, entry->size);
+}
+
+/**
+ * @brief Radio TX done, free the queue entry and continue
+ */
+static void OnMeshTxDone(void)
+{
+	if (meshActive != -1)
+	{
+		mesh_tx_entry_t *entry = &meshTxQueue[meshActive];
+		if (entry->is_relay)
+		{
+			meshStats.relayed++;
+		}
+		else
+		{
+			meshStats.originated++;
+		}
+		entry->in_use = false;
+	}
+	radioFree();
+}
+
+/**
+ * @brief Radio TX timeout, the frame is dropped
+ */
+static void OnMeshTxTimeout(void)
+{
+	LOG_LIB("MESH", "TX timeout");
+	if (meshActive != -1)
+	{
+		meshTxQueue[meshActive].in_use = false;
+		meshStats.dropped++;
+	}
+	radioFree();
+}
+
+/**
+ * @brief Radio RX done, deliver and relay the frame
+ */
+static void OnMeshRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+{
+	if ((size < P2P_MESH_HEADER_SIZE) || (size > P2P_MESH_HEADER_SIZE + P2P_MESH_MAX_PAYLOAD) || (payload[MESH_HDR_TYPE] != MESH_TYPE_DATA))
+	{
+		return;
+	}
+
+	uint8_t origin = payload[MESH_HDR_ORIGIN];
+	uint8_t dst = payload[MESH_HDR_DST];
+	uint8_t next_hop = payload[MESH_HDR_NEXT_HOP];
+	uint8_t ttl = payload[MESH_HDR_TTL];
+	uint8_t hops = payload[MESH_HDR_HOPS];
+	uint8_t sender = payload[MESH_HDR_SENDER];
+	uint16_t key = (origin << 8) | payload[MESH_HDR_SEQ];
+
+	if (origin == meshAddress)
+	{
+		// Own frame relayed by a neighbour
+		return;
+	}
+	if (meshRouting)
+	{
+		learnRoute(sender, sender, 1);
+		if (origin != sender)
+		{
+			learnRoute(origin, sender, hops + 1);
+		}
+	}
+
+	if (dupCheckInsert(key))
+	{
+		meshStats.duplicates++;
+		overheard(key);
+		return;
+	}
+
+	if ((dst == meshAddress) || (dst == P2P_MESH_BROADCAST))
+	{
+		meshStats.delivered++;
+		if ((meshCallbacks != NULL) && (meshCallbacks->RxData != NULL))
+		{
+			meshCallbacks->RxData(origin, &payload[P2P_MESH_HEADER_SIZE], size - P2P_MESH_HEADER_SIZE, hops, rssi, snr);
+		}
+	}
+
+	// Relay floods and unicast frames addressed to this node as next hop
+	if ((dst == meshAddress) || (ttl <= 1) || ((next_hop != P2P_MESH_BROADCAST) && (next_hop != meshAddress)))
+	{
+		return;
+	}
+
+	uint8_t frame[P2P_MESH_HEADER_SIZE + P2P_MESH_MAX_PAYLOAD];
+	memcpy(frame, payload, size);
+	mesh_route_t *route = ((dst != P2P_MESH_BROADCAST) && meshRouting) ? findRoute(dst) : NULL;
+	frame[MESH_HDR_NEXT_HOP] = route != NULL ? route->next_hop : P2P_MESH_BROADCAST;
+	frame[MESH_HDR_TTL] = ttl - 1;
+	frame[MESH_HDR_HOPS] = hops + 1;
+	frame[MESH_HDR_SENDER] = meshAddress;
+
+	// A unicast relay has no competing relays, a flood relay waits a random number of relay slots
+	uint32_t delay = 0;
+	if (frame[MESH_HDR_NEXT_HOP] == P2P_MESH_BROADCAST)
+	{
+		delay = random(P2P_MESH_RELAY_SLOTS * relaySlot(size));
+	}
+	enqueue(frame, size, delay, true);
+}
+
+/**
+ * @brief Radio RX timeout, restart the reception
+ */
+static void OnMeshRxTimeout(void)
+{
+	if (meshActive == -1)
+	{
+		Radio.Rx(0);
+	}
+}
+
+/**
+ * @brief Radio RX error, restart the reception
+ */
+static void OnMeshRxError(void)
+{
+	OnMeshRxTimeout();
+}
@@ -0,0 +1,144 @@
+/**
+ * @file P2PMesh.h
+ * @brief Managed flooding mesh for P2P with duplicate suppression and route learning
+ *
+ * Every frame carries its origin, a sequence number and a TTL. A node relays a
+ * frame it has not seen before after a random delay of a few relay slots,
+ * and only if a CAD finds the channel free. The relay is dropped if the node
+ * overhears P2P_MESH_SUPPRESS_COUNT other relays of the same frame during its
+ * delay. Seen frames are remembered in a fixed size hash set keyed on origin
+ * and sequence number.
+ *
+ * With route learning enabled, each node remembers the neighbour it heard an
+ * origin from with the lowest hop count. Frames to a known destination are sent
+ * unicast to that neighbour and only the addressed next hop relays them.
+ *
+ * Usage:
+ * 1. p2p_mesh_init() initializes the radio with the mesh radio events
+ * 2. configure the radio with Radio.SetChannel(), Radio.SetTxConfig() and
+ *    Radio.SetRxConfig(), RX must be set to continuous mode
+ * 3. p2p_mesh_start() starts the reception
+ * 4. send data with p2p_mesh_send()
+ */
+#ifndef __P2PMESH_H__
+#define __P2PMESH_H__
+
+#include "stdint.h"
+#include "boards/mcu/board.h"
+
+#ifndef P2P_MESH_MAX_PAYLOAD
+#define P2P_MESH_MAX_PAYLOAD 64 /**< Max payload size of a frame */
+#endif
+#ifndef P2P_MESH_DUP_CACHE
+#define P2P_MESH_DUP_CACHE 64 /**< Entries of the duplicate cache, power of 2 */
+#endif
+#ifndef P2P_MESH_DUP_TIMEOUT
+#define P2P_MESH_DUP_TIMEOUT 60000 /**< Time in ms a frame is remembered */
+#endif
+#ifndef P2P_MESH_TX_QUEUE
+#define P2P_MESH_TX_QUEUE 4 /**< Frames waiting for transmission or relay */
+#endif
+#ifndef P2P_MESH_DEFAULT_TTL
+#define P2P_MESH_DEFAULT_TTL 4 /**< Max number of hops of a frame */
+#endif
+#ifndef P2P_MESH_RELAY_SLOTS
+#define P2P_MESH_RELAY_SLOTS 4 /**< Number of relay slots the random delay is chosen from */
+#endif
+#ifndef P2P_MESH_SUPPRESS_COUNT
+#define P2P_MESH_SUPPRESS_COUNT 2 /**< Overheard relays that cancel the own relay */
+#endif
+#ifndef P2P_MESH_CAD_RETRIES
+#define P2P_MESH_CAD_RETRIES 5 /**< Busy channel detections before a frame is dropped */
+#endif
+#ifndef P2P_MESH_MAX_ROUTES
+#define P2P_MESH_MAX_ROUTES 16 /**< Entries of the route table */
+#endif
+#ifndef P2P_MESH_ROUTE_TIMEOUT
+#define P2P_MESH_ROUTE_TIMEOUT 300000 /**< Time in ms a learned route is valid */
+#endif
+
+#if (P2P_MESH_DUP_CACHE & (P2P_MESH_DUP_CACHE - 1)) != 0
+#error "P2P_MESH_DUP_CACHE must be a power of 2"
+#endif
+
+#define P2P_MESH_HEADER_SIZE 8	/**< Size of the frame header */
+#define P2P_MESH_BROADCAST 0xFF /**< Destination address of a broadcast */
+
+typedef enum
+{
+	P2P_MESH_ERROR = -1,
+	P2P_MESH_SUCCESS = 0,
+	P2P_MESH_BUSY = 1
+} p2p_mesh_status;
+
+/**@brief P2P mesh callbacks
+ */
+typedef struct p2p_mesh_callback_s
+{
+	/**@brief Data received for this node or as broadcast
+	 * @param origin address of the node that sent the frame
+	 * @param data received payload
+	 * @param size size of the payload
+	 * @param hops number of relays the frame passed
+	 * @param rssi RSSI of the frame
+	 * @param snr SNR of the frame
+	 */
+	void (*RxData)(uint8_t origin, uint8_t *data, uint8_t size, uint8_t hops, int16_t rssi, int8_t snr);
+} p2p_mesh_callback_t;
+
+/**@brief Mesh statistics
+ */
+typedef struct p2p_mesh_stats_s
+{
+	uint32_t originated; /**< Own frames sent */
+	uint32_t relayed;	 /**< Frames of other nodes sent again */
+	uint32_t suppressed; /**< Relays cancelled because other nodes relayed the frame */
+	uint32_t duplicates; /**< Frames received again */
+	uint32_t delivered;	 /**< Frames delivered to the application */
+	uint32_t cad_busy;	 /**< CAD detected a busy channel */
+	uint32_t dropped;	 /**< Frames dropped, queue full or channel busy */
+	uint32_t airtime;	 /**< Time on air of all sent frames in ms */
+} p2p_mesh_stats_t;
+
+/**@brief Initialize the mesh layer and the radio
+ *
+ * @param callbacks Pointer to structure containing the callback functions
+ * @param address Own node address, 0xFF is not allowed
+ *
+ * @retval error status, P2P_MESH_BUSY if another P2P module owns the radio, see releaseP2PEvents()
+ */
+p2p_mesh_status p2p_mesh_init(p2p_mesh_callback_t *callbacks, uint8_t address);
+
+/**@brief Start the reception, call after the radio is configured
+ *
+ * @param spreading_factor LoRa spreading factor used, sets the CAD detection parameters
+ * @param route_learning Send to learned routes unicast instead of flooding
+ */
+void p2p_mesh_start(uint8_t spreading_factor, bool route_learning = true);
+
+/**@brief Send data through the mesh
+ *
+ * @param dst Address of the receiver or P2P_MESH_BROADCAST
+ * @param data Payload to send
+ * @param size Size of the payload, max P2P_MESH_MAX_PAYLOAD
+ * @param ttl Max number of hops
+ *
+ * @retval P2P_MESH_BUSY if the transmit queue is full
+ */
+p2p_mesh_status p2p_mesh_send(uint8_t dst, uint8_t *data, uint8_t size, uint8_t ttl = P2P_MESH_DEFAULT_TTL);
+
+/**@brief Get the number of hops of a learned route
+ *
+ * @param dst Address of the destination
+ *
+ * @retval hops to the destination, 0 if no route is known
+ */
+uint8_t p2p_mesh_route_hops(uint8_t dst);
+
+/**@brief Get the mesh statistics
+ *
+ * @param stats Structure to fill with the statistics
+ */
+void p2p_mesh_get_stats(p2p_mesh_stats_t *stats);
+
+#endif // __P2PMESH_H__
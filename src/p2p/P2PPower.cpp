@@ -0,0 +1,219 @@
+/**
+ * @file P2PPower.cpp
+ * @brief Closed loop TX power control for P2P links
+ */
+#include "p2p/P2PPower.h"
+
+/** Noise figure of the receiver in dB for the sensitivity */
+#define POWER_NOISE_FIGURE 6
+
+/** TX power state of a peer */
+typedef struct
+{
+	uint8_t address;
+	bool used;
+	uint32_t last_active;
+	p2p_power_stats_t stats;
+} power_peer_t;
+
+static bool powerEnabled = false;
+static int8_t powerMin = -9;
+static int8_t powerMax = 22;
+static int8_t powerTarget = 10;
+
+static power_peer_t powerPeers[P2P_POWER_MAX_PEERS];
+
+/**
+ * @brief Find the power state of a peer
+ *
+ * @param address address of the peer
+ * @param create create the state if the peer is unknown, replaces the least recently active peer
+ * @return power_peer_t* power state or NULL
+ */
+static power_peer_t *getPeer(uint8_t address, bool create)
+{
+	power_peer_t *candidate = NULL;
+
+	for (int idx = 0; idx < P2P_POWER_MAX_PEERS; idx++)
+	{
+		power_peer_t *peer = &powerPeers[idx];
+		if (peer->used && (peer->address == address))
+		{
+			peer->last_active = millis();
+			return peer;
+		}
+		if (!peer->used)
+		{
+			if ((candidate == NULL) || candidate->used)
+			{
+				candidate = peer;
+			}
+		}
+		else if ((candidate == NULL) || (candidate->used && ((int32_t)(peer->last_active - candidate->last_active) < 0)))
+		{
+			candidate = peer;
+		}
+	}
+	if (!create)
+	{
+		return NULL;
+	}
+
+	memset(candidate, 0, sizeof(power_peer_t));
+	candidate->address = address;
+	candidate->used = true;
+	candidate->last_active = millis();
+	candidate->stats.power = powerMax;
+	candidate->stats.margin = P2P_POWER_NO_MARGIN;
+	return candidate;
+}
+
+/**
+ * @brief Set the TX power of a peer within the configured range
+ *
+ * @param peer power state
+ * @param power new TX power in dBm
+ */
+static void setPower(power_peer_t *peer, int16_t power)
+{
+	if (power > powerMax)
+	{
+		power = powerMax;
+	}
+	else if (power < powerMin)
+	{
+		power = powerMin;
+	}
+	if (power != peer->stats.power)
+	{
+		LOG_LIB("POWER", "Peer %02X %d dBm", peer->address, power);
+		peer->stats.power = power;
+		peer->stats.changes++;
+	}
+}
+
+/**
+ * @brief Estimate the supply energy of a frame
+ *
+ * @param power TX power in dBm
+ * @param time_on_air time on air in ms
+ * @return energy in uJ
+ */
+static uint32_t frameEnergy(int8_t power, uint32_t time_on_air)
+{
+	return (uint32_t)(((uint64_t)SX126xGetTxCurrent(power) * P2P_POWER_SUPPLY_MV * time_on_air) / 10000);
+}
+
+p2p_power_status p2p_power_init(int8_t min_power, int8_t max_power, int8_t target_margin)
+{
+	if (min_power > max_power)
+	{
+		return P2P_POWER_ERROR;
+	}
+	powerMin = min_power;
+	powerMax = max_power;
+	powerTarget = target_margin;
+	memset(powerPeers, 0, sizeof(powerPeers));
+	powerEnabled = true;
+	return P2P_POWER_SUCCESS;
+}
+
+bool p2p_power_enabled(void)
+{
+	return powerEnabled;
+}
+
+int8_t p2p_power_margin(int16_t rssi, int8_t snr)
+{
+	uint8_t sf = SX126x.ModulationParams.Params.LoRa.SpreadingFactor;
+	uint32_t bandwidth = SX126xGetLoRaBandwidthHz(SX126x.ModulationParams.Params.LoRa.Bandwidth);
+	// Demodulator SNR limit, -7.5 dB at SF7 and 2.5 dB lower per SF step
+	float snr_min = -2.5f * (sf - 4);
+	float margin = snr - snr_min;
+
+	if ((snr >= 0) && (bandwidth != 0))
+	{
+		// Above the noise the SNR saturates, the RSSI shows the distance to the sensitivity
+		float sensitivity = -174.0f + 10.0f * log10f((float)bandwidth) + POWER_NOISE_FIGURE + snr_min;
+		if (rssi - sensitivity > margin)
+		{
+			margin = rssi - sensitivity;
+		}
+	}
+	if (margin > 100)
+	{
+		margin = 100;
+	}
+	else if (margin < -100)
+	{
+		margin = -100;
+	}
+	return (int8_t)margin;
+}
+
+void p2p_power_report(uint8_t address, int8_t margin)
+{
+	if (!powerEnabled || (margin == P2P_POWER_NO_MARGIN))
+	{
+		return;
+	}
+	power_peer_t *peer = getPeer(address, true);
+	peer->stats.margin = margin;
+
+	if (margin < powerTarget)
+	{
+		// Too weak, raise the power at once
+		setPower(peer, peer->stats.power + (powerTarget - margin));
+	}
+	else if (margin > powerTarget + P2P_POWER_HYSTERESIS)
+	{
+		// Strong enough, lower the power in small steps
+		int16_t excess = margin - powerTarget - P2P_POWER_HYSTERESIS;
+		setPower(peer, peer->stats.power - (excess > P2P_POWER_STEP_DOWN ? P2P_POWER_STEP_DOWN : excess));
+	}
+}
+
+int8_t p2p_power_apply(uint8_t address)
+{
+	if (!powerEnabled)
+	{
+		return powerMax;
+	}
+	power_peer_t *peer = getPeer(address, true);
+	SX126xSetRfTxPower(peer->stats.power);
+	return peer->stats.power;
+}
+
+void p2p_power_tx_done(uint8_t address, uint8_t size)
+{
+	if (!powerEnabled)
+	{
+		return;
+	}
+	power_peer_t *peer = getPeer(address, true);
+	uint32_t time_on_air = Radio.TimeOnAir(MODEM_LORA, size);
+	peer->stats.tx_frames++;
+	peer->stats.energy += frameEnergy(peer->stats.power, time_on_air);
+	peer->stats.energy_max += frameEnergy(powerMax, time_on_air);
+}
+
+void p2p_power_tx_failed(uint8_t address)
+{
+	if (!powerEnabled)
+	{
+		return;
+	}
+	power_peer_t *peer = getPeer(address, true);
+	setPower(peer, peer->stats.power + P2P_POWER_STEP_FAIL);
+}
+
+p2p_power_status p2p_power_get_stats(uint8_t address, p2p_power_stats_t *stats)
+{
+	power_peer_t *peer = getPeer(address, false);
+	if (peer == NULL)
+	{
+		return P2P_POWER_ERROR;
+	}
+	*stats = peer->stats;
+	return P2P_POWER_SUCCESS;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file P2PPower.h
+ * @brief Closed loop TX power control for P2P links
+ *
+ * The receiver of a frame computes the link margin, how many dB the frame was
+ * received above the sensitivity of the current spreading factor and bandwidth,
+ * and reports it back to the sender in its acknowledges or beacons. The sender
+ * keeps a TX power per peer: a margin below the target raises the power at once
+ * by the missing dB, a margin above the target plus P2P_POWER_HYSTERESIS lowers
+ * it by up to P2P_POWER_STEP_DOWN dB per report. A frame that was not answered
+ * raises the power by P2P_POWER_STEP_FAIL dB.
+ *
+ * The PA of the radio is set up with the most efficient configuration for each
+ * power level. The statistics compare the estimated supply energy of the frames
+ * with the energy the same frames need at the max power.
+ *
+ * The ARQ layer reports the margin in every frame and uses the power control
+ * once p2p_power_init() is called. Other protocols use the functions directly.
+ *
+ * Usage:
+ * 1. p2p_power_init() with the power range and the target margin
+ * 2. the receiver reports p2p_power_margin() of a received frame to its sender
+ * 3. the sender passes the reported margin to p2p_power_report()
+ * 4. p2p_power_apply() before each transmission to a peer,
+ *    p2p_power_tx_done() or p2p_power_tx_failed() after it
+ */
+#ifndef __P2PPOWER_H__
+#define __P2PPOWER_H__
+
+#include "stdint.h"
+#include "boards/mcu/board.h"
+
+#ifndef P2P_POWER_MAX_PEERS
+#define P2P_POWER_MAX_PEERS 8 /**< Peers with their own TX power */
+#endif
+#ifndef P2P_POWER_HYSTERESIS
+#define P2P_POWER_HYSTERESIS 3 /**< Margin in dB above the target before the power is lowered */
+#endif
+#ifndef P2P_POWER_STEP_DOWN
+#define P2P_POWER_STEP_DOWN 2 /**< Max power reduction in dB per report */
+#endif
+#ifndef P2P_POWER_STEP_FAIL
+#define P2P_POWER_STEP_FAIL 3 /**< Power increase in dB after an unanswered frame */
+#endif
+#ifndef P2P_POWER_SUPPLY_MV
+#define P2P_POWER_SUPPLY_MV 3300 /**< Supply voltage in mV for the energy estimate */
+#endif
+
+#define P2P_POWER_NO_MARGIN -128 /**< Margin value if nothing was received from a peer */
+
+typedef enum
+{
+	P2P_POWER_ERROR = -1,
+	P2P_POWER_SUCCESS = 0,
+	P2P_POWER_BUSY = 1
+} p2p_power_status;
+
+/**@brief Power control statistics of a peer
+ */
+typedef struct p2p_power_stats_s
+{
+	int8_t power;		   /**< Current TX power in dBm */
+	int8_t margin;		   /**< Last margin reported by the peer in dB */
+	uint32_t tx_frames;	   /**< Frames sent to the peer */
+	uint32_t changes;	   /**< TX power changes */
+	uint32_t energy;	   /**< Estimated supply energy of the frames in uJ */
+	uint32_t energy_max;   /**< Estimated supply energy of the frames at the max power in uJ */
+} p2p_power_stats_t;
+
+/**@brief Initialize the power control
+ *
+ * @param min_power Lowest TX power in dBm
+ * @param max_power Highest TX power in dBm, used for unknown peers
+ * @param target_margin Link margin in dB the control aims for
+ *
+ * @retval P2P_POWER_ERROR if the range is empty
+ */
+p2p_power_status p2p_power_init(int8_t min_power, int8_t max_power, int8_t target_margin);
+
+/**@brief Check if the power control is initialized
+ *
+ * @retval true if enabled
+ */
+bool p2p_power_enabled(void);
+
+/**@brief Get the link margin of a received frame for the current modem settings
+ *
+ * @param rssi RSSI of the frame
+ * @param snr SNR of the frame
+ *
+ * @retval margin in dB above the sensitivity
+ */
+int8_t p2p_power_margin(int16_t rssi, int8_t snr);
+
+/**@brief Adjust the TX power of a peer with the margin it reported
+ *
+ * @param address Address of the peer
+ * @param margin Reported margin in dB, P2P_POWER_NO_MARGIN is ignored
+ */
+void p2p_power_report(uint8_t address, int8_t margin);
+
+/**@brief Set the TX power of a peer in the radio, call before the frame is sent
+ *
+ * @param address Address of the peer
+ *
+ * @retval TX power in dBm
+ */
+int8_t p2p_power_apply(uint8_t address);
+
+/**@brief Account a frame sent to a peer
+ *
+ * @param address Address of the peer
+ * @param size Size of the frame
+ */
+void p2p_power_tx_done(uint8_t address, uint8_t size);
+
+/**@brief Raise the TX power of a peer after a frame was not answered
+ *
+ * @param address Address of the peer
+ */
+void p2p_power_tx_failed(uint8_t address);
+
+/**@brief Get the power control statistics of a peer
+ *
+ * @param address Address of the peer
+ * @param stats Structure to fill with the statistics
+ *
+ * @retval P2P_POWER_ERROR if the peer is unknown
+ */
+p2p_power_status p2p_power_get_stats(uint8_t address, p2p_power_stats_t *stats);
+
+#endif // __P2PPOWER_H__
@@ -0,0 +1,299 @@
+/**
+ * @file P2PScan.cpp
+ * @brief Multi spreading factor CAD scanning receiver for single radio gateways
+ */
+#include "p2p/P2PScan.h"
+
+/** Delay in ms before the next CAD after a reception, lets the radio events of the packet finish */
+#define SCAN_RESTART_DELAY 1
+
+/** CAD settings of a spreading factor */
+typedef struct
+{
+	RadioLoRaCadSymbols_t symbols;
+	uint8_t det_peak;
+	uint8_t det_min;
+} scan_cad_settings_t;
+
+/** AN1200.48 best settings, SF5 and SF6 are not covered and use the SF7 values */
+static const scan_cad_settings_t scanCadSettings[P2P_SCAN_NUM_SF] = {
+	{LORA_CAD_02_SYMBOL, 22, 10}, // SF5
+	{LORA_CAD_02_SYMBOL, 22, 10}, // SF6
+	{LORA_CAD_02_SYMBOL, 22, 10}, // SF7
+	{LORA_CAD_02_SYMBOL, 22, 10}, // SF8
+	{LORA_CAD_04_SYMBOL, 23, 10}, // SF9
+	{LORA_CAD_04_SYMBOL, 24, 10}, // SF10
+	{LORA_CAD_04_SYMBOL, 25, 10}, // SF11
+	{LORA_CAD_04_SYMBOL, 28, 10}, // SF12
+};
+
+typedef enum
+{
+	SCAN_IDLE = 0,
+	SCAN_CAD,
+	SCAN_RX
+} scan_state_t;
+
+static p2p_scan_callback_t *scanCallbacks;
+static RadioEvents_t scanRadioEvents;
+static TimerEvent_t scanTimer;
+
+/** Prepared modulation parameters and CAD timeouts of the scanned spreading factors */
+static ModulationParams_t scanModParams[P2P_SCAN_NUM_SF];
+static uint32_t scanCadTimeout[P2P_SCAN_NUM_SF];
+static uint8_t scanSf[P2P_SCAN_NUM_SF];
+static uint8_t scanCount = 0;
+static uint8_t scanIndex = 0;
+static uint32_t scanCycleTime = 0;
+
+/** Modulation parameters before the scan, restored on stop */
+static ModulationParams_t scanBaseParams;
+
+static volatile bool scanRunning = false;
+static volatile scan_state_t scanState = SCAN_IDLE;
+
+static p2p_scan_stats_t scanStats;
+
+static void OnScanRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr);
+static void OnScanRxTimeout(void);
+static void OnScanRxError(void);
+static void OnScanCadDone(bool channelActivityDetected);
+static void OnScanTimerEvent(void);
+
+/**
+ * @brief Start the CAD on the current spreading factor
+ * The CAD exits into RX if it detects a preamble.
+ */
+static void startCad(void)
+{
+	const scan_cad_settings_t *cad = &scanCadSettings[scanSf[scanIndex] - P2P_SCAN_MIN_SF];
+
+	SX126xSetModulationParams(&scanModParams[scanIndex]);
+	// Keeps the time on air and the RX handling in line with the scanned spreading factor
+	SX126x.ModulationParams = scanModParams[scanIndex];
+	SX126xSetCadParams(cad->symbols, cad->det_peak, cad->det_min, LORA_CAD_RX, scanCadTimeout[scanIndex]);
+	scanState = SCAN_CAD;
+	SX126xSetCad();
+}
+
+/**
+ * @brief Move to the next spreading factor of the scan
+ */
+static void nextSf(void)
+{
+	if (++scanIndex >= scanCount)
+	{
+		scanIndex = 0;
+		scanStats.cycles++;
+	}
+}
+
+/**
+ * @brief Start the next CAD after the radio events of the last packet are handled
+ */
+static void scheduleRestart(void)
+{
+	scanState = SCAN_IDLE;
+	TimerSetValue(&scanTimer, SCAN_RESTART_DELAY);
+	TimerStart(&scanTimer);
+}
+
+/**
+ * @brief Get the symbol time of a spreading factor
+ *
+ * @param sf spreading factor
+ * @param bandwidth bandwidth in Hz
+ * @return symbol time in us
+ */
+static uint32_t symbolTime(uint8_t sf, uint32_t bandwidth)
+{
+	return (uint32_t)(((uint64_t)1000000 << sf) / bandwidth);
+}
+
+p2p_scan_status p2p_scan_init(p2p_scan_callback_t *callbacks)
+{
+	scanCallbacks = callbacks;
+	memset(&scanStats, 0, sizeof(p2p_scan_stats_t));
+
+	scanRadioEvents.RxDone = OnScanRxDone;
+	scanRadioEvents.RxTimeout = OnScanRxTimeout;
+	scanRadioEvents.RxError = OnScanRxError;
+	scanRadioEvents.CadDone = OnScanCadDone;
+	if (!initP2PEvents(&scanRadioEvents))
+	{
+		// Another P2P module owns the radio
+		return P2P_SCAN_BUSY;
+	}
+
+	scanTimer.oneShot = true;
+	TimerInit(&scanTimer, OnScanTimerEvent);
+
+	return P2P_SCAN_SUCCESS;
+}
+
+p2p_scan_status p2p_scan_start(uint16_t sf_mask)
+{
+	uint32_t bandwidth = 0;
+
+	if (scanRunning)
+	{
+		return P2P_SCAN_BUSY;
+	}
+	if (SX126x.ModulationParams.PacketType == PACKET_TYPE_LORA)
+	{
+		bandwidth = SX126xGetLoRaBandwidthHz(SX126x.ModulationParams.Params.LoRa.Bandwidth);
+	}
+	if (bandwidth == 0)
+	{
+		return P2P_SCAN_ERROR;
+	}
+
+	scanBaseParams = SX126x.ModulationParams;
+	scanCount = 0;
+	scanCycleTime = 0;
+	for (uint8_t sf = P2P_SCAN_MIN_SF; sf <= P2P_SCAN_MAX_SF; sf++)
+	{
+		if ((sf_mask & P2P_SCAN_SF(sf)) == 0)
+		{
+			continue;
+		}
+		uint32_t symbol = symbolTime(sf, bandwidth);
+		const scan_cad_settings_t *cad = &scanCadSettings[sf - P2P_SCAN_MIN_SF];
+
+		scanSf[scanCount] = sf;
+		scanModParams[scanCount] = scanBaseParams;
+		scanModParams[scanCount].Params.LoRa.SpreadingFactor = (RadioLoRaSpreadingFactors_t)sf;
+		// Low datarate optimization is required for symbols of 16.38 ms and longer
+		scanModParams[scanCount].Params.LoRa.LowDatarateOptimize = symbol >= 16380 ? 0x01 : 0x00;
+
+		// RX timeout after a detection in steps of 15.625 us, covers the preamble and a few symbols for the header
+		uint64_t timeout = ((uint64_t)(SX126x.PacketParams.Params.LoRa.PreambleLength + P2P_SCAN_RX_SYMBOLS) * symbol * 64) / 1000;
+		scanCadTimeout[scanCount] = timeout > 0xFFFFFE ? 0xFFFFFE : (uint32_t)timeout;
+
+		// A CAD takes its symbols plus about one symbol for the processing
+		scanCycleTime += ((1 << cad->symbols) + 1) * symbol;
+		scanCount++;
+	}
+	if (scanCount == 0)
+	{
+		return P2P_SCAN_ERROR;
+	}
+
+	Radio.Standby();
+	SX126xSetDioIrqParams(IRQ_CAD_DONE | IRQ_CAD_ACTIVITY_DETECTED | IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT | IRQ_CRC_ERROR | IRQ_HEADER_ERROR,
+						  IRQ_CAD_DONE | IRQ_CAD_ACTIVITY_DETECTED | IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT | IRQ_CRC_ERROR | IRQ_HEADER_ERROR,
+						  IRQ_RADIO_NONE, IRQ_RADIO_NONE);
+	SX126xRXena();
+
+	scanIndex = 0;
+	scanRunning = true;
+	startCad();
+	return P2P_SCAN_SUCCESS;
+}
+
+void p2p_scan_stop(void)
+{
+	if (!scanRunning)
+	{
+		return;
+	}
+	TimerStop(&scanTimer);
+	scanRunning = false;
+	scanState = SCAN_IDLE;
+	Radio.Standby();
+	SX126x.ModulationParams = scanBaseParams;
+	SX126xSetModulationParams(&scanBaseParams);
+}
+
+uint32_t p2p_scan_cycle_time(void)
+{
+	return scanCycleTime;
+}
+
+void p2p_scan_get_stats(p2p_scan_stats_t *stats)
+{
+	memcpy(stats, &scanStats, sizeof(p2p_scan_stats_t));
+}
+
+/**
+ * @brief CAD done, stay in RX on activity, else continue with the next spreading factor
+ */
+static void OnScanCadDone(bool channelActivityDetected)
+{
+	if (!scanRunning || (scanState != SCAN_CAD))
+	{
+		return;
+	}
+
+	if (channelActivityDetected)
+	{
+		scanStats.cad_detections[scanSf[scanIndex] - P2P_SCAN_MIN_SF]++;
+		// The CAD exit mode already switched the radio to RX
+		SX126xSetOperatingMode(MODE_RX);
+		scanState = SCAN_RX;
+		return;
+	}
+
+	nextSf();
+	startCad();
+}
+
+/**
+ * @brief Radio RX done, report the packet and scan again starting with its spreading factor
+ */
+static void OnScanRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+{
+	if (!scanRunning || (scanState == SCAN_IDLE))
+	{
+		return;
+	}
+
+	uint8_t sf = scanSf[scanIndex];
+	scanStats.received[sf - P2P_SCAN_MIN_SF]++;
+	scheduleRestart();
+
+	if ((scanCallbacks != NULL) && (scanCallbacks->RxData != NULL))
+	{
+		scanCallbacks->RxData(payload, size, rssi, snr, sf);
+	}
+}
+
+/**
+ * @brief Radio RX timeout, the detection was not followed by a packet
+ */
+static void OnScanRxTimeout(void)
+{
+	if (!scanRunning || (scanState != SCAN_RX))
+	{
+		return;
+	}
+
+	scanStats.false_detections[scanSf[scanIndex] - P2P_SCAN_MIN_SF]++;
+	nextSf();
+	scheduleRestart();
+}
+
+/**
+ * @brief Radio RX error, scan again starting with the same spreading factor
+ */
+static void OnScanRxError(void)
+{
+	if (!scanRunning || (scanState == SCAN_IDLE))
+	{
+		return;
+	}
+
+	scanStats.rx_errors[scanSf[scanIndex] - P2P_SCAN_MIN_SF]++;
+	scheduleRestart();
+}
+
+/**
+ * @brief Restart timer, start the next CAD
+ */
+static void OnScanTimerEvent(void)
+{
+	if (scanRunning && (scanState == SCAN_IDLE))
+	{
+		startCad();
+	}
+}
@@ -0,0 +1,111 @@
+/**
+ * @file P2PScan.h
+ * @brief Multi spreading factor CAD scanning receiver for single radio gateways
+ *
+ * The scanner runs a CAD on each spreading factor of a configured set in turn.
+ * The CAD exits into RX, so when a preamble is detected the radio is already
+ * receiving on the spreading factor that showed activity, without another
+ * configuration step. The modulation parameters of every spreading factor are
+ * prepared once at the start, switching to the next one is a single SPI command.
+ * After a reception the scanner starts the next cycle with the spreading factor
+ * of the last packet, so a busy spreading factor is checked first.
+ *
+ * The CAD parameters of each spreading factor follow the best settings of the
+ * Semtech application note AN1200.48 for 125 kHz bandwidth.
+ *
+ * A packet is only received if its preamble is still on air when the scanner
+ * comes back to its spreading factor. The senders must use a preamble of at
+ * least p2p_scan_cycle_time() plus the CAD symbols, the statistics show how many
+ * detections ended without a packet.
+ *
+ * Usage:
+ * 1. p2p_scan_init() initializes the radio with the scan radio events
+ * 2. configure the radio with Radio.SetChannel() and Radio.SetRxConfig(), the
+ *    bandwidth, coding rate and preamble length are used for all spreading
+ *    factors, RX must not be set to continuous mode
+ * 3. p2p_scan_start() with the spreading factors to scan
+ * 4. p2p_scan_stop() before the radio is used for something else
+ */
+#ifndef __P2PSCAN_H__
+#define __P2PSCAN_H__
+
+#include "stdint.h"
+#include "boards/mcu/board.h"
+
+#ifndef P2P_SCAN_RX_SYMBOLS
+#define P2P_SCAN_RX_SYMBOLS 4 /**< Symbols after the preamble the RX waits for a header after a detection */
+#endif
+
+#define P2P_SCAN_MIN_SF 5	/**< Lowest spreading factor */
+#define P2P_SCAN_MAX_SF 12	/**< Highest spreading factor */
+#define P2P_SCAN_NUM_SF (P2P_SCAN_MAX_SF - P2P_SCAN_MIN_SF + 1)
+
+/** Mask bit of a spreading factor for p2p_scan_start */
+#define P2P_SCAN_SF(sf) (1 << (sf))
+
+typedef enum
+{
+	P2P_SCAN_ERROR = -1,
+	P2P_SCAN_SUCCESS = 0,
+	P2P_SCAN_BUSY = 1
+} p2p_scan_status;
+
+/**@brief P2P scan callbacks, unused callbacks can be NULL
+ */
+typedef struct p2p_scan_callback_s
+{
+	/**@brief A packet was received
+	 * @param payload received packet
+	 * @param size size of the packet
+	 * @param rssi RSSI of the packet
+	 * @param snr SNR of the packet
+	 * @param sf spreading factor the packet was received with
+	 */
+	void (*RxData)(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr, uint8_t sf);
+} p2p_scan_callback_t;
+
+/**@brief Scan statistics, the arrays are indexed with the spreading factor - P2P_SCAN_MIN_SF
+ */
+typedef struct p2p_scan_stats_s
+{
+	uint32_t cycles;							/**< Completed scan cycles over all spreading factors */
+	uint32_t cad_detections[P2P_SCAN_NUM_SF];	/**< CAD with activity */
+	uint32_t false_detections[P2P_SCAN_NUM_SF];	/**< Detections that ended in a RX timeout */
+	uint32_t received[P2P_SCAN_NUM_SF];			/**< Packets received */
+	uint32_t rx_errors[P2P_SCAN_NUM_SF];			/**< Packets with CRC or header error */
+} p2p_scan_stats_t;
+
+/**@brief Initialize the scanner and the radio
+ *
+ * @param callbacks Pointer to structure containing the callback functions
+ *
+ * @retval error status, P2P_SCAN_BUSY if another P2P module owns the radio, see releaseP2PEvents()
+ */
+p2p_scan_status p2p_scan_init(p2p_scan_callback_t *callbacks);
+
+/**@brief Start scanning
+ *
+ * @param sf_mask Spreading factors to scan, e.g. P2P_SCAN_SF(7) | P2P_SCAN_SF(9)
+ *
+ * @retval P2P_SCAN_ERROR if the mask has no valid spreading factor
+ * @retval P2P_SCAN_BUSY if the scanner is running
+ */
+p2p_scan_status p2p_scan_start(uint16_t sf_mask);
+
+/**@brief Stop scanning, the radio is put into standby
+ */
+void p2p_scan_stop(void);
+
+/**@brief Get the duration of one scan cycle over all spreading factors
+ *
+ * @retval time in us, 0 if the scanner is not started
+ */
+uint32_t p2p_scan_cycle_time(void);
+
+/**@brief Get the scan statistics
+ *
+ * @param stats Structure to fill with the statistics
+ */
+void p2p_scan_get_stats(p2p_scan_stats_t *stats);
+
+#endif // __P2PSCAN_H__
@@ -0,0 +1,328 @@
+/**
+ * @file P2PSurvey.cpp
+ * @brief Spectrum survey and channel selection for P2P deployments
+ */
+#include "p2p/P2PSurvey.h"
+
+static p2p_survey_callback_t *surveyCallbacks;
+static TimerEvent_t surveyTimer;
+
+static p2p_survey_channel_t surveyChannels[P2P_SURVEY_MAX_CHANNELS];
+static uint8_t surveyCount = 0;
+static uint8_t surveyCurrent = 0;
+static uint16_t surveySamplesPerVisit = 1;
+static uint16_t surveyVisitSamples = 0;
+static uint16_t surveyRounds = 0;
+static uint16_t surveyRound = 0;
+static volatile bool surveyRunning = false;
+
+static void OnSurveyTimerEvent(void);
+
+/**
+ * @brief Tune the radio to a channel and start listening
+ * Standby on XOSC keeps the oscillator running between the channels.
+ *
+ * @param channel index of the channel
+ */
+static void tuneChannel(uint8_t channel)
+{
+	SX126xSetStandby(STDBY_XOSC);
+	SX126xSetRfPllWord(surveyChannels[channel].pll_word);
+	SX126xSetRx(0xFFFFFF);
+}
+
+/**
+ * @brief Add a RSSI sample to the channel statistics
+ *
+ * @param entry channel statistics
+ * @param rssi RSSI sample in dBm
+ */
+static void addSample(p2p_survey_channel_t *entry, int8_t rssi)
+{
+	int16_t bin = (rssi - P2P_SURVEY_MIN_RSSI) / P2P_SURVEY_BIN_WIDTH;
+	if (bin < 0)
+	{
+		bin = 0;
+	}
+	else if (bin >= P2P_SURVEY_BINS)
+	{
+		bin = P2P_SURVEY_BINS - 1;
+	}
+
+	if (entry->hist[bin] == 0xFFFF)
+	{
+		// Age the histogram and the counters together, older samples weigh half
+		for (int idx = 0; idx < P2P_SURVEY_BINS; idx++)
+		{
+			entry->hist[idx] >>= 1;
+		}
+		entry->samples >>= 1;
+		entry->busy >>= 1;
+	}
+	entry->hist[bin]++;
+	entry->samples++;
+	if (rssi > P2P_SURVEY_BUSY_RSSI)
+	{
+		entry->busy++;
+	}
+	if ((entry->samples == 1) || (rssi > entry->max_rssi))
+	{
+		entry->max_rssi = rssi;
+	}
+}
+
+/**
+ * @brief Common start of a survey
+ *
+ * @param callbacks callback functions
+ * @param dwell time in ms on a channel per sweep
+ * @param rounds number of sweeps
+ */
+static void startSurvey(p2p_survey_callback_t *callbacks, uint16_t dwell, uint16_t rounds)
+{
+	surveyCallbacks = callbacks;
+	surveyRounds = rounds;
+	surveyRound = 0;
+	surveyCurrent = 0;
+	surveyVisitSamples = 0;
+	surveySamplesPerVisit = dwell / P2P_SURVEY_SAMPLE_INTERVAL;
+	if (surveySamplesPerVisit == 0)
+	{
+		surveySamplesPerVisit = 1;
+	}
+
+	// Calibrates the image for the band once, IRQs are off as the survey only reads the RSSI
+	Radio.Standby();
+	Radio.SetChannel(surveyChannels[0].frequency);
+	SX126xSetDioIrqParams(IRQ_RADIO_NONE, IRQ_RADIO_NONE, IRQ_RADIO_NONE, IRQ_RADIO_NONE);
+	SX126xRXena();
+
+	surveyRunning = true;
+	surveyTimer.oneShot = true;
+	TimerInit(&surveyTimer, OnSurveyTimerEvent);
+	tuneChannel(0);
+	TimerSetValue(&surveyTimer, P2P_SURVEY_SAMPLE_INTERVAL);
+	TimerStart(&surveyTimer);
+}
+
+p2p_survey_status p2p_survey_start(p2p_survey_callback_t *callbacks, uint32_t *frequencies, uint8_t count, uint16_t dwell, uint16_t rounds)
+{
+	if ((frequencies == NULL) || (count == 0) || (count > P2P_SURVEY_MAX_CHANNELS))
+	{
+		return P2P_SURVEY_ERROR;
+	}
+	if (surveyRunning)
+	{
+		return P2P_SURVEY_BUSY;
+	}
+
+	memset(surveyChannels, 0, sizeof(surveyChannels));
+	surveyCount = count;
+	for (uint8_t idx = 0; idx < count; idx++)
+	{
+		surveyChannels[idx].frequency = frequencies[idx];
+		surveyChannels[idx].pll_word = SX126xGetPllWord(frequencies[idx]);
+	}
+	startSurvey(callbacks, dwell, rounds);
+	return P2P_SURVEY_SUCCESS;
+}
+
+p2p_survey_status p2p_survey_start_range(p2p_survey_callback_t *callbacks, uint32_t start, uint32_t stop, uint32_t step, uint16_t dwell, uint16_t rounds)
+{
+	if ((step == 0) || (stop < start) || (((stop - start) / step) >= P2P_SURVEY_MAX_CHANNELS))
+	{
+		return P2P_SURVEY_ERROR;
+	}
+	if (surveyRunning)
+	{
+		return P2P_SURVEY_BUSY;
+	}
+
+	memset(surveyChannels, 0, sizeof(surveyChannels));
+	surveyCount = ((stop - start) / step) + 1;
+	for (uint8_t idx = 0; idx < surveyCount; idx++)
+	{
+		surveyChannels[idx].frequency = start + idx * step;
+		surveyChannels[idx].pll_word = SX126xGetPllWord(surveyChannels[idx].frequency);
+	}
+	startSurvey(callbacks, dwell, rounds);
+	return P2P_SURVEY_SUCCESS;
+}
+
+void p2p_survey_stop(void)
+{
+	if (!surveyRunning)
+	{
+		return;
+	}
+	TimerStop(&surveyTimer);
+	surveyRunning = false;
+	Radio.Standby();
+}
+
+bool p2p_survey_running(void)
+{
+	return surveyRunning;
+}
+
+const p2p_survey_channel_t *p2p_survey_channel(uint8_t channel)
+{
+	if (channel >= surveyCount)
+	{
+		return NULL;
+	}
+	return &surveyChannels[channel];
+}
+
+int16_t p2p_survey_percentile(uint8_t channel, uint8_t percent)
+{
+	uint32_t total = 0;
+
+	if (channel >= surveyCount)
+	{
+		return 0;
+	}
+	p2p_survey_channel_t *entry = &surveyChannels[channel];
+	for (int idx = 0; idx < P2P_SURVEY_BINS; idx++)
+	{
+		total += entry->hist[idx];
+	}
+	if (total == 0)
+	{
+		return 0;
+	}
+
+	uint32_t target = (total * percent + 99) / 100;
+	uint32_t sum = 0;
+	for (int idx = 0; idx < P2P_SURVEY_BINS; idx++)
+	{
+		sum += entry->hist[idx];
+		if ((sum >= target) && (sum != 0))
+		{
+			return P2P_SURVEY_MIN_RSSI + (idx + 1) * P2P_SURVEY_BIN_WIDTH;
+		}
+	}
+	return entry->max_rssi;
+}
+
+uint8_t p2p_survey_busy_ratio(uint8_t channel)
+{
+	if ((channel >= surveyCount) || (surveyChannels[channel].samples == 0))
+	{
+		return 0;
+	}
+	return (uint8_t)((surveyChannels[channel].busy * 100) / surveyChannels[channel].samples);
+}
+
+/**
+ * @brief Score of a channel, lower is quieter
+ *
+ * @param channel index of the channel
+ * @return score
+ */
+static int16_t channelScore(uint8_t channel)
+{
+	return p2p_survey_percentile(channel, 90) + p2p_survey_busy_ratio(channel);
+}
+
+uint8_t p2p_survey_best_channels(uint8_t *channels, uint8_t count)
+{
+	int16_t scores[P2P_SURVEY_MAX_CHANNELS];
+	uint8_t order[P2P_SURVEY_MAX_CHANNELS];
+	uint8_t valid = 0;
+
+	for (uint8_t idx = 0; idx < surveyCount; idx++)
+	{
+		if (surveyChannels[idx].samples != 0)
+		{
+			scores[valid] = channelScore(idx);
+			order[valid] = idx;
+			valid++;
+		}
+	}
+
+	// Insertion sort, the lists are short
+	for (uint8_t idx = 1; idx < valid; idx++)
+	{
+		int16_t score = scores[idx];
+		uint8_t channel = order[idx];
+		int pos = idx - 1;
+		while ((pos >= 0) && (scores[pos] > score))
+		{
+			scores[pos + 1] = scores[pos];
+			order[pos + 1] = order[pos];
+			pos--;
+		}
+		scores[pos + 1] = score;
+		order[pos + 1] = channel;
+	}
+
+	if (count > valid)
+	{
+		count = valid;
+	}
+	memcpy(channels, order, count);
+	return count;
+}
+
+uint32_t p2p_survey_select(void)
+{
+	uint8_t best;
+
+	if (surveyRunning || (p2p_survey_best_channels(&best, 1) == 0))
+	{
+		return 0;
+	}
+	Radio.SetChannel(surveyChannels[best].frequency);
+	return surveyChannels[best].frequency;
+}
+
+/**
+ * @brief Survey timer, take a RSSI sample and move to the next channel after the dwell time
+ */
+static void OnSurveyTimerEvent(void)
+{
+	if (!surveyRunning)
+	{
+		return;
+	}
+
+	addSample(&surveyChannels[surveyCurrent], SX126xGetRssiInst());
+
+	if (++surveyVisitSamples >= surveySamplesPerVisit)
+	{
+		surveyVisitSamples = 0;
+		surveyCurrent++;
+		if (surveyCurrent >= surveyCount)
+		{
+			surveyCurrent = 0;
+			surveyRound++;
+			if ((surveyCallbacks != NULL) && (surveyCallbacks->RoundDone != NULL))
+			{
+				surveyCallbacks->RoundDone(surveyRound);
+				if (!surveyRunning)
+				{
+					// Stopped by the application
+					return;
+				}
+			}
+			if ((surveyRounds != 0) && (surveyRound >= surveyRounds))
+			{
+				surveyRunning = false;
+				Radio.Standby();
+				if ((surveyCallbacks != NULL) && (surveyCallbacks->Done != NULL))
+				{
+					surveyCallbacks->Done();
+				}
+				return;
+			}
+		}
+		if (surveyCount > 1)
+		{
+			tuneChannel(surveyCurrent);
+		}
+	}
+
+	TimerSetValue(&surveyTimer, P2P_SURVEY_SAMPLE_INTERVAL);
+	TimerStart(&surveyTimer);
+}
@@ -0,0 +1,156 @@
+/**
+ * @file P2PSurvey.h
+ * @brief Spectrum survey and channel selection for P2P deployments
+ *
+ * The survey visits every channel of a list or range in turn, listens for
+ * a dwell time and samples the instantaneous RSSI. The sweep is repeated for
+ * a number of rounds, so the statistics cover a longer period of time. Each
+ * channel keeps a histogram of the RSSI samples, the noise floor percentiles
+ * are taken from it, and counts the samples above P2P_SURVEY_BUSY_RSSI.
+ *
+ * The RSSI is measured with the modem settings of the last Radio.SetRxConfig(),
+ * so configure the radio as it will be used before the survey is started.
+ * The PLL words of the channels are computed once at the start, a channel
+ * change is then a single SPI command.
+ *
+ * Usage:
+ * 1. initialize and configure the radio, no other P2P layer may use the radio
+ *    during the survey
+ * 2. p2p_survey_start() or p2p_survey_start_range()
+ * 3. after the Done callback, get the best channels with p2p_survey_best_channels()
+ *    or switch to the best one with p2p_survey_select()
+ */
+#ifndef __P2PSURVEY_H__
+#define __P2PSURVEY_H__
+
+#include "stdint.h"
+#include "boards/mcu/board.h"
+
+#ifndef P2P_SURVEY_MAX_CHANNELS
+#define P2P_SURVEY_MAX_CHANNELS 64 /**< Max number of channels in a survey */
+#endif
+#ifndef P2P_SURVEY_SAMPLE_INTERVAL
+#define P2P_SURVEY_SAMPLE_INTERVAL 2 /**< Time in ms between two RSSI samples */
+#endif
+#ifndef P2P_SURVEY_BUSY_RSSI
+#define P2P_SURVEY_BUSY_RSSI -100 /**< RSSI in dBm above which a channel is counted as busy */
+#endif
+#ifndef P2P_SURVEY_MIN_RSSI
+#define P2P_SURVEY_MIN_RSSI -140 /**< RSSI of the lowest histogram bin */
+#endif
+#ifndef P2P_SURVEY_BIN_WIDTH
+#define P2P_SURVEY_BIN_WIDTH 3 /**< Width of a histogram bin in dB */
+#endif
+
+#define P2P_SURVEY_BINS 24 /**< Histogram bins, the last bin collects all higher values */
+
+typedef enum
+{
+	P2P_SURVEY_ERROR = -1,
+	P2P_SURVEY_SUCCESS = 0,
+	P2P_SURVEY_BUSY = 1
+} p2p_survey_status;
+
+/**@brief Statistics of one channel
+ */
+typedef struct p2p_survey_channel_s
+{
+	uint32_t frequency;				  /**< RF frequency in Hz */
+	uint32_t pll_word;				  /**< Cached PLL word of the frequency */
+	uint16_t hist[P2P_SURVEY_BINS];	  /**< RSSI histogram, halved when a bin is full */
+	uint32_t samples;				  /**< Number of RSSI samples, aged with the histogram */
+	uint32_t busy;					  /**< Samples above P2P_SURVEY_BUSY_RSSI, aged with the histogram */
+	int8_t max_rssi;				  /**< Highest RSSI seen */
+} p2p_survey_channel_t;
+
+/**@brief P2P survey callbacks, unused callbacks can be NULL
+ */
+typedef struct p2p_survey_callback_s
+{
+	/**@brief A sweep over all channels is finished
+	 * @param round number of the finished sweep, starting with 1
+	 */
+	void (*RoundDone)(uint16_t round);
+
+	/**@brief The survey is finished, the radio is in standby
+	 */
+	void (*Done)(void);
+} p2p_survey_callback_t;
+
+/**@brief Start a survey over a list of frequencies
+ *
+ * @param callbacks Pointer to structure containing the callback functions
+ * @param frequencies List of RF frequencies in Hz
+ * @param count Number of frequencies, max P2P_SURVEY_MAX_CHANNELS
+ * @param dwell Time in ms spent on a channel per sweep
+ * @param rounds Number of sweeps, 0 runs until p2p_survey_stop()
+ *
+ * @retval P2P_SURVEY_BUSY if a survey is running
+ */
+p2p_survey_status p2p_survey_start(p2p_survey_callback_t *callbacks, uint32_t *frequencies, uint8_t count, uint16_t dwell, uint16_t rounds);
+
+/**@brief Start a survey over a frequency range
+ *
+ * @param callbacks Pointer to structure containing the callback functions
+ * @param start First RF frequency in Hz
+ * @param stop Last RF frequency in Hz
+ * @param step Channel spacing in Hz
+ * @param dwell Time in ms spent on a channel per sweep
+ * @param rounds Number of sweeps, 0 runs until p2p_survey_stop()
+ *
+ * @retval P2P_SURVEY_ERROR if the range has more than P2P_SURVEY_MAX_CHANNELS channels
+ */
+p2p_survey_status p2p_survey_start_range(p2p_survey_callback_t *callbacks, uint32_t start, uint32_t stop, uint32_t step, uint16_t dwell, uint16_t rounds);
+
+/**@brief Stop a running survey, the statistics are kept
+ */
+void p2p_survey_stop(void);
+
+/**@brief Check if a survey is running
+ *
+ * @retval true if running
+ */
+bool p2p_survey_running(void);
+
+/**@brief Get the statistics of a channel
+ *
+ * @param channel Index of the channel
+ *
+ * @retval statistics, NULL if the index is out of range
+ */
+const p2p_survey_channel_t *p2p_survey_channel(uint8_t channel);
+
+/**@brief Get an RSSI percentile of a channel from its histogram
+ *
+ * @param channel Index of the channel
+ * @param percent Percentile, 10 gives the noise floor, 90 the typical interference
+ *
+ * @retval RSSI in dBm, upper edge of the histogram bin
+ */
+int16_t p2p_survey_percentile(uint8_t channel, uint8_t percent);
+
+/**@brief Get the share of busy samples of a channel
+ *
+ * @param channel Index of the channel
+ *
+ * @retval busy ratio in percent
+ */
+uint8_t p2p_survey_busy_ratio(uint8_t channel);
+
+/**@brief Rank the channels, quietest first
+ * The score is the 90th percentile RSSI plus 1 dB per percent of busy samples.
+ *
+ * @param channels Array for the channel indexes
+ * @param count Size of the array
+ *
+ * @retval number of channels written
+ */
+uint8_t p2p_survey_best_channels(uint8_t *channels, uint8_t count);
+
+/**@brief Switch the radio to the quietest channel
+ *
+ * @retval frequency of the channel in Hz, 0 if no survey data is available
+ */
+uint32_t p2p_survey_select(void);
+
+#endif // __P2PSURVEY_H__
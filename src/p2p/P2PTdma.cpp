@@ -0,0 +1,685 @@
+/**
+ * @file P2PTdma.cpp
+ * @brief Beacon synchronized TDMA for star topology P2P sensor networks
+ */
+#include "p2p/P2PTdma.h"
+#include "loraEvents.h"
+
+/** Frame types */
+#define TDMA_TYPE_BEACON 0xB0
+#define TDMA_TYPE_JOIN 0xB1
+#define TDMA_TYPE_DATA 0xB2
+#define TDMA_TYPE_LEAVE 0xB3
+
+/** Sensor frame layout */
+#define TDMA_HDR_TYPE 0
+#define TDMA_HDR_SRC 1
+#define TDMA_HDR_DST 2
+#define TDMA_HEADER_SIZE 3
+
+/** Beacon layout, followed by one address per slot and the acknowledge bitmap */
+#define TDMA_BCN_TYPE 0
+#define TDMA_BCN_SRC 1
+#define TDMA_BCN_SEQ 2
+#define TDMA_BCN_SLOT_LEN 3
+#define TDMA_BCN_PERIOD 5
+#define TDMA_BCN_SLOTS 9
+#define TDMA_BCN_HEADER_SIZE 10
+
+#define TDMA_BCN_MAX_SIZE (TDMA_BCN_HEADER_SIZE + P2P_TDMA_MAX_SLOTS + (P2P_TDMA_MAX_SLOTS + 7) / 8)
+
+/** Address of a free slot */
+#define TDMA_NO_ADDRESS 0xFF
+
+typedef enum
+{
+	TDMA_ROLE_NONE = 0,
+	TDMA_ROLE_GATEWAY,
+	TDMA_ROLE_SENSOR
+} tdma_role_t;
+
+/** Sensor states */
+typedef enum
+{
+	TDMA_IDLE = 0,	  //!< Not started or left
+	TDMA_SCAN,		  //!< Searching for the gateway beacon
+	TDMA_SLEEP,		  //!< Waiting for the next slot or beacon
+	TDMA_TX,		  //!< Sending in the own or the join slot
+	TDMA_BEACON_RX,	  //!< Receiving the beacon
+} tdma_state_t;
+
+/** Next timed action */
+typedef enum
+{
+	TDMA_ACTION_NONE = 0,
+	TDMA_ACTION_BEACON_TX,
+	TDMA_ACTION_BEACON_RX,
+	TDMA_ACTION_SLOT_TX,
+} tdma_action_t;
+
+static p2p_tdma_callback_t *tdmaCallbacks;
+static RadioEvents_t tdmaRadioEvents;
+static TimerEvent_t tdmaTimer;
+
+static uint8_t tdmaAddress = TDMA_NO_ADDRESS;
+static tdma_role_t tdmaRole = TDMA_ROLE_NONE;
+static volatile tdma_state_t tdmaState = TDMA_IDLE;
+static tdma_action_t tdmaAction = TDMA_ACTION_NONE;
+static uint32_t tdmaActionTime = 0;
+
+/** Superframe parameters, set by the gateway and learned by the sensors from the beacon */
+static uint32_t tdmaPeriod = 0;
+static uint16_t tdmaSlotLen = 0;
+static uint8_t tdmaSlots = 0;
+/** End of the last beacon, the time reference of the superframe */
+static uint32_t tdmaRef = 0;
+/** Time on air of the beacon */
+static uint32_t tdmaBeaconToa = 0;
+
+/** Slot assignment, index 0 is data slot 1 */
+static uint8_t tdmaSlotOwner[P2P_TDMA_MAX_SLOTS];
+
+/** Gateway: slots heard in the current superframe */
+static uint8_t tdmaHeard[(P2P_TDMA_MAX_SLOTS + 7) / 8];
+/** Gateway: superframes without traffic per slot */
+static uint8_t tdmaIdle[P2P_TDMA_MAX_SLOTS];
+static uint8_t tdmaBeaconSeq = 0;
+
+/** Sensor: gateway address learned from the beacon */
+static uint8_t tdmaGateway = TDMA_NO_ADDRESS;
+/** Sensor: own slot, 0 if none */
+static uint8_t tdmaMySlot = 0;
+static uint8_t tdmaMissed = 0;
+static bool tdmaTxPending = false;
+static bool tdmaTxSent = false;
+static uint8_t tdmaTxRetries = 0;
+static bool tdmaLeavePending = false;
+static uint8_t tdmaTxType = TDMA_TYPE_DATA;
+
+static uint8_t tdmaBuffer[TDMA_BCN_MAX_SIZE > TDMA_HEADER_SIZE + P2P_TDMA_MAX_PAYLOAD ? TDMA_BCN_MAX_SIZE : TDMA_HEADER_SIZE + P2P_TDMA_MAX_PAYLOAD];
+static uint8_t tdmaTxData[P2P_TDMA_MAX_PAYLOAD];
+static uint8_t tdmaTxSize = 0;
+
+static void OnTdmaTxDone(void);
+static void OnTdmaTxTimeout(void);
+static void OnTdmaRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr);
+static void OnTdmaRxTimeout(void);
+static void OnTdmaRxError(void);
+static void OnTdmaTimerEvent(void);
+
+/**
+ * @brief Size of the beacon for a number of slots
+ *
+ * @param slots number of data slots
+ * @return uint8_t beacon size
+ */
+static uint8_t beaconSize(uint8_t slots)
+{
+	return TDMA_BCN_HEADER_SIZE + slots + (slots + 7) / 8;
+}
+
+/**
+ * @brief Start time of a slot relative to the end of the beacon
+ *
+ * @param slot slot number, 0 is the join slot
+ * @return uint32_t offset in ms
+ */
+static uint32_t slotOffset(uint8_t slot)
+{
+	return P2P_TDMA_GUARD + (uint32_t)slot * tdmaSlotLen;
+}
+
+/**
+ * @brief Time of the last radio interrupt
+ * The TX done and RX done events run after the IRQ processing, the interrupt is the exact time.
+ *
+ * @return uint32_t millis() at the DIO1 interrupt
+ */
+static uint32_t irqMillis(void)
+{
+	return millis() - (micros() - RadioIrqTime) / 1000;
+}
+
+/**
+ * @brief Arm the timer for the next action
+ *
+ * @param action action to do
+ * @param time absolute time in ms
+ */
+static void scheduleAction(tdma_action_t action, uint32_t time)
+{
+	int32_t delay = (int32_t)(time - millis());
+
+	tdmaAction = action;
+	tdmaActionTime = time;
+	TimerStop(&tdmaTimer);
+	TimerSetValue(&tdmaTimer, delay > 0 ? delay : 1);
+	TimerStart(&tdmaTimer);
+}
+
+/**
+ * @brief Sensor: schedule the rest of the superframe and sleep the radio until then
+ */
+static void sensorScheduleSuperframe(void)
+{
+	uint32_t beaconRx = tdmaRef + tdmaPeriod - tdmaBeaconToa - P2P_TDMA_GUARD;
+
+	if ((tdmaMySlot != 0) && (tdmaTxPending || tdmaLeavePending))
+	{
+		tdmaTxType = tdmaLeavePending ? TDMA_TYPE_LEAVE : TDMA_TYPE_DATA;
+		scheduleAction(TDMA_ACTION_SLOT_TX, tdmaRef + slotOffset(tdmaMySlot) + P2P_TDMA_GUARD);
+	}
+	else if ((tdmaMySlot == 0) && !tdmaLeavePending)
+	{
+		// Random time in the join slot, the join requests of several sensors should not collide
+		uint32_t joinToa = Radio.TimeOnAir(MODEM_LORA, TDMA_HEADER_SIZE);
+		uint32_t spread = tdmaSlotLen > joinToa + 2 * P2P_TDMA_GUARD ? tdmaSlotLen - joinToa - 2 * P2P_TDMA_GUARD : 1;
+		tdmaTxType = TDMA_TYPE_JOIN;
+		scheduleAction(TDMA_ACTION_SLOT_TX, tdmaRef + slotOffset(0) + P2P_TDMA_GUARD + random(spread));
+	}
+	else
+	{
+		scheduleAction(TDMA_ACTION_BEACON_RX, beaconRx);
+	}
+	tdmaState = TDMA_SLEEP;
+	Radio.Sleep();
+}
+
+/**
+ * @brief Sensor: search for the gateway beacon
+ */
+static void sensorScan(void)
+{
+	TimerStop(&tdmaTimer);
+	tdmaAction = TDMA_ACTION_NONE;
+	tdmaState = TDMA_SCAN;
+	tdmaMissed = 0;
+	Radio.Rx(0);
+}
+
+/**
+ * @brief Sensor: handle a received beacon
+ *
+ * @param payload beacon
+ * @param size beacon size
+ */
+static void sensorBeacon(uint8_t *payload, uint8_t size)
+{
+	uint8_t slots = payload[TDMA_BCN_SLOTS];
+	if ((slots > P2P_TDMA_MAX_SLOTS) || (size < beaconSize(slots)))
+	{
+		return;
+	}
+	if ((tdmaGateway != TDMA_NO_ADDRESS) && (payload[TDMA_BCN_SRC] != tdmaGateway) && (tdmaState != TDMA_SCAN))
+	{
+		// Beacon of another network
+		return;
+	}
+
+	// The RX done interrupt is the end of the beacon
+	tdmaRef = irqMillis();
+	tdmaGateway = payload[TDMA_BCN_SRC];
+	tdmaSlotLen = payload[TDMA_BCN_SLOT_LEN] | (payload[TDMA_BCN_SLOT_LEN + 1] << 8);
+	tdmaPeriod = (uint32_t)payload[TDMA_BCN_PERIOD] | ((uint32_t)payload[TDMA_BCN_PERIOD + 1] << 8) |
+				 ((uint32_t)payload[TDMA_BCN_PERIOD + 2] << 16) | ((uint32_t)payload[TDMA_BCN_PERIOD + 3] << 24);
+	tdmaSlots = slots;
+	tdmaBeaconToa = Radio.TimeOnAir(MODEM_LORA, size);
+	tdmaMissed = 0;
+
+	uint8_t mySlot = 0;
+	for (uint8_t idx = 0; idx < slots; idx++)
+	{
+		tdmaSlotOwner[idx] = payload[TDMA_BCN_HEADER_SIZE + idx];
+		if (tdmaSlotOwner[idx] == tdmaAddress)
+		{
+			mySlot = idx + 1;
+		}
+	}
+
+	// Acknowledge of the frame sent in the last superframe
+	if (tdmaTxSent && (tdmaMySlot != 0) && (tdmaMySlot == mySlot))
+	{
+		uint8_t *ackMap = &payload[TDMA_BCN_HEADER_SIZE + slots];
+		bool acked = (ackMap[(tdmaMySlot - 1) / 8] & (1 << ((tdmaMySlot - 1) % 8))) != 0;
+		tdmaTxSent = false;
+		if (acked || (++tdmaTxRetries > P2P_TDMA_MAX_RETRIES))
+		{
+			tdmaTxPending = false;
+			if ((tdmaCallbacks != NULL) && (tdmaCallbacks->TxResult != NULL))
+			{
+				tdmaCallbacks->TxResult(acked);
+			}
+		}
+	}
+
+	if (mySlot != tdmaMySlot)
+	{
+		LOG_LIB("TDMA", "Slot %d -> %d", tdmaMySlot, mySlot);
+		tdmaMySlot = mySlot;
+		tdmaTxSent = false;
+		if ((tdmaCallbacks != NULL) && (tdmaCallbacks->SlotChanged != NULL))
+		{
+			tdmaCallbacks->SlotChanged(tdmaAddress, mySlot);
+		}
+	}
+
+	sensorScheduleSuperframe();
+}
+
+/**
+ * @brief Sensor: the beacon was not received, continue with the predicted timing
+ */
+static void sensorBeaconMissed(void)
+{
+	if (++tdmaMissed > P2P_TDMA_MAX_MISSED)
+	{
+		LOG_LIB("TDMA", "Beacon lost");
+		tdmaMySlot = 0;
+		tdmaTxSent = false;
+		if ((tdmaCallbacks != NULL) && (tdmaCallbacks->SlotChanged != NULL))
+		{
+			tdmaCallbacks->SlotChanged(tdmaAddress, 0);
+		}
+		sensorScan();
+		return;
+	}
+	// A frame sent in the last superframe is repeated, its acknowledge is unknown
+	tdmaTxSent = false;
+	tdmaRef += tdmaPeriod;
+	sensorScheduleSuperframe();
+}
+
+/**
+ * @brief Gateway: find the slot of a sensor
+ *
+ * @param address sensor address
+ * @return uint8_t slot number, 0 if the sensor has no slot
+ */
+static uint8_t gatewayFindSlot(uint8_t address)
+{
+	for (uint8_t idx = 0; idx < tdmaSlots; idx++)
+	{
+		if (tdmaSlotOwner[idx] == address)
+		{
+			return idx + 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Gateway: free a slot
+ *
+ * @param slot slot number
+ */
+static void gatewayFreeSlot(uint8_t slot)
+{
+	uint8_t address = tdmaSlotOwner[slot - 1];
+	tdmaSlotOwner[slot - 1] = TDMA_NO_ADDRESS;
+	LOG_LIB("TDMA", "Slot %d freed from %02X", slot, address);
+	if ((tdmaCallbacks != NULL) && (tdmaCallbacks->SlotChanged != NULL))
+	{
+		tdmaCallbacks->SlotChanged(address, 0);
+	}
+}
+
+/**
+ * @brief Gateway: send the beacon
+ * Frees the slots of idle sensors and acknowledges the slots heard in the last superframe.
+ */
+static void gatewaySendBeacon(void)
+{
+	uint8_t size = beaconSize(tdmaSlots);
+	uint8_t *ackMap = &tdmaBuffer[TDMA_BCN_HEADER_SIZE + tdmaSlots];
+
+	memset(ackMap, 0, (tdmaSlots + 7) / 8);
+	for (uint8_t idx = 0; idx < tdmaSlots; idx++)
+	{
+		if (tdmaSlotOwner[idx] == TDMA_NO_ADDRESS)
+		{
+			continue;
+		}
+		if (tdmaHeard[idx / 8] & (1 << (idx % 8)))
+		{
+			ackMap[idx / 8] |= (1 << (idx % 8));
+			tdmaIdle[idx] = 0;
+		}
+		else if (++tdmaIdle[idx] > P2P_TDMA_MAX_IDLE)
+		{
+			gatewayFreeSlot(idx + 1);
+		}
+	}
+	memset(tdmaHeard, 0, sizeof(tdmaHeard));
+
+	tdmaBuffer[TDMA_BCN_TYPE] = TDMA_TYPE_BEACON;
+	tdmaBuffer[TDMA_BCN_SRC] = tdmaAddress;
+	tdmaBuffer[TDMA_BCN_SEQ] = tdmaBeaconSeq++;
+	tdmaBuffer[TDMA_BCN_SLOT_LEN] = tdmaSlotLen & 0xFF;
+	tdmaBuffer[TDMA_BCN_SLOT_LEN + 1] = tdmaSlotLen >> 8;
+	tdmaBuffer[TDMA_BCN_PERIOD] = tdmaPeriod & 0xFF;
+	tdmaBuffer[TDMA_BCN_PERIOD + 1] = (tdmaPeriod >> 8) & 0xFF;
+	tdmaBuffer[TDMA_BCN_PERIOD + 2] = (tdmaPeriod >> 16) & 0xFF;
+	tdmaBuffer[TDMA_BCN_PERIOD + 3] = (tdmaPeriod >> 24) & 0xFF;
+	tdmaBuffer[TDMA_BCN_SLOTS] = tdmaSlots;
+	memcpy(&tdmaBuffer[TDMA_BCN_HEADER_SIZE], tdmaSlotOwner, tdmaSlots);
+
+	Radio.Send(tdmaBuffer, size);
+}
+
+/**
+ * @brief Gateway: handle a frame of a sensor
+ *
+ * @param payload frame
+ * @param size frame size
+ * @param rssi RSSI of the frame
+ * @param snr SNR of the frame
+ */
+static void gatewayFrame(uint8_t *payload, uint8_t size, int16_t rssi, int8_t snr)
+{
+	if ((size < TDMA_HEADER_SIZE) || (payload[TDMA_HDR_DST] != tdmaAddress))
+	{
+		return;
+	}
+	uint8_t src = payload[TDMA_HDR_SRC];
+	uint8_t slot = gatewayFindSlot(src);
+
+	switch (payload[TDMA_HDR_TYPE])
+	{
+	case TDMA_TYPE_JOIN:
+		if (slot == 0)
+		{
+			slot = gatewayFindSlot(TDMA_NO_ADDRESS);
+			if (slot == 0)
+			{
+				LOG_LIB("TDMA", "No free slot for %02X", src);
+				return;
+			}
+			tdmaSlotOwner[slot - 1] = src;
+			tdmaIdle[slot - 1] = 0;
+			LOG_LIB("TDMA", "Slot %d assigned to %02X", slot, src);
+			if ((tdmaCallbacks != NULL) && (tdmaCallbacks->SlotChanged != NULL))
+			{
+				tdmaCallbacks->SlotChanged(src, slot);
+			}
+		}
+		break;
+	case TDMA_TYPE_DATA:
+		if (slot == 0)
+		{
+			// Slot was freed, the sensor joins again after the next beacon
+			return;
+		}
+		tdmaHeard[(slot - 1) / 8] |= (1 << ((slot - 1) % 8));
+		if ((tdmaCallbacks != NULL) && (tdmaCallbacks->RxData != NULL))
+		{
+			tdmaCallbacks->RxData(src, &payload[TDMA_HEADER_SIZE], size - TDMA_HEADER_SIZE, rssi, snr);
+		}
+		break;
+	case TDMA_TYPE_LEAVE:
+		if (slot != 0)
+		{
+			gatewayFreeSlot(slot);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+p2p_tdma_status p2p_tdma_init(p2p_tdma_callback_t *callbacks, uint8_t address)
+{
+	if (address == TDMA_NO_ADDRESS)
+	{
+		return P2P_TDMA_ERROR;
+	}
+	tdmaCallbacks = callbacks;
+	tdmaAddress = address;
+	tdmaRole = TDMA_ROLE_NONE;
+	tdmaState = TDMA_IDLE;
+
+	tdmaRadioEvents.TxDone = OnTdmaTxDone;
+	tdmaRadioEvents.TxTimeout = OnTdmaTxTimeout;
+	tdmaRadioEvents.RxDone = OnTdmaRxDone;
+	tdmaRadioEvents.RxTimeout = OnTdmaRxTimeout;
+	tdmaRadioEvents.RxError = OnTdmaRxError;
+	tdmaRadioEvents.CadDone = NULL;
+	if (!initP2PEvents(&tdmaRadioEvents))
+	{
+		// Another P2P module owns the radio
+		return P2P_TDMA_BUSY;
+	}
+
+	tdmaTimer.oneShot = true;
+	TimerInit(&tdmaTimer, OnTdmaTimerEvent);
+
+	return P2P_TDMA_SUCCESS;
+}
+
+p2p_tdma_status p2p_tdma_gateway_start(uint32_t period, uint8_t slots)
+{
+	if ((slots == 0) || (slots > P2P_TDMA_MAX_SLOTS))
+	{
+		return P2P_TDMA_ERROR;
+	}
+
+	// A slot holds the largest frame with a guard time before and after
+	tdmaSlotLen = Radio.TimeOnAir(MODEM_LORA, TDMA_HEADER_SIZE + P2P_TDMA_MAX_PAYLOAD) + 2 * P2P_TDMA_GUARD;
+	tdmaBeaconToa = Radio.TimeOnAir(MODEM_LORA, beaconSize(slots));
+	// Beacon, join slot and data slots have to fit into the period
+	uint32_t needed = tdmaBeaconToa + slotOffset(slots + 1) + P2P_TDMA_GUARD;
+	if (period < needed)
+	{
+		LOG_LIB("TDMA", "Period too short, %ld ms needed", needed);
+		return P2P_TDMA_ERROR;
+	}
+
+	tdmaRole = TDMA_ROLE_GATEWAY;
+	tdmaPeriod = period;
+	tdmaSlots = slots;
+	memset(tdmaSlotOwner, TDMA_NO_ADDRESS, sizeof(tdmaSlotOwner));
+	memset(tdmaIdle, 0, sizeof(tdmaIdle));
+	memset(tdmaHeard, 0, sizeof(tdmaHeard));
+	LOG_LIB("TDMA", "Gateway with %d slots of %d ms", slots, tdmaSlotLen);
+
+	scheduleAction(TDMA_ACTION_BEACON_TX, millis());
+	return P2P_TDMA_SUCCESS;
+}
+
+p2p_tdma_status p2p_tdma_sensor_start(void)
+{
+	tdmaRole = TDMA_ROLE_SENSOR;
+	tdmaGateway = TDMA_NO_ADDRESS;
+	tdmaMySlot = 0;
+	tdmaTxPending = false;
+	tdmaTxSent = false;
+	tdmaLeavePending = false;
+	sensorScan();
+	return P2P_TDMA_SUCCESS;
+}
+
+p2p_tdma_status p2p_tdma_send(uint8_t *data, uint8_t size)
+{
+	if ((tdmaRole != TDMA_ROLE_SENSOR) || (size > P2P_TDMA_MAX_PAYLOAD))
+	{
+		return P2P_TDMA_ERROR;
+	}
+	if (tdmaTxPending || tdmaLeavePending)
+	{
+		return P2P_TDMA_BUSY;
+	}
+	memcpy(tdmaTxData, data, size);
+	tdmaTxSize = size;
+	tdmaTxRetries = 0;
+	tdmaTxSent = false;
+	tdmaTxPending = true;
+	if ((tdmaState == TDMA_SLEEP) && (tdmaAction == TDMA_ACTION_BEACON_RX) && (tdmaMySlot != 0) &&
+		((int32_t)(tdmaRef + slotOffset(tdmaMySlot) + P2P_TDMA_GUARD - millis()) > 0))
+	{
+		// Own slot of this superframe is still ahead
+		sensorScheduleSuperframe();
+	}
+	return P2P_TDMA_SUCCESS;
+}
+
+p2p_tdma_status p2p_tdma_leave(void)
+{
+	if ((tdmaRole != TDMA_ROLE_SENSOR) || (tdmaMySlot == 0))
+	{
+		return P2P_TDMA_ERROR;
+	}
+	tdmaLeavePending = true;
+	return P2P_TDMA_SUCCESS;
+}
+
+uint8_t p2p_tdma_get_slot(void)
+{
+	return tdmaMySlot;
+}
+
+uint32_t p2p_tdma_time_to_next_activity(void)
+{
+	if (tdmaState != TDMA_SLEEP)
+	{
+		return 0;
+	}
+	int32_t remaining = (int32_t)(tdmaActionTime - millis());
+	return remaining > 0 ? remaining : 0;
+}
+
+/**
+ * @brief Timer for beacons and slots
+ */
+static void OnTdmaTimerEvent(void)
+{
+	tdma_action_t action = tdmaAction;
+	tdmaAction = TDMA_ACTION_NONE;
+
+	switch (action)
+	{
+	case TDMA_ACTION_BEACON_TX:
+		gatewaySendBeacon();
+		break;
+	case TDMA_ACTION_BEACON_RX:
+		tdmaState = TDMA_BEACON_RX;
+		Radio.Rx(tdmaBeaconToa + 2 * P2P_TDMA_GUARD);
+		break;
+	case TDMA_ACTION_SLOT_TX:
+		tdmaBuffer[TDMA_HDR_TYPE] = tdmaTxType;
+		tdmaBuffer[TDMA_HDR_SRC] = tdmaAddress;
+		tdmaBuffer[TDMA_HDR_DST] = tdmaGateway;
+		if (tdmaTxType == TDMA_TYPE_DATA)
+		{
+			memcpy(&tdmaBuffer[TDMA_HEADER_SIZE], tdmaTxData, tdmaTxSize);
+			Radio.Send(tdmaBuffer, TDMA_HEADER_SIZE + tdmaTxSize);
+		}
+		else
+		{
+			Radio.Send(tdmaBuffer, TDMA_HEADER_SIZE);
+		}
+		tdmaState = TDMA_TX;
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief Radio TX done
+ * Gateway: the end of the beacon is the time reference, the next beacon ends one period later.
+ * Sensor: sleep until the next beacon.
+ */
+static void OnTdmaTxDone(void)
+{
+	if (tdmaRole == TDMA_ROLE_GATEWAY)
+	{
+		tdmaRef = irqMillis();
+		scheduleAction(TDMA_ACTION_BEACON_TX, tdmaRef + tdmaPeriod - tdmaBeaconToa);
+		Radio.Rx(0);
+		return;
+	}
+
+	if (tdmaTxType == TDMA_TYPE_LEAVE)
+	{
+		tdmaLeavePending = false;
+		tdmaMySlot = 0;
+		tdmaRole = TDMA_ROLE_NONE;
+		tdmaState = TDMA_IDLE;
+		TimerStop(&tdmaTimer);
+		Radio.Sleep();
+		return;
+	}
+	if (tdmaTxType == TDMA_TYPE_DATA)
+	{
+		tdmaTxSent = true;
+	}
+	scheduleAction(TDMA_ACTION_BEACON_RX, tdmaRef + tdmaPeriod - tdmaBeaconToa - P2P_TDMA_GUARD);
+	tdmaState = TDMA_SLEEP;
+	Radio.Sleep();
+}
+
+/**
+ * @brief Radio TX timeout, handled like a sent frame
+ */
+static void OnTdmaTxTimeout(void)
+{
+	LOG_LIB("TDMA", "TX timeout");
+	OnTdmaTxDone();
+}
+
+/**
+ * @brief Radio RX done
+ */
+static void OnTdmaRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+{
+	if (size == 0)
+	{
+		return;
+	}
+	if (tdmaRole == TDMA_ROLE_GATEWAY)
+	{
+		gatewayFrame(payload, size, rssi, snr);
+		return;
+	}
+	if ((tdmaRole == TDMA_ROLE_SENSOR) && (payload[0] == TDMA_TYPE_BEACON) && (size >= TDMA_BCN_HEADER_SIZE))
+	{
+		sensorBeacon(payload, size);
+		if (tdmaState == TDMA_SCAN)
+		{
+			// Not a valid beacon, keep searching
+			Radio.Rx(0);
+		}
+		return;
+	}
+	if (tdmaState == TDMA_BEACON_RX)
+	{
+		// Frame of a sensor instead of the beacon
+		sensorBeaconMissed();
+	}
+}
+
+/**
+ * @brief Radio RX timeout, the beacon was missed
+ */
+static void OnTdmaRxTimeout(void)
+{
+	if (tdmaRole == TDMA_ROLE_GATEWAY)
+	{
+		Radio.Rx(0);
+	}
+	else if (tdmaState == TDMA_BEACON_RX)
+	{
+		sensorBeaconMissed();
+	}
+	else if (tdmaState == TDMA_SCAN)
+	{
+		Radio.Rx(0);
+	}
+}
+
+/**
+ * @brief Radio RX error
+ */
+static void OnTdmaRxError(void)
+{
+	OnTdmaRxTimeout();
+}
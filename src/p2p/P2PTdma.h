@@ -0,0 +1,134 @@
+/**
+ * @file P2PTdma.h
+ * @brief Beacon synchronized TDMA for star topology P2P sensor networks
+ *
+ * The gateway broadcasts a beacon every period. The beacon carries the slot
+ * length, the period, the slot assignments and an acknowledge bit per slot for
+ * the frames received in the last superframe. The end of the beacon is the time
+ * reference for the sensors. After the beacon follows the join slot, where
+ * sensors without a slot request one, then the data slots:
+ *
+ *   | beacon | guard | join slot | slot 1 | slot 2 | ... | slot n | sleep ... | beacon |
+ *
+ * A sensor sends only in its own slot and sleeps the radio until then, and
+ * again until just before the next beacon. Slots of sensors that were not heard
+ * for P2P_TDMA_MAX_IDLE superframes or that left are given to new sensors.
+ *
+ * Usage:
+ * 1. p2p_tdma_init() initializes the radio with the TDMA radio events
+ * 2. configure the radio with Radio.SetChannel(), Radio.SetTxConfig() and
+ *    Radio.SetRxConfig(), RX must be set to continuous mode
+ * 3. p2p_tdma_gateway_start() or p2p_tdma_sensor_start()
+ * 4. on sensors, queue data with p2p_tdma_send()
+ */
+#ifndef __P2PTDMA_H__
+#define __P2PTDMA_H__
+
+#include "stdint.h"
+#include "boards/mcu/board.h"
+
+#ifndef P2P_TDMA_MAX_SLOTS
+#define P2P_TDMA_MAX_SLOTS 32 /**< Max number of data slots */
+#endif
+#ifndef P2P_TDMA_MAX_PAYLOAD
+#define P2P_TDMA_MAX_PAYLOAD 48 /**< Max payload size of a sensor frame */
+#endif
+#ifndef P2P_TDMA_GUARD
+#define P2P_TDMA_GUARD 20 /**< Guard time in ms for clock drift and radio switching */
+#endif
+#ifndef P2P_TDMA_MAX_MISSED
+#define P2P_TDMA_MAX_MISSED 3 /**< Missed beacons before a sensor searches for the gateway again */
+#endif
+#ifndef P2P_TDMA_MAX_IDLE
+#define P2P_TDMA_MAX_IDLE 10 /**< Superframes without traffic before the gateway frees a slot */
+#endif
+#ifndef P2P_TDMA_MAX_RETRIES
+#define P2P_TDMA_MAX_RETRIES 3 /**< Superframes a sensor repeats an unacknowledged frame */
+#endif
+
+typedef enum
+{
+	P2P_TDMA_ERROR = -1,
+	P2P_TDMA_SUCCESS = 0,
+	P2P_TDMA_BUSY = 1
+} p2p_tdma_status;
+
+/**@brief P2P TDMA callbacks, unused callbacks can be NULL
+ */
+typedef struct p2p_tdma_callback_s
+{
+	/**@brief Gateway: data received from a sensor
+	 * @param src address of the sensor
+	 * @param data received payload
+	 * @param size size of the payload
+	 * @param rssi RSSI of the frame
+	 * @param snr SNR of the frame
+	 */
+	void (*RxData)(uint8_t src, uint8_t *data, uint8_t size, int16_t rssi, int8_t snr);
+
+	/**@brief Sensor: result of the frame queued with p2p_tdma_send
+	 * @param success true if the gateway acknowledged the frame in its beacon
+	 */
+	void (*TxResult)(bool success);
+
+	/**@brief Gateway: a sensor got a slot, Sensor: the own slot changed
+	 * @param address address of the sensor
+	 * @param slot assigned slot, 0 if the slot was freed
+	 */
+	void (*SlotChanged)(uint8_t address, uint8_t slot);
+} p2p_tdma_callback_t;
+
+/**@brief Initialize the TDMA layer and the radio
+ *
+ * @param callbacks Pointer to structure containing the callback functions
+ * @param address Own node address, 0xFF is not allowed
+ *
+ * @retval error status, P2P_TDMA_BUSY if another P2P module owns the radio, see releaseP2PEvents()
+ */
+p2p_tdma_status p2p_tdma_init(p2p_tdma_callback_t *callbacks, uint8_t address);
+
+/**@brief Start as gateway, call after the radio is configured
+ *
+ * @param period Beacon period in ms
+ * @param slots Number of data slots, max P2P_TDMA_MAX_SLOTS
+ *
+ * @retval P2P_TDMA_ERROR if the slots do not fit into the period
+ */
+p2p_tdma_status p2p_tdma_gateway_start(uint32_t period, uint8_t slots);
+
+/**@brief Start as sensor, call after the radio is configured
+ * Searches for the gateway beacon and requests a slot.
+ *
+ * @retval error status
+ */
+p2p_tdma_status p2p_tdma_sensor_start(void);
+
+/**@brief Queue data for the next own slot
+ *
+ * @param data Payload to send
+ * @param size Size of the payload, max P2P_TDMA_MAX_PAYLOAD
+ *
+ * @retval P2P_TDMA_BUSY if a frame is still waiting for its slot or acknowledge
+ */
+p2p_tdma_status p2p_tdma_send(uint8_t *data, uint8_t size);
+
+/**@brief Give the own slot back to the gateway and stop
+ *
+ * @retval P2P_TDMA_ERROR if the sensor has no slot
+ */
+p2p_tdma_status p2p_tdma_leave(void);
+
+/**@brief Get the own slot
+ *
+ * @retval slot number, 0 if no slot is assigned
+ */
+uint8_t p2p_tdma_get_slot(void);
+
+/**@brief Time until the next radio activity of a sensor
+ * Can be used by the application to sleep until then.
+ *
+ * @retval time in ms, 0 if the radio is active
+ */
+uint32_t p2p_tdma_time_to_next_activity(void);
+
+#endif // __P2PTDMA_H__
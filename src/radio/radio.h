@@ -50,6 +50,38 @@ typedef enum
 	RF_CAD,		   //!< The radio is doing channel activity detection
 } RadioState_t;
 
+/*!
+ * Max number of channels of the software frequency hopping.
+ * The hop tables take 8 bytes of RAM per channel in every build, define
+ * it higher in the compiler options if more channels are needed, e.g.
+ * 50 or more for frequency hopping under FCC part 15.247
+ */
+#ifndef RADIO_FHSS_MAX_CHANNELS
+#define RADIO_FHSS_MAX_CHANNELS 16
+#endif
+
+/*!
+ * Radio driver address filter modes
+ */
+typedef enum
+{
+	ADDRESS_FILTER_OFF = 0,			//!< All frames are received
+	ADDRESS_FILTER_NODE,			//!< Only frames to the node address are received
+	ADDRESS_FILTER_NODE_BROADCAST,	//!< Frames to the node or the broadcast address are received
+} RadioAddressFilter_t;
+
+/*!
+ * Radio driver RX done to TX start latency, see GetTurnaround
+ */
+typedef struct
+{
+	uint32_t Count;	  //!< Transmissions started after a reception
+	uint32_t Last;	  //!< Latency of the last one [us]
+	uint32_t Min;	  //!< Shortest latency [us]
+	uint32_t Max;	  //!< Longest latency [us]
+	uint32_t Average; //!< Average latency [us]
+} RadioTurnaround_t;
+
 /*!
  * \brief Radio driver callback functions
  */
@@ -185,12 +217,10 @@ struct Radio_s
      * \param  fixLen       Fixed length packets [0: variable, 1: fixed]
      * \param  payloadLen   Sets payload length when fixed length is used
      * \param  crcOn        Enables/Disables the CRC [0: OFF, 1: ON]
-     * \param  freqHopOn    Enables disables the intra-packet frequency hopping
-     *                          FSK : N/A ( set to 0 )
-     *                          LoRa: [0: OFF, 1: ON]
-     * \param  hopPeriod    Number of symbols between each hop
-     *                          FSK : N/A ( set to 0 )
-     *                          LoRa: Number of symbols
+     * \param  freqHopOn    Enables disables the packet level software frequency hopping
+     *                          over the channels set with SetFhssChannels [0: OFF, 1: ON]
+     * \param  hopPeriod    Time on each channel of the hop sequence
+     *                          [10 ms steps, 0: 400 ms]
      * \param  iqInverted   Inverts IQ signals (LoRa only)
      *                          FSK : N/A ( set to 0 )
      *                          LoRa: [0: not inverted, 1: inverted]
@@ -228,12 +258,10 @@ struct Radio_s
      *                          LoRa: Length in symbols (the hardware adds 4 more symbols)
      * \param  fixLen       Fixed length packets [0: variable, 1: fixed]
      * \param  crcOn        Enables disables the CRC [0: OFF, 1: ON]
-     * \param  freqHopOn    Enables disables the intra-packet frequency hopping
-     *                          FSK : N/A ( set to 0 )
-     *                          LoRa: [0: OFF, 1: ON]
-     * \param  hopPeriod    Number of symbols between each hop
-     *                          FSK : N/A ( set to 0 )
-     *                          LoRa: Number of symbols
+     * \param  freqHopOn    Enables disables the packet level software frequency hopping
+     *                          over the channels set with SetFhssChannels [0: OFF, 1: ON]
+     * \param  hopPeriod    Time on each channel of the hop sequence
+     *                          [10 ms steps, 0: 400 ms]
      * \param  iqInverted   Inverts IQ signals (LoRa only)
      *                          FSK : N/A ( set to 0 )
      *                          LoRa: [0: not inverted, 1: inverted]
@@ -390,6 +418,138 @@ struct Radio_s
      * \param   sleepTime     Structure describing sleep timeout value
      */
 	void (*SetRxDutyCycle)(uint32_t rxTime, uint32_t sleepTime);
+	/*!
+     * \brief Sets the LoRa sync word of a private network
+     *
+     * \remark Available on SX126x radios only.
+     *          Frames with another sync word are not detected and do not
+     *          wake up the MCU. Use values of the form 0xX4Y4.
+     *
+     * \param   syncWord      Sync word register value [0x1424: default private network]
+     */
+	void (*SetSyncWord)(uint16_t syncWord);
+	/*!
+     * \brief Sets the P2P address filter, the address is the first byte of the payload
+     *
+     * \remark Available on SX126x radios only.
+     *          GFSK frames are filtered by the radio. For LoRa only the first
+     *          byte of a frame is read and foreign frames are dropped before
+     *          the payload is read. Not applied on public networks.
+     *
+     * \param   mode          Filter mode [ADDRESS_FILTER_OFF, ADDRESS_FILTER_NODE,
+     *                                    ADDRESS_FILTER_NODE_BROADCAST]
+     * \param   nodeAddress   Address of this node
+     * \param   broadcastAddress Broadcast address
+     */
+	void (*SetAddressFilter)(RadioAddressFilter_t mode, uint8_t nodeAddress, uint8_t broadcastAddress);
+	/*!
+     * \brief Sets the channels of the software frequency hopping
+     *
+     * \remark Available on SX126x radios only.
+     *          Hopping is enabled with freqHopOn of SetRxConfig and SetTxConfig.
+     *          The channels are shuffled into a hop sequence derived from the
+     *          seed, all nodes of a network must use the same channels and seed.
+     *          Each channel is used for hopPeriod, a frame is sent on the channel
+     *          of the time it starts. The frame carries its position in the
+     *          sequence, receivers follow the timing of the last received frame
+     *          and keep hopping when frames are missed. A receiver that has not
+     *          received a frame yet waits on the first channel of the sequence.
+     *          The hop header takes 3 bytes of the max payload size.
+     *
+     * \param   channels      List of RF frequencies [Hz]
+     * \param   count         Number of channels, channels above RADIO_FHSS_MAX_CHANNELS are ignored
+     * \param   seed          Seed of the hop sequence
+     */
+	void (*SetFhssChannels)(uint32_t *channels, uint8_t count, uint32_t seed);
+	/*!
+     * \brief Gets the frequency error of the last received LoRa packet
+     *
+     * \remark Available on SX126x radios only.
+     *
+     * \retval  freqError     Frequency error [Hz], positive if the signal is above the receiver
+     */
+	int32_t (*GetFrequencyError)(void);
+	/*!
+     * \brief Enables the tracking of the crystal offset against received packets
+     *
+     * \remark Available on SX126x radios only.
+     *          Each received LoRa packet corrects the offset by a share of its
+     *          frequency error, the first packets with a larger share. The
+     *          correction is applied to all RF frequencies, after a single
+     *          reception the radio is retuned at once, in continuous RX with
+     *          the next SetChannel or hop. Track against a single reference,
+     *          e.g. the gateway. With several peers keep a correction per peer
+     *          with GetFrequencyCorrection and SetFrequencyCorrection instead.
+     *
+     * \param   enable        [true: track the offset, false: keep the correction]
+     */
+	void (*SetAfc)(bool enable);
+	/*!
+     * \brief Sets the crystal offset correction, e.g. restored after a reset
+     *
+     * \remark Available on SX126x radios only.
+     *
+     * \param   ppb           Correction [parts per billion], positive raises the frequency
+     */
+	void (*SetFrequencyCorrection)(int32_t ppb);
+	/*!
+     * \brief Gets the crystal offset correction
+     *
+     * \remark Available on SX126x radios only.
+     *
+     * \retval  ppb           Correction [parts per billion]
+     */
+	int32_t (*GetFrequencyCorrection)(void);
+	/*!
+     * \brief Loads the payload of the next transmission while the radio receives
+     *
+     * \remark Available on SX126x radios only.
+     *          The data buffer is split, received frames use the first
+     *          MaxPayloadLength bytes, see SetMaxPayloadLength, the prepared
+     *          payload is placed at the end. A following Send with the same
+     *          buffer and size only sets the packet parameters and starts the
+     *          transmission. Any other Send writes its payload as before.
+     *
+     * \param   buffer        Buffer pointer
+     * \param   size          Buffer size
+     * \retval  prepared      [true: payload loaded, false: payload and max RX payload do not fit into the buffer]
+     */
+	bool (*PrepareTx)(uint8_t *buffer, uint8_t size);
+	/*!
+     * \brief Sets the mode the radio goes to after a TX or RX done
+     *
+     * \remark Available on SX126x radios only.
+     *          RADIO_FALLBACK_FS keeps the synthesizer locked and
+     *          RADIO_FALLBACK_STDBY_XOSC the crystal running, both shorten the
+     *          start of the next TX or RX at the cost of a higher current
+     *          between the packets. With them the IRQs of TX and RX are
+     *          configured together, switching from RX to TX does not write
+     *          the DIO masks again. Together with PrepareTx a reply, e.g. an
+     *          ACK, only needs the packet parameters and the TX command.
+     *          RADIO_FALLBACK_STDBY_RC, the default, ends the mode.
+     *
+     * \param   fallbackMode  [RADIO_FALLBACK_STDBY_RC, RADIO_FALLBACK_STDBY_XOSC,
+     *                         RADIO_FALLBACK_FS]
+     */
+	void (*SetTurnaroundMode)(uint8_t fallbackMode);
+	/*!
+     * \brief Gets the latency from RX done to TX start
+     *
+     * \remark Available on SX126x radios only.
+     *          Measured from the DIO1 interrupt of a received frame to the
+     *          TX command of the next Send, in any fallback mode. A Rx,
+     *          StartCad or Sleep in between drops the measurement. The ramp
+     *          up of the PA after the TX command is not included.
+     *
+     * \param   turnaround    Structure to fill with the latency
+     */
+	void (*GetTurnaround)(RadioTurnaround_t *turnaround);
+	/*!
+     * \brief Clears the RX done to TX start latency
+     *
+     * \remark Available on SX126x radios only.
+     */
+	void (*ResetTurnaround)(void);
 };
 
 /*!
@@ -400,4 +560,36 @@ struct Radio_s
  */
 extern const struct Radio_s Radio;
 
+/*!
+ * Time of the last DIO1 interrupt [us], micros() in the interrupt handler.
+ *
+ * The radio events run later, from the IRQ processing. The millis() time of
+ * the interrupt is millis() - (micros() - RadioIrqTime) / 1000.
+ */
+extern volatile uint32_t RadioIrqTime;
+
+/*!
+ * \brief Initializes the radio and registers the same events for P2P
+ *
+ * Without a public network sync word the radio reports to the P2P events
+ * instead of the radio events. The P2P events registered here forward to the
+ * given radio events, the timeout type is dropped.
+ *
+ * The P2P modules of src/p2p are exclusive. The events of the first module
+ * own the radio, the registration of other events fails until
+ * releaseP2PEvents() is called. The owner can register again.
+ *
+ * \param  events  Radio events, also used for P2P
+ * \retval success True if the events were registered, false if other events own the radio
+ */
+bool initP2PEvents(RadioEvents_t *events);
+
+/*!
+ * \brief Releases the radio for the events of another P2P module
+ *
+ * The module that owns the radio must be stopped first, its events stay
+ * registered until the next initP2PEvents().
+ */
+void releaseP2PEvents(void);
+
 #endif // __RADIO_H__
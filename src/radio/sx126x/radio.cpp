@@ -35,6 +35,31 @@ loraEvents_t *_p2p, *_lrw;
 TimerEvent_t TxTimeoutTimer;
 TimerEvent_t RxTimeoutTimer;
 
+/*!
+ * Size of the hop header in front of the payload in frequency hopping mode
+ */
+#define RADIO_FHSS_HEADER_SIZE 3
+
+/*!
+ * Time in ms a hop is postponed while a frame is received
+ */
+#define RADIO_FHSS_HOP_DEFER 20
+
+/*!
+ * Max number of postponed hops, limits the effect of false detections
+ */
+#define RADIO_FHSS_MAX_DEFERS 25
+
+/*!
+ * Packets tracked with a fast filter after the AFC is enabled
+ */
+#define RADIO_AFC_ACQUIRE_PACKETS 4
+
+/*!
+ * Max crystal offset correction of the AFC in parts per billion
+ */
+#define RADIO_AFC_MAX_CORRECTION 50000
+
 /*!
  * @brief Initializes the radio
  *
@@ -121,12 +146,10 @@ uint32_t RadioRandom(void);
  * @param  fixLen       Fixed length packets [0: variable, 1: fixed]
  * @param  payloadLen   Sets payload length when fixed length is used
  * @param  crcOn        Enables/Disables the CRC [0: OFF, 1: ON]
- * @param  FreqHopOn    Enables disables the intra-packet frequency hopping
- *                          FSK : N/A ( set to 0 )
- *                          LoRa: [0: OFF, 1: ON]
- * @param  HopPeriod    Number of symbols between each hop
- *                          FSK : N/A ( set to 0 )
- *                          LoRa: Number of symbols
+ * @param  FreqHopOn    Enables disables the packet level software frequency hopping
+ *                          over the channels set with RadioSetFhssChannels [0: OFF, 1: ON]
+ * @param  HopPeriod    Time on each channel of the hop sequence
+ *                          [10 ms steps, 0: 400 ms]
  * @param  iqInverted   Inverts IQ signals (LoRa only)
  *                          FSK : N/A ( set to 0 )
  *                          LoRa: [0: not inverted, 1: inverted]
@@ -165,12 +188,10 @@ void RadioSetRxConfig(RadioModems_t modem, uint32_t bandwidth,
  *                          LoRa: Length in symbols (the hardware adds 4 more symbols)
  * @param  fixLen       Fixed length packets [0: variable, 1: fixed]
  * @param  crcOn        Enables disables the CRC [0: OFF, 1: ON]
- * @param  FreqHopOn    Enables disables the intra-packet frequency hopping
- *                          FSK : N/A ( set to 0 )
- *                          LoRa: [0: OFF, 1: ON]
- * @param  HopPeriod    Number of symbols between each hop
- *                          FSK : N/A ( set to 0 )
- *                          LoRa: Number of symbols
+ * @param  FreqHopOn    Enables disables the packet level software frequency hopping
+ *                          over the channels set with RadioSetFhssChannels [0: OFF, 1: ON]
+ * @param  HopPeriod    Time on each channel of the hop sequence
+ *                          [10 ms steps, 0: 400 ms]
  * @param  iqInverted   Inverts IQ signals (LoRa only)
  *                          FSK : N/A ( set to 0 )
  *                          LoRa: [0: not inverted, 1: inverted]
@@ -358,6 +379,92 @@ void RadioRxBoosted(uint32_t timeout);
  */
 void RadioSetRxDutyCycle(uint32_t rxTime, uint32_t sleepTime);
 
+/*!
+ * @brief Sets the LoRa sync word of a private network
+ *
+ * @param   syncWord      Sync word register value
+ */
+void RadioSetSyncWord(uint16_t syncWord);
+
+/*!
+ * @brief Sets the P2P address filter
+ *
+ * @param   mode          Filter mode
+ * @param   nodeAddress   Address of this node
+ * @param   broadcastAddress Broadcast address
+ */
+void RadioSetAddressFilter(RadioAddressFilter_t mode, uint8_t nodeAddress, uint8_t broadcastAddress);
+
+/*!
+ * @brief Sets the channels of the software frequency hopping
+ *
+ * @param   channels      List of RF frequencies [Hz]
+ * @param   count         Number of channels
+ * @param   seed          Seed of the hop sequence
+ */
+void RadioSetFhssChannels(uint32_t *channels, uint8_t count, uint32_t seed);
+
+/*!
+ * @brief Gets the frequency error of the last received LoRa packet
+ *
+ * @retval  freqError     Frequency error [Hz]
+ */
+int32_t RadioGetFrequencyError(void);
+
+/*!
+ * @brief Enables the crystal offset tracking
+ *
+ * @param   enable        [true: track the offset, false: keep the correction]
+ */
+void RadioSetAfc(bool enable);
+
+/*!
+ * @brief Sets the crystal offset correction
+ *
+ * @param   ppb           Correction [parts per billion]
+ */
+void RadioSetFrequencyCorrection(int32_t ppb);
+
+/*!
+ * @brief Gets the crystal offset correction
+ *
+ * @retval  ppb           Correction [parts per billion]
+ */
+int32_t RadioGetFrequencyCorrection(void);
+
+/*!
+ * @brief Loads the payload of the next transmission while the radio receives
+ *
+ * @param  buffer       Buffer pointer
+ * @param  size         Buffer size
+ * @retval prepared     [true: payload loaded, false: does not fit]
+ */
+bool RadioPrepareTx(uint8_t *buffer, uint8_t size);
+
+/*!
+ * @brief Sets the mode the radio goes to after a TX or RX done
+ *
+ * @param  fallbackMode [RadioFallbackModes_t]
+ */
+void RadioSetTurnaroundMode(uint8_t fallbackMode);
+
+/*!
+ * @brief Gets the latency from RX done to TX start
+ *
+ * @param  turnaround   Structure to fill
+ */
+void RadioGetTurnaround(RadioTurnaround_t *turnaround);
+
+/*!
+ * @brief Clears the latency from RX done to TX start
+ */
+void RadioResetTurnaround(void);
+
+/*!
+ * @brief Hop timer callback
+ */
+void RadioOnFhssTimerIrq(void);
+
 /*!
  * Radio driver structure initialization
  */
@@ -394,7 +501,18 @@ const struct Radio_s Radio =
 		RadioIrqProcessAfterDeepSleep,
 		// Available on SX126x only
 		RadioRxBoosted,
-		RadioSetRxDutyCycle};
+		RadioSetRxDutyCycle,
+		RadioSetSyncWord,
+		RadioSetAddressFilter,
+		RadioSetFhssChannels,
+		RadioGetFrequencyError,
+		RadioSetAfc,
+		RadioSetFrequencyCorrection,
+		RadioGetFrequencyCorrection,
+		RadioPrepareTx,
+		RadioSetTurnaroundMode,
+		RadioGetTurnaround,
+		RadioResetTurnaround};
 
 /*
  * Local types definition
@@ -441,13 +559,35 @@ const FskBandwidth_t FskBandwidths[] =
 // const RadioLoRaBandwidths_t Bandwidths[] = {LORA_BW_125, LORA_BW_250, LORA_BW_500};
 const RadioLoRaBandwidths_t Bandwidths[] = {LORA_BW_125, LORA_BW_250, LORA_BW_500, LORA_BW_062, LORA_BW_041, LORA_BW_031, LORA_BW_020, LORA_BW_015, LORA_BW_010, LORA_BW_007};
 
-//                                          SF12    SF11    SF10    SF9    SF8    SF7
-static double RadioLoRaSymbTime[3][6] = {{32.768, 16.384, 8.192, 4.096, 2.048, 1.024}, // 125 KHz
-										 {16.384, 8.192, 4.096, 2.048, 1.024, 0.512},  // 250 KHz
-										 {8.192, 4.096, 2.048, 1.024, 0.512, 0.256}};  // 500 KHz
-
 uint8_t MaxPayloadLength = 0xFF;
 
+/*!
+ * Payload loaded by RadioPrepareTx
+ */
+typedef struct
+{
+	bool Valid;		 //!< Payload is in the buffer
+	uint8_t *Buffer; //!< Buffer of the payload
+	uint8_t Size;	 //!< Size of the payload
+	uint8_t Base;	 //!< Start of the frame in the data buffer
+} RadioTxPrepared_t;
+
+static RadioTxPrepared_t RadioTxPrepared = {false, NULL, 0, 0};
+
+/*!
+ * RX done to TX start turnaround
+ */
+typedef struct
+{
+	bool On;				 //!< RX and TX IRQs are configured together
+	bool Pending;			 //!< A frame was received, the next Send measures the latency
+	uint32_t RxDoneTime;	 //!< Time of the DIO1 interrupt of the received frame [us]
+	uint64_t Total;			 //!< Sum of all latencies [us]
+	RadioTurnaround_t Stats; //!< Latency statistics
+} RadioTurnaroundState_t;
+
+static RadioTurnaroundState_t RadioTurnaround = {false, false, 0, 0, {0, 0, UINT32_MAX, 0, 0}};
+
 uint32_t TxTimeout = 0;
 uint32_t RxTimeout = 0;
 
@@ -462,6 +602,15 @@ bool DRAM_ATTR IrqFired = false;
 bool IrqFired = false;
 #endif
 
+/*!
+ * Time of the last DIO1 interrupt [us]
+ */
+#if defined(ESP32)
+volatile uint32_t DRAM_ATTR RadioIrqTime = 0;
+#else
+volatile uint32_t RadioIrqTime = 0;
+#endif
+
 bool TimerRxTimeout = false;
 bool TimerTxTimeout = false;
 
@@ -501,6 +650,57 @@ typedef struct
 
 static RadioPublicNetwork_t RadioPublicNetwork = {false};
 
+/*!
+ * LoRa sync word used for private networks
+ */
+static uint16_t RadioPrivateSyncWord = LORA_MAC_PRIVATE_SYNCWORD;
+
+/*!
+ * P2P address filter
+ */
+static RadioAddressFilter_t RadioAddrFilter = ADDRESS_FILTER_OFF;
+static uint8_t RadioNodeAddress = 0x00;
+static uint8_t RadioBroadcastAddress = 0xFF;
+
+/*!
+ * Software frequency hopping state
+ */
+typedef struct
+{
+	bool On;									//!< Enabled by freqHopOn of the configuration
+	bool Synced;								//!< Hop timing known from an own or a received frame
+	uint8_t Count;								//!< Channels in the hop sequence
+	uint8_t Position;							//!< Current position in the hop sequence
+	uint8_t Defers;								//!< Hops postponed for a frame in reception
+	uint32_t Dwell;								//!< Time in ms on each channel
+	uint32_t Epoch;								//!< Start of position 0 of the sequence
+	uint32_t Frequencies[RADIO_FHSS_MAX_CHANNELS]; //!< Channels in hop order
+	uint32_t PllWords[RADIO_FHSS_MAX_CHANNELS];	   //!< Cached PLL words of the channels with the crystal offset correction
+} RadioFhss_t;
+
+static RadioFhss_t RadioFhss;
+
+/*!
+ * Hop timer
+ */
+static TimerEvent_t FhssTimer;
+
+/*!
+ * Crystal offset tracking state
+ */
+typedef struct
+{
+	bool On;		 //!< Enabled with RadioSetAfc
+	uint8_t Packets; //!< Packets tracked since the AFC was enabled
+} RadioAfc_t;
+
+static RadioAfc_t RadioAfc;
+
+/*!
+ * Frequency of the last RadioSetChannel
+ */
+static uint32_t RadioFrequency = 0;
+
 /*!
  * Radio callbacks variable
  */
@@ -544,10 +744,267 @@ static uint8_t RadioGetFskBandwidthRegValue(uint32_t bandwidth)
 	// 	;
 }
 
+/*!
+ * @brief Gets the DIO1 IRQs of a reception
+ *
+ * @retval irqs         RX IRQs, in turnaround mode with the TX IRQs
+ */
+static uint16_t RadioRxIrqs(void)
+{
+	return IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT | IRQ_HEADER_ERROR | IRQ_CRC_ERROR | (RadioTurnaround.On ? IRQ_TX_DONE : 0);
+}
+
+/*!
+ * @brief Gets the operating mode the radio falls back to after a TX or RX done
+ *
+ * @retval mode         Operating mode of the fallback mode
+ */
+static RadioOperatingModes_t RadioFallbackOperatingMode(void)
+{
+	switch (SX126xGetRxTxFallbackMode())
+	{
+	case RADIO_FALLBACK_FS:
+		return MODE_FS;
+	case RADIO_FALLBACK_STDBY_XOSC:
+		return MODE_STDBY_XOSC;
+	default:
+		return MODE_STDBY_RC;
+	}
+}
+
+/*!
+ * @brief Applies the frequency hopping parameters of the configuration
+ *
+ * @param  freqHopOn    Enables the frequency hopping
+ * @param  hopPeriod    Time on each channel [10 ms steps, 0: 400 ms]
+ */
+static void RadioFhssConfig(bool freqHopOn, uint8_t hopPeriod)
+{
+	RadioFhss.On = freqHopOn && (RadioFhss.Count != 0);
+	RadioFhss.Dwell = (hopPeriod != 0 ? hopPeriod : 40) * 10;
+	if (!RadioFhss.On)
+	{
+		TimerStop(&FhssTimer);
+	}
+}
+
+/*!
+ * @brief Gets the position in the hop sequence at a time
+ *
+ * @param  now          Time [ms]
+ * @param  elapsed      Time since the start of the position [ms], can be NULL
+ * @retval position     Position in the hop sequence
+ */
+static uint8_t RadioFhssPosition(uint32_t now, uint32_t *elapsed)
+{
+	uint32_t time = now - RadioFhss.Epoch;
+
+	if (elapsed != NULL)
+	{
+		*elapsed = time % RadioFhss.Dwell;
+	}
+	return (time / RadioFhss.Dwell) % RadioFhss.Count;
+}
+
+/*!
+ * @brief Retunes the radio to a position of the hop sequence
+ *
+ * @param  position     Position in the hop sequence
+ */
+static void RadioFhssTune(uint8_t position)
+{
+	RadioFhss.Position = position;
+	RadioFhss.Defers = 0;
+	// The oscillator keeps running, only the PLL has to lock again
+	SX126xSetStandby(STDBY_XOSC);
+	SX126xSetRfPllWord(RadioFhss.PllWords[position]);
+	if ((RadioEvents != NULL) && (RadioEvents->FhssChangeChannel != NULL))
+	{
+		RadioEvents->FhssChangeChannel(position);
+	}
+}
+
+/*!
+ * @brief Starts the hop timer for the end of the current position
+ */
+static void RadioFhssSchedule(void)
+{
+	uint32_t elapsed;
+
+	RadioFhssPosition(millis(), &elapsed);
+	TimerSetValue(&FhssTimer, RadioFhss.Dwell - elapsed);
+	TimerStart(&FhssTimer);
+}
+
+/*!
+ * @brief Restarts the reception after a hop
+ */
+static void RadioFhssRestartRx(void)
+{
+	if (RxContinuous == true)
+	{
+		SX126xSetRx(0xFFFFFF);
+	}
+	else
+	{
+		SX126xSetRx(RxTimeout << 6);
+	}
+}
+
+/*!
+ * @brief Tunes the receiver to the current hop position
+ * Without a known hop timing it waits on the first channel of the sequence.
+ */
+static void RadioFhssRxTune(void)
+{
+	if (!RadioFhss.Synced)
+	{
+		TimerStop(&FhssTimer);
+		RadioFhssTune(0);
+		return;
+	}
+	RadioFhssTune(RadioFhssPosition(millis(), NULL));
+	RadioFhssSchedule();
+}
+
+/*!
+ * @brief Writes the hop header and the payload for a transmission
+ *
+ * @param  buffer       Payload, NULL if it is already in the buffer
+ * @param  size         Payload size
+ */
+static void RadioFhssTxPrepare(uint8_t *buffer, uint8_t size)
+{
+	uint8_t header[RADIO_FHSS_HEADER_SIZE];
+	uint32_t now = millis();
+	uint32_t elapsed;
+
+	if (!RadioFhss.Synced)
+	{
+		// First node to send sets the hop timing
+		RadioFhss.Epoch = now;
+		RadioFhss.Synced = true;
+	}
+	TimerStop(&FhssTimer);
+	uint8_t position = RadioFhssPosition(now, &elapsed);
+	RadioFhssTune(position);
+
+	header[0] = position;
+	header[1] = elapsed & 0xFF;
+	header[2] = (elapsed >> 8) & 0xFF;
+	uint8_t base = SX126xGetTxBaseAddress();
+	SX126xWriteBuffer(base, header, RADIO_FHSS_HEADER_SIZE);
+	if (buffer != NULL)
+	{
+		SX126xWriteBuffer(base + RADIO_FHSS_HEADER_SIZE, buffer, size);
+	}
+}
+
+/*!
+ * @brief Takes the hop timing from a received frame and removes the hop header
+ *
+ * @param  payload      Received frame, moved to the payload
+ * @param  size         Frame size, reduced to the payload size
+ * @retval valid        [true: frame with hop header, false: drop the frame]
+ */
+static bool RadioFhssRxSync(uint8_t **payload, uint8_t *size)
+{
+	uint8_t *frame = *payload;
+
+	if ((*size < RADIO_FHSS_HEADER_SIZE) || (frame[0] >= RadioFhss.Count))
+	{
+		return false;
+	}
+	uint32_t elapsed = frame[1] | (frame[2] << 8);
+	// The frame ended at the RX_DONE interrupt, not when the IRQ is processed
+	uint32_t rxDone = millis() - (micros() - RadioIrqTime) / 1000;
+	uint32_t txStart = rxDone - RadioTimeOnAir(_modem, *size);
+	RadioFhss.Epoch = txStart - elapsed - frame[0] * RadioFhss.Dwell;
+	RadioFhss.Synced = true;
+	*payload += RADIO_FHSS_HEADER_SIZE;
+	*size -= RADIO_FHSS_HEADER_SIZE;
+
+	if ((RxContinuous == true) && (SX126xGetOperatingMode() == MODE_RX))
+	{
+		uint8_t position = RadioFhssPosition(millis(), NULL);
+		if (position != RadioFhss.Position)
+		{
+			RadioFhssTune(position);
+			RadioFhssRestartRx();
+		}
+		RadioFhssSchedule();
+	}
+	return true;
+}
+
+/*!
+ * @brief Computes the cached PLL words of the hop channels with the current crystal offset correction
+ */
+static void RadioFhssUpdatePllWords(void)
+{
+	for (uint8_t idx = 0; idx < RadioFhss.Count; idx++)
+	{
+		RadioFhss.PllWords[idx] = SX126xGetPllWord(RadioFhss.Frequencies[idx]);
+	}
+}
+
+void RadioSetFhssChannels(uint32_t *channels, uint8_t count, uint32_t seed)
+{
+	uint32_t state = (seed != 0) ? seed : 0x9E3779B9;
+
+	if (count > RADIO_FHSS_MAX_CHANNELS)
+	{
+		count = RADIO_FHSS_MAX_CHANNELS;
+	}
+	TimerStop(&FhssTimer);
+	RadioFhss.Count = count;
+	RadioFhss.Position = 0;
+	RadioFhss.Synced = false;
+	memcpy(RadioFhss.Frequencies, channels, count * sizeof(uint32_t));
+	// Shuffle with xorshift32, the same seed gives the same sequence on all nodes
+	for (int idx = count - 1; idx > 0; idx--)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		int swap = state % (idx + 1);
+		uint32_t frequency = RadioFhss.Frequencies[idx];
+		RadioFhss.Frequencies[idx] = RadioFhss.Frequencies[swap];
+		RadioFhss.Frequencies[swap] = frequency;
+	}
+	RadioFhssUpdatePllWords();
+	if (count == 0)
+	{
+		RadioFhss.On = false;
+	}
+}
+
+void RadioOnFhssTimerIrq(void)
+{
+	if (!RadioFhss.On || (SX126xGetOperatingMode() != MODE_RX))
+	{
+		return;
+	}
+	// Stay on the channel while a frame is received
+	if (((SX126xGetIrqStatus() & (IRQ_HEADER_VALID | IRQ_SYNCWORD_VALID)) != 0) && (RadioFhss.Defers < RADIO_FHSS_MAX_DEFERS))
+	{
+		RadioFhss.Defers++;
+		TimerSetValue(&FhssTimer, RADIO_FHSS_HOP_DEFER);
+		TimerStart(&FhssTimer);
+		return;
+	}
+	SX126xClearIrqStatus(IRQ_HEADER_VALID | IRQ_SYNCWORD_VALID | IRQ_PREAMBLE_DETECTED);
+	RadioFhssTune(RadioFhssPosition(millis(), NULL));
+	RadioFhssRestartRx();
+	RadioFhssSchedule();
+}
+
 void RadioInit(RadioEvents_t *events)
 {
 	RadioEvents = events;
 	SX126xInit(RadioOnDioIrq);
+	RadioTurnaround.On = false;
+	RadioTurnaround.Pending = false;
 	SX126xSetStandby(STDBY_RC);
 	if (_hwConfig.USE_LDO)
 	{
@@ -567,6 +1024,8 @@ void RadioInit(RadioEvents_t *events)
 	RxTimeoutTimer.oneShot = true;
 	TimerInit(&TxTimeoutTimer, RadioOnTxTimeoutIrq);
 	TimerInit(&RxTimeoutTimer, RadioOnRxTimeoutIrq);
+	FhssTimer.oneShot = true;
+	TimerInit(&FhssTimer, RadioOnFhssTimerIrq);
 
 	IrqFired = false;
 }
@@ -581,6 +1040,8 @@ void RadioReInit(RadioEvents_t *events)
 	RxTimeoutTimer.oneShot = true;
 	TimerInit(&TxTimeoutTimer, RadioOnTxTimeoutIrq);
 	TimerInit(&RxTimeoutTimer, RadioOnRxTimeoutIrq);
+	FhssTimer.oneShot = true;
+	TimerInit(&FhssTimer, RadioOnFhssTimerIrq);
 
 	IrqFired = false;
 }
@@ -615,7 +1076,7 @@ void RadioSetModem(RadioModems_t modem)
 	case MODEM_LORA:
 		SX126xSetPacketType(PACKET_TYPE_LORA);
 		// Public/Private network register is reset when switching modems
-		if (RadioPublicNetwork.Current != RadioPublicNetwork.Previous)
+		if ((RadioPublicNetwork.Current != RadioPublicNetwork.Previous) || (RadioPrivateSyncWord != LORA_MAC_PRIVATE_SYNCWORD))
 		{
 			RadioPublicNetwork.Current = RadioPublicNetwork.Previous;
 			RadioSetPublicNetwork(RadioPublicNetwork.Current);
@@ -627,6 +1088,7 @@ void RadioSetModem(RadioModems_t modem)
 
 void RadioSetChannel(uint32_t freq)
 {
+	RadioFrequency = freq;
 	SX126xSetRfFrequency(freq);
 }
 
@@ -694,6 +1156,7 @@ void RadioSetRxConfig(RadioModems_t modem, uint32_t bandwidth,
 					  bool iqInverted, bool rxContinuous)
 {
 
+	RadioFhssConfig(freqHopOn, hopPeriod);
 	RxContinuous = rxContinuous;
 	if (rxContinuous == true)
 	{
@@ -722,7 +1185,7 @@ void RadioSetRxConfig(RadioModems_t modem, uint32_t bandwidth,
 		SX126x.PacketParams.Params.Gfsk.PreambleLength = (preambleLen << 3); // convert byte into bit
 		SX126x.PacketParams.Params.Gfsk.PreambleMinDetect = RADIO_PREAMBLE_DETECTOR_08_BITS;
 		SX126x.PacketParams.Params.Gfsk.SyncWordLength = 3 << 3; // convert byte into bit
-		SX126x.PacketParams.Params.Gfsk.AddrComp = RADIO_ADDRESSCOMP_FILT_OFF;
+		SX126x.PacketParams.Params.Gfsk.AddrComp = (RadioAddressComp_t)RadioAddrFilter;
 		SX126x.PacketParams.Params.Gfsk.HeaderType = (fixLen == true) ? RADIO_PACKET_FIXED_LENGTH : RADIO_PACKET_VARIABLE_LENGTH;
 		SX126x.PacketParams.Params.Gfsk.PayloadLength = MaxPayloadLength;
 		if (crcOn == true)
@@ -829,6 +1292,7 @@ void RadioSetTxConfig(RadioModems_t modem, int8_t power, uint32_t fdev,
 					  uint8_t hopPeriod, bool iqInverted, uint32_t timeout)
 {
 
+	RadioFhssConfig(freqHopOn, hopPeriod);
 	switch (modem)
 	{
 	case MODEM_FSK:
@@ -843,7 +1307,7 @@ void RadioSetTxConfig(RadioModems_t modem, int8_t power, uint32_t fdev,
 		SX126x.PacketParams.Params.Gfsk.PreambleLength = (preambleLen << 3); // convert byte into bit
 		SX126x.PacketParams.Params.Gfsk.PreambleMinDetect = RADIO_PREAMBLE_DETECTOR_08_BITS;
 		SX126x.PacketParams.Params.Gfsk.SyncWordLength = 3 << 3; // convert byte into bit
-		SX126x.PacketParams.Params.Gfsk.AddrComp = RADIO_ADDRESSCOMP_FILT_OFF;
+		SX126x.PacketParams.Params.Gfsk.AddrComp = (RadioAddressComp_t)RadioAddrFilter;
 		SX126x.PacketParams.Params.Gfsk.HeaderType = (fixLen == true) ? RADIO_PACKET_FIXED_LENGTH : RADIO_PACKET_VARIABLE_LENGTH;
 
 		if (crcOn == true)
@@ -972,22 +1436,14 @@ uint32_t RadioTimeOnAir(RadioModems_t modem, uint8_t pktLen)
 	break;
 	case MODEM_LORA:
 	{
-		double ts = RadioLoRaSymbTime[SX126x.ModulationParams.Params.LoRa.Bandwidth - 4][12 - SX126x.ModulationParams.Params.LoRa.SpreadingFactor];
-		// time of preamble
-		double tPreamble = (SX126x.PacketParams.Params.LoRa.PreambleLength + 4.25) * ts;
-		// Symbol length of payload and time
-		double tmp = ceil((8 * pktLen - 4 * SX126x.ModulationParams.Params.LoRa.SpreadingFactor +
-						   28 + 16 * SX126x.PacketParams.Params.LoRa.CrcMode -
-						   ((SX126x.PacketParams.Params.LoRa.HeaderType == LORA_PACKET_FIXED_LENGTH) ? 20 : 0)) /
-						  (double)(4 * (SX126x.ModulationParams.Params.LoRa.SpreadingFactor -
-										((SX126x.ModulationParams.Params.LoRa.LowDatarateOptimize > 0) ? 2 : 0)))) *
-					 ((SX126x.ModulationParams.Params.LoRa.CodingRate % 4) + 4);
-		double nPayload = 8 + ((tmp > 0) ? tmp : 0);
-		double tPayload = nPayload * ts;
-		// Time on air
-		double tOnAir = tPreamble + tPayload;
-		// return milli seconds
-		airTime = floor(tOnAir + 0.999);
+		airTime = SX126xGetLoRaTimeOnAir(SX126x.ModulationParams.Params.LoRa.SpreadingFactor,
+										 SX126xGetLoRaBandwidthHz(SX126x.ModulationParams.Params.LoRa.Bandwidth),
+										 SX126x.ModulationParams.Params.LoRa.CodingRate,
+										 SX126x.ModulationParams.Params.LoRa.LowDatarateOptimize > 0,
+										 SX126x.PacketParams.Params.LoRa.PreambleLength,
+										 SX126x.PacketParams.Params.LoRa.HeaderType == LORA_PACKET_FIXED_LENGTH,
+										 SX126x.PacketParams.Params.LoRa.CrcMode == LORA_CRC_ON,
+										 pktLen);
 	}
 	break;
 	}
@@ -1003,31 +1459,138 @@ uint32_t RadioTimeOnAir(RadioModems_t modem, uint8_t pktLen)
  */
 void RadioSend(uint8_t *buffer, uint8_t size)
 {
+	uint8_t frameSize = size;
+
 	SX126xTXena();
-	SX126xSetDioIrqParams(IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT,
-						  IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT,
-						  IRQ_RADIO_NONE,
-						  IRQ_RADIO_NONE);
+	if (RadioTurnaround.On)
+	{
+		// Same masks as RadioRx, they are not written again
+		SX126xSetDioIrqParams(RadioRxIrqs() | (RadioFhss.On ? (IRQ_HEADER_VALID | IRQ_SYNCWORD_VALID) : 0),
+							  RadioRxIrqs(),
+							  IRQ_RADIO_NONE,
+							  IRQ_RADIO_NONE);
+	}
+	else
+	{
+		SX126xSetDioIrqParams(IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT,
+							  IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT,
+							  IRQ_RADIO_NONE,
+							  IRQ_RADIO_NONE);
+	}
+
+	if (RadioFhss.On)
+	{
+		if (size > (255 - RADIO_FHSS_HEADER_SIZE))
+		{
+			size = 255 - RADIO_FHSS_HEADER_SIZE;
+		}
+		frameSize = size + RADIO_FHSS_HEADER_SIZE;
+	}
 
 	if (SX126xGetPacketType() == PACKET_TYPE_LORA)
 	{
-		SX126x.PacketParams.Params.LoRa.PayloadLength = size;
+		SX126x.PacketParams.Params.LoRa.PayloadLength = frameSize;
 	}
 	else
 	{
-		SX126x.PacketParams.Params.Gfsk.PayloadLength = size;
+		SX126x.PacketParams.Params.Gfsk.PayloadLength = frameSize;
 	}
 	SX126xSetPacketParams(&SX126x.PacketParams);
 
-	SX126xSendPayload(buffer, size, 0);
+	// The payload of RadioPrepareTx is still valid if nobody moved the TX base since
+	bool prepared = RadioTxPrepared.Valid && (RadioTxPrepared.Buffer == buffer) && (RadioTxPrepared.Size == size) &&
+					(SX126xGetTxBaseAddress() == RadioTxPrepared.Base);
+	RadioTxPrepared.Valid = false;
+	if (!prepared && (SX126xGetTxBaseAddress() != 0x00))
+	{
+		SX126xSetBufferBaseAddress(0x00, 0x00);
+	}
+
+	if (RadioFhss.On)
+	{
+		RadioFhssTxPrepare(prepared ? NULL : buffer, size);
+		SX126xSetTx(0);
+	}
+	else if (prepared)
+	{
+		SX126xSetTx(0);
+	}
+	else
+	{
+		SX126xSendPayload(buffer, size, 0);
+	}
+	if (RadioTurnaround.Pending)
+	{
+		uint32_t latency = micros() - RadioTurnaround.RxDoneTime;
+		RadioTurnaround.Pending = false;
+		RadioTurnaround.Stats.Count++;
+		RadioTurnaround.Stats.Last = latency;
+		RadioTurnaround.Total += latency;
+		if (latency < RadioTurnaround.Stats.Min)
+		{
+			RadioTurnaround.Stats.Min = latency;
+		}
+		if (latency > RadioTurnaround.Stats.Max)
+		{
+			RadioTurnaround.Stats.Max = latency;
+		}
+	}
 	TimerSetValue(&TxTimeoutTimer, TxTimeout);
 	TimerStart(&TxTimeoutTimer);
 }
 
+bool RadioPrepareTx(uint8_t *buffer, uint8_t size)
+{
+	uint16_t frameSize = size + (RadioFhss.On ? RADIO_FHSS_HEADER_SIZE : 0);
+
+	RadioTxPrepared.Valid = false;
+	// Received frames fill the buffer from 0 up to the max payload length
+	if ((frameSize > 255) || (frameSize + MaxPayloadLength > 256))
+	{
+		return false;
+	}
+	uint8_t base = 256 - frameSize;
+	SX126xSetBufferBaseAddress(base, 0x00);
+	SX126xWriteBuffer(base + (RadioFhss.On ? RADIO_FHSS_HEADER_SIZE : 0), buffer, size);
+
+	RadioTxPrepared.Buffer = buffer;
+	RadioTxPrepared.Size = size;
+	RadioTxPrepared.Base = base;
+	RadioTxPrepared.Valid = true;
+	return true;
+}
+
+void RadioSetTurnaroundMode(uint8_t fallbackMode)
+{
+	SX126xSetRxTxFallbackMode(fallbackMode);
+	RadioTurnaround.On = (fallbackMode == RADIO_FALLBACK_FS) || (fallbackMode == RADIO_FALLBACK_STDBY_XOSC);
+}
+
+void RadioGetTurnaround(RadioTurnaround_t *turnaround)
+{
+	*turnaround = RadioTurnaround.Stats;
+	turnaround->Average = RadioTurnaround.Stats.Count != 0 ? (uint32_t)(RadioTurnaround.Total / RadioTurnaround.Stats.Count) : 0;
+	if (RadioTurnaround.Stats.Count == 0)
+	{
+		turnaround->Min = 0;
+	}
+}
+
+void RadioResetTurnaround(void)
+{
+	RadioTurnaround.Stats.Count = 0;
+	RadioTurnaround.Stats.Last = 0;
+	RadioTurnaround.Stats.Min = UINT32_MAX;
+	RadioTurnaround.Stats.Max = 0;
+	RadioTurnaround.Total = 0;
+}
+
 void RadioSleep(void)
 {
 	SleepParams_t params = {0};
 
+	RadioTurnaround.Pending = false;
+
 	params.Fields.WarmStart = 1;
 	SX126xSetSleep(params);
 
@@ -1041,11 +1604,17 @@ void RadioStandby(void)
 
 void RadioRx(uint32_t timeout)
 {
+	RadioTurnaround.Pending = false;
 	SX126xRXena();
-	SX126xSetDioIrqParams(IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT | IRQ_HEADER_ERROR | IRQ_CRC_ERROR, // IRQ_RADIO_ALL
-						  IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT | IRQ_HEADER_ERROR | IRQ_CRC_ERROR, // IRQ_RADIO_ALL
+	// With frequency hopping the header and sync word flags show a frame in reception, they do not raise DIO1
+	SX126xSetDioIrqParams(RadioRxIrqs() | (RadioFhss.On ? (IRQ_HEADER_VALID | IRQ_SYNCWORD_VALID) : 0), // IRQ_RADIO_ALL
+						  RadioRxIrqs(), // IRQ_RADIO_ALL
 						  IRQ_RADIO_NONE,
 						  IRQ_RADIO_NONE);
+	if (RadioFhss.On)
+	{
+		RadioFhssRxTune();
+	}
 
 	LOG_LIB("RADIO", "RX window timeout = %ld", timeout);
 	// Even Continous mode is selected, put a timeout here
@@ -1066,8 +1635,9 @@ void RadioRx(uint32_t timeout)
 
 void RadioRxBoosted(uint32_t timeout)
 {
-	SX126xSetDioIrqParams(IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT | IRQ_HEADER_ERROR | IRQ_CRC_ERROR, // IRQ_RADIO_ALL
-						  IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT | IRQ_HEADER_ERROR | IRQ_CRC_ERROR, // IRQ_RADIO_ALL
+	RadioTurnaround.Pending = false;
+	SX126xSetDioIrqParams(RadioRxIrqs(), // IRQ_RADIO_ALL
+						  RadioRxIrqs(), // IRQ_RADIO_ALL
 						  IRQ_RADIO_NONE,
 						  IRQ_RADIO_NONE);
 
@@ -1102,6 +1672,7 @@ void RadioSetCadParams(uint8_t cadSymbolNum, uint8_t cadDetPeak, uint8_t cadDetM
 
 void RadioStartCad(void)
 {
+	RadioTurnaround.Pending = false;
 	SX126xRXena();
 	SX126xSetDioIrqParams(IRQ_CAD_DONE | IRQ_CAD_ACTIVITY_DETECTED,
 						  IRQ_CAD_DONE | IRQ_CAD_ACTIVITY_DETECTED,
@@ -1209,11 +1780,170 @@ void RadioSetPublicNetwork(bool enable)
 	else
 	{
 		// Change LoRa modem SyncWord
-		SX126xWriteRegister(REG_LR_SYNCWORD, (LORA_MAC_PRIVATE_SYNCWORD >> 8) & 0xFF);
-		SX126xWriteRegister(REG_LR_SYNCWORD + 1, LORA_MAC_PRIVATE_SYNCWORD & 0xFF);
+		SX126xWriteRegister(REG_LR_SYNCWORD, (RadioPrivateSyncWord >> 8) & 0xFF);
+		SX126xWriteRegister(REG_LR_SYNCWORD + 1, RadioPrivateSyncWord & 0xFF);
+	}
+}
+
+void RadioSetSyncWord(uint16_t syncWord)
+{
+	RadioPrivateSyncWord = syncWord;
+	RadioSetPublicNetwork(false);
+}
+
+void RadioSetAddressFilter(RadioAddressFilter_t mode, uint8_t nodeAddress, uint8_t broadcastAddress)
+{
+	RadioAddrFilter = mode;
+	RadioNodeAddress = nodeAddress;
+	RadioBroadcastAddress = broadcastAddress;
+
+	SX126xWriteRegister(REG_GFSK_NODEADDRESS, nodeAddress);
+	SX126xWriteRegister(REG_GFSK_BROADCASTADDRESS, broadcastAddress);
+	if (SX126xGetPacketType() == PACKET_TYPE_GFSK)
+	{
+		SX126x.PacketParams.Params.Gfsk.AddrComp = (RadioAddressComp_t)mode;
+		SX126xSetPacketParams(&SX126x.PacketParams);
+	}
+}
+
+int32_t RadioGetFrequencyError(void)
+{
+	if (RadioPktStatus.packetType != PACKET_TYPE_LORA)
+	{
+		return 0;
+	}
+	return RadioPktStatus.Params.LoRa.FreqError;
+}
+
+void RadioSetAfc(bool enable)
+{
+	RadioAfc.On = enable;
+	RadioAfc.Packets = 0;
+}
+
+void RadioSetFrequencyCorrection(int32_t ppb)
+{
+	SX126xSetFrequencyCorrection(ppb);
+	RadioFhssUpdatePllWords();
+	if ((SX126xGetOperatingMode() == MODE_RX) || (SX126xGetOperatingMode() == MODE_TX))
+	{
+		return;
+	}
+	if (RadioFhss.On)
+	{
+		SX126xSetRfPllWord(RadioFhss.PllWords[RadioFhss.Position]);
+	}
+	else if (RadioFrequency != 0)
+	{
+		SX126xSetRfFrequency(RadioFrequency);
+	}
+}
+
+int32_t RadioGetFrequencyCorrection(void)
+{
+	return SX126xGetFrequencyCorrection();
+}
+
+/*!
+ * @brief Updates the crystal offset correction with the frequency error of a received packet
+ * The correction integrates the remaining error, fast for the first packets and then
+ * slowly to filter the noise of the frequency error indicator.
+ */
+static void RadioAfcUpdate(void)
+{
+	if (!RadioAfc.On || (RadioFrequency == 0) || (RadioPktStatus.packetType != PACKET_TYPE_LORA))
+	{
+		return;
+	}
+
+	int32_t error = (int32_t)(((int64_t)RadioPktStatus.Params.LoRa.FreqError * 1000000000) / RadioFrequency);
+	int32_t correction = SX126xGetFrequencyCorrection();
+	if (RadioAfc.Packets < RADIO_AFC_ACQUIRE_PACKETS)
+	{
+		RadioAfc.Packets++;
+		correction += error / 2;
+	}
+	else
+	{
+		correction += error / 8;
+	}
+	if (correction > RADIO_AFC_MAX_CORRECTION)
+	{
+		correction = RADIO_AFC_MAX_CORRECTION;
+	}
+	else if (correction < -RADIO_AFC_MAX_CORRECTION)
+	{
+		correction = -RADIO_AFC_MAX_CORRECTION;
+	}
+	if (correction == SX126xGetFrequencyCorrection())
+	{
+		return;
+	}
+	SX126xSetFrequencyCorrection(correction);
+	RadioFhssUpdatePllWords();
+
+	// Retune while the radio is in standby
+	if (RxContinuous)
+	{
+		return;
+	}
+	if (RadioFhss.On)
+	{
+		SX126xSetRfPllWord(RadioFhss.PllWords[RadioFhss.Position]);
+	}
+	else
+	{
+		SX126xSetRfFrequency(RadioFrequency);
 	}
 }
 
+/*!
+ * @brief Checks the address of a received LoRa P2P frame
+ * Reads only the first byte of the frame from the radio buffer.
+ *
+ * @retval accept [true: frame for this node, false: drop the frame]
+ */
+static bool RadioAcceptFrame(void)
+{
+	uint8_t size = 0;
+	uint8_t offset = 0;
+	uint8_t address;
+
+	// GFSK frames are filtered by the radio, LoRaWAN frames have no address byte
+	if ((RadioAddrFilter == ADDRESS_FILTER_OFF) || (SX126xGetPacketType() != PACKET_TYPE_LORA) || RadioPublicNetwork.Current)
+	{
+		return true;
+	}
+	SX126xGetRxBufferStatus(&size, &offset);
+	// With frequency hopping the address follows the hop header
+	uint8_t position = RadioFhss.On ? RADIO_FHSS_HEADER_SIZE : 0;
+	if (size <= position)
+	{
+		return false;
+	}
+	SX126xReadBuffer(offset + position, &address, 1);
+	return (address == RadioNodeAddress) || ((RadioAddrFilter == ADDRESS_FILTER_NODE_BROADCAST) && (address == RadioBroadcastAddress));
+}
+
+/*!
+ * @brief Restarts a single reception after a dropped frame
+ * The RX timeout timer keeps running, the window still ends at the timeout of Radio.Rx()
+ */
+static void RadioRxRestart(void)
+{
+	if (RxContinuous == true)
+	{
+		return;
+	}
+	RadioTurnaround.Pending = false;
+	SX126xRXena();
+	if (RadioFhss.On)
+	{
+		RadioFhssRxTune();
+	}
+	SX126xSetRx(RxTimeout << 6);
+}
+
 uint32_t RadioGetWakeupTime(void)
 {
 	if (_hwConfig.USE_DIO3_TCXO)
@@ -1272,6 +2002,8 @@ void IRAM_ATTR RadioOnDioIrq(void)
 void RadioOnDioIrq(void)
 #endif
 {
+	trace_add(TRACE_DIO, 0, 0);
+	RadioIrqTime = micros();
 	BoardDisableIrq();
 	IrqFired = true;
 	BoardEnableIrq();
@@ -1295,11 +2027,12 @@ void RadioBgIrqProcess(void)
 	bool tx_timeout_handled = false;
 	if (IrqFired == true)
 	{
+		PROFILE_ZONE("radio_irq");
 		BoardDisableIrq();
 		IrqFired = false;
 		BoardEnableIrq();
 
-		uint16_t irqRegs = SX126xGetIrqStatus();
+		uint16_t irqRegs = trace_irq_status(SX126xGetIrqStatus());
 		SX126xClearIrqStatus(IRQ_RADIO_ALL);
 
 		if ((irqRegs & IRQ_TX_DONE) == IRQ_TX_DONE)
@@ -1307,8 +2040,8 @@ void RadioBgIrqProcess(void)
 			LOG_LIB("RADIO", "IRQ_TX_DONE");
 			tx_timeout_handled = true;
 			TimerStop(&TxTimeoutTimer);
-			//!< Update operating mode state to a value lower than \ref MODE_STDBY_XOSC
-			SX126xSetOperatingMode(MODE_STDBY_RC);
+			//!< Update operating mode state to the fallback mode of the radio
+			SX126xSetOperatingMode(RadioFallbackOperatingMode());
 
 			if(RadioPublicNetwork.Current == true)
 			{
@@ -1335,16 +2068,32 @@ void RadioBgIrqProcess(void)
 		if ((irqRegs & IRQ_RX_DONE) == IRQ_RX_DONE)
 		{
 			LOG_LIB("RADIO", "IRQ_RX_DONE");
-			uint8_t size;
+			uint8_t size = 0;
+			// A replayed packet is not in the data buffer, see sx126x-trace.h
+			bool replayed = trace_rx_replayed(&size);
 
 			rx_timeout_handled = true;
 			if (RadioPublicNetwork.Current)
 				TimerStop(&RxTimeoutTimer);
+			// The next Send measures the turnaround from here
+			RadioTurnaround.RxDoneTime = RadioIrqTime;
+			RadioTurnaround.Pending = true;
+			if (RadioTxPrepared.Valid)
+			{
+				uint8_t rxSize;
+				uint8_t rxStart;
+				SX126xGetRxBufferStatus(&rxSize, &rxStart);
+				// A frame longer than the max payload length overwrote the prepared payload
+				if ((uint16_t)rxStart + rxSize > RadioTxPrepared.Base)
+				{
+					RadioTxPrepared.Valid = false;
+				}
+			}
 		
 			if (RxContinuous == false)
 			{
-				//!< Update operating mode state to a value lower than \ref MODE_STDBY_XOSC
-				SX126xSetOperatingMode(MODE_STDBY_RC);
+				//!< Update operating mode state to the fallback mode of the radio
+				SX126xSetOperatingMode(RadioFallbackOperatingMode());
 
 				// WORKAROUND - Implicit Header Mode Timeout Behavior, see DS_SX1261-2_V1.2 datasheet chapter 15.3
 				// RegRtcControl = @address 0x0902
@@ -1359,10 +2108,13 @@ void RadioBgIrqProcess(void)
 			{
 				LOG_LIB("RADIO", "IRQ_CRC_ERROR");
 
-				uint8_t size;
 				// Discard buffer
 				memset(RadioRxPayload, 0, 255);
-				SX126xGetPayload(RadioRxPayload, &size, 255);
+				if (!replayed)
+				{
+					SX126xGetPayload(RadioRxPayload, &size, 255);
+					trace_add(TRACE_RX, 0, size);
+				}
 				SX126xGetPacketStatus(&RadioPktStatus);
 				if(RadioPublicNetwork.Current == true)
 				{
@@ -1384,28 +2136,47 @@ void RadioBgIrqProcess(void)
 					}
 				}
 			}
+			else if (replayed ? (size == 0) : !RadioAcceptFrame())
+			{
+				LOG_LIB("RADIO", "Frame for another node dropped");
+				RadioRxRestart();
+			}
 			else
 			{
-				SX126xGetPayload(RadioRxPayload, &size, 255);
+				uint8_t *payload = RadioRxPayload;
+				if (!replayed)
+				{
+					SX126xGetPayload(RadioRxPayload, &size, 255);
+					trace_add(TRACE_RX, 0, size);
+				}
 				SX126xGetPacketStatus(&RadioPktStatus);
-				if(RadioPublicNetwork.Current == true)
+				if (!replayed)
+				{
+					RadioAfcUpdate();
+				}
+				if (RadioFhss.On && !replayed && !RadioFhssRxSync(&payload, &size))
+				{
+					LOG_LIB("RADIO", "Frame without hop header dropped");
+					RadioRxRestart();
+				}
+				else if(RadioPublicNetwork.Current == true)
 				{
 					if ((RadioEvents != NULL) && (RadioEvents->RxDone != NULL))
 					{
-						RadioEvents->RxDone(RadioRxPayload, size, RadioPktStatus.Params.LoRa.RssiPkt, RadioPktStatus.Params.LoRa.SnrPkt);
+						RadioEvents->RxDone(payload, size, RadioPktStatus.Params.LoRa.RssiPkt, RadioPktStatus.Params.LoRa.SnrPkt);
 
 					}
 
 					if((_lrw != NULL) && (_lrw->RxDone != NULL))
 					{
-						_lrw->RxDone(RadioRxPayload, size, RadioPktStatus.Params.LoRa.RssiPkt, RadioPktStatus.Params.LoRa.SnrPkt);
+						_lrw->RxDone(payload, size, RadioPktStatus.Params.LoRa.RssiPkt, RadioPktStatus.Params.LoRa.SnrPkt);
 					}
 				}
 				else
 				{
 					if((_p2p != NULL) && (_p2p->RxDone != NULL))
 					{
-						_p2p->RxDone(RadioRxPayload, size, RadioPktStatus.Params.LoRa.RssiPkt, RadioPktStatus.Params.LoRa.SnrPkt);
+						_p2p->RxDone(payload, size, RadioPktStatus.Params.LoRa.RssiPkt, RadioPktStatus.Params.LoRa.SnrPkt);
 					}
 				}
 			}
@@ -1431,8 +2202,8 @@ void RadioBgIrqProcess(void)
 				LOG_LIB("RADIO", "IRQ_TX_TIMEOUT");
 				tx_timeout_handled = true;
 				TimerStop(&TxTimeoutTimer);
-				//!< Update operating mode state to a value lower than \ref MODE_STDBY_XOSC
-				SX126xSetOperatingMode(MODE_STDBY_RC);
+				//!< Update operating mode state to the fallback mode of the radio
+				SX126xSetOperatingMode(RadioFallbackOperatingMode());
 				if(RadioPublicNetwork.Current == true)
 				{
 					if ((RadioEvents != NULL) && (RadioEvents->TxTimeout != NULL))
@@ -1458,8 +2229,8 @@ void RadioBgIrqProcess(void)
 				LOG_LIB("RADIO", "IRQ_RX_TIMEOUT");
 				rx_timeout_handled = true;
 				TimerStop(&RxTimeoutTimer);
-				//!< Update operating mode state to a value lower than \ref MODE_STDBY_XOSC
-				SX126xSetOperatingMode(MODE_STDBY_RC);
+				//!< Update operating mode state to the fallback mode of the radio
+				SX126xSetOperatingMode(RadioFallbackOperatingMode());
 				if(RadioPublicNetwork.Current == true)
 				{
 					if ((RadioEvents != NULL) && (RadioEvents->RxTimeout != NULL))
@@ -1508,8 +2279,8 @@ void RadioBgIrqProcess(void)
 			TimerStop(&RxTimeoutTimer);
 			if (RxContinuous == false)
 			{
-				//!< Update operating mode state to a value lower than \ref MODE_STDBY_XOSC
-				SX126xSetOperatingMode(MODE_STDBY_RC);
+				//!< Update operating mode state to the fallback mode of the radio
+				SX126xSetOperatingMode(RadioFallbackOperatingMode());
 			}
 			if(RadioPublicNetwork.Current == true)
 			{
@@ -1608,6 +2379,62 @@ void setP2PEvents(loraEvents_t *p2p)
 	_p2p = p2p;
 }
 
+/*!
+ * Radio events the P2P events of initP2PEvents() forward to, the P2P module
+ * that owns the radio until releaseP2PEvents()
+ */
+static RadioEvents_t *RadioP2PForward;
+
+/*!
+ * P2P events registered by initP2PEvents()
+ */
+static loraEvents_t RadioP2PEvents;
+
+static void RadioP2PTxTimeout(timeoutType_t type)
+{
+	(void)type;
+	if ((RadioP2PForward != NULL) && (RadioP2PForward->TxTimeout != NULL))
+	{
+		RadioP2PForward->TxTimeout();
+	}
+}
+
+static void RadioP2PRxTimeout(timeoutType_t type)
+{
+	(void)type;
+	if ((RadioP2PForward != NULL) && (RadioP2PForward->RxTimeout != NULL))
+	{
+		RadioP2PForward->RxTimeout();
+	}
+}
+
+bool initP2PEvents(RadioEvents_t *events)
+{
+	if ((RadioP2PForward != NULL) && (RadioP2PForward != events))
+	{
+		// Another P2P module owns the radio
+		return false;
+	}
+
+	RadioInit(events);
+
+	// Without a public network sync word the radio reports to the P2P events
+	RadioP2PForward = events;
+	RadioP2PEvents.TxDone = events->TxDone;
+	RadioP2PEvents.TxTimeout = RadioP2PTxTimeout;
+	RadioP2PEvents.RxDone = events->RxDone;
+	RadioP2PEvents.RxTimeout = RadioP2PRxTimeout;
+	RadioP2PEvents.RxError = events->RxError;
+	RadioP2PEvents.param = NULL;
+	setP2PEvents(&RadioP2PEvents);
+	return true;
+}
+
+void releaseP2PEvents(void)
+{
+	RadioP2PForward = NULL;
+}
+
 void setLRWEvents(loraEvents_t *lrw)
 {
 	_lrw = lrw;
@@ -48,13 +48,55 @@ static RadioPacketTypes_t PacketType;
 /*!
  * \brief Stores the last frequency error measured on LoRa received packet
  */
-volatile uint32_t FrequencyError = 0;
+volatile int32_t FrequencyError = 0;
+
+/*!
+ * \brief Crystal offset correction of the RF frequencies in parts per billion
+ */
+static int32_t FrequencyCorrection = 0;
+
+/*!
+ * \brief Optimal PA settings of the power levels, DS_SX1261-2 chapter 13.1.14
+ */
+static const PaSetting_t Sx1261PaSettings[] = {
+	{10, 0x01, 0x00, 13, 186},
+	{14, 0x04, 0x00, 14, 255},
+	{15, 0x06, 0x00, 14, 327},
+};
+
+static const PaSetting_t Sx1262PaSettings[] = {
+	{14, 0x02, 0x02, 22, 900},
+	{17, 0x02, 0x03, 22, 950},
+	{20, 0x03, 0x05, 22, 1020},
+	{22, 0x04, 0x07, 22, 1180},
+};
+
+/*!
+ * \brief LoRa bandwidths in Hz, indexed with RadioLoRaBandwidths_t
+ */
+static const uint32_t LoRaBandwidthsHz[] = {7810, 15630, 31250, 62500, 125000, 250000, 500000, 0, 10420, 20830, 41670};
 
 /*!
  * \brief Hold the status of the Image calibration
  */
 static bool ImageCalibrated = false;
 
+/*!
+ * \brief Start of the transmission in the data buffer
+ */
+static uint8_t TxBaseAddress = 0x00;
+
+/*!
+ * \brief Mode the radio goes to after a TX or RX done [RadioFallbackModes_t]
+ */
+static uint8_t FallbackMode = RADIO_FALLBACK_STDBY_RC;
+
+/*!
+ * \brief Last IRQ and DIO masks written to the radio, unchanged masks are not written again
+ */
+static uint16_t DioIrqParams[4];
+static bool DioIrqParamsValid = false;
+
 /*
  * SX126x DIO IRQ callback functions prototype
  */
@@ -82,6 +124,8 @@ void SX126xProcessIrqs(void);
 void SX126xInit(DioIrqHandler dioIrq)
 {
 	SX126xReset();
+	FallbackMode = RADIO_FALLBACK_STDBY_RC;
+	DioIrqParamsValid = false;
 
 	SX126xIoIrqInit(dioIrq);
 
@@ -132,7 +176,7 @@ void SX126xCheckDeviceReady(void)
 
 void SX126xSetPayload(uint8_t *payload, uint8_t size)
 {
-	SX126xWriteBuffer(0x00, payload, size);
+	SX126xWriteBuffer(TxBaseAddress, payload, size);
 }
 
 uint8_t SX126xGetPayload(uint8_t *buffer, uint8_t *size, uint8_t maxSize)
@@ -229,6 +273,12 @@ void SX126xSetSleep(SleepParams_t sleepConfig)
 
 	SX126xWriteCommand(RADIO_SET_SLEEP, &sleepConfig.Value, 1);
 	SX126xSetOperatingMode(MODE_SLEEP);
+	if (sleepConfig.Fields.WarmStart == 0)
+	{
+		// A cold start loses the configuration
+		FallbackMode = RADIO_FALLBACK_STDBY_RC;
+		DioIrqParamsValid = false;
+	}
 }
 
 void SX126xSetStandby(RadioStandbyModes_t standbyConfig)
@@ -388,12 +438,29 @@ void SX126xSetPaConfig(uint8_t paDutyCycle, uint8_t hpMax, uint8_t deviceSel, ui
 void SX126xSetRxTxFallbackMode(uint8_t fallbackMode)
 {
 	SX126xWriteCommand(RADIO_SET_TXFALLBACKMODE, &fallbackMode, 1);
+	FallbackMode = fallbackMode;
+}
+
+uint8_t SX126xGetRxTxFallbackMode(void)
+{
+	return FallbackMode;
 }
 
 void SX126xSetDioIrqParams(uint16_t irqMask, uint16_t dio1Mask, uint16_t dio2Mask, uint16_t dio3Mask)
 {
 	uint8_t buf[8];
 
+	if (DioIrqParamsValid && (DioIrqParams[0] == irqMask) && (DioIrqParams[1] == dio1Mask) &&
+		(DioIrqParams[2] == dio2Mask) && (DioIrqParams[3] == dio3Mask))
+	{
+		return;
+	}
+	DioIrqParams[0] = irqMask;
+	DioIrqParams[1] = dio1Mask;
+	DioIrqParams[2] = dio2Mask;
+	DioIrqParams[3] = dio3Mask;
+	DioIrqParamsValid = true;
+
 	buf[0] = (uint8_t)((irqMask >> 8) & 0x00FF);
 	buf[1] = (uint8_t)(irqMask & 0x00FF);
 	buf[2] = (uint8_t)((dio1Mask >> 8) & 0x00FF);
@@ -441,20 +508,39 @@ void SX126xSetDio3AsTcxoCtrl(RadioTcxoCtrlVoltage_t tcxoVoltage, uint32_t timeou
 
 void SX126xSetRfFrequency(uint32_t frequency)
 {
-	uint8_t buf[4];
-	uint32_t freq = 0;
-
 	if (ImageCalibrated == false)
 	{
 		SX126xCalibrateImage(frequency);
 		ImageCalibrated = true;
 	}
 
-	freq = (uint32_t)((double)frequency / (double)FREQ_STEP);
-	buf[0] = (uint8_t)((freq >> 24) & 0xFF);
-	buf[1] = (uint8_t)((freq >> 16) & 0xFF);
-	buf[2] = (uint8_t)((freq >> 8) & 0xFF);
-	buf[3] = (uint8_t)(freq & 0xFF);
+	SX126xSetRfPllWord(SX126xGetPllWord(frequency));
+}
+
+uint32_t SX126xGetPllWord(uint32_t frequency)
+{
+	frequency += (int32_t)(((int64_t)frequency * FrequencyCorrection) / 1000000000);
+	return (uint32_t)((double)frequency / (double)FREQ_STEP);
+}
+
+void SX126xSetFrequencyCorrection(int32_t ppb)
+{
+	FrequencyCorrection = ppb;
+}
+
+int32_t SX126xGetFrequencyCorrection(void)
+{
+	return FrequencyCorrection;
+}
+
+void SX126xSetRfPllWord(uint32_t pllWord)
+{
+	uint8_t buf[4];
+
+	buf[0] = (uint8_t)((pllWord >> 24) & 0xFF);
+	buf[1] = (uint8_t)((pllWord >> 16) & 0xFF);
+	buf[2] = (uint8_t)((pllWord >> 8) & 0xFF);
+	buf[3] = (uint8_t)(pllWord & 0xFF);
 	SX126xWriteCommand(RADIO_SET_RFFREQUENCY, buf, 4);
 }
 
@@ -470,28 +556,50 @@ RadioPacketTypes_t SX126xGetPacketType(void)
 	return PacketType;
 }
 
+/*!
+ * \brief Selects the PA setting with the lowest output power that reaches a power level
+ *
+ * \param   device        SX1261 or SX1262
+ * \param   power         RF output power [dBm]
+ * \retval  setting       PA setting
+ */
+static const PaSetting_t *SX126xGetPaSetting(uint8_t device, int8_t power)
+{
+	const PaSetting_t *settings = Sx1262PaSettings;
+	uint8_t count = sizeof(Sx1262PaSettings) / sizeof(Sx1262PaSettings[0]);
+
+	if (device == SX1261)
+	{
+		settings = Sx1261PaSettings;
+		count = sizeof(Sx1261PaSettings) / sizeof(Sx1261PaSettings[0]);
+	}
+	for (uint8_t idx = 0; idx < count - 1; idx++)
+	{
+		if (power <= settings[idx].Power)
+		{
+			return &settings[idx];
+		}
+	}
+	return &settings[count - 1];
+}
+
 void SX126xSetTxParams(int8_t power, RadioRampTimes_t rampTime)
 {
 	uint8_t buf[2];
+	const PaSetting_t *setting;
 
 	if (SX126xGetPaSelect(0) == SX1261)
 	{
-		if (power == 15)
-		{
-			SX126xSetPaConfig(0x06, 0x00, 0x01, 0x01);
-		}
-		else
+		if (power > 15)
 		{
-			SX126xSetPaConfig(0x04, 0x00, 0x01, 0x01);
-		}
-		if (power >= 14)
-		{
-			power = 14;
+			power = 15;
 		}
 		else if (power < -17)
 		{
 			power = -17;
 		}
+		setting = SX126xGetPaSetting(SX126xGetPaSelect(0), power);
+		SX126xSetPaConfig(setting->PaDutyCycle, setting->HpMax, 0x01, 0x01);
 		SX126xWriteRegister(REG_OCP, 0x18); // current max is 80 mA for the whole device
 	}
 	else // sx1262
@@ -501,7 +609,6 @@ void SX126xSetTxParams(int8_t power, RadioRampTimes_t rampTime)
 		SX126xWriteRegister(0x08D8, SX126xReadRegister(0x08D8) | (0x0F << 1));
 		// WORKAROUND END
 
-		SX126xSetPaConfig(0x04, 0x07, 0x00, 0x01);
 		if (power > 22)
 		{
 			power = 22;
@@ -510,13 +617,26 @@ void SX126xSetTxParams(int8_t power, RadioRampTimes_t rampTime)
 		{
 			power = -9;
 		}
+		setting = SX126xGetPaSetting(SX126xGetPaSelect(0), power);
+		SX126xSetPaConfig(setting->PaDutyCycle, setting->HpMax, 0x00, 0x01);
 		SX126xWriteRegister(REG_OCP, 0x38); // current max 160mA for the whole device
 	}
-	buf[0] = power;
+	// Below its nominal power a PA setting is driven with a lower power register value
+	buf[0] = setting->Register - (setting->Power - power);
 	buf[1] = (uint8_t)rampTime;
 	SX126xWriteCommand(RADIO_SET_TXPARAMS, buf, 2);
 }
 
+uint16_t SX126xGetTxCurrent(int8_t power)
+{
+	return SX126xGetPaSetting(SX126xGetPaSelect(0), power)->Current;
+}
+
+uint16_t SX126xGetDeviceTxCurrent(uint8_t device, int8_t power)
+{
+	return SX126xGetPaSetting(device, power)->Current;
+}
+
 void SX126xSetModulationParams(ModulationParams_t *modulationParams)
 {
 	uint8_t n;
@@ -643,6 +763,12 @@ void SX126xSetBufferBaseAddress(uint8_t txBaseAddress, uint8_t rxBaseAddress)
 	buf[0] = txBaseAddress;
 	buf[1] = rxBaseAddress;
 	SX126xWriteCommand(RADIO_SET_BUFFERBASEADDRESS, buf, 2);
+	TxBaseAddress = txBaseAddress;
+}
+
+uint8_t SX126xGetTxBaseAddress(void)
+{
+	return TxBaseAddress;
 }
 
 RadioStatus_t SX126xGetStatus(void)
@@ -705,6 +831,7 @@ void SX126xGetPacketStatus(PacketStatus_t *pktStatus)
 		// Returns SNR value [dB] rounded to the nearest integer value
 		pktStatus->Params.LoRa.SnrPkt = (((int8_t)status[1]) + 2) >> 2;
 		pktStatus->Params.LoRa.SignalRssiPkt = -status[2] >> 1;
+		FrequencyError = SX126xGetFrequencyError();
 		pktStatus->Params.LoRa.FreqError = FrequencyError;
 		break;
 
@@ -718,6 +845,52 @@ void SX126xGetPacketStatus(PacketStatus_t *pktStatus)
 	}
 }
 
+uint32_t SX126xGetLoRaBandwidthHz(RadioLoRaBandwidths_t bandwidth)
+{
+	if ((uint8_t)bandwidth >= sizeof(LoRaBandwidthsHz) / sizeof(LoRaBandwidthsHz[0]))
+	{
+		return 0;
+	}
+	return LoRaBandwidthsHz[bandwidth];
+}
+
+uint32_t SX126xGetLoRaTimeOnAir(uint8_t sf, uint32_t bandwidth, uint8_t cr, bool lowDatarateOptimize,
+								uint16_t preambleLength, bool fixLength, bool crcOn, uint8_t pktLen)
+{
+	if (bandwidth == 0)
+	{
+		return 0;
+	}
+	double ts = ((double)(1 << sf) / (double)bandwidth) * 1000;
+	// time of preamble
+	double tPreamble = (preambleLength + 4.25) * ts;
+	// Symbol length of payload and time
+	double tmp = ceil((8 * pktLen - 4 * sf + 28 + (crcOn ? 16 : 0) - (fixLength ? 20 : 0)) /
+					  (double)(4 * (sf - (lowDatarateOptimize ? 2 : 0)))) *
+				 (cr + 4);
+	double nPayload = 8 + ((tmp > 0) ? tmp : 0);
+	double tPayload = nPayload * ts;
+	// Time on air
+	double tOnAir = tPreamble + tPayload;
+	// return milli seconds
+	return floor(tOnAir + 0.999);
+}
+
+int32_t SX126xGetFrequencyError(void)
+{
+	uint8_t buf[3];
+	uint32_t bandwidth = SX126xGetLoRaBandwidthHz(SX126x.ModulationParams.Params.LoRa.Bandwidth);
+
+	SX126xReadRegisters(REG_LR_FREQ_ERROR, buf, 3);
+	int32_t fei = ((buf[0] & 0x0F) << 16) | (buf[1] << 8) | buf[2];
+	if ((fei & 0x80000) != 0)
+	{
+		fei -= 0x100000;
+	}
+	// One step is 1.55 Hz at 1.6 kHz bandwidth and scales with the bandwidth
+	return (int32_t)(((int64_t)fei * bandwidth * 155) / 160000000);
+}
+
 RadioError_t SX126xGetDeviceErrors(void)
 {
 	RadioError_t error;
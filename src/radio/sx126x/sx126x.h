@@ -107,6 +107,17 @@
  */
 #define REG_LR_SYNCWORD 0x0740
 
+/*!
+ * \brief The addresses of the registers holding the GFSK node and broadcast address
+ */
+#define REG_GFSK_NODEADDRESS 0x06CD
+#define REG_GFSK_BROADCASTADDRESS 0x06CE
+
+/*!
+ * \brief The address of the register holding the LoRa frequency error indicator (20 bits, signed)
+ */
+#define REG_LR_FREQ_ERROR 0x076B
+
 /*!
  * Syncword for Private LoRa networks
  */
@@ -196,6 +207,19 @@ typedef enum
 	STDBY_XOSC = 0x01,
 } RadioStandbyModes_t;
 
+/*!
+ * \brief Declares the mode the radio goes to after a TX or RX done
+ *
+ * RADIO_FALLBACK_FS keeps the synthesizer locked for the fastest turnaround
+ * between packets, at the cost of a higher current between them
+ */
+typedef enum
+{
+	RADIO_FALLBACK_STDBY_RC = 0x20,
+	RADIO_FALLBACK_STDBY_XOSC = 0x30,
+	RADIO_FALLBACK_FS = 0x40,
+} RadioFallbackModes_t;
+
 /*!
  * \brief Declares the power regulation used to power the device
  *
@@ -579,18 +603,30 @@ typedef struct
 			uint8_t RxStatus;
 			int8_t RssiAvg;	 //!< The averaged RSSI
 			int8_t RssiSync; //!< The RSSI measured on last packet
-			uint32_t FreqError;
+			int32_t FreqError; //!< Not measured in GFSK, always 0
 		} Gfsk;
 		struct
 		{
 			int8_t RssiPkt; //!< The RSSI of the last packet
 			int8_t SnrPkt;	//!< The SNR of the last packet
 			int8_t SignalRssiPkt;
-			uint32_t FreqError;
+			int32_t FreqError; //!< Frequency error of the last packet [Hz], positive if the signal is above the receiver
 		} LoRa;
 	} Params;
 } PacketStatus_t;
 
+/*!
+ * \brief Represents the optimal PA configuration of an output power level
+ */
+typedef struct
+{
+	int8_t Power;		 //!< Nominal output power of the setting [dBm]
+	uint8_t PaDutyCycle; //!< paDutyCycle of SetPaConfig
+	uint8_t HpMax;		 //!< hpMax of SetPaConfig
+	int8_t Register;	 //!< TX power register value for the nominal output power
+	uint16_t Current;	 //!< Typical supply current at the nominal output power [0.1 mA]
+} PaSetting_t;
+
 /*!
  * \brief Represents the Rx internal counters values when GFSK or LoRa packet type is used
  */
@@ -749,7 +785,7 @@ void SX126xSetOperatingMode(RadioOperatingModes_t mode);
 void SX126xCheckDeviceReady(void);
 
 /*!
- * \brief Saves the payload to be send in the radio buffer
+ * \brief Saves the payload to be send in the radio buffer at the transmission base address
  *
  * \param   payload       A pointer to the payload
  * \param   size          The size of the payload
@@ -936,10 +972,17 @@ void SX126xSetPaConfig(uint8_t paDutyCycle, uint8_t hpMax, uint8_t deviceSel, ui
 /*!
  * \brief Defines into which mode the chip goes after a TX / RX done
  *
- * \param   fallbackMode    The mode in which the radio goes
+ * \param   fallbackMode    The mode in which the radio goes [RadioFallbackModes_t]
  */
 void SX126xSetRxTxFallbackMode(uint8_t fallbackMode);
 
+/*!
+ * \brief Gets the mode the chip goes to after a TX / RX done
+ *
+ * \retval  fallbackMode    The mode in which the radio goes [RadioFallbackModes_t]
+ */
+uint8_t SX126xGetRxTxFallbackMode(void);
+
 /*!
  * \brief Write data to the radio memory
  *
@@ -979,6 +1022,8 @@ void SX126xReadBuffer(uint8_t offset, uint8_t *buffer, uint8_t size);
 /*!
  * \brief   Sets the IRQ mask and DIO masks
  *
+ * \remark  Masks equal to the last written ones are not sent to the radio again
+ *
  * \param   irqMask       General IRQ mask
  * \param   dio1Mask      DIO1 mask
  * \param   dio2Mask      DIO2 mask
@@ -1015,6 +1060,41 @@ void SX126xSetDio3AsTcxoCtrl(RadioTcxoCtrlVoltage_t tcxoVoltage, uint32_t timeou
  */
 void SX126xSetRfFrequency(uint32_t frequency);
 
+/*!
+ * \brief Converts a RF frequency into the PLL word of the radio
+ *
+ * \param   frequency     RF frequency [Hz]
+ * \retval  pllWord       Value for SX126xSetRfPllWord
+ */
+uint32_t SX126xGetPllWord(uint32_t frequency);
+
+/*!
+ * \brief Sets the RF frequency from a PLL word
+ *
+ * \remark Skips the conversion and the image calibration check, for
+ *         channels that are programmed repeatedly. SX126xSetRfFrequency
+ *         must have been called once in the same band.
+ *
+ * \param   pllWord       PLL word from SX126xGetPllWord
+ */
+void SX126xSetRfPllWord(uint32_t pllWord);
+
+/*!
+ * \brief Sets the crystal offset correction applied to all RF frequencies
+ *
+ * \remark Takes effect with the next SX126xSetRfFrequency or SX126xGetPllWord.
+ *
+ * \param   ppb           Correction [parts per billion], positive raises the frequency
+ */
+void SX126xSetFrequencyCorrection(int32_t ppb);
+
+/*!
+ * \brief Gets the crystal offset correction
+ *
+ * \retval  ppb           Correction [parts per billion]
+ */
+int32_t SX126xGetFrequencyCorrection(void);
+
 /*!
  * \brief Sets the radio for the given protocol
  *
@@ -1035,11 +1115,36 @@ RadioPacketTypes_t SX126xGetPacketType(void);
 /*!
  * \brief Sets the transmission parameters
  *
- * \param   power         RF output power [-18..13] dBm
+ * \remark The PA is configured with the most efficient setting that reaches
+ *         the power, see the optimal settings of DS_SX1261-2 chapter 13.1.14.
+ *
+ * \param   power         RF output power [SX1261: -17..15, SX1262: -9..22] dBm
  * \param   rampTime      Transmission ramp up time
  */
 void SX126xSetTxParams(int8_t power, RadioRampTimes_t rampTime);
 
+/*!
+ * \brief Gets the typical supply current of a TX power level
+ *
+ * \remark Current of the PA setting used for the power at its nominal
+ *         output power, an upper limit for the lower power levels.
+ *
+ * \param   power         RF output power [dBm]
+ * \retval  current       Supply current [0.1 mA]
+ */
+uint16_t SX126xGetTxCurrent(int8_t power);
+
+/*!
+ * \brief Gets the typical supply current of a TX power level of a device
+ *
+ * \remark Same as SX126xGetTxCurrent without a radio, e.g. for planning.
+ *
+ * \param   device        SX1261 or SX1262
+ * \param   power         RF output power [dBm]
+ * \retval  current       Supply current [0.1 mA]
+ */
+uint16_t SX126xGetDeviceTxCurrent(uint8_t device, int8_t power);
+
 /*!
  * \brief Set the modulation parameters
  *
@@ -1077,6 +1182,13 @@ void SX126xSetCadParams(RadioLoRaCadSymbols_t cadSymbolNum, uint8_t cadDetPeak,
  */
 void SX126xSetBufferBaseAddress(uint8_t txBaseAddress, uint8_t rxBaseAddress);
 
+/*!
+ * \brief Gets the data buffer base address for transmission
+ *
+ * \retval  txBaseAddress Transmission base address
+ */
+uint8_t SX126xGetTxBaseAddress(void);
+
 /*!
  * \brief Gets the current radio status
  *
@@ -1106,6 +1218,39 @@ void SX126xGetRxBufferStatus(uint8_t *payloadLength, uint8_t *rxStartBuffer);
  */
 void SX126xGetPacketStatus(PacketStatus_t *pktStatus);
 
+/*!
+ * \brief Converts a LoRa bandwidth into Hz
+ *
+ * \param   bandwidth     LoRa bandwidth
+ * \retval  bandwidthHz   Bandwidth [Hz], 0 for invalid values
+ */
+uint32_t SX126xGetLoRaBandwidthHz(RadioLoRaBandwidths_t bandwidth);
+
+/*!
+ * \brief Computes the time on air of a LoRa packet
+ *
+ * \remark Depends only on the parameters, not on the radio state.
+ *
+ * \param   sf                  Spreading factor [5..12]
+ * \param   bandwidth           Bandwidth [Hz]
+ * \param   cr                  Coding rate [1: 4/5, 2: 4/6, 3: 4/7, 4: 4/8]
+ * \param   lowDatarateOptimize Low datarate optimization enabled
+ * \param   preambleLength      Preamble length in symbols
+ * \param   fixLength           Fixed length packets without header
+ * \param   crcOn               Payload CRC enabled
+ * \param   pktLen              Packet payload length
+ * \retval  airTime             Time on air [ms], 0 for an invalid bandwidth
+ */
+uint32_t SX126xGetLoRaTimeOnAir(uint8_t sf, uint32_t bandwidth, uint8_t cr, bool lowDatarateOptimize,
+								uint16_t preambleLength, bool fixLength, bool crcOn, uint8_t pktLen);
+
+/*!
+ * \brief Reads the frequency error indicator of the last received LoRa packet
+ *
+ * \retval      freqError     Frequency error [Hz], positive if the signal is above the receiver
+ */
+int32_t SX126xGetFrequencyError(void);
+
 /*!
  * \brief Returns the possible system errors
  *
@@ -0,0 +1,121 @@
+/**
+ * @file sx126x-profile.h
+ * @brief Cycle counting profiler with scoped zones for all platforms
+ * 		Set LIB_PROFILE to 1 to enable the profiler
+ *      - either here in this header files (Arduino IDE)
+ *      - or globale with build_flags = -DLIB_PROFILE=1 in platformio.ini (PIO)
+ *
+ * A zone measures the time from PROFILE_ZONE() to the end of the enclosing
+ * block. Each zone keeps count, min, max and total in a static structure, the
+ * zones link themselves into a list at their first use, nothing is allocated.
+ * The counter is the DWT CYCCNT on the nRF52, the CCOUNT on the ESP32 and
+ * ESP8266 and the 1 MHz system timer on the RP2040.
+ *
+ * With LIB_PROFILE 0 the zones compile to nothing and the functions are empty.
+ */
+#ifndef __SX126X_PROFILE_H__
+#define __SX126X_PROFILE_H__
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// If not on PIO or not defined in platformio.ini
+#ifndef LIB_PROFILE
+// Profiler set to 0 to disable the profile zones
+#define LIB_PROFILE 0
+#endif
+
+#if LIB_PROFILE > 0 && (defined ARDUINO_ARCH_RP2040 || defined ARDUINO_RAKWIRELESS_RAK11300)
+#include <hardware/timer.h>
+#endif
+
+/**@brief Profile zone, one static instance per PROFILE_ZONE()
+ */
+typedef struct profile_zone_s
+{
+	const char *name;			 /**< Name of the zone */
+	uint32_t count;				 /**< Number of runs */
+	uint32_t min;				 /**< Shortest run in counter ticks */
+	uint32_t max;				 /**< Longest run in counter ticks */
+	uint64_t total;				 /**< Sum of all runs in counter ticks */
+	struct profile_zone_s *next; /**< Next zone of the report */
+	bool registered;			 /**< Zone is in the report list */
+} profile_zone_t;
+
+#if LIB_PROFILE > 0
+
+/**@brief Read the profile counter
+ *
+ * @retval counter ticks, see profile_frequency()
+ */
+static inline uint32_t profile_counter(void)
+{
+#if defined NRF52_SERIES
+	return DWT->CYCCNT;
+#elif defined ESP32 || defined ESP8266
+	return ESP.getCycleCount();
+#elif defined ARDUINO_ARCH_RP2040 || defined ARDUINO_RAKWIRELESS_RAK11300
+	return time_us_32();
+#else
+	return micros();
+#endif
+}
+
+/**@brief Start the cycle counter, called by lora_hardware_init()
+ */
+void profile_init(void);
+
+/**@brief Get the frequency of the profile counter
+ *
+ * @retval ticks per second
+ */
+uint32_t profile_frequency(void);
+
+/**@brief Add a run to a zone
+ *
+ * @param zone Zone of the run
+ * @param ticks Duration of the run in counter ticks
+ */
+void profile_add(profile_zone_t *zone, uint32_t ticks);
+
+/**@brief Print count, min, avg and max of all zones in ns to Serial
+ */
+void profile_report(void);
+
+/**@brief Clear the statistics of all zones
+ */
+void profile_reset(void);
+
+/**@brief Measures from its construction to the end of the enclosing block
+ */
+class ProfileScope
+{
+public:
+	ProfileScope(profile_zone_t *zone) : _zone(zone), _start(profile_counter()) {}
+	~ProfileScope() { profile_add(_zone, profile_counter() - _start); }
+
+private:
+	profile_zone_t *_zone;
+	uint32_t _start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+/** Measure the rest of the enclosing block as zone name */
+#define PROFILE_ZONE(name)                                                                                     \
+	static profile_zone_t PROFILE_CONCAT(_profile_zone_, __LINE__) = {name, 0, UINT32_MAX, 0, 0, NULL, false}; \
+	ProfileScope PROFILE_CONCAT(_profile_scope_, __LINE__)(&PROFILE_CONCAT(_profile_zone_, __LINE__))
+
+#else
+
+static inline void profile_init(void) {}
+static inline uint32_t profile_frequency(void) { return 0; }
+static inline void profile_report(void) {}
+static inline void profile_reset(void) {}
+
+#define PROFILE_ZONE(name)
+
+#endif
+
+#endif // __SX126X_PROFILE_H__
@@ -0,0 +1,156 @@
+/**
+ * @file sx126x-trace.h
+ * @brief Trace ring of radio IRQs, timer expirations and SPI commands with replay
+ * 		Set LIB_TRACE to 1 to enable the trace
+ *      - either here in this header files (Arduino IDE)
+ *      - or globale with build_flags = -DLIB_TRACE=1 in platformio.ini (PIO)
+ *
+ * Each event is an 8 byte entry with a timestamp in us in a RAM ring of
+ * LIB_TRACE_SIZE entries, the oldest entries are overwritten. Recorded are
+ * - TRACE_DIO the DIO1 interrupt
+ * - TRACE_IRQ the IRQ status the radio processes
+ * - TRACE_TIMER the expiry of a timer, arg is the timer number
+ * - TRACE_SPI an SPI access, arg is the opcode, value the size or the register address
+ * - TRACE_RX the payload length of a received packet
+ *
+ * trace_dump() prints the entries as text lines to Serial, trace_parse() reads
+ * such a line back. trace_replay() feeds the IRQ status words of a trace into
+ * the radio IRQ processing at the recorded times, stretched by a scale factor.
+ * The MAC handles them as if the radio had raised them, e.g. a late TxDone
+ * moves the RX windows. The IRQs of the radio are ignored during a replay,
+ * the commands of the MAC still reach the radio. Payloads are not part of the
+ * trace: a replayed RX_DONE delivers a payload of zeros with the recorded
+ * length, the data buffer of the radio is not read. A packet without recorded
+ * length, e.g. one dropped by the address filter, is dropped again. The hop
+ * header and the frequency error are not applied to replayed packets.
+ * The replay is recorded again, so both traces can be compared.
+ *
+ * With LIB_TRACE 0 the hooks compile to nothing and the functions are empty.
+ */
+#ifndef __SX126X_TRACE_H__
+#define __SX126X_TRACE_H__
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// If not on PIO or not defined in platformio.ini
+#ifndef LIB_TRACE
+// Trace set to 0 to disable the trace
+#define LIB_TRACE 0
+#endif
+
+#ifndef LIB_TRACE_SIZE
+#define LIB_TRACE_SIZE 256 /**< Entries of the trace ring */
+#endif
+
+/** Event types of the trace */
+typedef enum
+{
+	TRACE_DIO = 0,
+	TRACE_IRQ = 1,
+	TRACE_TIMER = 2,
+	TRACE_SPI = 3,
+	TRACE_RX = 4
+} trace_type_t;
+
+/**@brief Entry of the trace ring
+ */
+typedef struct trace_entry_s
+{
+	uint32_t time;	/**< Timestamp in us */
+	uint8_t type;	/**< Event type, see trace_type_t */
+	uint8_t arg;	/**< Timer number or SPI opcode */
+	uint16_t value; /**< IRQ status, SPI size, register address or payload length */
+} trace_entry_t;
+
+#if LIB_TRACE > 0
+
+/**@brief Add an event to the trace ring, can be called from interrupts
+ *
+ * @param type Event type
+ * @param arg Timer number or SPI opcode
+ * @param value IRQ status, SPI size, register address or payload length
+ */
+void trace_add(trace_type_t type, uint8_t arg, uint16_t value);
+
+/**@brief Record the IRQ status the radio processes, replaced by the replayed status during a replay
+ *
+ * @param status IRQ status read from the radio
+ *
+ * @retval IRQ status to process
+ */
+uint16_t trace_irq_status(uint16_t status);
+
+/**@brief Get the payload length of a replayed packet
+ * Call for an RX_DONE instead of reading the data buffer of the radio
+ *
+ * @param size Payload length to fill, the recorded length or 0 if the packet has none
+ *
+ * @retval true if the IRQ status in process is replayed, false if it is from the radio
+ */
+bool trace_rx_replayed(uint8_t *size);
+
+/**@brief Start or stop the recording, e.g. stop it after an error to keep the events before
+ *
+ * @param enable true to record
+ */
+void trace_enable(bool enable);
+
+/**@brief Clear the trace ring
+ */
+void trace_clear(void);
+
+/**@brief Copy the trace ring, oldest entry first
+ *
+ * @param entries Array for the entries
+ * @param max Size of the array
+ *
+ * @retval number of entries copied
+ */
+uint16_t trace_get(trace_entry_t *entries, uint16_t max);
+
+/**@brief Print the trace ring to Serial, one entry per line, oldest first
+ */
+void trace_dump(void);
+
+/**@brief Read an entry from a line of trace_dump()
+ *
+ * @param line Text line
+ * @param entry Entry to fill
+ *
+ * @retval false if the line is not a trace entry
+ */
+bool trace_parse(const char *line, trace_entry_t *entry);
+
+/**@brief Replay the IRQ status words of a trace into the radio IRQ processing
+ *
+ * @param entries Trace to replay, must stay valid until the replay ends
+ * @param count Number of entries
+ * @param scale Time scale in percent, e.g. 120 delays the IRQs 20% more than recorded
+ *
+ * @retval false if a replay runs or the trace has no IRQ status
+ */
+bool trace_replay(const trace_entry_t *entries, uint16_t count, uint16_t scale);
+
+/**@brief Check if a replay runs
+ *
+ * @retval true while IRQs of the trace are pending
+ */
+bool trace_replaying(void);
+
+#else
+
+static inline void trace_add(trace_type_t, uint8_t, uint16_t) {}
+static inline uint16_t trace_irq_status(uint16_t status) { return status; }
+static inline bool trace_rx_replayed(uint8_t *) { return false; }
+static inline void trace_enable(bool) {}
+static inline void trace_clear(void) {}
+static inline uint16_t trace_get(trace_entry_t *, uint16_t) { return 0; }
+static inline void trace_dump(void) {}
+static inline bool trace_parse(const char *, trace_entry_t *) { return false; }
+static inline bool trace_replay(const trace_entry_t *, uint16_t, uint16_t) { return false; }
+static inline bool trace_replaying(void) { return false; }
+
+#endif
+
+#endif // __SX126X_TRACE_H__
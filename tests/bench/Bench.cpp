@@ -0,0 +1,482 @@
+/**
+ * @file Bench.cpp
+ * @brief Host benchmark of the library hot paths
+ *
+ * Runs the unchanged crypto, region, time on air, radio IRQ and MAC code
+ * against the emulated board of tests/regions/stubs and measures the time per
+ * call with the host clock. Each result is printed as one JSON object per line.
+ * With --baseline the results of an earlier run are read and the change is
+ * added to each line, see the Makefile.
+ *
+ * The numbers compare two versions of the library on the same host, they are
+ * no measure of the time on the target. examples/Benchmark runs the same
+ * benchmarks on a board, except for the MAC benchmarks that need the radio
+ * events of the emulated board.
+ */
+#include <stdio.h>
+#include <chrono>
+#include <map>
+#include <new>
+#include <string>
+
+#include "HostBoard.h"
+#include "boards/mcu/board.h"
+#include "mac/LoRaMac.h"
+#include "mac/LoRaMacCrypto.h"
+#include "mac/LoRaMacTest.h"
+#include "mac/region/Region.h"
+#include "radio/radio.h"
+#include "radio/sx126x/sx126x.h"
+
+/** Min measuring time per round in us */
+#define BENCH_MIN_TIME 50000
+
+/** Rounds per benchmark, the fastest round is reported to filter out the noise of the host */
+#define BENCH_ROUNDS 5
+
+/** Device address of the ABP session of the MAC benchmarks */
+#define BENCH_DEV_ADDR 0x260116F8
+
+/** Max steps of 100 ms until the MAC confirms an uplink */
+#define BENCH_MAX_UPLINK_STEPS 100
+
+/** Heap allocations, the library should have none in its hot paths */
+static uint32_t allocations = 0;
+
+void *operator new(size_t size)
+{
+	allocations++;
+	void *ptr = malloc(size == 0 ? 1 : size);
+	if (ptr == NULL)
+	{
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	free(ptr);
+}
+
+static RadioEvents_t RadioEvents;
+
+static uint8_t benchBuffer[256];
+static uint8_t benchEncrypted[256];
+static const uint8_t benchKey[16] = {0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+
+/** Payload sizes of the crypto benchmarks, from a small sensor frame to the max LoRaWAN payload */
+static const uint8_t payloadSizes[] = {16, 51, 115, 222};
+
+/** Results of the measured functions, keeps the compiler from dropping the calls */
+static volatile uint32_t benchSink;
+
+static LoRaMacPrimitives_t macPrimitives;
+static LoRaMacCallback_t macCallbacks;
+
+/** Uplinks confirmed by the MAC */
+static uint32_t macConfirms = 0;
+
+/** Downlinks with application data indicated by the MAC */
+static uint32_t macIndications = 0;
+
+/** Uplinks or downlinks of the MAC benchmarks that did not complete, the results are void then */
+static uint32_t macFailures = 0;
+
+/** Downlink frames of the MAC benchmark, per payload size */
+static uint8_t downlinkFrames[sizeof(payloadSizes)][256];
+
+/** ns/op of the baseline run by "bench/param" */
+static std::map<std::string, uint32_t> baseline;
+
+/** Largest slowdown against the baseline in percent */
+static int32_t worstChange = 0;
+
+static uint64_t hostMicros(void)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+/**
+ * @brief Run a function for BENCH_ROUNDS rounds of at least BENCH_MIN_TIME and print the fastest round
+ *
+ * @param name name of the benchmark
+ * @param param parameter of the benchmark, e.g. the payload size
+ * @param function function to measure
+ * @param arg argument for the function
+ */
+static void runBenchmark(const char *name, uint32_t param, void (*function)(uint32_t), uint32_t arg)
+{
+	uint32_t totalOps = 0;
+	uint32_t nsOp = UINT32_MAX;
+	uint32_t startAllocations = allocations;
+
+	for (uint8_t round = 0; round < BENCH_ROUNDS; round++)
+	{
+		uint32_t ops = 0;
+		uint32_t batch = 1;
+		uint64_t start = hostMicros();
+		uint64_t elapsed = 0;
+
+		// Grow the batches so the loop overhead of the clock stays small
+		while (elapsed < BENCH_MIN_TIME)
+		{
+			for (uint32_t idx = 0; idx < batch; idx++)
+			{
+				function(arg);
+			}
+			ops += batch;
+			batch *= 2;
+			elapsed = hostMicros() - start;
+		}
+		totalOps += ops;
+		if ((elapsed * 1000) / ops < nsOp)
+		{
+			nsOp = (uint32_t)((elapsed * 1000) / ops);
+		}
+	}
+
+	printf("{\"bench\":\"%s\",\"param\":%lu,\"ops\":%lu,\"ns_op\":%lu,\"allocs\":%lu",
+		   name, (unsigned long)param, (unsigned long)totalOps, (unsigned long)nsOp,
+		   (unsigned long)(allocations - startAllocations));
+
+	char key[64];
+	snprintf(key, sizeof(key), "%s/%lu", name, (unsigned long)param);
+	std::map<std::string, uint32_t>::iterator base = baseline.find(key);
+	if ((base != baseline.end()) && (base->second > 0))
+	{
+		int32_t change = (int32_t)(((int64_t)nsOp - base->second) * 100 / base->second);
+		printf(",\"base_ns_op\":%lu,\"change\":%ld", (unsigned long)base->second, (long)change);
+		if (change > worstChange)
+		{
+			worstChange = change;
+		}
+	}
+	printf("}\n");
+	fflush(stdout);
+}
+
+/**
+ * @brief Read the results of an earlier run
+ *
+ * @param path file with the JSON lines of the run
+ * @return true if the file was read
+ */
+static bool readBaseline(const char *path)
+{
+	FILE *file = fopen(path, "r");
+	if (file == NULL)
+	{
+		return false;
+	}
+	char text[256];
+	while (fgets(text, sizeof(text), file) != NULL)
+	{
+		char name[32];
+		unsigned long param;
+		unsigned long ops;
+		unsigned long nsOp;
+		if (sscanf(text, "{\"bench\":\"%31[^\"]\",\"param\":%lu,\"ops\":%lu,\"ns_op\":%lu", name, &param, &ops, &nsOp) == 4)
+		{
+			char key[64];
+			snprintf(key, sizeof(key), "%s/%lu", name, param);
+			baseline[key] = nsOp;
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+static void benchMic(uint32_t size)
+{
+	uint32_t mic;
+	LoRaMacComputeMic(benchBuffer, size, benchKey, 0x260116F8, UP_LINK, 1, &mic);
+	benchSink = mic;
+}
+
+static void benchEncrypt(uint32_t size)
+{
+	LoRaMacPayloadEncrypt(benchBuffer, size, benchKey, 0x260116F8, UP_LINK, 1, benchEncrypted);
+	benchSink = benchEncrypted[0];
+}
+
+static void benchTimeOnAir(uint32_t size)
+{
+	benchSink = Radio.TimeOnAir(MODEM_LORA, size);
+}
+
+static void benchRxDone(uint32_t size)
+{
+	// IRQ handling of a received packet, IRQ status, buffer read and packet status
+	HostRadioIrq(IRQ_RX_DONE, NULL, size, -80, 7);
+}
+
+static void benchNextChannel(uint32_t region)
+{
+	NextChanParams_t nextChan;
+	uint8_t channel;
+	TimerTime_t dutyCycleTimeOff;
+	TimerTime_t aggregatedTimeOff = 0;
+
+	nextChan.AggrTimeOff = 0;
+	nextChan.LastAggrTx = 0;
+	nextChan.Datarate = DR_0;
+	nextChan.Joined = true;
+	nextChan.DutyCycleEnabled = false;
+	RegionNextChannel((LoRaMacRegion_t)region, &nextChan, &channel, &dutyCycleTimeOff, &aggregatedTimeOff);
+	benchSink = channel;
+}
+
+static void onRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+{
+	benchSink = size;
+}
+
+static void onMcpsConfirm(McpsConfirm_t *mcpsConfirm)
+{
+	macConfirms++;
+}
+
+static void onMcpsIndication(McpsIndication_t *mcpsIndication)
+{
+	if ((mcpsIndication->Status == LORAMAC_EVENT_INFO_STATUS_OK) && mcpsIndication->RxData)
+	{
+		macIndications++;
+	}
+}
+
+static void onMlmeConfirm(MlmeConfirm_t *mlmeConfirm)
+{
+}
+
+/**
+ * @brief Send an unconfirmed uplink and end it as the radio would, Tx done and no answer in both RX windows
+ *
+ * @param size payload size
+ */
+static void benchMcpsRequest(uint32_t size)
+{
+	McpsReq_t mcpsReq;
+	uint32_t confirms = macConfirms;
+
+	mcpsReq.Type = MCPS_UNCONFIRMED;
+	mcpsReq.Req.Unconfirmed.fPort = 2;
+	mcpsReq.Req.Unconfirmed.fBuffer = benchBuffer;
+	mcpsReq.Req.Unconfirmed.fBufferSize = size;
+	mcpsReq.Req.Unconfirmed.Datarate = DR_5;
+	if (LoRaMacMcpsRequest(&mcpsReq) != LORAMAC_STATUS_OK)
+	{
+		macFailures++;
+		return;
+	}
+	HostRadioIrq(IRQ_TX_DONE, NULL, 0, 0, 0);
+	for (uint8_t step = 0; (step < BENCH_MAX_UPLINK_STEPS) && (macConfirms == confirms); step++)
+	{
+		HostRun(100);
+		if (Radio.GetStatus() == RF_RX_RUNNING)
+		{
+			HostRadioIrq(IRQ_RX_TX_TIMEOUT, NULL, 0, 0, 0);
+		}
+	}
+	if (macConfirms == confirms)
+	{
+		macFailures++;
+	}
+}
+
+/**
+ * @brief Receive an unconfirmed downlink in the continuous RX2 window of Class C
+ *
+ * @param idx index of the frame in payloadSizes
+ */
+static void benchMacRxDone(uint32_t idx)
+{
+	MibRequestConfirm_t mibReq;
+	uint32_t indications = macIndications;
+
+	// The same frame is received again, counter 1 is new after the reset
+	mibReq.Type = MIB_DOWNLINK_COUNTER;
+	mibReq.Param.DownLinkCounter = 0;
+	LoRaMacMibSetRequestConfirm(&mibReq);
+	HostRadioIrq(IRQ_RX_DONE, downlinkFrames[idx], LORA_MAC_FRMPAYLOAD_OVERHEAD + payloadSizes[idx], -80, 7);
+	if (macIndications == indications)
+	{
+		macFailures++;
+	}
+}
+
+/**
+ * @brief Build an unconfirmed downlink with frame counter 1 to the ABP session
+ *
+ * @param frame buffer of the frame
+ * @param size payload size
+ */
+static void buildDownlink(uint8_t *frame, uint8_t size)
+{
+	uint8_t idx = 0;
+	uint32_t mic;
+
+	frame[idx++] = FRAME_TYPE_DATA_UNCONFIRMED_DOWN << 5;
+	frame[idx++] = BENCH_DEV_ADDR & 0xFF;
+	frame[idx++] = (BENCH_DEV_ADDR >> 8) & 0xFF;
+	frame[idx++] = (BENCH_DEV_ADDR >> 16) & 0xFF;
+	frame[idx++] = (BENCH_DEV_ADDR >> 24) & 0xFF;
+	frame[idx++] = 0;
+	frame[idx++] = 1;
+	frame[idx++] = 0;
+	frame[idx++] = 2;
+	LoRaMacPayloadEncrypt(benchBuffer, size, benchKey, BENCH_DEV_ADDR, DOWN_LINK, 1, &frame[idx]);
+	idx += size;
+	LoRaMacComputeMic(frame, idx, benchKey, BENCH_DEV_ADDR, DOWN_LINK, 1, &mic);
+	frame[idx++] = mic & 0xFF;
+	frame[idx++] = (mic >> 8) & 0xFF;
+	frame[idx++] = (mic >> 16) & 0xFF;
+	frame[idx++] = (mic >> 24) & 0xFF;
+}
+
+/**
+ * @brief Start the MAC in EU868 with an ABP session, ADR and duty cycle off
+ *
+ * @return true if the MAC is ready
+ */
+static bool startMac(void)
+{
+	MibRequestConfirm_t mibReq;
+
+	macPrimitives.MacMcpsConfirm = onMcpsConfirm;
+	macPrimitives.MacMcpsIndication = onMcpsIndication;
+	macPrimitives.MacMlmeConfirm = onMlmeConfirm;
+	if (LoRaMacInitialization(&macPrimitives, &macCallbacks, LORAMAC_REGION_EU868) != LORAMAC_STATUS_OK)
+	{
+		return false;
+	}
+	LoRaMacTestSetDutyCycleOn(false);
+
+	mibReq.Type = MIB_PUBLIC_NETWORK;
+	mibReq.Param.EnablePublicNetwork = true;
+	LoRaMacMibSetRequestConfirm(&mibReq);
+	mibReq.Type = MIB_ADR;
+	mibReq.Param.AdrEnable = false;
+	LoRaMacMibSetRequestConfirm(&mibReq);
+	mibReq.Type = MIB_DEV_ADDR;
+	mibReq.Param.DevAddr = BENCH_DEV_ADDR;
+	LoRaMacMibSetRequestConfirm(&mibReq);
+	mibReq.Type = MIB_NWK_SKEY;
+	mibReq.Param.NwkSKey = (uint8_t *)benchKey;
+	LoRaMacMibSetRequestConfirm(&mibReq);
+	mibReq.Type = MIB_APP_SKEY;
+	mibReq.Param.AppSKey = (uint8_t *)benchKey;
+	LoRaMacMibSetRequestConfirm(&mibReq);
+	mibReq.Type = MIB_NETWORK_JOINED;
+	mibReq.Param.IsNetworkJoined = JOIN_OK;
+	LoRaMacMibSetRequestConfirm(&mibReq);
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	int32_t maxChange = -1;
+	for (int idx = 1; idx < argc; idx++)
+	{
+		if ((strcmp(argv[idx], "--baseline") == 0) && (idx + 1 < argc))
+		{
+			if (!readBaseline(argv[++idx]))
+			{
+				fprintf(stderr, "Cannot read %s\n", argv[idx]);
+				return 2;
+			}
+		}
+		else if ((strcmp(argv[idx], "--max-change") == 0) && (idx + 1 < argc))
+		{
+			maxChange = atoi(argv[++idx]);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [--baseline file] [--max-change percent]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	RadioEvents.RxDone = onRxDone;
+	Radio.Init(&RadioEvents);
+	// The radio events are called for the public network only, the P2P events otherwise
+	Radio.SetPublicNetwork(true);
+	Radio.SetChannel(868000000);
+	Radio.Standby();
+
+	for (uint16_t idx = 0; idx < sizeof(benchBuffer); idx++)
+	{
+		benchBuffer[idx] = (uint8_t)idx;
+	}
+
+	for (uint8_t idx = 0; idx < sizeof(payloadSizes); idx++)
+	{
+		runBenchmark("mic", payloadSizes[idx], benchMic, payloadSizes[idx]);
+		runBenchmark("encrypt", payloadSizes[idx], benchEncrypt, payloadSizes[idx]);
+	}
+
+	for (uint8_t sf = 7; sf <= 12; sf++)
+	{
+		Radio.SetTxConfig(MODEM_LORA, 22, 0, 0, sf, 1, 8, false, true, 0, 0, false, 3000);
+		runBenchmark("time_on_air", sf, benchTimeOnAir, 51);
+	}
+
+	Radio.SetRxConfig(MODEM_LORA, 0, 7, 1, 0, 8, 0, false, 0, true, 0, 0, false, true);
+	Radio.Rx(0);
+	for (uint8_t idx = 0; idx < sizeof(payloadSizes); idx++)
+	{
+		runBenchmark("rx_done", payloadSizes[idx], benchRxDone, payloadSizes[idx]);
+	}
+
+	for (uint8_t region = LORAMAC_REGION_AS923; region <= LORAMAC_REGION_RU864; region++)
+	{
+		if (RegionIsActive((LoRaMacRegion_t)region))
+		{
+			RegionInitDefaults((LoRaMacRegion_t)region, INIT_TYPE_INIT);
+			runBenchmark("next_channel", region, benchNextChannel, region);
+		}
+	}
+
+	if (!startMac())
+	{
+		fprintf(stderr, "Cannot start the MAC\n");
+		return 2;
+	}
+	for (uint8_t idx = 0; idx < sizeof(payloadSizes); idx++)
+	{
+		runBenchmark("mcps_request", payloadSizes[idx], benchMcpsRequest, payloadSizes[idx]);
+	}
+	// Class C receives on RX2, with DR_5 the downlinks of all sizes fit
+	MibRequestConfirm_t mibReq;
+	mibReq.Type = MIB_DEVICE_CLASS;
+	mibReq.Param.Class = CLASS_C;
+	LoRaMacMibSetRequestConfirm(&mibReq);
+	mibReq.Type = MIB_RX2_CHANNEL;
+	mibReq.Param.Rx2Channel.Frequency = 869525000;
+	mibReq.Param.Rx2Channel.Datarate = DR_5;
+	LoRaMacMibSetRequestConfirm(&mibReq);
+	for (uint8_t idx = 0; idx < sizeof(payloadSizes); idx++)
+	{
+		buildDownlink(downlinkFrames[idx], payloadSizes[idx]);
+		runBenchmark("mac_rx_done", payloadSizes[idx], benchMacRxDone, idx);
+	}
+	if (macFailures > 0)
+	{
+		fprintf(stderr, "%lu uplinks or downlinks of the MAC did not complete\n", (unsigned long)macFailures);
+		return 2;
+	}
+
+	if ((maxChange >= 0) && (worstChange > maxChange))
+	{
+		fprintf(stderr, "Slower than the baseline by %ld%%\n", (long)worstChange);
+		return 1;
+	}
+	return 0;
+}
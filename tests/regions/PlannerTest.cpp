@@ -0,0 +1,137 @@
+/**
+ * @file PlannerTest.cpp
+ * @brief Host test of the time on air and duty cycle of the uplink planner
+ *
+ * The expected time on air follows the formula of the SX126x datasheet for a
+ * 10 byte payload in a 23 byte frame with 8 preamble symbols, CR 4/5,
+ * explicit header and CRC, e.g. 61.696 ms for SF7 and 1482.752 ms for SF12
+ * with low datarate optimization, rounded up to full ms. The duty cycle is
+ * the airtime per period against the duty cycle of the bands of the default
+ * channels of the region.
+ *
+ * The schedules are planned before any region is initialized and again after
+ * the region storage was set up for another region, the results must match.
+ */
+#include <stdio.h>
+
+#include "boards/mcu/board.h"
+#include "mac/LoRaMacPlanner.h"
+#include "mac/region/Region.h"
+
+// Globals of LoRaMacHelper.cpp used by the regions
+uint16_t ChannelsMask[6];
+uint16_t ChannelsDefaultMask[6];
+uint16_t ChannelsMaskRemaining[6];
+
+/** Schedule and its expected result, UINT32_MAX for values not checked */
+typedef struct
+{
+	const char *name;
+	LoRaMacRegion_t region;
+	int8_t datarate;
+	uint8_t payload;
+	uint32_t period;
+	lmh_plan_status status;
+	uint32_t timeOnAir;
+	uint32_t dutyCycle;
+	uint32_t minPeriod;
+	uint32_t nextTx;
+} test_plan_t;
+
+static const test_plan_t testPlans[] = {
+	// 1% band of the three default channels: 62 ms per 10 min is 10.3 per mille, 99 times the time on air off
+	{"EU868 SF7", LORAMAC_REGION_EU868, DR_5, 10, 600000, LMH_PLAN_SUCCESS, 62, 11, 6200, 6138},
+	{"EU868 SF12", LORAMAC_REGION_EU868, DR_0, 10, 3600000, LMH_PLAN_SUCCESS, 1483, 42, 148300, 146817},
+	// No duty cycle limit, 100% band
+	{"US915 SF10", LORAMAC_REGION_US915, DR_0, 10, 60000, LMH_PLAN_SUCCESS, 371, 7, UINT32_MAX, 0},
+	{"AS923 SF7", LORAMAC_REGION_AS923, DR_5, 10, 600000, LMH_PLAN_SUCCESS, 62, 11, 6200, 6138},
+	// FSK datarate and a payload above the max payload of SF12
+	{"EU868 FSK", LORAMAC_REGION_EU868, DR_7, 10, 600000, LMH_PLAN_ERROR, 0, 0, 0, 0},
+	{"EU868 too long", LORAMAC_REGION_EU868, DR_0, 60, 600000, LMH_PLAN_ERROR, 0, 0, 0, 0},
+};
+
+#define TEST_NB_PLANS (sizeof(testPlans) / sizeof(testPlans[0]))
+
+static void fillPlan(const test_plan_t *test, lmh_plan_t *plan)
+{
+	memset(plan, 0, sizeof(lmh_plan_t));
+	plan->region = test->region;
+	plan->datarate = test->datarate;
+	plan->tx_power = 14;
+	plan->payload = test->payload;
+	plan->period = test->period;
+	plan->nb_trans = 1;
+	plan->chip = SX1262_CHIP;
+}
+
+static bool check(const char *name, const char *field, uint32_t value, uint32_t expected)
+{
+	if ((expected != UINT32_MAX) && (value != expected))
+	{
+		printf("%s FAILED: %s %lu, expected %lu\n", name, field, (unsigned long)value, (unsigned long)expected);
+		return false;
+	}
+	return true;
+}
+
+static int checkResults(const lmh_plan_result_t *results)
+{
+	int failed = 0;
+	for (size_t idx = 0; idx < TEST_NB_PLANS; idx++)
+	{
+		const test_plan_t *test = &testPlans[idx];
+		lmh_plan_t plan;
+		lmh_plan_result_t result;
+		fillPlan(test, &plan);
+		bool ok = check(test->name, "status", lmh_plan_evaluate(&plan, &result), test->status);
+		ok &= check(test->name, "time_on_air", result.time_on_air, test->timeOnAir);
+		ok &= check(test->name, "duty_cycle", result.duty_cycle, test->dutyCycle);
+		ok &= check(test->name, "min_period", result.min_period, test->minPeriod);
+		ok &= check(test->name, "next_tx", result.next_tx, test->nextTx);
+		if (memcmp(&result, &results[idx], sizeof(result)) != 0)
+		{
+			printf("%s FAILED: batch result differs\n", test->name);
+			ok = false;
+		}
+		if (ok)
+		{
+			printf("%s OK\n", test->name);
+		}
+		else
+		{
+			failed++;
+		}
+	}
+	return failed;
+}
+
+int main(void)
+{
+	lmh_plan_t plans[TEST_NB_PLANS];
+	lmh_plan_result_t results[TEST_NB_PLANS];
+	lmh_plan_result_t initResults[TEST_NB_PLANS];
+
+	for (size_t idx = 0; idx < TEST_NB_PLANS; idx++)
+	{
+		fillPlan(&testPlans[idx], &plans[idx]);
+	}
+
+	// Before any region is initialized
+	uint16_t evaluated = lmh_plan_batch(plans, results, TEST_NB_PLANS);
+	int failed = checkResults(results);
+
+	// Region storage of another region
+	RegionInitDefaults(LORAMAC_REGION_US915, INIT_TYPE_INIT);
+	lmh_plan_batch(plans, initResults, TEST_NB_PLANS);
+	if (memcmp(results, initResults, sizeof(results)) != 0)
+	{
+		printf("Results depend on the initialized region\n");
+		failed++;
+	}
+	if (evaluated != 4)
+	{
+		printf("Batch evaluated %u schedules, expected 4\n", evaluated);
+		failed++;
+	}
+	return failed == 0 ? 0 : 1;
+}
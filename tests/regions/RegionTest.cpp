@@ -0,0 +1,608 @@
+/**
+ * @file RegionTest.cpp
+ * @brief Host test that the region implementations keep the behavior of the per-region files
+ *
+ * Every region runs the same pseudo random sequence of MAC calls through the
+ * Region API. The return values, the radio calls, the channel masks and the
+ * channels after every call are folded into a hash per region and compared
+ * with the hashes recorded from the per-region implementations of the
+ * baseline commit, see the Makefile. `make golden` rebuilds this file against
+ * the baseline sources and prints the table below again.
+ */
+#include <stdio.h>
+#include <string>
+
+#include "boards/mcu/board.h"
+#include "mac/LoRaMac.h"
+#include "mac/region/Region.h"
+
+/** Calls per region */
+#define TEST_ITERATIONS 100000
+
+/** Region under test and the limits of its tables */
+typedef struct
+{
+	LoRaMacRegion_t region;
+	const char *name;
+	int8_t txMin;		 // Lowest uplink datarate
+	int8_t txMax;		 // Highest uplink datarate
+	int8_t drMax;		 // Last entry of the datarate table
+	int8_t maxDrOffset;	 // Last column of the RX1 datarate offset table
+	uint64_t golden;
+} test_region_t;
+
+static test_region_t testRegions[] = {
+	{LORAMAC_REGION_AS923, "AS923", DR_0, DR_7, DR_7, 7, 0x4c7d4cfaa4e177eeULL},
+	{LORAMAC_REGION_AU915, "AU915", DR_2, DR_6, DR_13, 5, 0xd7b5c8a859ba8942ULL},
+	{LORAMAC_REGION_CN470, "CN470", DR_0, DR_5, DR_5, 3, 0xb1734966e74b107cULL},
+	{LORAMAC_REGION_CN779, "CN779", DR_0, DR_7, DR_7, 5, 0x063224a3dc0c313bULL},
+	{LORAMAC_REGION_EU433, "EU433", DR_0, DR_7, DR_7, 5, 0xe23d6e1b4194ac39ULL},
+	{LORAMAC_REGION_EU868, "EU868", DR_0, DR_7, DR_7, 5, 0xf12e1b2de8bfc52aULL},
+	{LORAMAC_REGION_IN865, "IN865", DR_0, DR_7, DR_7, 7, 0xc3affa7d4e5565abULL},
+	{LORAMAC_REGION_KR920, "KR920", DR_0, DR_5, DR_5, 5, 0xd530eeab2902039cULL},
+	{LORAMAC_REGION_US915, "US915", DR_0, DR_4, DR_13, 3, 0x7d167ddd9801b1bdULL},
+	{LORAMAC_REGION_RU864, "RU864", DR_0, DR_7, DR_7, 7, 0xb812731d52537a3cULL},
+};
+
+/** Attributes of GetPhyParam with a value, as in the baseline */
+static const PhyAttribute_t testAttributes[] = {
+	PHY_MIN_RX_DR, PHY_MIN_TX_DR, PHY_MAX_RX_DR, PHY_MAX_TX_DR, PHY_TX_DR, PHY_DEF_TX_DR,
+	PHY_RX_DR, PHY_TX_POWER, PHY_DEF_TX_POWER, PHY_MAX_PAYLOAD, PHY_MAX_PAYLOAD_REPEATER,
+	PHY_DUTY_CYCLE, PHY_MAX_RX_WINDOW, PHY_RECEIVE_DELAY1, PHY_RECEIVE_DELAY2,
+	PHY_JOIN_ACCEPT_DELAY1, PHY_JOIN_ACCEPT_DELAY2, PHY_MAX_FCNT_GAP, PHY_ACK_TIMEOUT,
+	PHY_DEF_DR1_OFFSET, PHY_DEF_RX2_FREQUENCY, PHY_DEF_RX2_DR, PHY_MAX_NB_CHANNELS,
+	PHY_NB_JOIN_TRIALS, PHY_DEF_NB_JOIN_TRIALS, PHY_NEXT_LOWER_TX_DR, PHY_DEF_UPLINK_DWELL_TIME,
+	PHY_DEF_DOWNLINK_DWELL_TIME, PHY_DEF_MAX_EIRP, PHY_DEF_ANTENNA_GAIN};
+
+/** Attributes of Verify */
+static const PhyAttribute_t testVerifyAttributes[] = {
+	PHY_TX_DR, PHY_DEF_TX_DR, PHY_RX_DR, PHY_TX_POWER, PHY_DEF_TX_POWER, PHY_DUTY_CYCLE,
+	PHY_NB_JOIN_TRIALS, PHY_DEF_NB_JOIN_TRIALS};
+
+// Globals of LoRaMacHelper.cpp used by the regions
+uint16_t ChannelsMask[6];
+uint16_t ChannelsDefaultMask[6];
+uint16_t ChannelsMaskRemaining[6];
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+/** Random numbers of the region code, reseeded before every call */
+static uint32_t regionSeed;
+int32_t randr(int32_t min, int32_t max)
+{
+	regionSeed = regionSeed * 1664525 + 1013904223;
+	return (int32_t)((regionSeed >> 8) % (uint32_t)(max - min + 1)) + min;
+}
+
+/** Random numbers of the test sequence */
+static uint32_t testSeed;
+static uint32_t testRandom(void)
+{
+	testSeed = testSeed * 1103515245 + 12345;
+	return (testSeed >> 8) & 0xFFFFFF;
+}
+static int32_t testRange(int32_t min, int32_t max)
+{
+	return min + (int32_t)(testRandom() % (uint32_t)(max - min + 1));
+}
+
+static TimerTime_t testNow;
+TimerTime_t TimerGetElapsedTime(TimerTime_t savedTime)
+{
+	(void)savedTime;
+	return testNow;
+}
+TimerTime_t TimerGetCurrentTime(void)
+{
+	return testNow;
+}
+void delay(unsigned long ms)
+{
+	(void)ms;
+}
+
+/** Transcript of the current call */
+static std::string transcript;
+static char line[160];
+
+static void addLine(void)
+{
+	transcript += line;
+	transcript += ';';
+}
+
+static RadioState_t radioState;
+static RadioState_t stubGetStatus(void)
+{
+	return radioState;
+}
+static void stubSetChannel(uint32_t freq)
+{
+	snprintf(line, sizeof(line), "CH %lu", (unsigned long)freq);
+	addLine();
+}
+static void stubSetRxConfig(RadioModems_t modem, uint32_t bandwidth, uint32_t datarate, uint8_t coderate,
+							uint32_t bandwidthAfc, uint16_t preambleLen, uint16_t symbTimeout, bool fixLen,
+							uint8_t payloadLen, bool crcOn, bool freqHopOn, uint8_t hopPeriod, bool iqInverted, bool rxContinuous)
+{
+	snprintf(line, sizeof(line), "RX %d %lu %lu %u %lu %u %u %d %u %d %d %u %d %d", modem, (unsigned long)bandwidth,
+			 (unsigned long)datarate, coderate, (unsigned long)bandwidthAfc, preambleLen, symbTimeout, fixLen,
+			 payloadLen, crcOn, freqHopOn, hopPeriod, iqInverted, rxContinuous);
+	addLine();
+}
+static void stubSetTxConfig(RadioModems_t modem, int8_t power, uint32_t fdev, uint32_t bandwidth, uint32_t datarate,
+							uint8_t coderate, uint16_t preambleLen, bool fixLen, bool crcOn, bool freqHopOn,
+							uint8_t hopPeriod, bool iqInverted, uint32_t timeout)
+{
+	snprintf(line, sizeof(line), "TX %d %d %lu %lu %lu %u %u %d %d %d %u %d %lu", modem, power, (unsigned long)fdev,
+			 (unsigned long)bandwidth, (unsigned long)datarate, coderate, preambleLen, fixLen, crcOn, freqHopOn,
+			 hopPeriod, iqInverted, (unsigned long)timeout);
+	addLine();
+}
+static bool stubCheckRfFrequency(uint32_t frequency)
+{
+	return (frequency % 7) != 0;
+}
+static uint32_t stubTimeOnAir(RadioModems_t modem, uint8_t pktLen)
+{
+	return pktLen * 3 + modem;
+}
+static void stubSetTxContinuousWave(uint32_t freq, int8_t power, uint16_t time)
+{
+	snprintf(line, sizeof(line), "CW %lu %d %u", (unsigned long)freq, power, time);
+	addLine();
+}
+static void stubSetMaxPayloadLength(RadioModems_t modem, uint8_t max)
+{
+	snprintf(line, sizeof(line), "PL %d %u", modem, max);
+	addLine();
+}
+
+static struct Radio_s stubRadio(void)
+{
+	struct Radio_s radio;
+	memset(&radio, 0, sizeof(radio));
+	radio.GetStatus = stubGetStatus;
+	radio.SetChannel = stubSetChannel;
+	radio.SetRxConfig = stubSetRxConfig;
+	radio.SetTxConfig = stubSetTxConfig;
+	radio.CheckRfFrequency = stubCheckRfFrequency;
+	radio.TimeOnAir = stubTimeOnAir;
+	radio.SetTxContinuousWave = stubSetTxContinuousWave;
+	radio.SetMaxPayloadLength = stubSetMaxPayloadLength;
+	return radio;
+}
+const struct Radio_s Radio = stubRadio();
+
+static uint32_t getPhy(LoRaMacRegion_t region, PhyAttribute_t attribute)
+{
+	GetPhyParams_t phy = {attribute, 0, 0, 0};
+	return RegionGetPhyParam(region, &phy).Value;
+}
+
+/** Append masks and channels after a call */
+static void addState(LoRaMacRegion_t region, uint8_t nbChannels)
+{
+	GetPhyParams_t phy = {PHY_CHANNELS_MASK, 0, 0, 0};
+	uint16_t *mask = RegionGetPhyParam(region, &phy).ChannelsMask;
+	phy.Attribute = PHY_CHANNELS_DEFAULT_MASK;
+	uint16_t *defaultMask = RegionGetPhyParam(region, &phy).ChannelsMask;
+	for (int idx = 0; idx < 6; idx++)
+	{
+		snprintf(line, sizeof(line), "%04x/%04x/%04x", mask[idx], defaultMask[idx], ChannelsMaskRemaining[idx]);
+		addLine();
+	}
+	phy.Attribute = PHY_CHANNELS;
+	ChannelParams_t *channels = RegionGetPhyParam(region, &phy).Channels;
+	for (int idx = 0; idx < nbChannels; idx++)
+	{
+		snprintf(line, sizeof(line), "%lu,%lu,%02x,%u", (unsigned long)channels[idx].Frequency,
+				 (unsigned long)channels[idx].Rx1Frequency, (uint8_t)channels[idx].DrRange.Value, channels[idx].Band);
+		addLine();
+	}
+}
+
+/** FNV-1a */
+static uint64_t hashAdd(uint64_t hash, const std::string &text)
+{
+	for (size_t idx = 0; idx < text.size(); idx++)
+	{
+		hash ^= (uint8_t)text[idx];
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+/** Random channel mask word, mostly all or nothing */
+static uint16_t randomMask(void)
+{
+	switch (testRange(0, 5))
+	{
+	case 0:
+		return 0;
+	case 1:
+	case 2:
+		return 0xFFFF;
+	case 3:
+		return 1 << testRange(0, 15);
+	default:
+		return testRandom();
+	}
+}
+
+/** Random channel for the channel requests around the default frequencies */
+static void randomChannel(ChannelParams_t *channel, uint32_t base)
+{
+	channel->Frequency = (testRange(0, 7) == 0) ? 0 : base + testRange(-20, 40) * 100000;
+	channel->Rx1Frequency = 0;
+	channel->DrRange.Fields.Min = testRange(0, 7);
+	channel->DrRange.Fields.Max = testRange(0, 7);
+	channel->Band = 0;
+}
+
+static uint64_t runRegion(const test_region_t *test)
+{
+	LoRaMacRegion_t region = test->region;
+	uint64_t hash = 0xCBF29CE484222325ULL;
+
+	testSeed = 12345;
+	RegionInitDefaults(region, INIT_TYPE_INIT);
+
+	uint8_t nbChannels = getPhy(region, PHY_MAX_NB_CHANNELS);
+	int8_t txMin = test->txMin;
+	int8_t txMax = test->txMax;
+	int8_t drMax = test->drMax;
+	uint32_t rx2Frequency = getPhy(region, PHY_DEF_RX2_FREQUENCY);
+	GetPhyParams_t phy = {PHY_CHANNELS, 0, 0, 0};
+	uint32_t base = RegionGetPhyParam(region, &phy).Channels[0].Frequency;
+	// The baseline US915 and AU915 read past their 72 channels for mask bits of channels 72 to 79
+	bool limit500 = (nbChannels == 72);
+
+	for (int iteration = 0; iteration < TEST_ITERATIONS; iteration++)
+	{
+		transcript.clear();
+		regionSeed = testRandom();
+		testNow = testRandom();
+		radioState = (testRange(0, 4) == 0) ? RF_RX_RUNNING : RF_IDLE;
+		int op = testRange(0, 25);
+		snprintf(line, sizeof(line), "%d", op);
+		addLine();
+
+		switch (op)
+		{
+		case 0:
+		case 1:
+		{
+			GetPhyParams_t get;
+			int attribute = testRange(0, sizeof(testAttributes) / sizeof(testAttributes[0]) - 1);
+			get.Attribute = testAttributes[attribute];
+			get.Datarate = (get.Attribute == PHY_NEXT_LOWER_TX_DR) ? testRange(txMin, txMax) : testRange(0, drMax);
+			get.UplinkDwellTime = testRange(0, 1);
+			get.DownlinkDwellTime = testRange(0, 1);
+			PhyParam_t value = RegionGetPhyParam(region, &get);
+			snprintf(line, sizeof(line), "%d %lu", attribute, (unsigned long)value.Value);
+			addLine();
+			break;
+		}
+		case 2:
+		{
+			VerifyParams_t verify;
+			memset(&verify, 0, sizeof(verify));
+			int index = testRange(0, sizeof(testVerifyAttributes) / sizeof(testVerifyAttributes[0]) - 1);
+			PhyAttribute_t attribute = testVerifyAttributes[index];
+			int value = testRange(-20, 70);
+			if ((attribute == PHY_NB_JOIN_TRIALS) || (attribute == PHY_DEF_NB_JOIN_TRIALS))
+			{
+				verify.NbJoinTrials = value;
+			}
+			else if ((attribute == PHY_TX_POWER) || (attribute == PHY_DEF_TX_POWER))
+			{
+				verify.TxPower = value;
+			}
+			else if (attribute == PHY_DUTY_CYCLE)
+			{
+				verify.DutyCycle = value & 1;
+			}
+			else
+			{
+				verify.DatarateParams.Datarate = value % 17;
+				verify.DatarateParams.UplinkDwellTime = testRange(0, 1);
+				verify.DatarateParams.DownlinkDwellTime = testRange(0, 1);
+			}
+			snprintf(line, sizeof(line), "%d %d", index, RegionVerify(region, &verify, attribute));
+			addLine();
+			break;
+		}
+		case 3:
+		{
+			uint16_t mask[6];
+			for (int idx = 0; idx < 6; idx++)
+			{
+				mask[idx] = randomMask();
+			}
+			if (limit500)
+			{
+				mask[4] &= 0x00FF;
+				mask[5] = 0;
+			}
+			ChanMaskSetParams_t set = {mask, (ChannelsMask_t)testRange(0, 1)};
+			snprintf(line, sizeof(line), "%d", RegionChanMaskSet(region, &set));
+			addLine();
+			break;
+		}
+		case 4:
+		{
+			AdrNextParams_t adr;
+			adr.UpdateChanMask = testRange(0, 1);
+			adr.AdrEnabled = testRange(0, 1);
+			adr.AdrAckCounter = testRange(0, 200);
+			adr.Datarate = testRange(txMin, txMax);
+			adr.TxPower = testRange(0, 14);
+			adr.UplinkDwellTime = testRange(0, 1);
+			int8_t dr;
+			int8_t power;
+			uint32_t counter;
+			bool result = RegionAdrNext(region, &adr, &dr, &power, &counter);
+			snprintf(line, sizeof(line), "%d %d %d %lu", result, dr, power, (unsigned long)counter);
+			addLine();
+			break;
+		}
+		case 5:
+		{
+			RxConfigParams_t rx;
+			memset(&rx, 0, sizeof(rx));
+			RegionComputeRxWindowParameters(region, testRange(0, drMax), testRange(4, 20), testRange(0, 50), &rx);
+			snprintf(line, sizeof(line), "%d %lu %lu %ld", rx.Datarate, (unsigned long)rx.Bandwidth,
+					 (unsigned long)rx.WindowTimeout, (long)rx.WindowOffset);
+			addLine();
+			break;
+		}
+		case 6:
+		case 7:
+		{
+			RxConfigParams_t rx;
+			memset(&rx, 0, sizeof(rx));
+			rx.Channel = testRange(0, nbChannels - 1);
+			rx.Window = testRange(0, 1);
+			rx.Datarate = testRange(0, drMax);
+			rx.Bandwidth = testRange(0, 2);
+			rx.DrOffset = testRange(0, test->maxDrOffset);
+			rx.Frequency = (testRange(0, 3) == 0) ? testRandom() * 37 : rx2Frequency;
+			rx.WindowTimeout = testRange(5, 50);
+			rx.WindowOffset = testRange(-50, 50);
+			rx.DownlinkDwellTime = testRange(0, 1);
+			rx.RepeaterSupport = testRange(0, 1);
+			rx.RxContinuous = testRange(0, 1);
+			int8_t dr = -1;
+			bool result = RegionRxConfig(region, &rx, &dr);
+			snprintf(line, sizeof(line), "%d %d", result, dr);
+			addLine();
+			break;
+		}
+		case 8:
+		case 9:
+		{
+			TxConfigParams_t tx;
+			tx.Channel = testRange(0, nbChannels - 1);
+			tx.Datarate = testRange(txMin, txMax);
+			tx.TxPower = testRange(0, 14);
+			tx.MaxEirp = testRange(10, 36);
+			tx.AntennaGain = testRange(0, 4) / 2.0f;
+			tx.PktLen = testRange(0, 255);
+			int8_t power = -1;
+			TimerTime_t timeOnAir = 0;
+			bool result = RegionTxConfig(region, &tx, &power, &timeOnAir);
+			// The baseline CN470 TxConfig has no return statement
+			snprintf(line, sizeof(line), "%d %d %lu", region == LORAMAC_REGION_CN470 ? 1 : result, power, (unsigned long)timeOnAir);
+			addLine();
+			break;
+		}
+		case 10:
+		case 11:
+		{
+			uint8_t payload[20];
+			int nbBlocks = testRange(1, 4);
+			for (int idx = 0; idx < nbBlocks; idx++)
+			{
+				uint8_t redundancy = (testRange(0, 7) << 4) | testRange(0, 15);
+				uint16_t mask = randomMask();
+				if (limit500 && ((redundancy >> 4) >= 4))
+				{
+					mask &= 0x00FF;
+				}
+				payload[idx * 5] = 0x03;
+				payload[idx * 5 + 1] = (testRange(0, 15) << 4) | testRange(0, 15);
+				payload[idx * 5 + 2] = mask & 0xFF;
+				payload[idx * 5 + 3] = mask >> 8;
+				payload[idx * 5 + 4] = redundancy;
+			}
+			LinkAdrReqParams_t req;
+			req.Payload = payload;
+			req.PayloadSize = nbBlocks * 5;
+			req.UplinkDwellTime = testRange(0, 1);
+			req.AdrEnabled = testRange(0, 1);
+			req.CurrentDatarate = testRange(txMin, txMax);
+			req.CurrentTxPower = testRange(0, 14);
+			req.CurrentNbRep = testRange(1, 3);
+			int8_t dr = -1;
+			int8_t power = -1;
+			uint8_t nbRep = 0;
+			uint8_t parsed = 0;
+			uint8_t status = RegionLinkAdrReq(region, &req, &dr, &power, &nbRep, &parsed);
+			snprintf(line, sizeof(line), "%02x %d %d %u %u", status, dr, power, nbRep, parsed);
+			addLine();
+			break;
+		}
+		case 12:
+		{
+			RxParamSetupReqParams_t req;
+			req.Datarate = testRange(-2, 16);
+			req.DrOffset = testRange(-1, 8);
+			req.Frequency = rx2Frequency + testRange(-10, 20) * 100000;
+			snprintf(line, sizeof(line), "%02x", RegionRxParamSetupReq(region, &req));
+			addLine();
+			break;
+		}
+		case 13:
+		{
+			ChannelParams_t channel;
+			randomChannel(&channel, base);
+			NewChannelReqParams_t req = {&channel, (int8_t)testRange(0, nbChannels - 1)};
+			snprintf(line, sizeof(line), "%02x", RegionNewChannelReq(region, &req));
+			addLine();
+			break;
+		}
+		case 14:
+		{
+			ChannelParams_t channel;
+			randomChannel(&channel, base);
+			ChannelAddParams_t add = {&channel, (uint8_t)testRange(0, nbChannels + 1)};
+			snprintf(line, sizeof(line), "%d", RegionChannelAdd(region, &add));
+			addLine();
+			break;
+		}
+		case 15:
+		{
+			ChannelRemoveParams_t remove = {(uint8_t)testRange(0, nbChannels - 1)};
+			snprintf(line, sizeof(line), "%d", RegionChannelsRemove(region, &remove));
+			addLine();
+			break;
+		}
+		case 16:
+		{
+			DlChannelReqParams_t req;
+			req.ChannelId = testRange(0, nbChannels - 1);
+			req.Rx1Frequency = base + testRange(-20, 40) * 100000;
+			snprintf(line, sizeof(line), "%02x", RegionDlChannelReq(region, &req));
+			addLine();
+			break;
+		}
+		case 17:
+		{
+			TxParamSetupReqParams_t req;
+			req.UplinkDwellTime = testRange(0, 1);
+			req.DownlinkDwellTime = testRange(0, 1);
+			req.MaxEirp = testRange(0, 15);
+			snprintf(line, sizeof(line), "%d", RegionTxParamSetupReq(region, &req));
+			addLine();
+			break;
+		}
+		case 18:
+		{
+			uint8_t payload[16];
+			for (int idx = 0; idx < 5; idx++)
+			{
+				uint32_t frequency = (testRange(0, 4) == 0) ? 0 : (base + testRange(-10, 30) * 200000) / 100;
+				payload[idx * 3] = frequency & 0xFF;
+				payload[idx * 3 + 1] = (frequency >> 8) & 0xFF;
+				payload[idx * 3 + 2] = (frequency >> 16) & 0xFF;
+			}
+			payload[15] = 0;
+			ApplyCFListParams_t cfList = {payload, (uint8_t)(testRange(0, 5) == 0 ? 15 : 16)};
+			RegionApplyCFList(region, &cfList);
+			break;
+		}
+		case 19:
+		case 20:
+		{
+			AlternateDrParams_t alternate = {(uint16_t)testRange(1, 200)};
+			snprintf(line, sizeof(line), "%d", RegionAlternateDr(region, &alternate));
+			addLine();
+			break;
+		}
+		case 21:
+		{
+			CalcBackOffParams_t backOff;
+			backOff.Joined = testRange(0, 1);
+			backOff.LastTxIsJoinRequest = testRange(0, 1);
+			backOff.DutyCycleEnabled = testRange(0, 1);
+			backOff.Channel = testRange(0, nbChannels - 1);
+			backOff.ElapsedTime = testRandom();
+			backOff.TxTimeOnAir = testRange(0, 3000);
+			RegionCalcBackOff(region, &backOff);
+			break;
+		}
+		case 22:
+		case 23:
+		{
+			NextChanParams_t next;
+			next.AggrTimeOff = (testRange(0, 3) == 0) ? testRandom() : 0;
+			next.LastAggrTx = testRandom();
+			next.Datarate = testRange(txMin, txMax);
+			next.Joined = testRange(0, 1);
+			next.DutyCycleEnabled = testRange(0, 1);
+			uint8_t channel = 0xFF;
+			TimerTime_t time = 1;
+			TimerTime_t aggregatedTimeOff = 7;
+			bool result = RegionNextChannel(region, &next, &channel, &time, &aggregatedTimeOff);
+			snprintf(line, sizeof(line), "%d %u %lu %lu", result, channel, (unsigned long)time, (unsigned long)aggregatedTimeOff);
+			addLine();
+			break;
+		}
+		case 24:
+		{
+			if (testRange(0, 1) == 0)
+			{
+				SetBandTxDoneParams_t txDone = {(uint8_t)testRange(0, nbChannels - 1), (bool)testRange(0, 1), testRandom()};
+				RegionSetBandTxDone(region, &txDone);
+			}
+			else
+			{
+				ContinuousWaveParams_t wave;
+				wave.Channel = testRange(0, nbChannels - 1);
+				wave.Datarate = testRange(txMin, txMax);
+				wave.TxPower = testRange(0, 14);
+				wave.MaxEirp = testRange(10, 36);
+				wave.AntennaGain = testRange(0, 4) / 2.0f;
+				wave.Timeout = testRange(0, 60);
+				RegionSetContinuousWave(region, &wave);
+			}
+			break;
+		}
+		default:
+		{
+			if (testRange(0, 3) == 0)
+			{
+				RegionInitDefaults(region, (InitType_t)testRange(INIT_TYPE_RESTORE, INIT_TYPE_APP_DEFAULTS));
+			}
+			else
+			{
+				int8_t dr = testRange(0, txMax);
+				int8_t offset = testRange(0, test->maxDrOffset);
+				snprintf(line, sizeof(line), "%u", RegionApplyDrOffset(region, testRange(0, 1), dr, offset));
+				addLine();
+			}
+			break;
+		}
+		}
+		addState(region, nbChannels);
+		hash = hashAdd(hash, transcript);
+#ifdef REGION_TEST_DUMP
+		// Transcripts of two builds can be diffed to find the first call that differs
+		printf("%s %d %s\n", test->name, iteration, transcript.c_str());
+#endif
+	}
+	return hash;
+}
+
+int main(void)
+{
+	int failures = 0;
+
+	for (size_t idx = 0; idx < sizeof(testRegions) / sizeof(testRegions[0]); idx++)
+	{
+		uint64_t hash = runRegion(&testRegions[idx]);
+#ifdef REGION_TEST_RECORD
+		printf("%s 0x%016llxULL\n", testRegions[idx].name, (unsigned long long)hash);
+#else
+		bool ok = (hash == testRegions[idx].golden);
+		printf("%s %s\n", testRegions[idx].name, ok ? "OK" : "FAILED");
+		if (!ok)
+		{
+			failures++;
+		}
+#endif
+	}
+	return failures == 0 ? 0 : 1;
+}
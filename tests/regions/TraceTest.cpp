@@ -0,0 +1,102 @@
+/**
+ * @file TraceTest.cpp
+ * @brief Host test of the trace replay of received packets
+ *
+ * Two packets are received by the radio driver on the emulated SX126x and
+ * traced, then the trace is replayed. The replay must deliver the recorded
+ * payload lengths at the recorded distance without reading the data buffer
+ * of the radio, which still holds the last packet. Built with LIB_TRACE 1.
+ */
+#include <stdio.h>
+
+#include "HostBoard.h"
+#include "boards/mcu/board.h"
+
+/** Received packets */
+typedef struct
+{
+	uint64_t time;
+	uint16_t size;
+	bool zeros;
+} test_rx_t;
+
+static test_rx_t received[4];
+static uint8_t nbReceived = 0;
+
+static void onRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+{
+	if (nbReceived < sizeof(received) / sizeof(received[0]))
+	{
+		received[nbReceived].time = HostTime();
+		received[nbReceived].size = size;
+		received[nbReceived].zeros = true;
+		for (uint16_t idx = 0; idx < size; idx++)
+		{
+			if (payload[idx] != 0)
+			{
+				received[nbReceived].zeros = false;
+			}
+		}
+	}
+	nbReceived++;
+}
+
+static RadioEvents_t RadioEvents;
+
+static int failed = 0;
+
+static void check(const char *name, bool ok)
+{
+	printf("%s %s\n", name, ok ? "OK" : "FAILED");
+	if (!ok)
+	{
+		failed++;
+	}
+}
+
+int main(void)
+{
+	uint8_t packet[64];
+	trace_entry_t trace[LIB_TRACE_SIZE];
+
+	RadioEvents.RxDone = onRxDone;
+	Radio.Init(&RadioEvents);
+	// The radio events are called for the public network only, the P2P events otherwise
+	Radio.SetPublicNetwork(true);
+	Radio.SetRxConfig(MODEM_LORA, 0, 7, 1, 0, 8, 0, false, 0, true, 0, 0, false, true);
+	Radio.Rx(0);
+
+	// Record two packets 150 ms apart
+	trace_clear();
+	memset(packet, 0xA5, sizeof(packet));
+	HostRadioIrq(IRQ_RX_DONE, packet, 20, -80, 7);
+	HostRun(150);
+	HostRadioIrq(IRQ_RX_DONE, packet, 7, -80, 7);
+	uint16_t count = trace_get(trace, LIB_TRACE_SIZE);
+
+	uint8_t nbRx = 0;
+	for (uint16_t idx = 0; idx < count; idx++)
+	{
+		if (trace[idx].type == TRACE_RX)
+		{
+			nbRx++;
+		}
+	}
+	check("record", (nbReceived == 2) && (nbRx == 2) && (received[0].size == 20) && (received[1].size == 7));
+
+	// Replay slower than recorded, the radio raises no IRQ
+	nbReceived = 0;
+	uint32_t reads = HostBufferReads();
+	HostRun(10);
+	check("replay start", trace_replay(trace, count, 200));
+	// The first IRQ is raised at once, handled by the LoRa task
+	Radio.BgIrqProcess();
+	HostRun(1000);
+	check("replay lengths", (nbReceived == 2) && (received[0].size == 20) && (received[1].size == 7));
+	check("replay payload", received[0].zeros && received[1].zeros);
+	check("replay timing", (received[1].time - received[0].time) / 1000 == 300);
+	check("replay buffer", HostBufferReads() == reads);
+	check("replay end", !trace_replaying());
+
+	return failed == 0 ? 0 : 1;
+}
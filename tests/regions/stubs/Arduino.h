@@ -0,0 +1,56 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal Arduino core declarations to compile the region code on a host
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define RISING 1
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+struct HardwareSerial
+{
+	void printf(const char *, ...) {}
+	void print(const char *) {}
+	void println(const char *) {}
+	void begin(int) {}
+	void flush(void) {}
+	operator bool() { return true; }
+};
+extern HardwareSerial Serial;
+
+class SPISettings
+{
+public:
+	SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass
+{
+public:
+	void begin(void) {}
+	void begin(int, int, int, int) {}
+	void end(void) {}
+	void beginTransaction(SPISettings) {}
+	void endTransaction(void) {}
+	uint8_t transfer(uint8_t) { return 0; }
+};
+extern SPIClass SPI;
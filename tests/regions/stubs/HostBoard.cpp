@@ -0,0 +1,382 @@
+/**
+ * @file HostBoard.cpp
+ * @brief Emulated board and SX126x to run the radio driver and the MAC sources on a host
+ */
+#include "HostBoard.h"
+
+#include "boards/mcu/board.h"
+#include "boards/mcu/timer.h"
+#include "boards/sx126x/sx126x-board.h"
+#include "radio/radio.h"
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+hw_config _hwConfig;
+
+/** Simulated time in us */
+static uint64_t hostNow = 0;
+
+uint64_t HostTime(void)
+{
+	return hostNow;
+}
+
+unsigned long millis(void)
+{
+	return (unsigned long)(hostNow / 1000);
+}
+
+unsigned long micros(void)
+{
+	return (unsigned long)hostNow;
+}
+
+/** Busy wait, the timers expire only in HostRun() */
+void delay(unsigned long ms)
+{
+	hostNow += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	hostNow += us;
+}
+
+uint32_t BoardGetRandomSeed(void)
+{
+	return 0x4C6F5261;
+}
+
+void BoardGetUniqueId(uint8_t *id)
+{
+	for (uint8_t idx = 0; idx < 8; idx++)
+	{
+		id[idx] = idx;
+	}
+}
+
+uint8_t BoardGetBatteryLevel(void)
+{
+	return 254;
+}
+
+void BoardDisableIrq(void)
+{
+}
+
+void BoardEnableIrq(void)
+{
+}
+
+/** Maximum number of timers */
+#define HOST_MAX_TIMERS 32
+
+/** Timer structure */
+struct s_timer
+{
+	TimerEvent_t *obj = NULL;
+	bool armed = false;
+	uint64_t expiry = 0;
+};
+
+/** Array to hold the timers */
+static s_timer timer[HOST_MAX_TIMERS];
+
+void TimerConfig(void)
+{
+	for (int idx = 0; idx < HOST_MAX_TIMERS; idx++)
+	{
+		timer[idx].obj = NULL;
+		timer[idx].armed = false;
+	}
+}
+
+void TimerInit(TimerEvent_t *obj, void (*callback)(void))
+{
+	obj->Callback = callback;
+
+	int freeSlot = -1;
+	for (int idx = 0; idx < HOST_MAX_TIMERS; idx++)
+	{
+		if (timer[idx].obj == obj)
+		{
+			timer[idx].armed = false;
+			obj->timerNum = idx;
+			return;
+		}
+		if ((timer[idx].obj == NULL) && (freeSlot == -1))
+		{
+			freeSlot = idx;
+		}
+	}
+	if (freeSlot == -1)
+	{
+		abort();
+	}
+	timer[freeSlot].obj = obj;
+	timer[freeSlot].armed = false;
+	obj->timerNum = freeSlot;
+}
+
+void TimerArm(TimerEvent_t *obj, uint32_t value)
+{
+	timer[obj->timerNum].armed = true;
+	timer[obj->timerNum].expiry = hostNow + (uint64_t)value * 1000;
+}
+
+void TimerStart(TimerEvent_t *obj)
+{
+	uint32_t value = obj->ReloadValue;
+
+	timer[obj->timerNum].armed = false;
+	if (TimerCoalesce(obj, &value))
+	{
+		TimerArm(obj, value);
+	}
+}
+
+void TimerStop(TimerEvent_t *obj)
+{
+	timer[obj->timerNum].armed = false;
+	TimerRemove(obj);
+}
+
+void TimerReset(TimerEvent_t *obj)
+{
+	TimerStart(obj);
+}
+
+void TimerSetValue(TimerEvent_t *obj, uint32_t value)
+{
+	obj->ReloadValue = value;
+}
+
+TimerTime_t TimerGetCurrentTime(void)
+{
+	return millis();
+}
+
+TimerTime_t TimerGetElapsedTime(TimerTime_t past)
+{
+	return millis() - past;
+}
+
+void HostRun(uint32_t ms)
+{
+	uint64_t end = hostNow + (uint64_t)ms * 1000;
+
+	while (true)
+	{
+		int next = -1;
+		for (int idx = 0; idx < HOST_MAX_TIMERS; idx++)
+		{
+			if (timer[idx].armed && (timer[idx].expiry <= end) &&
+				((next == -1) || (timer[idx].expiry < timer[next].expiry)))
+			{
+				next = idx;
+			}
+		}
+		if (next == -1)
+		{
+			break;
+		}
+
+		TimerEvent_t *obj = timer[next].obj;
+		if (timer[next].expiry > hostNow)
+		{
+			hostNow = timer[next].expiry;
+		}
+		if (obj->oneShot || (obj->ReloadValue == 0))
+		{
+			timer[next].armed = false;
+		}
+		else
+		{
+			timer[next].expiry += (uint64_t)obj->ReloadValue * 1000;
+		}
+		TimerDispatch(obj);
+		// The LoRa task handles the radio IRQs raised by the timer callbacks
+		Radio.BgIrqProcess();
+	}
+	if (end > hostNow)
+	{
+		hostNow = end;
+	}
+}
+
+/** Emulated SX126x */
+static DioIrqHandler *dioIrqHandler = NULL;
+static uint16_t chipIrq = 0;
+static uint8_t chipPacketType = 0;
+static uint8_t chipRxStatus[2] = {0, 0};
+static uint8_t chipPacketStatus[3] = {0, 0, 0};
+static uint8_t chipBuffer[256];
+static uint8_t chipRegisters[0x1000];
+static uint32_t chipBufferReads = 0;
+
+void SX126xIoInit(void)
+{
+	SX126xReset();
+}
+
+void SX126xIoReInit(void)
+{
+}
+
+void SX126xIoIrqInit(DioIrqHandler dioIrq)
+{
+	dioIrqHandler = dioIrq;
+}
+
+void SX126xIoDeInit(void)
+{
+}
+
+void SX126xReset(void)
+{
+	chipIrq = 0;
+	memset(chipRegisters, 0, sizeof(chipRegisters));
+}
+
+void SX126xWaitOnBusy(void)
+{
+}
+
+void SX126xWakeup(void)
+{
+}
+
+void SX126xWriteCommand(RadioCommands_t command, uint8_t *buffer, uint16_t size)
+{
+	switch (command)
+	{
+	case RADIO_CLR_IRQSTATUS:
+		chipIrq &= ~((buffer[0] << 8) | buffer[1]);
+		break;
+	case RADIO_SET_PACKETTYPE:
+		chipPacketType = buffer[0];
+		break;
+	default:
+		break;
+	}
+}
+
+void SX126xReadCommand(RadioCommands_t command, uint8_t *buffer, uint16_t size)
+{
+	memset(buffer, 0, size);
+	switch (command)
+	{
+	case RADIO_GET_IRQSTATUS:
+		buffer[0] = chipIrq >> 8;
+		buffer[1] = chipIrq & 0xFF;
+		break;
+	case RADIO_GET_PACKETTYPE:
+		buffer[0] = chipPacketType;
+		break;
+	case RADIO_GET_RXBUFFERSTATUS:
+		memcpy(buffer, chipRxStatus, size < 2 ? size : 2);
+		break;
+	case RADIO_GET_PACKETSTATUS:
+		memcpy(buffer, chipPacketStatus, size < 3 ? size : 3);
+		break;
+	default:
+		break;
+	}
+}
+
+void SX126xWriteRegisters(uint16_t address, uint8_t *buffer, uint16_t size)
+{
+	for (uint16_t idx = 0; idx < size; idx++)
+	{
+		chipRegisters[(address + idx) & 0x0FFF] = buffer[idx];
+	}
+}
+
+void SX126xWriteRegister(uint16_t address, uint8_t value)
+{
+	SX126xWriteRegisters(address, &value, 1);
+}
+
+void SX126xReadRegisters(uint16_t address, uint8_t *buffer, uint16_t size)
+{
+	for (uint16_t idx = 0; idx < size; idx++)
+	{
+		buffer[idx] = chipRegisters[(address + idx) & 0x0FFF];
+	}
+}
+
+uint8_t SX126xReadRegister(uint16_t address)
+{
+	uint8_t data;
+	SX126xReadRegisters(address, &data, 1);
+	return data;
+}
+
+void SX126xWriteBuffer(uint8_t offset, uint8_t *buffer, uint8_t size)
+{
+	for (uint16_t idx = 0; idx < size; idx++)
+	{
+		chipBuffer[(uint8_t)(offset + idx)] = buffer[idx];
+	}
+}
+
+void SX126xReadBuffer(uint8_t offset, uint8_t *buffer, uint8_t size)
+{
+	for (uint16_t idx = 0; idx < size; idx++)
+	{
+		buffer[idx] = chipBuffer[(uint8_t)(offset + idx)];
+	}
+	chipBufferReads += size;
+}
+
+void SX126xSetRfTxPower(int8_t power)
+{
+	SX126xSetTxParams(power, RADIO_RAMP_40_US);
+}
+
+uint8_t SX126xGetPaSelect(uint32_t channel)
+{
+	return SX1262;
+}
+
+void SX126xAntSwOn(void)
+{
+}
+
+void SX126xAntSwOff(void)
+{
+}
+
+void SX126xRXena(void)
+{
+}
+
+void SX126xTXena(void)
+{
+}
+
+uint32_t HostBufferReads(void)
+{
+	return chipBufferReads;
+}
+
+void HostRadioIrq(uint16_t irq, const uint8_t *payload, uint8_t size, int8_t rssi, int8_t snr)
+{
+	if (payload != NULL)
+	{
+		memcpy(chipBuffer, payload, size);
+	}
+	chipRxStatus[0] = size;
+	chipRxStatus[1] = 0;
+	chipPacketStatus[0] = (uint8_t)(-rssi * 2);
+	chipPacketStatus[1] = (uint8_t)(snr * 4);
+	chipPacketStatus[2] = (uint8_t)(-rssi * 2);
+	chipIrq |= irq;
+
+	if (dioIrqHandler != NULL)
+	{
+		dioIrqHandler();
+	}
+	Radio.BgIrqProcess();
+}
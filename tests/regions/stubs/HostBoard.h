@@ -0,0 +1,44 @@
+/**
+ * @file HostBoard.h
+ * @brief Emulated board and SX126x to run the radio driver and the MAC sources on a host
+ *
+ * HostBoard.cpp replaces the MCU and SX126x board files of src/boards. It
+ * links with the unchanged radio driver, src/boards/mcu/timer.cpp and the MAC
+ * sources:
+ * - a simulated clock for millis(), micros() and delay()
+ * - a timer backend on the simulated clock, see HostRun()
+ * - an SX126x with IRQ flags, data buffer, registers and packet status that
+ *   answers the commands of the driver, BUSY is always ready
+ *
+ * Nothing is sent, TX and RX end only when the test raises the IRQ with
+ * HostRadioIrq().
+ */
+#pragma once
+
+#include <stdint.h>
+
+/** Simulated time since the start in us */
+uint64_t HostTime(void);
+
+/**
+ * @brief Advance the simulated time and call the callbacks of the expired timers
+ * The callbacks run in the order of their expiry with the time set to it.
+ * After each callback the radio IRQs are handled as the LoRa task does.
+ *
+ * @param ms time to advance in milliseconds
+ */
+void HostRun(uint32_t ms);
+
+/**
+ * @brief Raise radio IRQs on DIO1 and handle them as the LoRa task does
+ *
+ * @param irq IRQ flags, IRQ_RX_DONE, IRQ_TX_DONE, ...
+ * @param payload received packet, copied to the start of the data buffer, NULL keeps the buffer
+ * @param size packet size reported by the RX buffer status
+ * @param rssi packet RSSI in dBm
+ * @param snr packet SNR in dB
+ */
+void HostRadioIrq(uint16_t irq, const uint8_t *payload, uint8_t size, int8_t rssi, int8_t snr);
+
+/** Bytes read from the data buffer of the emulated SX126x since the start */
+uint32_t HostBufferReads(void);